@@ -32,15 +32,22 @@
 #include <systemd/sd-daemon.h>
 #include <boost/system/error_code.hpp>
 #include <boost/asio/basic_waitable_timer.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/thread_pool.hpp>
 #include <boost/asio/ssl.hpp>
 #include <boost/asio/ip/tcp.hpp>
 #include <date/date.h>
 #include <cassandra.h>
-#include <cassobs/dbconnection_observations.h>
 
+#include "storage/observations_storage.h"
 #include "time_offseter.h"
 #include "abstract_download_scheduler.h"
 #include "http_utils.h"
+#include "monitoring/metrics.h"
+#include "monitoring/loop_lag_monitor.h"
+#include "monitoring/db_profiler.h"
+#include "monitoring/ingestion_trace.h"
 
 namespace asio = boost::asio;
 namespace ip = boost::asio::ip;
@@ -55,19 +62,32 @@ using namespace date;
 
 AbstractDownloadScheduler::AbstractDownloadScheduler(
 		chrono::steady_clock::duration period, asio::io_context& ioContext,
-		DbConnectionObservations& db
+		ObservationsStorage& db, const char* name
 	) :
 		Connector{ioContext, db},
+		_tracePath{std::string{"scheduler_"} + name},
+		_timer{ioContext},
 		_period{period},
-		_timer{ioContext}
+		_name{name},
+		_downloadDuration{MetricsRegistry::instance().histogram("meteodata_scheduler_download_duration_seconds",
+			"Time taken by the periodic downloads of the schedulers", {{"scheduler", name}})},
+		_downloadFailures{MetricsRegistry::instance().counter("meteodata_scheduler_download_failures_total",
+			"Number of periodic downloads of the schedulers aborted by an error", {{"scheduler", name}})},
+		_downloadDelay{MetricsRegistry::instance().histogram("meteodata_scheduler_download_delay_seconds",
+			"Delay between the scheduled time of the periodic downloads of the schedulers and their start",
+			{{"scheduler", name}}, {0.1, 1, 5, 15, 60, 300, 900, 3600})},
+		_skippedDownloads{MetricsRegistry::instance().counter("meteodata_scheduler_skipped_downloads_total",
+			"Number of periodic downloads of the schedulers skipped because the previous one was still running",
+			{{"scheduler", name}})}
 {
+	_db.setCaller(name);
 	_status.shortStatus = "IDLE";
 }
 
 void AbstractDownloadScheduler::start()
 {
 	_mustStop = false;
-	auto now = date::floor<chrono::seconds>(chrono::system_clock::now());
+	auto now = date::floor<chrono::seconds>(SystemClock::now());
 	_status.activeSince = now;
 	_status.lastReloaded = now;
 	_status.nbDownloads = 0;
@@ -76,6 +96,51 @@ void AbstractDownloadScheduler::start()
 	waitUntilNextDownload();
 }
 
+void AbstractDownloadScheduler::startInBackground(asio::thread_pool& warmupPool)
+{
+	_mustStop = false;
+
+	auto self(shared_from_this());
+	// keep the I/O context running until the stations are loaded
+	auto work = asio::make_work_guard(_ioContext);
+	// The status is only ever touched from the I/O threads, the warm-up
+	// thread only loads the stations, through the storage which is safe to
+	// share between threads.
+	asio::post(_ioContext, [this, self, work, &warmupPool]() {
+		if (_mustStop)
+			return;
+		auto now = date::floor<chrono::seconds>(SystemClock::now());
+		_status.activeSince = now;
+		_status.lastReloaded = now;
+		_status.nbDownloads = 0;
+		_status.shortStatus = "LOADING STATIONS";
+
+		asio::post(warmupPool, [this, self, work]() {
+			bool loaded = true;
+			try {
+				reloadStations();
+			} catch (std::exception& e) {
+				std::cerr << SD_ERR << "[Scheduler] management: "
+					<< "Failed to load the stations: " << e.what() << "\n"
+					<< "Giving up for now, reload the connector to retry."
+					<< std::endl;
+				loaded = false;
+			}
+
+			asio::post(_ioContext, [this, self, loaded]() {
+				if (_mustStop)
+					return;
+				if (!loaded) {
+					_status.shortStatus = "FAILED TO LOAD STATIONS";
+					return;
+				}
+				_status.shortStatus = "OK";
+				waitUntilNextDownload();
+			});
+		});
+	});
+}
+
 void AbstractDownloadScheduler::stop()
 {
 	_mustStop = true;
@@ -86,9 +151,13 @@ void AbstractDownloadScheduler::stop()
 void AbstractDownloadScheduler::reload()
 {
 	_timer.cancel();
-	_status.lastReloaded = date::floor<chrono::seconds>(chrono::system_clock::now());
+	_status.lastReloaded = date::floor<chrono::seconds>(SystemClock::now());
 	_status.nbDownloads = 0;
-	reloadStations();
+	{
+		LoopLagMonitor::Activity activity{"stations reload of scheduler", _name};
+		reloadStations();
+	}
+	_status.shortStatus = "OK";
 	waitUntilNextDownload();
 }
 
@@ -98,7 +167,7 @@ void AbstractDownloadScheduler::waitUntilNextDownload()
 		return;
 
 	auto self(shared_from_this());
-	auto now = chrono::system_clock::now();
+	auto now = SystemClock::now();
 	auto tp = _period - (now.time_since_epoch() % _period) + _offset;
 	_timer.expires_from_now(tp);
 	_status.nextDownload = date::floor<chrono::seconds>(now + tp);
@@ -113,12 +182,18 @@ void AbstractDownloadScheduler::checkDeadline(const sys::error_code& e)
 		return;
 
 	// verify that the timeout is not spurious
-	if (_timer.expires_at() <= chrono::steady_clock::now()) {
+	if (_timer.expires_at() <= SteadyClock::now()) {
 		++_status.nbDownloads;
-		_status.lastDownload = date::floor<chrono::seconds>(chrono::system_clock::now());
+		auto now = SystemClock::now();
+		_status.lastDownload = date::floor<chrono::seconds>(now);
+		_downloadDelay.observe(chrono::duration_cast<chrono::steady_clock::duration>(now - _status.nextDownload));
 		try {
+			LoopLagMonitor::Activity activity{"periodic download of scheduler", _name};
+			DbProfiler::CallerScope callerScope{_name};
+			Histogram::ScopedTimer timer{_downloadDuration};
 			download();
 		} catch (std::runtime_error& e) {
+			_downloadFailures.increment();
 			// If the error comes from cURL, there will be details in log
 			// already at this point
 			std::cerr << SD_ERR << "[Scheduler] management: "
@@ -126,6 +201,11 @@ void AbstractDownloadScheduler::checkDeadline(const sys::error_code& e)
 				<< "Giving up for now, will retry at next scheduled time."
 				<< std::endl;
 		}
+		// the downloads missed while this one was running are not made
+		// up for, the next one is scheduled in the next period
+		auto overrun = SystemClock::now() - _status.nextDownload;
+		if (overrun >= _period)
+			_skippedDownloads.increment(overrun / _period);
 		waitUntilNextDownload();
 	} else {
 		/* spurious handler call, restart the timer without changing the
@@ -144,7 +224,7 @@ std::string AbstractDownloadScheduler::getStatus() const
 	os << Connector::getStatus()
 	   << "next download scheduled at " << date::make_zoned(z, _status.nextDownload);
 
-	auto timeToNextDownload = _status.nextDownload - chrono::system_clock::now();
+	auto timeToNextDownload = _status.nextDownload - SystemClock::now();
 	if (timeToNextDownload > chrono::seconds(0)) {
 		auto h = date::floor<chrono::hours>(timeToNextDownload);
 		auto m = date::floor<chrono::minutes>(timeToNextDownload - h);
@@ -31,11 +31,15 @@
 #include <map>
 
 #include <boost/asio/basic_waitable_timer.hpp>
+#include <boost/asio/thread_pool.hpp>
 #include <cassandra.h>
-#include <cassobs/dbconnection_observations.h>
 
+#include "storage/observations_storage.h"
 #include "curl_wrapper.h"
+#include "simulated_clock.h"
 #include "connector.h"
+#include "monitoring/metrics.h"
+#include "monitoring/ingestion_trace.h"
 
 namespace meteodata
 {
@@ -64,15 +68,32 @@ public:
 	 * @param ioContext the Boost object used to process asynchronous
 	 * events, timers, and callbacks
 	 * @param db the Météodata observations database connector
+	 * @param name the name of the scheduler in the metrics and the logs, a
+	 * string literal
 	 */
 	AbstractDownloadScheduler(chrono::steady_clock::duration period, asio::io_context& ioContext,
-							  DbConnectionObservations& db);
+							  ObservationsStorage& db, const char* name);
 
 	/**
 	 * @brief Start the periodic downloads
 	 */
 	void start() override;
 
+	/**
+	 * @brief Start the periodic downloads, once the stations have been
+	 * loaded in the background
+	 *
+	 * Loading the stations may take a while (database queries, HTTP
+	 * requests, etc.), this lets the caller start the other connectors
+	 * meanwhile. The first download is scheduled from the I/O context, as
+	 * usual, after the stations are loaded. The status is only updated
+	 * from the I/O context.
+	 *
+	 * @param warmupPool The threads to load the stations from, it must
+	 * outlive the loading
+	 */
+	void startInBackground(asio::thread_pool& warmupPool);
+
 	/**
 	 * @brief Stop the periodic downloads
 	 */
@@ -107,17 +128,53 @@ protected:
 	 */
 	bool _mustStop = false;
 
+	/**
+	 * @brief The histograms of the stages of the periodic downloads, the
+	 * schedulers open one trace per station (or per message for the
+	 * connectors downloading several stations at once) in which the
+	 * downloaders mark the stages
+	 */
+	IngestionTrace::Path _tracePath;
+
 private:
 	/**
-	 * @brief The timer used to periodically trigger the data downloads
+	 * @brief The timer used to periodically trigger the data downloads,
+	 * in simulated time (see SimulatedTime)
 	 */
-	asio::basic_waitable_timer<chrono::steady_clock> _timer;
+	SteadyTimer _timer;
 
 	/**
 	 * @brief The time between two measurements
 	 */
 	chrono::steady_clock::duration _period;
 
+	/**
+	 * @brief The name of the scheduler
+	 */
+	const char* _name;
+
+	/**
+	 * @brief The time taken by each periodic download, for all stations
+	 */
+	Histogram& _downloadDuration;
+
+	/**
+	 * @brief The number of periodic downloads that have failed
+	 */
+	Counter& _downloadFailures;
+
+	/**
+	 * @brief The delay between the time each periodic download is
+	 * scheduled at and the time it actually starts
+	 */
+	Histogram& _downloadDelay;
+
+	/**
+	 * @brief The number of periodic downloads skipped because the previous
+	 * download lasted longer than the period
+	 */
+	Counter& _skippedDownloads;
+
 	/**
 	 * @brief Reload the list of StatIC stations from the database and
 	 * recreate all downloaders
@@ -0,0 +1,59 @@
+/**
+ * @file archive_cleanup.cpp
+ * @brief Implementation of the helpers used to replace real-time observations
+ * by archive observations
+ * @author Laurent Georget
+ * @date 2026-10-18
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <chrono>
+
+#include <cassandra.h>
+#include <date/date.h>
+
+#include "monitoring/profiled_db_connection.h"
+#include "archive_cleanup.h"
+
+namespace meteodata
+{
+
+namespace chrono = std::chrono;
+
+bool deleteSupersededRealtimeObservations(const ProfiledDbConnection& db, const CassUuid& station,
+	const date::sys_seconds& lastArchive, const date::sys_seconds& oldest, const date::sys_seconds& newest,
+	chrono::minutes pollingPeriod)
+{
+	// Everything up to the last archive already comes from an archive
+	// and is simply overwritten, but the real-time observations stored
+	// since, including those shortly before the first record of the new
+	// archive, must go
+	date::sys_seconds begin = std::max(lastArchive + chrono::seconds{1}, oldest - pollingPeriod);
+	auto lastDay = date::floor<date::days>(newest);
+	begin = std::max(begin, date::sys_seconds{lastDay - (MAX_DELETION_DAYS - date::days{1})});
+	if (begin > newest)
+		return true;
+
+	bool ret = true;
+	for (auto day = date::floor<date::days>(begin) ; day <= lastDay ; day += date::days{1})
+		ret = db.deleteDataPoints(station, day, begin, newest) && ret;
+	return ret;
+}
+
+}
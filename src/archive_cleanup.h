@@ -0,0 +1,80 @@
+/**
+ * @file archive_cleanup.h
+ * @brief Definition of the helpers used to replace real-time observations by
+ * archive observations
+ * @author Laurent Georget
+ * @date 2026-10-18
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ARCHIVE_CLEANUP_H
+#define ARCHIVE_CLEANUP_H
+
+#include <chrono>
+
+#include <cassandra.h>
+#include <date/date.h>
+
+#include "monitoring/profiled_db_connection.h"
+
+namespace meteodata
+{
+
+/**
+ * @brief Delete the real-time observations about to be superseded by an
+ * archive
+ *
+ * Observations are keyed on (station, day, time) so inserting an archive
+ * record overwrites whatever was stored at the same time, re-downloading an
+ * archive that overlaps what is already stored costs only the writes. The only
+ * records that must really disappear are the temporary real-time observations
+ * stored since the last archive, at times the archive may not have. This
+ * function deletes those and only those: everything after the last archive,
+ * up to the newest record of the new archive, and nothing at or before the
+ * last archive, so as not to create useless tombstones in the partitions
+ * already holding archives.
+ *
+ * The deletions are done day by day, so the interval is bounded for new
+ * stations and for stations offline for a long time, whose last archive is
+ * far away: it starts at most one polling period before the oldest record of
+ * the new archive, and spans at most MAX_DELETION_DAYS days.
+ *
+ * @param db The observations database, the deletions are profiled as
+ * the other calls of the caller
+ * @param station The station whose archive is being stored
+ * @param lastArchive The time of the last archive record stored before this
+ * one
+ * @param oldest The time of the oldest record in the new archive
+ * @param newest The time of the newest record in the new archive
+ * @param pollingPeriod The archive period of the station
+ * @return True if everything went fine (including if there was nothing to
+ * delete), false if one of the deletions failed
+ */
+bool deleteSupersededRealtimeObservations(const ProfiledDbConnection& db, const CassUuid& station,
+	const date::sys_seconds& lastArchive, const date::sys_seconds& oldest, const date::sys_seconds& newest,
+	std::chrono::minutes pollingPeriod);
+
+/**
+ * @brief The maximum number of days of real-time observations deleted by
+ * deleteSupersededRealtimeObservations() at once
+ */
+constexpr date::days MAX_DELETION_DAYS{31};
+
+}
+
+#endif /* ARCHIVE_CLEANUP_H */
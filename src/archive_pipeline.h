@@ -0,0 +1,285 @@
+/**
+ * @file archive_pipeline.h
+ * @brief Definition of the ArchivePipeline class
+ * @author Laurent Georget
+ * @date 2026-10-18
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ARCHIVE_PIPELINE_H
+#define ARCHIVE_PIPELINE_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+#include "monitoring/db_profiler.h"
+
+namespace meteodata
+{
+
+/**
+ * @brief A FIFO queue with a maximum size, shared between a producer and a
+ * consumer thread
+ *
+ * The producer blocks when the queue is full, the consumer blocks when it is
+ * empty. Once closed, the producer can no longer push while the consumer can
+ * still drain the remaining elements.
+ */
+template<typename T>
+class BoundedQueue
+{
+public:
+	explicit BoundedQueue(std::size_t capacity) :
+		_capacity{capacity}
+	{}
+
+	/**
+	 * @brief Append an element, waiting for some room if necessary
+	 *
+	 * @param element The element to append
+	 * @return False if the queue has been closed, in which case the element
+	 * is dropped, true otherwise
+	 */
+	bool push(T&& element)
+	{
+		std::unique_lock<std::mutex> lock{_mutex};
+		_notFull.wait(lock, [this]() { return _closed || _elements.size() < _capacity; });
+		if (_closed)
+			return false;
+		_elements.push_back(std::move(element));
+		_notEmpty.notify_one();
+		return true;
+	}
+
+	/**
+	 * @brief Remove the first element, waiting for one if necessary
+	 *
+	 * @return The first element, or nothing if the queue is closed and
+	 * empty
+	 */
+	std::optional<T> pop()
+	{
+		std::unique_lock<std::mutex> lock{_mutex};
+		_notEmpty.wait(lock, [this]() { return _closed || !_elements.empty(); });
+		if (_elements.empty())
+			return std::nullopt;
+		std::optional<T> element{std::move(_elements.front())};
+		_elements.pop_front();
+		_notFull.notify_one();
+		return element;
+	}
+
+	/**
+	 * @brief Close the queue and wake up both sides
+	 */
+	void close()
+	{
+		std::lock_guard<std::mutex> lock{_mutex};
+		_closed = true;
+		_notFull.notify_all();
+		_notEmpty.notify_all();
+	}
+
+private:
+	std::size_t _capacity;
+	std::deque<T> _elements;
+	bool _closed = false;
+	std::mutex _mutex;
+	std::condition_variable _notFull;
+	std::condition_variable _notEmpty;
+};
+
+/**
+ * @brief A three-stage download → decode → store pipeline to catch up with
+ * the archive of a station
+ *
+ * Downloaders that are days behind fetch the archive window by window. Run in
+ * sequence, the network, the CPU and the database each sit idle most of the
+ * time. The pipeline runs the fetch stage and the decode stage each in their
+ * own thread so that the next window is being downloaded while the previous
+ * one is parsed and the one before is stored. Queues between the stages are
+ * bounded so that a slow database does not make the pipeline buffer the whole
+ * archive in memory.
+ *
+ * The store stage runs in the calling thread, so the database connection is
+ * still used from one thread only, and the windows are stored strictly in the
+ * order they have been fetched in. The first failure stops the whole
+ * pipeline: the windows fetched after a window that could not be stored are
+ * discarded so that the last archive download time never skips over a hole.
+ *
+ * When there is only one window to download, which is the common case for
+ * stations that are up-to-date, the three stages simply run one after the
+ * other in the calling thread, no thread is started.
+ *
+ * @tparam Raw The output of the fetch stage (typically the HTTP response body)
+ * @tparam Decoded The output of the decode stage (typically observations)
+ */
+template<typename Raw, typename Decoded>
+class ArchivePipeline
+{
+public:
+	/**
+	 * @brief Download the next window
+	 *
+	 * Called repeatedly until it returns nothing, the first two times in
+	 * the calling thread and then in the fetch thread.
+	 * The fetcher may throw, in which case the windows fetched before are
+	 * still decoded and stored before the exception is rethrown by run().
+	 */
+	using Fetcher = std::function<std::optional<Raw>()>;
+	/**
+	 * @brief Parse a window, called in the decode thread (or in the calling
+	 * thread when there is only one window)
+	 *
+	 * The decoder must not use the database connection.
+	 */
+	using Decoder = std::function<Decoded(Raw&&)>;
+	/**
+	 * @brief Store a window, called in the calling thread, in order
+	 *
+	 * Returning false stops the pipeline.
+	 */
+	using Storer = std::function<bool(Decoded&&)>;
+
+	/**
+	 * @brief Construct the pipeline
+	 *
+	 * @param depth The capacity of each of the queues between the stages
+	 */
+	explicit ArchivePipeline(std::size_t depth = DEFAULT_DEPTH) :
+		_raw{depth},
+		_decoded{depth}
+	{}
+
+	/**
+	 * @brief Run the pipeline until the fetcher has nothing left to
+	 * download or a stage fails
+	 *
+	 * A pipeline can only be run once.
+	 *
+	 * @param fetch The fetch stage
+	 * @param decode The decode stage
+	 * @param store The store stage
+	 * @return True if all the windows fetched have been stored, false if
+	 * the storer has reported an error
+	 */
+	bool run(const Fetcher& fetch, const Decoder& decode, const Storer& store)
+	{
+		// The fetch and decode threads attribute their database calls,
+		// if any, to the same component as the calling thread
+		const char* caller = DbProfiler::currentCaller();
+
+		std::optional<Raw> first = fetch();
+		if (!first)
+			return true;
+
+		std::optional<Raw> second;
+		std::exception_ptr fetchError;
+		try {
+			second = fetch();
+		} catch (...) {
+			fetchError = std::current_exception();
+		}
+
+		if (!second) {
+			// Most of the time, the station is up-to-date and there is
+			// only one window to download, not worth starting threads
+			if (!store(decode(std::move(*first))))
+				return false;
+			if (fetchError)
+				std::rethrow_exception(fetchError);
+			return true;
+		}
+
+		std::exception_ptr decodeError;
+
+		std::thread fetcher{[&]() {
+			DbProfiler::CallerScope scope{caller};
+			try {
+				if (_raw.push(std::move(*first)) && _raw.push(std::move(*second))) {
+					for (std::optional<Raw> raw = fetch() ; raw ; raw = fetch()) {
+						if (!_raw.push(std::move(*raw)))
+							break;
+					}
+				}
+			} catch (...) {
+				fetchError = std::current_exception();
+			}
+			_raw.close();
+		}};
+
+		std::thread decoder{[&]() {
+			DbProfiler::CallerScope scope{caller};
+			try {
+				for (std::optional<Raw> raw = _raw.pop() ; raw ; raw = _raw.pop()) {
+					if (!_decoded.push(decode(std::move(*raw))))
+						break;
+				}
+			} catch (...) {
+				decodeError = std::current_exception();
+			}
+			_raw.close();
+			_decoded.close();
+		}};
+
+		bool result = true;
+		std::exception_ptr storeError;
+		try {
+			for (std::optional<Decoded> decoded = _decoded.pop() ; decoded ; decoded = _decoded.pop()) {
+				if (!store(std::move(*decoded))) {
+					result = false;
+					break;
+				}
+			}
+		} catch (...) {
+			storeError = std::current_exception();
+		}
+		_decoded.close();
+		_raw.close();
+
+		fetcher.join();
+		decoder.join();
+
+		if (storeError)
+			std::rethrow_exception(storeError);
+		if (result && decodeError)
+			std::rethrow_exception(decodeError);
+		if (result && fetchError)
+			std::rethrow_exception(fetchError);
+		return result;
+	}
+
+	/**
+	 * @brief The default capacity of the queues between the stages
+	 */
+	static constexpr std::size_t DEFAULT_DEPTH = 2;
+
+private:
+	BoundedQueue<Raw> _raw;
+	BoundedQueue<Decoded> _decoded;
+};
+
+}
+
+#endif /* ARCHIVE_PIPELINE_H */
@@ -0,0 +1,194 @@
+/**
+ * @file async_archive_writer.cpp
+ * @brief Implementation of the AsyncArchiveWriter class
+ * @author Laurent Georget
+ * @date 2026-10-18
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/asio/post.hpp>
+#include <boost/asio/thread_pool.hpp>
+#include <systemd/sd-daemon.h>
+#include <cassandra.h>
+#include <cassobs/observation.h>
+#include <date/date.h>
+
+#include "storage/observations_storage.h"
+#include "async_archive_writer.h"
+#include "cassandra_utils.h"
+#include "monitoring/metrics.h"
+#include "monitoring/db_profiler.h"
+
+namespace meteodata
+{
+
+namespace chrono = std::chrono;
+namespace asio = boost::asio;
+
+namespace
+{
+asio::thread_pool& writersPool()
+{
+	static asio::thread_pool pool{AsyncArchiveWriter::WRITER_THREADS};
+	return pool;
+}
+}
+
+AsyncArchiveWriter::AsyncArchiveWriter(ObservationsStorage& db, const CassUuid& station, const char* caller,
+		std::string logPrefix, Progress onStored) :
+	_db{db, caller},
+	_station{station},
+	_caller{caller},
+	_logPrefix{std::move(logPrefix)},
+	_onStored{std::move(onStored)}
+{
+}
+
+AsyncArchiveWriter::~AsyncArchiveWriter()
+{
+	// wait for the pages already enqueued to be stored
+	std::unique_lock<std::mutex> lock{_mutex};
+	_closed = true;
+	_condition.wait(lock, [this]() { return !_scheduled; });
+}
+
+bool AsyncArchiveWriter::enqueue(std::vector<Observation>&& observations)
+{
+	if (_failed)
+		return false;
+
+	std::lock_guard<std::mutex> lock{_mutex};
+	if (_closed)
+		return false;
+	_pages.push_back(std::move(observations));
+	schedule();
+	return true;
+}
+
+void AsyncArchiveWriter::finish(Completion onFinished)
+{
+	std::lock_guard<std::mutex> lock{_mutex};
+	_onFinished = std::move(onFinished);
+	_closed = true;
+	schedule();
+}
+
+void AsyncArchiveWriter::schedule()
+{
+	// called with the mutex held, the write in progress, if any, will
+	// pick up what has just been handed over
+	if (_scheduled)
+		return;
+	_scheduled = true;
+	asio::post(writersPool(), [this]() { write(); });
+}
+
+void AsyncArchiveWriter::write()
+{
+	// the callbacks may end up querying the database too
+	DbProfiler::CallerScope callerScope{_caller};
+
+	std::unique_lock<std::mutex> lock{_mutex};
+	for (;;) {
+		if (!_pages.empty()) {
+			// take all the pages received while the previous write
+			// was ongoing and store them together
+			std::deque<std::vector<Observation>> pages;
+			std::swap(pages, _pages);
+			lock.unlock();
+
+			if (!_failed) {
+				std::vector<Observation> allObs;
+				for (auto&& page : pages)
+					std::move(page.begin(), page.end(), std::back_inserter(allObs));
+				if (!allObs.empty() && !store(allObs))
+					_failed = true;
+			}
+
+			lock.lock();
+		} else if (_closed && _onFinished) {
+			Completion onFinished = std::move(_onFinished);
+			_onFinished = nullptr;
+			lock.unlock();
+			onFinished(!_failed, _oldest, _newest);
+			lock.lock();
+		} else {
+			break;
+		}
+	}
+
+	// the writer may be destroyed as soon as the mutex is released
+	_scheduled = false;
+	_condition.notify_all();
+}
+
+bool AsyncArchiveWriter::store(const std::vector<Observation>& observations)
+{
+	static Histogram& duration = MetricsRegistry::instance().histogram("meteodata_archive_write_duration_seconds",
+		"Time taken by the bulk writes of archive records in the database");
+	static Counter& records = MetricsRegistry::instance().counter("meteodata_archive_records_written_total",
+		"Number of archive records written in the database");
+	static Counter& failures = MetricsRegistry::instance().counter("meteodata_archive_write_failures_total",
+		"Number of bulk writes of archive records in the database that have failed");
+
+	bool ret = true;
+	{
+		Histogram::ScopedTimer timer{duration};
+		for (auto it = observations.begin() ; it != observations.end() && ret ; ++it)
+			ret = _db.insertV2DataPoint(*it);
+		ret = ret && _db.insertV2DataPointsInTimescaleDB(observations.begin(), observations.end());
+	}
+	if (!ret) {
+		failures.increment();
+		std::cerr << SD_ERR << "[" << _logPrefix << " " << _station << "] measurement: "
+			  << "Failed to store " << observations.size() << " archive records" << std::endl;
+		return false;
+	}
+
+	auto [oldestIt, newestIt] = std::minmax_element(observations.begin(), observations.end(),
+		[](const Observation& o1, const Observation& o2) { return o1.time < o2.time; });
+	date::sys_seconds oldest = date::floor<chrono::seconds>(oldestIt->time);
+	date::sys_seconds newest = date::floor<chrono::seconds>(newestIt->time);
+
+	_oldest = std::min(_oldest, oldest);
+	if (newest > _newest) {
+		_newest = newest;
+		if (!_db.updateLastArchiveDownloadTime(_station, chrono::system_clock::to_time_t(_newest))) {
+			// the data is there, the next download will only
+			// fetch it once more
+			std::cerr << SD_ERR << "[" << _logPrefix << " " << _station << "] management: "
+				  << "Couldn't update last archive download time" << std::endl;
+		}
+	}
+
+	records.increment(observations.size());
+	if (_onStored)
+		_onStored(oldest, newest);
+	return true;
+}
+
+}
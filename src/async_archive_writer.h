@@ -0,0 +1,178 @@
+/**
+ * @file async_archive_writer.h
+ * @brief Definition of the AsyncArchiveWriter class
+ * @author Laurent Georget
+ * @date 2026-10-18
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ASYNC_ARCHIVE_WRITER_H
+#define ASYNC_ARCHIVE_WRITER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <cassandra.h>
+#include <cassobs/observation.h>
+#include <date/date.h>
+
+#include "storage/observations_storage.h"
+#include "monitoring/profiled_db_connection.h"
+
+namespace meteodata
+{
+
+/**
+ * @brief The background storage of the archive pages downloaded from a
+ * station
+ *
+ * Connectors talking to a station over a serial-like link can acknowledge
+ * each archive page as soon as it has been received correctly and hand it
+ * over to the writer, instead of leaving the link idle while the page is
+ * being inserted in the database. The writer stores the pages in the order
+ * they have been enqueued, grouping all the pages queued since its last write
+ * into one bulk write. The last archive download time of the station is
+ * updated after each successful write only, so it never gets past data not
+ * yet in the database.
+ *
+ * The writes are run on a small pool of threads shared by all the writers, a
+ * writer having at most one write in progress at a time, so that thousands of
+ * stations downloading their archive at once do not need as many threads.
+ *
+ * After the first failure, the writer discards everything it is given, so
+ * that the next download restarts from the last page actually stored.
+ */
+class AsyncArchiveWriter
+{
+public:
+	/**
+	 * @brief Called from a thread of the writers pool after each
+	 * successful write
+	 *
+	 * The parameters are the timestamps of the oldest and newest
+	 * observations just stored.
+	 */
+	using Progress = std::function<void(const date::sys_seconds&, const date::sys_seconds&)>;
+	/**
+	 * @brief Called from a thread of the writers pool once all the pages
+	 * have been processed
+	 *
+	 * The first parameter is true if, and only if, all the pages have been
+	 * stored, the other two are the timestamps of the oldest and newest
+	 * observations stored overall (the oldest is after the newest if
+	 * nothing has been stored).
+	 */
+	using Completion = std::function<void(bool, const date::sys_seconds&, const date::sys_seconds&)>;
+
+	/**
+	 * @brief The number of threads running the writes of all the writers
+	 */
+	static constexpr int WRITER_THREADS = 4;
+
+	/**
+	 * @brief Construct the writer
+	 *
+	 * @param db The database to store the observations into
+	 * @param station The station the observations come from
+	 * @param caller The component the database calls are attributed to,
+	 * it must be a string literal
+	 * @param logPrefix The tag of the owner's log messages, the station is
+	 * appended to it
+	 * @param onStored The callback to call after each successful write
+	 */
+	AsyncArchiveWriter(ObservationsStorage& db, const CassUuid& station, const char* caller,
+		std::string logPrefix, Progress onStored = nullptr);
+
+	/**
+	 * @brief Stop the writer and wait for the pages already enqueued to
+	 * be stored
+	 */
+	~AsyncArchiveWriter();
+
+	AsyncArchiveWriter(const AsyncArchiveWriter&) = delete;
+	AsyncArchiveWriter& operator=(const AsyncArchiveWriter&) = delete;
+
+	/**
+	 * @brief Hand a decoded page over to the writer, without waiting
+	 *
+	 * @param observations The observations in the page
+	 * @return False if a previous write has failed, in which case the page
+	 * is dropped, true otherwise
+	 */
+	bool enqueue(std::vector<Observation>&& observations);
+
+	/**
+	 * @brief Tell whether a write has failed
+	 *
+	 * @return True if, and only if, a page could not be stored
+	 */
+	bool failed() const
+	{
+		return _failed;
+	}
+
+	/**
+	 * @brief Signal that no more page will be enqueued
+	 *
+	 * @param onFinished The callback to call once all the pages enqueued so
+	 * far have been processed
+	 */
+	void finish(Completion onFinished);
+
+private:
+	ProfiledDbConnection _db;
+	CassUuid _station;
+	const char* _caller;
+	std::string _logPrefix;
+	Progress _onStored;
+	Completion _onFinished;
+
+	std::deque<std::vector<Observation>> _pages;
+	bool _closed = false;
+	std::atomic<bool> _failed{false};
+	std::mutex _mutex;
+	std::condition_variable _condition;
+
+	/**
+	 * @brief The timestamp of the oldest observation stored so far
+	 */
+	date::sys_seconds _oldest = date::sys_seconds::max();
+	/**
+	 * @brief The timestamp of the newest observation stored so far, the
+	 * last archive download time is never moved backwards
+	 */
+	date::sys_seconds _newest{};
+
+	/**
+	 * @brief Whether a write is scheduled or in progress on the pool
+	 */
+	bool _scheduled = false;
+
+	void schedule();
+	void write();
+	bool store(const std::vector<Observation>& observations);
+};
+
+}
+
+#endif /* ASYNC_ARCHIVE_WRITER_H */
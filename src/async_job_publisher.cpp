@@ -22,7 +22,9 @@
  */
 
 #include <map>
+#include <memory>
 #include <mutex>
+#include <utility>
 #include <iostream>
 
 #include <systemd/sd-daemon.h>
@@ -39,15 +41,14 @@ namespace sys = boost::system;
 
 using namespace std::chrono_literals;
 
-AsyncJobPublisher::AsyncJobPublisher(boost::asio::io_context& ioContext,
-	const std::string& dbAddr, const std::string& dbUsername, const std::string& dbPassword, const std::string& dbName) :
+AsyncJobPublisher::AsyncJobPublisher(boost::asio::io_context& ioContext, std::unique_ptr<JobsStorage> dbJobs) :
 		_io{ioContext},
-		_dbJobs{dbAddr, dbUsername, dbPassword, dbName}
+		_dbJobs{std::move(dbJobs)}
 {}
 
 void AsyncJobPublisher::publishJobsForPastDataInsertion(const CassUuid& station, const date::sys_seconds& begin, const date::sys_seconds& end)
 {
-	date::sys_days today = date::floor<date::days>(chrono::system_clock::now());
+	date::sys_days today = date::floor<date::days>(SystemClock::now());
 	if (begin > end || date::floor<date::days>(begin) >= today)
 		return; // ignore if it's not in the past enough
 
@@ -61,7 +62,7 @@ void AsyncJobPublisher::publishJobsForPastDataInsertion(const CassUuid& station,
 	} else {
 		date::sys_seconds& b = std::get<0>(it->second);
 		date::sys_seconds& e = std::get<1>(it->second);
-		asio::basic_waitable_timer<chrono::system_clock>& timer = std::get<2>(it->second);
+		Timer& timer = std::get<2>(it->second);
 		timer.cancel();
 		if (begin < b) {
 			b = begin;
@@ -82,11 +83,11 @@ void AsyncJobPublisher::doPublish(const CassUuid& station)
 		std::get<2>(it->second).cancel();
 		/* Ultimately, if the starting date is not in the past enough, just
 		 * ignore the job */
-		if (date::floor<date::days>(std::get<0>(it->second)) < date::floor<date::days>(chrono::system_clock::now())) {
+		if (date::floor<date::days>(std::get<0>(it->second)) < date::floor<date::days>(SystemClock::now())) {
 			time_t b = std::get<0>(it->second).time_since_epoch().count();
 			time_t e = std::get<1>(it->second).time_since_epoch().count();
-			_dbJobs.publishMinmax(station, b, e);
-			_dbJobs.publishAnomalyMonitoring(station, b, e);
+			_dbJobs->publishMinmax(station, b, e);
+			_dbJobs->publishAnomalyMonitoring(station, b, e);
 		}
 		_debouncing.erase(it);
 	}
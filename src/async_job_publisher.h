@@ -27,33 +27,34 @@
 #include <map>
 #include <tuple>
 #include <chrono>
+#include <memory>
 #include <mutex>
 
 #include <boost/asio/io_context.hpp>
 #include <boost/asio/basic_waitable_timer.hpp>
-#include <cassobs/dbconnection_jobs.h>
 #include <date/date.h>
 #include <cassandra.h>
 
+#include "storage/jobs_storage.h"
+#include "simulated_clock.h"
+
 namespace meteodata
 {
 
 class AsyncJobPublisher
 {
 public:
-	AsyncJobPublisher(boost::asio::io_context& ioContext,
-		 const std::string& dbAddr, const std::string& dbUsername,
-		 const std::string& dbPassword, const std::string& dbName);
+	AsyncJobPublisher(boost::asio::io_context& ioContext, std::unique_ptr<JobsStorage> dbJobs);
 
 	void publishJobsForPastDataInsertion(const CassUuid& station,
 		const date::sys_seconds& begin, const date::sys_seconds& end);
 
 private:
-	using Timer = boost::asio::basic_waitable_timer<std::chrono::system_clock>;
+	using Timer = SystemTimer;
 
 	boost::asio::io_context& _io;
 
-	DbConnectionJobs _dbJobs;
+	std::unique_ptr<JobsStorage> _dbJobs;
 
 	std::map<CassUuid, std::tuple<date::sys_seconds, date::sys_seconds, Timer>> _debouncing;
 
@@ -45,7 +45,7 @@ namespace json = boost::json;
 
 const std::string BaraniAnemometer2023Message::BARANI_LAST_BATTERY = "meteowind_battery";
 
-BaraniAnemometer2023Message::BaraniAnemometer2023Message(DbConnectionObservations& db):
+BaraniAnemometer2023Message::BaraniAnemometer2023Message(ObservationsStorage& db):
 	LiveobjectsMessage{},
 	_db{db}
 {}
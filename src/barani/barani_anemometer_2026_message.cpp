@@ -56,7 +56,7 @@ namespace json = boost::json;
 
 const std::string BaraniAnemometer2026Message::BARANI_LAST_BATTERY = "meteowind_battery";
 
-BaraniAnemometer2026Message::BaraniAnemometer2026Message(DbConnectionObservations& db):
+BaraniAnemometer2026Message::BaraniAnemometer2026Message(ObservationsStorage& db):
 	LiveobjectsMessage{},
 	_db{db}
 {}
@@ -33,11 +33,12 @@
 
 #include <boost/json.hpp>
 #include <date/date.h>
-#include <cassobs/dbconnection_observations.h>
 #include <cassobs/observation.h>
 #include <cassandra.h>
 
+#include "storage/observations_storage.h"
 #include "liveobjects/liveobjects_message.h"
+#include "monitoring/profiled_db_connection.h"
 
 namespace meteodata
 {
@@ -49,7 +50,7 @@ namespace meteodata
 class BaraniAnemometer2026Message : public LiveobjectsMessage
 {
 public:
-	BaraniAnemometer2026Message(DbConnectionObservations& db);
+	BaraniAnemometer2026Message(ObservationsStorage& db);
 
 	Observation getObservation(const CassUuid& station) const override;
 
@@ -69,7 +70,7 @@ public:
 	boost::json::object getDecodedMessage() const override;
 
 private:
-	DbConnectionObservations& _db;
+	ProfiledDbConnection _db;
 
 	/**
 	 * @brief A struct used to store observation values to then populate the
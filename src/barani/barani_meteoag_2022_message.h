@@ -29,10 +29,11 @@
 #include <boost/json.hpp>
 #include <date/date.h>
 #include <cassobs/observation.h>
-#include <cassobs/dbconnection_observations.h>
 #include <cassandra.h>
 
+#include "storage/observations_storage.h"
 #include "liveobjects/liveobjects_message.h"
+#include "monitoring/profiled_db_connection.h"
 
 namespace meteodata
 {
@@ -44,7 +45,7 @@ namespace meteodata
 class BaraniMeteoAg2022Message : public LiveobjectsMessage
 {
 public:
-	explicit BaraniMeteoAg2022Message(DbConnectionObservations& db);
+	explicit BaraniMeteoAg2022Message(ObservationsStorage& db);
 
 	Observation getObservation(const CassUuid& station) const override;
 
@@ -68,7 +69,7 @@ public:
 	boost::json::object getDecodedMessage() const override;
 
 private:
-	DbConnectionObservations& _db;
+	ProfiledDbConnection _db;
 
 	/**
 	 * @brief A struct used to store observation values to then populate the
@@ -27,10 +27,10 @@
 #include <cmath>
 
 #include <cassandra.h>
-#include <cassobs/dbconnection_observations.h>
 #include <cassobs/observation.h>
 #include <systemd/sd-daemon.h>
 
+#include "storage/observations_storage.h"
 #include "barani_rain_gauge_message.h"
 #include "cassandra_utils.h"
 #include "hex_parser.h"
@@ -41,7 +41,7 @@ namespace meteodata
 namespace chrono = std::chrono;
 namespace json = boost::json;
 
-BaraniRainGaugeMessage::BaraniRainGaugeMessage(DbConnectionObservations& db):
+BaraniRainGaugeMessage::BaraniRainGaugeMessage(ObservationsStorage& db):
 	_db{db}
 {}
 
@@ -28,10 +28,10 @@
 
 #include <boost/json.hpp>
 #include <cassandra.h>
-#include <cassobs/dbconnection_observations.h>
 #include <cassobs/observation.h>
 #include <systemd/sd-daemon.h>
 
+#include "storage/observations_storage.h"
 #include "barani/barani_thermohygro_2026_message.h"
 #include "davis/vantagepro2_message.h"
 #include "cassandra_utils.h"
@@ -45,7 +45,7 @@ namespace json = boost::json;
 
 const std::string BaraniThermohygro2026Message::BARANI_LAST_BATTERY = "meteohelix_battery";
 
-BaraniThermohygro2026Message::BaraniThermohygro2026Message(DbConnectionObservations& db):
+BaraniThermohygro2026Message::BaraniThermohygro2026Message(ObservationsStorage& db):
 	_db{db}
 {}
 
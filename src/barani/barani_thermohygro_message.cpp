@@ -27,10 +27,10 @@
 #include <cmath>
 
 #include <cassandra.h>
-#include <cassobs/dbconnection_observations.h>
 #include <cassobs/observation.h>
 #include <systemd/sd-daemon.h>
 
+#include "storage/observations_storage.h"
 #include "barani/barani_thermohygro_message.h"
 #include "davis/vantagepro2_message.h"
 #include "cassandra_utils.h"
@@ -42,7 +42,7 @@ namespace meteodata
 namespace chrono = std::chrono;
 namespace json = boost::json;
 
-BaraniThermohygroMessage::BaraniThermohygroMessage(DbConnectionObservations& db):
+BaraniThermohygroMessage::BaraniThermohygroMessage(ObservationsStorage& db):
 	_db{db}
 {}
 
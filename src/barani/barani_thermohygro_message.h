@@ -34,10 +34,11 @@
 #include <boost/json.hpp>
 #include <date/date.h>
 #include <cassobs/observation.h>
-#include <cassobs/dbconnection_observations.h>
 #include <cassandra.h>
 
+#include "storage/observations_storage.h"
 #include "liveobjects/liveobjects_message.h"
+#include "monitoring/profiled_db_connection.h"
 
 namespace meteodata
 {
@@ -49,7 +50,7 @@ namespace meteodata
 class BaraniThermohygroMessage : public LiveobjectsMessage
 {
 public:
-	explicit BaraniThermohygroMessage(DbConnectionObservations& db);
+	explicit BaraniThermohygroMessage(ObservationsStorage& db);
 
 	Observation getObservation(const CassUuid& station) const override;
 
@@ -82,7 +83,7 @@ public:
 	boost::json::object getDecodedMessage() const override;
 
 private:
-	DbConnectionObservations& _db;
+	ProfiledDbConnection _db;
 
 	/**
 	 * @brief A struct used to store observation values to then populate the
@@ -0,0 +1,878 @@
+/**
+ * @file decoder_benchmark.cpp
+ * @brief Measure the throughput and the allocations of all the message decoders
+ * @author Laurent Georget
+ * @date 2026-10-18
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <new>
+#include <random>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <boost/asio.hpp>
+#include <boost/program_options.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include <cassandra.h>
+#include <date/date.h>
+
+#include "davis/vantagepro2_message.h"
+#include "davis/vantagepro2_archive_message.h"
+#include "davis/vantagepro2_archive_page.h"
+#include "davis/vantagepro2_loop_message.h"
+#include "davis/weatherlink_apiv2_archive_page.h"
+#include "liveobjects/liveobjects_message.h"
+#include "dragino/thwnbiot_message.h"
+#include "dragino/thplnbiot_message.h"
+#include "mbdata/mbdata_messages/mbdata_message_factory.h"
+#include "static/static_message.h"
+#include "meteo_france/mf_radome_message.h"
+#include "pessl/fieldclimate_archive_message_collection.h"
+#include "synop/synop_decoder/parser.h"
+#include "storage/in_memory_observations_storage.h"
+#include "time_offseter.h"
+#include "config.h"
+
+namespace po = boost::program_options;
+namespace asio = boost::asio;
+namespace pt = boost::property_tree;
+namespace chrono = std::chrono;
+
+using namespace meteodata;
+
+namespace
+{
+std::atomic<std::size_t> allocations{0};
+}
+
+/* Count all the allocations made by the program to spot regressions in the
+ * decoders */
+void* operator new(std::size_t size)
+{
+	allocations++;
+	void* p = std::malloc(size ? size : 1);
+	if (!p)
+		throw std::bad_alloc{};
+	return p;
+}
+
+void operator delete(void* p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+	std::free(p);
+}
+
+namespace
+{
+
+/**
+ * @brief A benchmark of one decoder over its corpus
+ */
+struct DecoderBenchmark
+{
+	/**
+	 * @brief The name of the benchmark, used to select it on the command line
+	 */
+	std::string name;
+	/**
+	 * @brief What one element of the corpus is (a message, a page, a line...)
+	 */
+	std::string unit;
+	/**
+	 * @brief The number of elements in the corpus
+	 */
+	std::size_t corpusSize;
+	/**
+	 * @brief Decode the whole corpus once
+	 *
+	 * The function returns the number of elements the decoder deemed
+	 * valid, to make sure the corpus exercises the complete decoding path
+	 * and not only the early rejections.
+	 */
+	std::function<std::size_t()> decodeCorpus;
+};
+
+/**
+ * @brief A stream buffer discarding everything written to it, used to keep
+ * the decoders logging (the formatting of the log lines is part of their
+ * cost) without flooding the terminal
+ */
+class NullBuffer : public std::streambuf
+{
+protected:
+	int overflow(int c) override
+	{
+		return c;
+	}
+
+	std::streamsize xsputn(const char*, std::streamsize n) override
+	{
+		return n;
+	}
+};
+
+/**
+ * @brief The context shared by all the benchmarks
+ */
+struct Context
+{
+	ObservationsStorage& db;
+	CassUuid station;
+	date::sys_seconds now;
+	std::minstd_rand rng;
+	std::size_t corpusSize;
+};
+
+int randomInt(std::minstd_rand& rng, int min, int max)
+{
+	return std::uniform_int_distribution<int>{min, max}(rng);
+}
+
+float randomFloat(std::minstd_rand& rng, float min, float max)
+{
+	// keep one decimal, like the stations do
+	return std::round(std::uniform_real_distribution<float>{min, max}(rng) * 10.f) / 10.f;
+}
+
+std::string randomHex(std::minstd_rand& rng, std::size_t length)
+{
+	static constexpr char DIGITS[] = "0123456789abcdef";
+	std::string s(length, '0');
+	for (char& c : s)
+		c = DIGITS[randomInt(rng, 0, 15)];
+	return s;
+}
+
+std::string hex(unsigned int value, int digits)
+{
+	std::ostringstream os;
+	os << std::hex << std::setfill('0') << std::setw(digits) << value;
+	return os.str();
+}
+
+void put16(std::uint8_t* buffer, std::size_t offset, std::uint16_t value)
+{
+	buffer[offset] = value & 0xFF;
+	buffer[offset + 1] = value >> 8;
+}
+
+std::vector<DecoderBenchmark> makeDavisBenchmarks(Context& ctx)
+{
+	std::vector<DecoderBenchmark> benchmarks;
+
+	// VantagePro2 archive pages, as received from the console after a DMPAFT
+	// command: five consecutive records from yesterday
+	std::size_t pageSize;
+	{
+		VantagePro2ArchivePage page;
+		pageSize = asio::buffer_size(page.getBuffer()[0]);
+	}
+	date::sys_days yesterday = date::floor<date::days>(ctx.now) - date::days{1};
+	date::year_month_day ymd{yesterday};
+	std::vector<std::vector<std::uint8_t>> pages;
+	for (std::size_t i = 0 ; i < ctx.corpusSize ; i++) {
+		std::vector<std::uint8_t> raw(pageSize, 0);
+		raw[0] = i % 5;
+		for (int j = 0 ; j < 5 ; j++) {
+			VantagePro2ArchiveMessage::ArchiveDataPoint point;
+			std::memset(&point, 0xFF, sizeof(point));
+			point.day = unsigned(ymd.day());
+			point.month = unsigned(ymd.month());
+			point.year = int(ymd.year()) - 2000;
+			int minutes = ((i * 5 + j) * 10) % (24 * 60);
+			point.time = (minutes / 60) * 100 + minutes % 60;
+			point.outsideTemp = randomInt(ctx.rng, 300, 900);
+			point.maxOutsideTemp = point.outsideTemp + randomInt(ctx.rng, 0, 10);
+			point.minOutsideTemp = point.outsideTemp - randomInt(ctx.rng, 0, 10);
+			point.rainfall = randomInt(ctx.rng, 0, 3);
+			point.maxRainRate = randomInt(ctx.rng, 0, 200);
+			point.barometer = randomInt(ctx.rng, 29500, 30500);
+			point.solarRad = randomInt(ctx.rng, 0, 900);
+			point.nbWindSamples = randomInt(ctx.rng, 200, 236);
+			point.insideTemp = randomInt(ctx.rng, 600, 750);
+			point.insideHum = randomInt(ctx.rng, 30, 60);
+			point.outsideHum = randomInt(ctx.rng, 40, 100);
+			point.avgWindSpeed = randomInt(ctx.rng, 0, 30);
+			point.maxWindSpeed = point.avgWindSpeed + randomInt(ctx.rng, 0, 20);
+			point.maxWindSpeedDir = randomInt(ctx.rng, 0, 15);
+			point.prevailingWindDir = randomInt(ctx.rng, 0, 15);
+			point.uv = randomInt(ctx.rng, 0, 80);
+			point.et = randomInt(ctx.rng, 0, 5);
+			point.maxSolarRad = point.solarRad + randomInt(ctx.rng, 0, 100);
+			point.maxUV = point.uv;
+			point.forecast = 8;
+			point.recordType = 0;
+			std::memcpy(raw.data() + 1 + j * sizeof(point), &point, sizeof(point));
+		}
+		VantagePro2Message::computeCRC(raw.data(), raw.size());
+		pages.push_back(std::move(raw));
+	}
+	benchmarks.push_back({"vantagepro2-archive", "page", pages.size(),
+		[&ctx, pages = std::move(pages), beginning = date::sys_seconds{yesterday} - date::days{1}]() {
+			static const TimeOffseter timeOffseter =
+				TimeOffseter::getTimeOffseterFor(TimeOffseter::PredefinedTimezone::UTC);
+			std::size_t valid = 0;
+			for (const auto& raw : pages) {
+				VantagePro2ArchivePage page;
+				std::memcpy(page.getBuffer()[0].data(), raw.data(), raw.size());
+				page.prepare(beginning, &timeOffseter);
+				if (page.isValid() && !page.decode(ctx.station).empty())
+					valid++;
+			}
+			return valid;
+		}
+	});
+
+	// VantagePro2 LOOP and LOOP2 packets, as received from the console
+	// after a "LPS 3 2" command
+	std::size_t loop1Size, loop2Size;
+	{
+		VantagePro2LoopMessage message{nullptr};
+		loop1Size = asio::buffer_size(message.getBuffer()[0]);
+		loop2Size = asio::buffer_size(message.getBuffer()[1]);
+	}
+	std::vector<std::pair<std::vector<std::uint8_t>, std::vector<std::uint8_t>>> loops;
+	for (std::size_t i = 0 ; i < ctx.corpusSize ; i++) {
+		std::vector<std::uint8_t> l1(loop1Size, 0);
+		std::vector<std::uint8_t> l2(loop2Size, 0);
+		std::uint16_t barometer = randomInt(ctx.rng, 29500, 30500);
+		std::uint16_t outsideTemp = randomInt(ctx.rng, 300, 900);
+		std::uint8_t outsideHum = randomInt(ctx.rng, 40, 100);
+		std::uint8_t windSpeed = randomInt(ctx.rng, 0, 30);
+		std::uint16_t windDir = randomInt(ctx.rng, 1, 360);
+		for (auto* l : {&l1, &l2}) {
+			std::memcpy(l->data(), "LOO", 3);
+			put16(l->data(), 7, barometer);
+			put16(l->data(), 9, randomInt(ctx.rng, 600, 750));
+			(*l)[11] = randomInt(ctx.rng, 30, 60);
+			put16(l->data(), 12, outsideTemp);
+			(*l)[14] = windSpeed;
+			put16(l->data(), 16, windDir);
+			(*l)[33] = outsideHum;
+			put16(l->data(), 41, randomInt(ctx.rng, 0, 200));
+			(*l)[43] = randomInt(ctx.rng, 0, 80);
+			put16(l->data(), 44, randomInt(ctx.rng, 0, 900));
+			put16(l->data(), 50, randomInt(ctx.rng, 0, 100));
+			(*l)[95] = '\n';
+			(*l)[96] = '\r';
+		}
+		l1[4] = 0;
+		l2[4] = 1;
+		// the extra sensors are not connected
+		std::memset(l1.data() + 18, 0xFF, 15);
+		std::memset(l1.data() + 34, 0xFF, 7);
+		std::memset(l1.data() + 62, 0xFF, 8);
+		put16(l2.data(), 30, outsideTemp / 10 - 5);
+		put16(l2.data(), 35, outsideTemp / 10);
+		put16(l2.data(), 37, outsideTemp / 10);
+		put16(l2.data(), 39, outsideTemp / 10);
+		VantagePro2Message::computeCRC(l1.data(), l1.size());
+		VantagePro2Message::computeCRC(l2.data(), l2.size());
+		loops.emplace_back(std::move(l1), std::move(l2));
+	}
+	benchmarks.push_back({"vantagepro2-loop", "message", loops.size(),
+		[&ctx, loops = std::move(loops)]() {
+			static const TimeOffseter timeOffseter =
+				TimeOffseter::getTimeOffseterFor(TimeOffseter::PredefinedTimezone::UTC);
+			std::size_t valid = 0;
+			for (const auto& [l1, l2] : loops) {
+				VantagePro2LoopMessage message{&timeOffseter};
+				auto& buffers = message.getBuffer();
+				std::memcpy(buffers[0].data(), l1.data(), l1.size());
+				std::memcpy(buffers[1].data(), l2.data(), l2.size());
+				if (message.looksValid()) {
+					message.getObservation(ctx.station, ctx.now);
+					valid++;
+				}
+			}
+			return valid;
+		}
+	});
+
+	// WeatherLink v2 API archive pages, for a WeatherLink Live with an ISS
+	// and a barometer: one page per hour, with a record every ten minutes
+	std::vector<std::string> wlPages;
+	for (std::size_t i = 0 ; i < ctx.corpusSize ; i++) {
+		auto hour = chrono::system_clock::to_time_t(date::sys_seconds{yesterday}) + (i % 24) * 3600;
+		std::ostringstream iss;
+		std::ostringstream bar;
+		for (int j = 0 ; j < 6 ; j++) {
+			if (j > 0) {
+				iss << ",";
+				bar << ",";
+			}
+			auto ts = hour + (j + 1) * 600;
+			float temp = randomFloat(ctx.rng, 30.f, 90.f);
+			iss << R"({"ts":)" << ts
+			    << R"(,"arch_int":600,"temp_last":)" << temp
+			    << R"(,"temp_hi":)" << temp + 0.5f
+			    << R"(,"temp_lo":)" << temp - 0.5f
+			    << R"(,"hum_last":)" << randomInt(ctx.rng, 40, 100)
+			    << R"(,"dew_point_last":)" << temp - 5.f
+			    << R"(,"wind_speed_avg":)" << randomFloat(ctx.rng, 0.f, 20.f)
+			    << R"(,"wind_speed_hi":)" << randomFloat(ctx.rng, 20.f, 40.f)
+			    << R"(,"wind_dir_of_prevail":)" << randomInt(ctx.rng, 1, 360)
+			    << R"(,"rainfall_clicks":)" << randomInt(ctx.rng, 0, 3)
+			    << R"(,"rain_rate_hi_clicks":)" << randomInt(ctx.rng, 0, 100)
+			    << R"(,"solar_rad_avg":)" << randomInt(ctx.rng, 0, 900)
+			    << R"(,"uv_index_avg":)" << randomFloat(ctx.rng, 0.f, 8.f)
+			    << R"(,"trans_battery":3.1,"supercap_volt_last":2.9,"solar_volt_last":4.2})";
+			bar << R"({"ts":)" << ts
+			    << R"(,"arch_int":600,"bar_sea_level":)" << randomFloat(ctx.rng, 29.5f, 30.5f)
+			    << R"(,"bar_absolute":)" << randomFloat(ctx.rng, 29.5f, 30.5f) << "}";
+		}
+		wlPages.push_back(
+			R"({"station_id":123456,"sensors":[)"
+			R"({"lsid":654321,"sensor_type":43,"data_structure_type":11,"data":[)" + iss.str() + "]},"
+			R"({"lsid":654322,"sensor_type":242,"data_structure_type":13,"data":[)" + bar.str() + "]}"
+			R"(],"generated_at":)" + std::to_string(hour + 3600) + "}"
+		);
+	}
+	benchmarks.push_back({"weatherlink-apiv2-archive", "page", wlPages.size(),
+		[&ctx, wlPages = std::move(wlPages), lastArchive = date::sys_seconds{yesterday}]() {
+			static const TimeOffseter timeOffseter =
+				TimeOffseter::getTimeOffseterFor(TimeOffseter::PredefinedTimezone::UTC);
+			std::size_t valid = 0;
+			for (const std::string& p : wlPages) {
+				WeatherlinkApiv2ArchivePage page{lastArchive, &timeOffseter};
+				std::istringstream is{p};
+				page.parse(is);
+				bool empty = true;
+				for (const auto& m : page) {
+					m.getObservation(ctx.station);
+					empty = false;
+				}
+				if (!empty)
+					valid++;
+			}
+			return valid;
+		}
+	});
+
+	return benchmarks;
+}
+
+std::vector<DecoderBenchmark> makeLoraBenchmarks(Context& ctx)
+{
+	std::vector<DecoderBenchmark> benchmarks;
+
+	struct Sensor
+	{
+		std::string sensor;
+		int port;
+		std::vector<std::size_t> lengths;
+		std::string sample;
+	};
+
+	// The payloads of the sensors are bit fields, all the values are
+	// decoded whatever the bits, so random payloads of the right size
+	// make the decoders go through their whole decoding path; a real
+	// payload is added when one is known
+	const Sensor sensors[] = {
+		{"dragino-cpl01-pluviometer",  2, {22},         ""},
+		{"dragino-lsn50v2",            2, {22},         "0cf70000010900010c0197"},
+		{"dragino-thpllora",           2, {24, 32, 34}, ""},
+		{"dragino-thwlora",            2, {24},         ""},
+		{"dragino-llms01",             2, {22},         ""},
+		{"dragino-lse01",              2, {22},         ""},
+		{"dragino-probe6470",          2, {22},         ""},
+		{"dragino-d2x",                2, {22},         ""},
+		{"dragino-sn50v3-probe6470",   2, {22},         ""},
+		{"barani-meteowind",           1, {20},         "c582a1087050904b3114"},
+		{"barani-meteowind-v2023",     1, {24},         "068088781c00101d380f5101"},
+		{"barani-meteowind-v2026",     1, {28},         ""},
+		{"barani-meteorain",           1, {12},         ""},
+		{"barani-meteohelix",          1, {22},         ""},
+		{"barani-meteohelix-v2026",    1, {32},         ""},
+		{"barani-meteoag-2022",        1, {26},         ""},
+		{"lorain-pluviometer",         2, {94},         ""},
+		{"thlora-thermohygrometer",    2, {18},         ""},
+		{"talkpool-oy1110",            2, {6, 26},      "3e441d"},
+		{"oseren-soil-station",        2, {84},         ""},
+	};
+
+	for (const Sensor& s : sensors) {
+		std::vector<std::string> payloads;
+		if (!s.sample.empty())
+			payloads.push_back(s.sample);
+		while (payloads.size() < ctx.corpusSize)
+			payloads.push_back(randomHex(ctx.rng, s.lengths[payloads.size() % s.lengths.size()]));
+
+		benchmarks.push_back({s.sensor, "message", payloads.size(),
+			[&ctx, sensor = s.sensor, port = s.port, payloads = std::move(payloads)]() {
+				std::size_t valid = 0;
+				for (const std::string& payload : payloads) {
+					auto m = LiveobjectsMessage::instantiateMessage(ctx.db, sensor, port, ctx.station);
+					m->ingest(ctx.station, payload, ctx.now);
+					if (m->looksValid()) {
+						m->getObservation(ctx.station);
+						valid++;
+					}
+				}
+				return valid;
+			}
+		});
+	}
+
+	// NB-IoT payloads: a header, six data points after the skipped one,
+	// and the HMAC (not checked by the decoders)
+	auto nbiotPayload = [&ctx](bool withPressure) {
+		std::string payload = randomHex(ctx.rng, 16) + "0001" + hex(randomInt(ctx.rng, 3000, 3600), 4) + hex(randomInt(ctx.rng, 10, 31), 2) + "01";
+		auto timestamp = chrono::system_clock::to_time_t(ctx.now) - 7 * 600;
+		for (int i = 0 ; i < 7 ; i++) {
+			payload += hex(randomInt(ctx.rng, 0, 300), 4)
+				+ hex(randomInt(ctx.rng, 400, 1000), 4)
+				+ (withPressure ? hex(randomInt(ctx.rng, 9800, 10300), 4) : hex(randomInt(ctx.rng, 0, 500), 4))
+				+ hex(randomInt(ctx.rng, 0, 60), 2)
+				+ hex(randomInt(ctx.rng, 0, 10), 2)
+				+ hex(randomInt(ctx.rng, 0, 359), 4)
+				+ hex(timestamp + i * 600, 8);
+		}
+		return payload + randomHex(ctx.rng, 64);
+	};
+	std::vector<std::string> thwPayloads, thplPayloads;
+	for (std::size_t i = 0 ; i < ctx.corpusSize ; i++) {
+		thwPayloads.push_back(nbiotPayload(false));
+		thplPayloads.push_back(nbiotPayload(true));
+	}
+	benchmarks.push_back({"dragino-thwnbiot", "message", thwPayloads.size(),
+		[&ctx, payloads = std::move(thwPayloads)]() {
+			std::size_t valid = 0;
+			for (const std::string& payload : payloads) {
+				ThwnbiotMessage m{ctx.db};
+				m.ingest(ctx.station, payload);
+				if (!m.getObservations(ctx.station).empty())
+					valid++;
+			}
+			return valid;
+		}
+	});
+	benchmarks.push_back({"dragino-thplnbiot", "message", thplPayloads.size(),
+		[&ctx, payloads = std::move(thplPayloads)]() {
+			std::size_t valid = 0;
+			for (const std::string& payload : payloads) {
+				ThplnbiotMessage m{ctx.db};
+				m.ingest(ctx.station, payload);
+				if (!m.getObservations(ctx.station).empty())
+					valid++;
+			}
+			return valid;
+		}
+	});
+
+	return benchmarks;
+}
+
+std::vector<DecoderBenchmark> makeTextBenchmarks(Context& ctx)
+{
+	std::vector<DecoderBenchmark> benchmarks;
+
+	date::sys_seconds recent = date::floor<chrono::minutes>(ctx.now) - chrono::minutes{30};
+
+	// MBData text files, in the flavours produced by the various weather
+	// station software
+	auto mbdataFields = [&ctx](bool withPressureVariation) {
+		std::ostringstream os;
+		float temp = randomFloat(ctx.rng, -5.f, 35.f);
+		os << temp << "|" << randomInt(ctx.rng, 20, 100) << "|" << temp - 4.f << "|"
+		   << randomFloat(ctx.rng, 990.f, 1035.f) << "|"
+		   << (withPressureVariation ? std::to_string(randomInt(ctx.rng, -3, 3)) : "") << "|"
+		   << randomFloat(ctx.rng, 0.f, 20.f) << "|" << randomFloat(ctx.rng, 0.f, 40.f) << "|"
+		   << randomInt(ctx.rng, 0, 359) << "|" << randomFloat(ctx.rng, 20.f, 80.f) << "|"
+		   << temp - 1.f << "|" << temp + 1.f << "|" << temp + 5.f << "|" << temp - 5.f << "|"
+		   << randomFloat(ctx.rng, 0.f, 10.f) << "|" << randomInt(ctx.rng, 0, 900) << "|";
+		return os.str();
+	};
+	const std::pair<std::string, std::string> mbdataTypes[] = {
+		{"weatherlink",    "%d/%m/%y;%H:%M;"},
+		{"meteohub",       "%Y-%m-%d;%H:%M;"},
+		{"weathercat",     "%Y-%m-%d;%H:%M;"},
+		{"wswin",          "%Y-%m-%d;%H:%M;"},
+		{"weatherdisplay", "%Y-%m-%d;%H:%M;"},
+	};
+	for (const auto& [type, dateFormat] : mbdataTypes) {
+		std::vector<std::string> files;
+		for (std::size_t i = 0 ; i < ctx.corpusSize ; i++)
+			files.push_back(date::format(dateFormat.c_str(), recent) + mbdataFields(type == "weatherlink" || type == "weathercat"));
+		benchmarks.push_back({"mbdata-" + type, "file", files.size(),
+			[&ctx, type = type, files = std::move(files)]() {
+				static const TimeOffseter timeOffseter =
+					TimeOffseter::getTimeOffseterFor(TimeOffseter::PredefinedTimezone::UTC);
+				std::size_t valid = 0;
+				for (const std::string& f : files) {
+					std::istringstream is{f};
+					auto m = MBDataMessageFactory::chose(ctx.db, ctx.station, type, is, timeOffseter);
+					if (m && *m) {
+						m->getObservation(ctx.station);
+						valid++;
+					}
+				}
+				return valid;
+			}
+		});
+	}
+
+	std::vector<std::string> meteobridgeFiles;
+	for (std::size_t i = 0 ; i < ctx.corpusSize ; i++) {
+		std::ostringstream os;
+		float temp = randomFloat(ctx.rng, -5.f, 35.f);
+		os << "actual_utcdate " << date::format("%Y%m%d%H%M%S", recent) << "\n"
+		   << "actual_th0_temp_c " << temp << "\n"
+		   << "actual_th0_hum_rel " << randomInt(ctx.rng, 20, 100) << "\n"
+		   << "actual_th0_dew_c " << temp - 4.f << "\n"
+		   << "actual_thb0_press_hpa " << randomFloat(ctx.rng, 990.f, 1035.f) << "\n"
+		   << "last15m_wind0_maindir_deg " << randomInt(ctx.rng, 0, 359) << "\n"
+		   << "last15m_wind0_speed_kmh " << randomFloat(ctx.rng, 0.f, 40.f) << "\n"
+		   << "last15m_wind0_gustspeedmax_kmh " << randomFloat(ctx.rng, 20.f, 80.f) << "\n"
+		   << "last15m_rain0_ratemax_mm " << randomFloat(ctx.rng, 0.f, 10.f) << "\n"
+		   << "day1_rain0_total_mm " << randomFloat(ctx.rng, 0.f, 20.f) << "\n"
+		   << "actual_sol0_radiation_wqm " << randomInt(ctx.rng, 0, 900) << "\n"
+		   << "actual_uv0_index " << randomFloat(ctx.rng, 0.f, 8.f) << "\n";
+		meteobridgeFiles.push_back(os.str());
+	}
+	benchmarks.push_back({"mbdata-meteobridge", "file", meteobridgeFiles.size(),
+		[&ctx, files = std::move(meteobridgeFiles)]() {
+			static const TimeOffseter timeOffseter =
+				TimeOffseter::getTimeOffseterFor(TimeOffseter::PredefinedTimezone::UTC);
+			std::size_t valid = 0;
+			for (const std::string& f : files) {
+				std::istringstream is{f};
+				auto m = MBDataMessageFactory::chose(ctx.db, ctx.station, "meteobridge", is, timeOffseter);
+				if (m && *m) {
+					m->getObservation(ctx.station);
+					valid++;
+				}
+			}
+			return valid;
+		}
+	});
+
+	// StatIC files, in the format exported by Weewx and WeatherLink
+	std::vector<std::string> staticFiles;
+	for (std::size_t i = 0 ; i < ctx.corpusSize ; i++) {
+		std::ostringstream os;
+		float temp = randomFloat(ctx.rng, -5.f, 35.f);
+		os << "# Fichier StatIC\n"
+		   << "nom_station=Station de test\n"
+		   << "date_releve=" << date::format("%d/%m/%Y", recent) << "\n"
+		   << "heure_releve_utc=" << date::format("%H:%M", recent) << "\n"
+		   << "temperature=" << temp << "\n"
+		   << "pression=" << randomFloat(ctx.rng, 990.f, 1035.f) << "\n"
+		   << "humidite=" << randomInt(ctx.rng, 20, 100) << "\n"
+		   << "point_de_rosee=" << temp - 4.f << "\n"
+		   << "vent_dir_moy=" << randomInt(ctx.rng, 0, 359) << "\n"
+		   << "vent_moyen=" << randomFloat(ctx.rng, 0.f, 40.f) << "\n"
+		   << "vent_rafales=" << randomFloat(ctx.rng, 20.f, 80.f) << "\n"
+		   << "pluie_intensite=" << randomFloat(ctx.rng, 0.f, 10.f) << "\n"
+		   << "pluie_cumul_1h=" << randomFloat(ctx.rng, 0.f, 5.f) << "\n"
+		   << "pluie_cumul=" << randomFloat(ctx.rng, 0.f, 20.f) << "\n"
+		   << "radiations_solaires_wlk=" << randomInt(ctx.rng, 0, 900) << "\n"
+		   << "uv_wlk=" << randomFloat(ctx.rng, 0.f, 8.f) << "\n";
+		staticFiles.push_back(os.str());
+	}
+	benchmarks.push_back({"static", "file", staticFiles.size(),
+		[&ctx, files = std::move(staticFiles)]() {
+			static const TimeOffseter timeOffseter =
+				TimeOffseter::getTimeOffseterFor(TimeOffseter::PredefinedTimezone::UTC);
+			std::size_t valid = 0;
+			for (const std::string& f : files) {
+				std::istringstream is{f};
+				StatICMessage m{is, timeOffseter, {}};
+				if (m) {
+					m.getObservation(ctx.station);
+					valid++;
+				}
+			}
+			return valid;
+		}
+	});
+
+	// SYNOP messages from an ogimet.com bulletin
+	static const char* SYNOPS[] = {
+		"07005,2026,10,11,00,00,AAXX 11001 07005 42/25 /3523 10217 20147 30209 40281 57037 333 55301 20401 69905 70128 91034=",
+		"07558,2026,10,11,03,00,AAXX 11031 07558 17856 40011 10153 20122 39908 40200 52018 69937 8632/ 333 20288 70250 86835 91019=",
+		"07020,2026,10,11,09,00,AAXX 11091 07020 17775 52225 10118 20065 39608 49987 53026 69934 863/0 333 55308 60015 84558 91040=",
+		"07591,2026,10,11,12,00,AAXX 11121 07591 47570 32213 10015 21058 30238 40264 52034 84320 333 55307 60044 70229 83626 91024=",
+		"07037,2026,10,11,18,00,AAXX 11181 07037 24475 62809 10154 20110 39648 40008 53037 76182 83/00 333 10211 55306 21955 87849=",
+		"07621,2026,10,11,21,00,AAXX 11211 07621 44170 61321 10169 29059 30053 40315 50004 880/0=",
+		"07117,2026,10,12,03,00,AAXX 12031 07117 27970 21517 10242 20219 30015 40059 57006 87540 555 60005=",
+		"07630,2026,10,12,06,00,AAXX 12061 07630 12156 53623 10100 29047 39609 49978 55007 69931 8207/ 333 20060 4/005 55008 60104 91025=",
+		"07149,2026,10,12,12,00,AAXX 12121 07149 21170 10425 10090 20060 39698 40039 54017 78082 88100=",
+		"07650,2026,10,12,15,00,AAXX 12151 07650 34160 22601 11035 21098 39746 40052 58028 76166 87520=",
+		"07190,2026,10,12,21,00,AAXX 12211 07190 37/65 02802 10198 29067 39699 49995 52014 333 22143 69907=",
+	};
+	std::vector<std::string> synops;
+	for (std::size_t i = 0 ; i < ctx.corpusSize ; i++)
+		synops.push_back(SYNOPS[i % std::size(SYNOPS)]);
+	benchmarks.push_back({"synop", "line", synops.size(),
+		[synops = std::move(synops)]() {
+			Parser parser;
+			std::size_t valid = 0;
+			for (const std::string& l : synops) {
+				if (parser.parse(std::string_view{l}))
+					valid++;
+			}
+			return valid;
+		}
+	});
+
+	return benchmarks;
+}
+
+std::vector<DecoderBenchmark> makeApiBenchmarks(Context& ctx)
+{
+	std::vector<DecoderBenchmark> benchmarks;
+
+	// Météo-France observations, one station from the answer of the
+	// "paquet" route of the DPObs API
+	std::vector<std::string> mfObservations;
+	for (std::size_t i = 0 ; i < ctx.corpusSize ; i++) {
+		std::ostringstream os;
+		float t = randomFloat(ctx.rng, 268.f, 308.f);
+		os << R"({"lat":48.4,"lon":-4.4,"geo_id_insee":"29075001","reference_time":")"
+		   << date::format("%FT%TZ", ctx.now) << R"(","insert_time":")" << date::format("%FT%TZ", ctx.now)
+		   << R"(","validity_time":")" << date::format("%FT%TZ", date::floor<chrono::hours>(ctx.now))
+		   << R"(","t":)" << t << R"(,"td":)" << t - 4.f
+		   << R"(,"tx":)" << t + 1.f << R"(,"tn":)" << t - 1.f
+		   << R"(,"u":)" << randomInt(ctx.rng, 20, 100) << R"(,"ux":100,"un":60)"
+		   << R"(,"dd":)" << randomInt(ctx.rng, 0, 359) << R"(,"ff":)" << randomFloat(ctx.rng, 0.f, 15.f)
+		   << R"(,"dxy":)" << randomInt(ctx.rng, 0, 359) << R"(,"fxy":)" << randomFloat(ctx.rng, 0.f, 20.f)
+		   << R"(,"dxi":)" << randomInt(ctx.rng, 0, 359) << R"(,"fxi":)" << randomFloat(ctx.rng, 10.f, 30.f)
+		   << R"(,"rr1":)" << randomFloat(ctx.rng, 0.f, 5.f)
+		   << R"(,"pres":)" << randomInt(ctx.rng, 99000, 103000) << R"(,"pmer":)" << randomInt(ctx.rng, 99000, 103000)
+		   << R"(,"ray_glo01":)" << randomInt(ctx.rng, 0, 3000000) << R"(,"insolh":)" << randomInt(ctx.rng, 0, 60)
+		   << "}";
+		mfObservations.push_back(os.str());
+	}
+	benchmarks.push_back({"meteo-france", "observation", mfObservations.size(),
+		[&ctx, observations = std::move(mfObservations)]() {
+			std::size_t valid = 0;
+			for (const std::string& o : observations) {
+				pt::ptree json;
+				std::istringstream is{o};
+				pt::read_json(is, json);
+				MfRadomeMessage m;
+				date::sys_seconds timestamp;
+				m.parse(std::move(json), timestamp);
+				if (m.looksValid()) {
+					m.getObservation(ctx.station);
+					valid++;
+				}
+			}
+			return valid;
+		}
+	});
+
+	// FieldClimate API archive pages, hourly records over six hours
+	std::vector<std::string> fieldclimatePages;
+	for (std::size_t i = 0 ; i < ctx.corpusSize ; i++) {
+		std::ostringstream dates;
+		std::ostringstream temp, tempMin, tempMax, hum, rain, wind, gust, solar;
+		auto first = date::floor<chrono::hours>(ctx.now) - chrono::hours{6};
+		for (int j = 0 ; j < 6 ; j++) {
+			const char* sep = j > 0 ? "," : "";
+			float t = randomFloat(ctx.rng, -5.f, 35.f);
+			dates << sep << '"' << date::format("%Y-%m-%d %H:%M:%S", first + chrono::hours{j}) << '"';
+			temp << sep << t;
+			tempMin << sep << t - 1.f;
+			tempMax << sep << t + 1.f;
+			hum << sep << randomInt(ctx.rng, 20, 100);
+			rain << sep << randomFloat(ctx.rng, 0.f, 5.f);
+			wind << sep << randomFloat(ctx.rng, 0.f, 10.f);
+			gust << sep << randomFloat(ctx.rng, 10.f, 20.f);
+			solar << sep << randomInt(ctx.rng, 0, 900);
+		}
+		fieldclimatePages.push_back(
+			R"({"dates":[)" + dates.str() + R"(],"data":[)"
+			R"({"name":"HC Air temperature","code":"506","values":{"avg":[)" + temp.str() + "],\"min\":[" + tempMin.str() + "],\"max\":[" + tempMax.str() + "]}},"
+			R"({"name":"HC Relative humidity","code":"507","values":{"avg":[)" + hum.str() + "]}},"
+			R"({"name":"Precipitation","code":"6","values":{"sum":[)" + rain.str() + "]}},"
+			R"({"name":"Wind speed","code":"5","values":{"avg":[)" + wind.str() + "],\"max\":[" + gust.str() + "]}},"
+			R"({"name":"Solar radiation","code":"600","values":{"avg":[)" + solar.str() + "]}}"
+			"]}"
+		);
+	}
+	benchmarks.push_back({"fieldclimate", "page", fieldclimatePages.size(),
+		[&ctx, pages = std::move(fieldclimatePages)]() {
+			static const std::map<std::string, std::string> sensors = {
+				{"temperature", "506"},
+				{"humidity", "507"},
+				{"rainfall", "6"},
+				{"wind speed", "5"},
+				{"wind gust speed", "5"},
+				{"solar radiation", "600"},
+			};
+			static const TimeOffseter timeOffseter = [] {
+				TimeOffseter t = TimeOffseter::getTimeOffseterFor(TimeOffseter::PredefinedTimezone::UTC);
+				t.setLatitude(48.4f);
+				t.setLongitude(-4.4f);
+				t.setElevation(50);
+				t.setMeasureStep(60);
+				return t;
+			}();
+			std::size_t valid = 0;
+			for (const std::string& p : pages) {
+				FieldClimateApiArchiveMessageCollection collection{&timeOffseter, &sensors};
+				std::istringstream is{p};
+				collection.parse(is);
+				bool empty = true;
+				for (const auto& m : collection) {
+					m.getObservation(ctx.station);
+					empty = false;
+				}
+				if (!empty)
+					valid++;
+			}
+			return valid;
+		}
+	});
+
+	return benchmarks;
+}
+
+}
+
+/**
+ * @brief Entry point
+ *
+ * @param argc the number of arguments passed on the command line
+ * @param argv the arguments passed on the command line
+ *
+ * @return 0 if everything went well, and either an "errno-style" error code
+ * or 255 otherwise
+ */
+int main(int argc, char** argv)
+{
+	unsigned long iterations = 100;
+	std::size_t corpusSize = 64;
+	std::vector<std::string> filters;
+
+	po::options_description desc("Allowed options");
+	desc.add_options()
+		("help", "display the help message and exit")
+		("version", "display the version of Meteodata and exit")
+		("list", "list the benchmarks and exit")
+		("iterations,n", po::value<unsigned long>(&iterations), "number of times each corpus is decoded, defaults to 100")
+		("corpus-size", po::value<std::size_t>(&corpusSize), "number of messages in each corpus, defaults to 64")
+		("verbose,v", "let the decoders log to the standard error output instead of discarding their logs")
+		("benchmark", po::value<std::vector<std::string>>(&filters), "run only the benchmarks whose name contains this string, can be repeated")
+	;
+	po::positional_options_description pd;
+	pd.add("benchmark", -1);
+
+	po::variables_map vm;
+	po::store(po::command_line_parser(argc, argv).options(desc).positional(pd).run(), vm);
+	po::notify(vm);
+
+	if (vm.count("help")) {
+		std::cout << "Usage: " << argv[0] << " [benchmark...] [-n iterations]\n";
+		std::cout << desc << "\n";
+		std::cout << "Each decoder is run over a corpus of payloads built from realistic values, "
+			  << "the storage is the in-memory one so that only the decoding is measured" << std::endl;
+		return 0;
+	}
+
+	if (vm.count("version")) {
+		std::cout << PACKAGE_STRING << std::endl;
+		return 0;
+	}
+
+	if (corpusSize == 0 || iterations == 0) {
+		std::cerr << "The corpus size and the number of iterations must be positive" << std::endl;
+		return 1;
+	}
+
+	InMemoryObservationsStorage db;
+	CassUuid station;
+	cass_uuid_from_string("00000000-0000-4000-8000-000000000001", &station);
+	Context ctx{db, station, date::floor<chrono::seconds>(chrono::system_clock::now()), std::minstd_rand{42}, corpusSize};
+
+	std::vector<DecoderBenchmark> benchmarks;
+	for (auto make : {&makeDavisBenchmarks, &makeLoraBenchmarks, &makeTextBenchmarks, &makeApiBenchmarks}) {
+		auto b = make(ctx);
+		std::move(b.begin(), b.end(), std::back_inserter(benchmarks));
+	}
+
+	if (vm.count("list")) {
+		for (const DecoderBenchmark& b : benchmarks)
+			std::cout << b.name << "\n";
+		return 0;
+	}
+
+	NullBuffer nullBuffer;
+	std::streambuf* cerrBuffer = std::cerr.rdbuf();
+	if (!vm.count("verbose"))
+		std::cerr.rdbuf(&nullBuffer);
+
+	bool found = false;
+	for (const DecoderBenchmark& b : benchmarks) {
+		if (!filters.empty() && std::none_of(filters.begin(), filters.end(),
+				[&b](const std::string& f) { return b.name.find(f) != std::string::npos; }))
+			continue;
+		found = true;
+
+		// warm up the caches and the lazy initializations (time zones,
+		// regexes, etc.) before measuring
+		std::size_t valid = b.decodeCorpus();
+
+		std::size_t allocationsBefore = allocations;
+		auto begin = chrono::steady_clock::now();
+		for (unsigned long i = 0 ; i < iterations ; i++)
+			b.decodeCorpus();
+		auto end = chrono::steady_clock::now();
+		std::size_t allocationsDuringDecoding = allocations - allocationsBefore;
+
+		std::size_t total = b.corpusSize * iterations;
+		std::cout << std::left << std::setw(28) << b.name << std::right << std::fixed
+			  << std::setw(12) << std::setprecision(1)
+			  << chrono::duration<double, std::nano>(end - begin).count() / total << " ns/" << std::left << std::setw(12) << b.unit
+			  << std::right << std::setw(10) << std::setprecision(2)
+			  << static_cast<double>(allocationsDuringDecoding) / total << " allocations/" << std::left << std::setw(12) << b.unit
+			  << std::right << "(" << valid << "/" << b.corpusSize << " valid)" << std::endl;
+	}
+
+	std::cerr.rdbuf(cerrBuffer);
+
+	if (!found) {
+		std::cerr << "No benchmark matches, see --list" << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
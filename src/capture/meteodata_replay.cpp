@@ -0,0 +1,434 @@
+/**
+ * @file meteodata_replay.cpp
+ * @brief Replay the messages captured by Meteodata against a running instance
+ * @author Laurent Georget
+ * @date 2026-10-18
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <optional>
+#include <set>
+#include <string>
+#include <string_view>
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <boost/asio.hpp>
+#include <boost/beast.hpp>
+#include <mqtt_client_cpp.hpp> // must be kept before boost/program_options.hpp else build breaks (not sure why...)
+#include <boost/program_options.hpp>
+
+#include "capture/traffic_capture.h"
+#include "config.h"
+
+#define DEFAULT_VERIFY_PATH "/etc/ssl/certs"
+
+using namespace meteodata;
+namespace po = boost::program_options;
+namespace asio = boost::asio;
+namespace beast = boost::beast;
+namespace http = beast::http;
+namespace sys = boost::system;
+using tcp = asio::ip::tcp;
+using udp = asio::ip::udp;
+
+namespace
+{
+
+constexpr char CLIENT_ID[] = "meteodata-replay";
+
+/**
+ * @brief The outcome of the replay of the messages of one type
+ */
+struct Statistics
+{
+	std::uint64_t sent = 0;
+	std::uint64_t failed = 0;
+	std::uint64_t skipped = 0;
+};
+
+/**
+ * @brief Rebuild a request to the REST server from its captured header and
+ * body
+ *
+ * The framing fields (Content-Length, etc.) and the Host are dropped from
+ * the captured header, they are set again for the target of the replay.
+ */
+http::request<http::string_body> rebuildRequest(const CapturedMessage& message, const std::string& host)
+{
+	http::request<http::string_body> request;
+	beast::string_view header{message.channel.data(), message.channel.size()};
+
+	auto eol = header.find("\r\n");
+	beast::string_view startLine = header.substr(0, eol);
+	auto firstSpace = startLine.find(' ');
+	auto secondSpace = startLine.rfind(' ');
+	if (firstSpace == beast::string_view::npos || secondSpace == firstSpace)
+		throw std::runtime_error("Invalid request line '" + std::string{startLine.data(), startLine.size()} + "'");
+	request.method_string(startLine.substr(0, firstSpace));
+	request.target(startLine.substr(firstSpace + 1, secondSpace - firstSpace - 1));
+	request.version(11);
+
+	while (eol != beast::string_view::npos) {
+		header.remove_prefix(eol + 2);
+		eol = header.find("\r\n");
+		beast::string_view line = header.substr(0, eol);
+		auto colon = line.find(':');
+		if (line.empty() || colon == beast::string_view::npos)
+			continue;
+		beast::string_view name = line.substr(0, colon);
+		beast::string_view value = line.substr(colon + 1);
+		while (!value.empty() && value.front() == ' ')
+			value.remove_prefix(1);
+		http::field field = http::string_to_field(name);
+		if (field == http::field::content_length || field == http::field::transfer_encoding ||
+		    field == http::field::host || field == http::field::connection)
+			continue;
+		request.insert(name, value);
+	}
+
+	request.set(http::field::host, host);
+	request.keep_alive(false);
+	request.body() = message.payload;
+	request.prepare_payload();
+	return request;
+}
+
+/**
+ * @brief The replay of a capture file, paced by the reception times of the
+ * messages
+ */
+class Replay
+{
+public:
+	struct Targets
+	{
+		std::string host;
+		int udpPort;
+		int httpPort;
+		std::set<CapturedMessage::Type> types;
+	};
+
+	using MqttClient = decltype(mqtt::make_tls_sync_client(std::declval<asio::io_context&>(), std::string{}, std::declval<int>()));
+
+	Replay(asio::io_context& ioContext, CaptureReader& reader, Targets targets, double speed, MqttClient mqttClient) :
+		_ioContext{ioContext},
+		_reader{reader},
+		_targets{std::move(targets)},
+		_speed{speed},
+		_mqttClient{std::move(mqttClient)},
+		_timer{ioContext},
+		_udpSocket{ioContext}
+	{
+		udp::resolver udpResolver{ioContext};
+		_udpEndpoint = *udpResolver.resolve(udp::v4(), _targets.host, std::to_string(_targets.udpPort)).begin();
+		_udpSocket.open(udp::v4());
+		tcp::resolver tcpResolver{ioContext};
+		_httpEndpoint = *tcpResolver.resolve(tcp::v4(), _targets.host, std::to_string(_targets.httpPort)).begin();
+	}
+
+	void start()
+	{
+		_start = chrono::steady_clock::now();
+		scheduleNext();
+	}
+
+	void acknowledge()
+	{
+		_acknowledged++;
+	}
+
+	void report(std::ostream& os) const
+	{
+		auto elapsed = chrono::duration<double>(chrono::steady_clock::now() - _start).count();
+		std::uint64_t total = 0;
+		for (auto&& s : _statistics)
+			total += s.second.sent;
+
+		os << "Replayed " << total << " messages in " << std::fixed << std::setprecision(3) << elapsed << "s ("
+		   << (elapsed > 0 ? total / elapsed : 0.) << " messages/s)\n";
+		for (auto&& [type, s] : _statistics) {
+			os << "  " << std::left << std::setw(6) << typeName(type) << std::right
+			   << " sent: " << s.sent << ", failed: " << s.failed << ", skipped: " << s.skipped;
+			if (type == CapturedMessage::Type::MQTT)
+				os << ", acknowledged by the broker: " << _acknowledged;
+			os << "\n";
+		}
+		if (_lag.count() > 0)
+			os << "The replay lagged behind the capture by up to "
+			   << chrono::duration<double>(_lag).count() << "s\n";
+	}
+
+private:
+	asio::io_context& _ioContext;
+	CaptureReader& _reader;
+	Targets _targets;
+	double _speed;
+	MqttClient _mqttClient;
+	asio::steady_timer _timer;
+	udp::socket _udpSocket;
+	udp::endpoint _udpEndpoint;
+	tcp::endpoint _httpEndpoint;
+
+	CapturedMessage _message;
+	std::optional<chrono::system_clock::time_point> _firstReception;
+	chrono::steady_clock::time_point _start;
+	chrono::steady_clock::duration _lag{0};
+	std::map<CapturedMessage::Type, Statistics> _statistics;
+	std::uint64_t _acknowledged = 0;
+
+	static const char* typeName(CapturedMessage::Type type)
+	{
+		switch (type) {
+			case CapturedMessage::Type::MQTT:
+				return "MQTT";
+			case CapturedMessage::Type::UDP:
+				return "UDP";
+			case CapturedMessage::Type::HTTP:
+				return "HTTP";
+		}
+		return "?";
+	}
+
+	void scheduleNext()
+	{
+		if (!_reader.next(_message)) {
+			if (_mqttClient)
+				_mqttClient->disconnect();
+			return;
+		}
+
+		if (!_firstReception)
+			_firstReception = _message.received;
+
+		// at the maximum speed, the timer still goes through the event
+		// loop so that the MQTT acknowledgements get processed
+		auto due = _start;
+		if (_speed > 0) {
+			due += chrono::duration_cast<chrono::steady_clock::duration>(
+				(_message.received - *_firstReception) / _speed);
+			_lag = std::max(_lag, chrono::steady_clock::now() - due);
+		}
+		_timer.expires_at(due);
+		_timer.async_wait([this](const sys::error_code& ec) {
+			if (ec == sys::errc::operation_canceled)
+				return;
+			send();
+			scheduleNext();
+		});
+	}
+
+	void send()
+	{
+		Statistics& statistics = _statistics[_message.type];
+		if (_targets.types.count(_message.type) == 0 ||
+		    (_message.type == CapturedMessage::Type::MQTT && !_mqttClient)) {
+			statistics.skipped++;
+			return;
+		}
+
+		try {
+			bool success = false;
+			switch (_message.type) {
+				case CapturedMessage::Type::MQTT:
+					_mqttClient->publish(_message.channel, _message.payload, mqtt::qos::at_least_once);
+					success = true;
+					break;
+				case CapturedMessage::Type::UDP:
+					_udpSocket.send_to(asio::buffer(_message.payload), _udpEndpoint);
+					success = true;
+					break;
+				case CapturedMessage::Type::HTTP:
+					success = sendHttpRequest();
+					break;
+			}
+			if (success)
+				statistics.sent++;
+			else
+				statistics.failed++;
+		} catch (const std::exception& e) {
+			std::cerr << "Failed to replay a " << typeName(_message.type) << " message: " << e.what() << std::endl;
+			statistics.failed++;
+		}
+	}
+
+	bool sendHttpRequest()
+	{
+		auto request = rebuildRequest(_message, _targets.host);
+
+		// the REST server closes the connection after each response
+		tcp::socket socket{_ioContext};
+		socket.connect(_httpEndpoint);
+		http::write(socket, request);
+		beast::flat_buffer buffer;
+		http::response<http::string_body> response;
+		http::read(socket, buffer, response);
+		sys::error_code ec;
+		socket.shutdown(tcp::socket::shutdown_both, ec);
+
+		if (http::to_status_class(response.result()) != http::status_class::successful) {
+			std::cerr << "HTTP request " << request.method_string() << " " << request.target()
+				  << " answered with " << response.result_int() << std::endl;
+			return false;
+		}
+		return true;
+	}
+};
+
+}
+
+/**
+ * @brief Entry point
+ *
+ * @param argc the number of arguments passed on the command line
+ * @param argv the arguments passed on the command line
+ *
+ * @return 0 if everything went well, and either an "errno-style" error code
+ * or 255 otherwise
+ */
+int main(int argc, char** argv)
+{
+	std::string inputFile;
+	double speed = 1.;
+	std::string host;
+	int udpPort;
+	int httpPort;
+	std::string mqttAddress;
+	int mqttPort;
+	std::string mqttUser;
+	std::string mqttPassword;
+	std::vector<std::string> only;
+
+	po::options_description desc("Allowed options");
+	desc.add_options()
+		("help", "display the help message and exit")
+		("version", "display the version of Meteodata and exit")
+		("input-file", po::value<std::string>(&inputFile), "the capture file, written by meteodata with --capture-file")
+		("speed", po::value<double>(&speed)->default_value(1.), "the replay speed, relative to the capture: 1 to replay in real time, 10 to replay ten times faster, etc., 0 to replay as fast as possible")
+		("host", po::value<std::string>(&host)->default_value("localhost"), "the host running meteodata, for the UDP datagrams and the HTTP requests")
+		("udp-port", po::value<int>(&udpPort)->default_value(5888), "the port of the meteodata UDP connector")
+		("http-port", po::value<int>(&httpPort)->default_value(5887), "the port of the meteodata REST server")
+		("mqtt-host", po::value<std::string>(&mqttAddress), "the MQTT broker to publish the MQTT messages to, the meteodata instance must be subscribed to it (the MQTT messages are skipped if not given)")
+		("mqtt-port", po::value<int>(&mqttPort)->default_value(8883), "the port of the MQTT broker")
+		("mqtt-user", po::value<std::string>(&mqttUser), "the username to connect to the MQTT broker")
+		("mqtt-password", po::value<std::string>(&mqttPassword), "the password to connect to the MQTT broker")
+		("only", po::value<std::vector<std::string>>(&only)->multitoken(), "the types of messages to replay, among mqtt, udp and http (can be given multiple times, defaults to all)")
+	;
+	po::positional_options_description pd;
+	pd.add("input-file", 1);
+
+	po::variables_map vm;
+	po::store(po::command_line_parser(argc, argv).options(desc).positional(pd).run(), vm);
+	po::notify(vm);
+
+	if (vm.count("help")) {
+		std::cout << PACKAGE_STRING"\n";
+		std::cout << "Usage: " << argv[0] << " [--speed N] [--host host] [--mqtt-host broker] capture_file\n";
+		std::cout << desc << "\n";
+		return 0;
+	}
+
+	if (vm.count("version")) {
+		std::cout << VERSION << std::endl;
+		return 0;
+	}
+
+	if (inputFile.empty()) {
+		std::cerr << "No capture file given, aborting" << std::endl;
+		return 1;
+	}
+
+	if (speed < 0) {
+		std::cerr << "The speed cannot be negative, aborting" << std::endl;
+		return 1;
+	}
+
+	Replay::Targets targets{host, udpPort, httpPort, {}};
+	if (only.empty()) {
+		targets.types = {CapturedMessage::Type::MQTT, CapturedMessage::Type::UDP, CapturedMessage::Type::HTTP};
+	} else {
+		for (const std::string& type : only) {
+			if (type == "mqtt") {
+				targets.types.insert(CapturedMessage::Type::MQTT);
+			} else if (type == "udp") {
+				targets.types.insert(CapturedMessage::Type::UDP);
+			} else if (type == "http") {
+				targets.types.insert(CapturedMessage::Type::HTTP);
+			} else {
+				std::cerr << "Unknown type of message '" << type << "', aborting" << std::endl;
+				return 1;
+			}
+		}
+	}
+
+	try {
+		CaptureReader reader{inputFile};
+		asio::io_context ioContext;
+
+		Replay::MqttClient client;
+		if (!mqttAddress.empty() && targets.types.count(CapturedMessage::Type::MQTT)) {
+			client = mqtt::make_tls_sync_client(ioContext, mqttAddress, mqttPort);
+			client->set_client_id(CLIENT_ID);
+			client->set_user_name(mqttUser);
+			client->set_password(mqttPassword);
+			client->set_clean_session(true);
+			client->get_ssl_context().add_verify_path(DEFAULT_VERIFY_PATH);
+			client->get_ssl_context().set_verify_mode(asio::ssl::verify_none);
+		}
+
+		Replay replay{ioContext, reader, targets, speed, client};
+
+		if (client) {
+			using packet_id_t = typename std::remove_reference_t<decltype(*client)>::packet_id_t;
+			client->set_connack_handler([&](bool, mqtt::connect_return_code ret) {
+				if (ret != mqtt::connect_return_code::accepted) {
+					std::cerr << "Failed to connect to the MQTT broker: " << mqtt::connect_return_code_to_str(ret) << std::endl;
+					return false;
+				}
+				replay.start();
+				return true;
+			});
+			client->set_close_handler([]() {});
+			client->set_error_handler([](std::error_code const& ec) {
+				std::cerr << "MQTT client disconnected: " << ec.message() << std::endl;
+			});
+			client->set_puback_handler([&replay]([[maybe_unused]] packet_id_t packetId) {
+				replay.acknowledge();
+				return true;
+			});
+			client->connect();
+		} else {
+			replay.start();
+		}
+
+		ioContext.run();
+		replay.report(std::cout);
+	} catch (const std::exception& e) {
+		std::cerr << "Replay aborted: " << e.what() << std::endl;
+		return 1;
+	}
+}
@@ -0,0 +1,186 @@
+/**
+ * @file traffic_capture.cpp
+ * @brief Implementation of the TrafficCapture and CaptureReader classes
+ * @author Laurent Georget
+ * @date 2026-10-18
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include <systemd/sd-daemon.h>
+
+#include "traffic_capture.h"
+
+namespace meteodata
+{
+
+namespace
+{
+	template<typename T>
+	void writeLittleEndian(std::ostream& os, T value)
+	{
+		char bytes[sizeof(T)];
+		for (std::size_t i = 0 ; i < sizeof(T) ; i++) {
+			bytes[i] = static_cast<char>(value & 0xFF);
+			value >>= 8;
+		}
+		os.write(bytes, sizeof(T));
+	}
+
+	template<typename T>
+	bool readLittleEndian(std::istream& is, T& value)
+	{
+		unsigned char bytes[sizeof(T)];
+		if (!is.read(reinterpret_cast<char*>(bytes), sizeof(T)))
+			return false;
+		value = 0;
+		for (std::size_t i = sizeof(T) ; i > 0 ; i--)
+			value = (value << 8) | bytes[i - 1];
+		return true;
+	}
+}
+
+TrafficCapture& TrafficCapture::instance()
+{
+	static TrafficCapture capture;
+	return capture;
+}
+
+TrafficCapture::~TrafficCapture()
+{
+	close();
+}
+
+bool TrafficCapture::open(const std::string& captureFile)
+{
+	std::lock_guard<std::mutex> lock{_mutex};
+	if (_file.is_open())
+		_file.close();
+
+	// an existing capture is appended to, without writing the magic
+	// string again
+	bool empty = true;
+	{
+		std::ifstream existing{captureFile, std::ios::binary | std::ios::ate};
+		if (existing)
+			empty = existing.tellg() <= 0;
+	}
+
+	_file.open(captureFile, std::ios::binary | std::ios::app);
+	if (!_file) {
+		std::cerr << SD_ERR << "[Server] management: " << "Cannot open the capture file " << captureFile
+			  << ", the traffic will not be captured" << std::endl;
+		_enabled = false;
+		return false;
+	}
+	if (empty)
+		_file.write(CAPTURE_MAGIC, sizeof(CAPTURE_MAGIC));
+
+	std::cerr << SD_NOTICE << "[Server] management: " << "Capturing the incoming traffic to " << captureFile << std::endl;
+	_messages = 0;
+	_lastFlush = chrono::steady_clock::now();
+	_enabled = true;
+	return true;
+}
+
+void TrafficCapture::close()
+{
+	std::lock_guard<std::mutex> lock{_mutex};
+	if (!_enabled)
+		return;
+
+	_enabled = false;
+	_file.close();
+	std::cerr << SD_NOTICE << "[Server] management: " << "Stopped capturing the incoming traffic, "
+		  << _messages << " messages captured" << std::endl;
+}
+
+void TrafficCapture::record(CapturedMessage::Type type, std::string_view channel, std::string_view payload)
+{
+	if (!isEnabled())
+		return;
+
+	auto received = chrono::duration_cast<chrono::microseconds>(chrono::system_clock::now().time_since_epoch());
+
+	std::lock_guard<std::mutex> lock{_mutex};
+	if (!_enabled)
+		return;
+
+	writeLittleEndian(_file, static_cast<std::uint8_t>(type));
+	writeLittleEndian(_file, static_cast<std::uint64_t>(received.count()));
+	writeLittleEndian(_file, static_cast<std::uint32_t>(channel.size()));
+	writeLittleEndian(_file, static_cast<std::uint32_t>(payload.size()));
+	_file.write(channel.data(), channel.size());
+	_file.write(payload.data(), payload.size());
+	_messages++;
+
+	auto now = chrono::steady_clock::now();
+	if (now - _lastFlush >= FLUSH_PERIOD) {
+		_file.flush();
+		_lastFlush = now;
+	}
+
+	if (!_file) {
+		std::cerr << SD_ERR << "[Server] management: " << "Failed to write to the capture file, "
+			  << "the traffic is no longer captured" << std::endl;
+		_enabled = false;
+		_file.close();
+	}
+}
+
+CaptureReader::CaptureReader(const std::string& captureFile) :
+	_file{captureFile, std::ios::binary}
+{
+	if (!_file)
+		throw std::runtime_error("Cannot open the capture file " + captureFile);
+
+	char magic[sizeof(TrafficCapture::CAPTURE_MAGIC)];
+	if (!_file.read(magic, sizeof(magic)) ||
+	    !std::equal(std::begin(magic), std::end(magic), std::begin(TrafficCapture::CAPTURE_MAGIC)))
+		throw std::runtime_error(captureFile + " is not a capture file, or is from an unsupported version");
+}
+
+bool CaptureReader::next(CapturedMessage& message)
+{
+	std::uint8_t type;
+	std::uint64_t received;
+	std::uint32_t channelSize;
+	std::uint32_t payloadSize;
+	if (!readLittleEndian(_file, type) || !readLittleEndian(_file, received) ||
+	    !readLittleEndian(_file, channelSize) || !readLittleEndian(_file, payloadSize))
+		return false;
+
+	message.type = static_cast<CapturedMessage::Type>(type);
+	message.received = chrono::system_clock::time_point{
+		chrono::duration_cast<chrono::system_clock::duration>(chrono::microseconds{received})
+	};
+	message.channel.resize(channelSize);
+	message.payload.resize(payloadSize);
+	return _file.read(message.channel.data(), channelSize) && _file.read(message.payload.data(), payloadSize);
+}
+
+}
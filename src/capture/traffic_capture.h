@@ -0,0 +1,181 @@
+/**
+ * @file traffic_capture.h
+ * @brief Definition of the TrafficCapture and CaptureReader classes
+ * @author Laurent Georget
+ * @date 2026-10-18
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRAFFIC_CAPTURE_H
+#define TRAFFIC_CAPTURE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+namespace meteodata
+{
+
+namespace chrono = std::chrono;
+
+/**
+ * @brief A message received by Meteodata, as stored in a capture file
+ */
+struct CapturedMessage
+{
+	/**
+	 * @brief The ingress the message has been received from
+	 */
+	enum class Type : std::uint8_t
+	{
+		MQTT = 1, //!< a MQTT message, the channel is the topic
+		UDP = 2,  //!< a datagram received by the UDP connector, the channel is empty
+		HTTP = 3  //!< a request to the REST server, the channel is the request header
+	};
+
+	Type type;
+	/**
+	 * @brief When the message has been received
+	 */
+	chrono::system_clock::time_point received;
+	/**
+	 * @brief The topic of a MQTT message, or the start line and the
+	 * fields of a HTTP request
+	 */
+	std::string channel;
+	/**
+	 * @brief The raw payload, datagram or request body
+	 */
+	std::string payload;
+};
+
+/**
+ * @brief The recorder of the messages received by the daemon, to replay them
+ * later against another instance (see meteodata-replay)
+ *
+ * When the capture is enabled, the MQTT subscribers, the UDP connector and
+ * the REST server (for the import routes) write each message they receive,
+ * undecoded, to a capture file. The file is a binary file, starting with the
+ * eight bytes of CAPTURE_MAGIC, followed by the messages, each one made of:
+ * - the type, on one byte;
+ * - the reception time, in microseconds since the Epoch, on 8 bytes;
+ * - the lengths of the channel and of the payload, on 4 bytes each;
+ * - the channel and the payload.
+ * All the integers are little-endian.
+ *
+ * Capturing is meant for short sessions, the file is not rotated.
+ */
+class TrafficCapture
+{
+public:
+	/**
+	 * @brief Get the capture of the process
+	 */
+	static TrafficCapture& instance();
+
+	/**
+	 * @brief Start capturing the messages
+	 *
+	 * @param captureFile The file to append the messages to
+	 * @return True if the capture is started, false if the file
+	 * cannot be opened
+	 */
+	bool open(const std::string& captureFile);
+
+	/**
+	 * @brief Stop capturing the messages and close the capture file
+	 */
+	void close();
+
+	/**
+	 * @brief Tell whether the messages are being captured, to avoid
+	 * preparing a message for nothing
+	 */
+	bool isEnabled() const
+	{
+		return _enabled.load(std::memory_order_relaxed);
+	}
+
+	/**
+	 * @brief Record a message, if the capture is enabled
+	 *
+	 * @param type The ingress the message has been received from
+	 * @param channel The topic, request header, etc. (see CapturedMessage)
+	 * @param payload The raw payload
+	 */
+	void record(CapturedMessage::Type type, std::string_view channel, std::string_view payload);
+
+	/**
+	 * @brief The magic string of the capture files, including the version
+	 * of the format
+	 */
+	static constexpr char CAPTURE_MAGIC[8] = {'M', 'D', 'C', 'A', 'P', 'T', '0', '1'};
+
+private:
+	TrafficCapture() = default;
+	~TrafficCapture();
+
+	std::mutex _mutex;
+	std::ofstream _file;
+	std::atomic<bool> _enabled{false};
+	std::uint64_t _messages = 0;
+	chrono::steady_clock::time_point _lastFlush;
+
+	/**
+	 * @brief The maximum time the messages can stay in the buffer of the
+	 * capture file before being flushed
+	 */
+	static constexpr chrono::seconds FLUSH_PERIOD{1};
+};
+
+/**
+ * @brief The reader of the capture files written by TrafficCapture
+ */
+class CaptureReader
+{
+public:
+	/**
+	 * @brief Open a capture file
+	 *
+	 * @param captureFile The file to read
+	 * @throw std::runtime_error If the file cannot be opened or is not a
+	 * capture file
+	 */
+	explicit CaptureReader(const std::string& captureFile);
+
+	/**
+	 * @brief Read the next message from the file
+	 *
+	 * @param message The message to fill in
+	 * @return True if a message has been read, false at the end of the
+	 * file (a truncated last message, from a daemon killed in the middle
+	 * of a write, is ignored)
+	 */
+	bool next(CapturedMessage& message);
+
+private:
+	std::ifstream _file;
+};
+
+}
+
+#endif /* TRAFFIC_CAPTURE_H */
@@ -28,8 +28,8 @@
 #include <systemd/sd-daemon.h>
 #include <cassandra.h>
 #include <date/date.h>
-#include <cassobs/dbconnection_observations.h>
 
+#include "storage/observations_storage.h"
 #include "../time_offseter.h"
 #include "../cassandra.h"
 #include "../cassandra_utils.h"
@@ -46,13 +46,13 @@ using namespace std::placeholders;
 using namespace meteodata;
 
 Cimel440204Importer::Cimel440204Importer(const CassUuid& station, const std::string& cimelId, const std::string& timezone,
-	DbConnectionObservations& db, const std::shared_ptr<AsyncJobPublisher>& jobPublisher) :
+	ObservationsStorage& db, const std::shared_ptr<AsyncJobPublisher>& jobPublisher) :
 		CimelImporter{station, cimelId, timezone, db, jobPublisher}
 {
 }
 
 Cimel440204Importer::Cimel440204Importer(const CassUuid& station, const std::string& cimelId, TimeOffseter&& timeOffseter,
-	DbConnectionObservations& db, const std::shared_ptr<AsyncJobPublisher>& jobPublisher) :
+	ObservationsStorage& db, const std::shared_ptr<AsyncJobPublisher>& jobPublisher) :
 		CimelImporter{station, cimelId, std::forward<TimeOffseter&&>(timeOffseter), db, jobPublisher}
 {
 }
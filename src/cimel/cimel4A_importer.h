@@ -36,9 +36,9 @@
 #include <cassandra.h>
 #include <date/date.h>
 #include <date/tz.h>
-#include <cassobs/dbconnection_observations.h>
 #include <cassobs/message.h>
 
+#include "storage/observations_storage.h"
 #include "time_offseter.h"
 #include "async_job_publisher.h"
 #include "cimel/cimel_importer.h"
@@ -70,7 +70,7 @@ public:
 	 * @param dbJobs The database connection to insert asynchronous job requests
 	 */
 	Cimel4AImporter(const CassUuid& station, const std::string& cimelId, const std::string& timezone,
-		DbConnectionObservations& db,
+		ObservationsStorage& db,
 		const std::shared_ptr<AsyncJobPublisher>& jobPublisher = nullptr);
 
 	/**
@@ -83,7 +83,7 @@ public:
 	 * @param dbJobs The database connection to insert asynchronous job requests
 	 */
 	Cimel4AImporter(const CassUuid& station, const std::string& cimelId, TimeOffseter&& timeOffseter,
-		DbConnectionObservations& db,
+		ObservationsStorage& db,
 		const std::shared_ptr<AsyncJobPublisher>& jobPublisher = nullptr);
 
 	bool doImport(std::istream& input, date::sys_seconds& start, date::sys_seconds& end, date::year year) override;
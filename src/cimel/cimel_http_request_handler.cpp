@@ -37,10 +37,11 @@
 #include "cimel/cimel4A_importer.h"
 #include "cimel/cimel440204_importer.h"
 #include "cimel/cimel_http_request_handler.h"
+#include "monitoring/ingestion_trace.h"
 
 namespace meteodata
 {
-CimelHttpRequestHandler::CimelHttpRequestHandler(DbConnectionObservations& db,
+CimelHttpRequestHandler::CimelHttpRequestHandler(ObservationsStorage& db,
 	const std::shared_ptr<AsyncJobPublisher>& jobPublisher) :
 		_db{db},
 		_jobPublisher{jobPublisher}
@@ -99,6 +100,7 @@ void CimelHttpRequestHandler::postArchiveFile(const Request& request, Response&
 	CassUuid uuid;
 
 	if (getUuidAndCheckAccess(request, response, uuid, url)) {
+		IngestionTrace::setCurrentStation(uuid);
 		const std::string& content = request.body();
 		std::istringstream stream(content);
 
@@ -131,7 +133,9 @@ void CimelHttpRequestHandler::postArchiveFile(const Request& request, Response&
 		date::year year{std::stoi(url[3].str())};
 
 		response.body() = "";
-		if (importer->import(stream, start, end, year, true)) {
+		bool imported = importer->import(stream, start, end, year, true);
+		IngestionTrace::markCurrent(IngestionTrace::Stage::STORED);
+		if (imported) {
 			std::cerr << SD_INFO << "[CIMEL HTTP " << uuid << "] measurement: " << "stored archive for station " << name
 					  << std::endl;
 
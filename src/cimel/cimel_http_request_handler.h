@@ -29,7 +29,6 @@
 #include <boost/asio.hpp>
 #include <systemd/sd-daemon.h>
 #include <date/date.h>
-#include <cassobs/dbconnection_observations.h>
 
 #include <map>
 #include <memory>
@@ -37,6 +36,7 @@
 #include <tuple>
 #include <regex>
 
+#include "storage/observations_storage.h"
 #include "http_connection.h"
 #include "cassandra.h"
 #include "cassandra_utils.h"
@@ -53,13 +53,13 @@ public:
 	using Request = boost::beast::http::request<boost::beast::http::string_body>;
 	using Response = boost::beast::http::response<boost::beast::http::string_body>;
 
-	explicit CimelHttpRequestHandler(DbConnectionObservations& db,
+	explicit CimelHttpRequestHandler(ObservationsStorage& db,
 		const std::shared_ptr<AsyncJobPublisher>& jobPublisher = nullptr);
 
 	void processRequest(const Request& request, Response& response);
 
 private:
-	DbConnectionObservations& _db;
+	ObservationsStorage& _db;
 
 	std::shared_ptr<AsyncJobPublisher> _jobPublisher;
 
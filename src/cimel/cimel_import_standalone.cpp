@@ -21,6 +21,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <memory>
 #include <iostream>
 #include <iterator>
 #include <map>
@@ -34,6 +35,7 @@
 #include "cimel_importer.h"
 #include "cimel4A_importer.h"
 #include "cimel440204_importer.h"
+#include "storage/observations_storage.h"
 #include "config.h"
 
 #define DEFAULT_CONFIG_FILE "/etc/meteodata/db_credentials"
@@ -58,6 +60,7 @@ int main(int argc, char** argv)
 	std::string pguser;
 	std::string pgpassword;
 	std::string pgaddress;
+	StorageConfiguration storageConfig;
 	std::string fileName;
 	std::string inputFile;
 	std::string uuid;
@@ -94,6 +97,9 @@ int main(int argc, char** argv)
 		("pguser", po::value<std::string>(&pguser), "PostgreSQL database username")
 		("pgpassword", po::value<std::string>(&pgpassword), "PostgreSQL database password")
 		("pghost", po::value<std::string>(&pgaddress), "PostgreSQL database IP address or domain name")
+		("storage", po::value<std::string>(&storageConfig.backend), "storage backend, 'cassandra' (Cassandra and PostgreSQL databases) or 'memory' (in-process stand-in keeping everything in memory, for benchmarks), defaults to 'cassandra'")
+		("station-table", po::value<std::string>(&storageConfig.stationTable), "with the 'memory' storage, file listing the stations and connectors to serve")
+		("storage-latency", po::value<unsigned long>(&storageConfig.latency), "with the 'memory' storage, delay in microseconds added to each call, defaults to 0")
 	;
 	desc.add(config);
 
@@ -142,7 +148,9 @@ int main(int argc, char** argv)
 	}
 
 	try {
-		DbConnectionObservations db(address, user, password, pgaddress, pguser, pgpassword);
+		std::unique_ptr<ObservationsStorage> storage = ObservationsStorage::create(storageConfig,
+			address, user, password, pgaddress, pguser, pgpassword);
+		ObservationsStorage& db = *storage;
 		CassUuid station;
 		cass_uuid_from_string(uuid.c_str(), &station);
 
@@ -28,8 +28,8 @@
 #include <systemd/sd-daemon.h>
 #include <cassandra.h>
 #include <date/date.h>
-#include <cassobs/dbconnection_observations.h>
 
+#include "storage/observations_storage.h"
 #include "time_offseter.h"
 #include "async_job_publisher.h"
 #include "cassandra_utils.h"
@@ -45,7 +45,7 @@ using namespace std::placeholders;
 using namespace meteodata;
 
 CimelImporter::CimelImporter(const CassUuid& station, std::string cimelId, const std::string& timezone,
-	DbConnectionObservations& db, const std::shared_ptr<AsyncJobPublisher>& jobPublisher) :
+	ObservationsStorage& db, const std::shared_ptr<AsyncJobPublisher>& jobPublisher) :
 		_station{station},
 		_cimelId{std::move(cimelId)},
 		_db{db},
@@ -55,7 +55,7 @@ CimelImporter::CimelImporter(const CassUuid& station, std::string cimelId, const
 }
 
 CimelImporter::CimelImporter(const CassUuid& station, std::string cimelId, TimeOffseter&& timeOffseter,
-	DbConnectionObservations& db, const std::shared_ptr<AsyncJobPublisher>& jobPublisher) :
+	ObservationsStorage& db, const std::shared_ptr<AsyncJobPublisher>& jobPublisher) :
 		_station{station},
 		_cimelId{std::move(cimelId)},
 		_db{db},
@@ -36,9 +36,9 @@
 #include <cassandra.h>
 #include <date/date.h>
 #include <date/tz.h>
-#include <cassobs/dbconnection_observations.h>
 #include <cassobs/message.h>
 
+#include "storage/observations_storage.h"
 #include "time_offseter.h"
 #include "async_job_publisher.h"
 
@@ -69,7 +69,7 @@ public:
 	 * @param jobPublisher The component able to schedule recomputations of the climatology
 	 */
 	CimelImporter(const CassUuid& station, std::string cimelId, const std::string& timezone,
-		DbConnectionObservations& db, const std::shared_ptr<AsyncJobPublisher>& jobPublisher = nullptr);
+		ObservationsStorage& db, const std::shared_ptr<AsyncJobPublisher>& jobPublisher = nullptr);
 
 	/**
 	 * Constructs a Cimel4AImporter
@@ -81,7 +81,7 @@ public:
 	 * @param jobPublisher The component able to schedule recomputations of the climatology
 	 */
 	CimelImporter(const CassUuid& station, std::string cimelId, TimeOffseter&& timeOffseter,
-		DbConnectionObservations& db, const std::shared_ptr<AsyncJobPublisher>& jobPublisher = nullptr);
+		ObservationsStorage& db, const std::shared_ptr<AsyncJobPublisher>& jobPublisher = nullptr);
 
 	virtual ~CimelImporter() = default;
 
@@ -91,7 +91,7 @@ public:
 protected:
 	CassUuid _station;
 	std::string _cimelId;
-	DbConnectionObservations& _db;
+	ObservationsStorage& _db;
 	TimeOffseter _tz;
 
 private:
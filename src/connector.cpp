@@ -36,7 +36,9 @@
 namespace meteodata
 {
 
-Connector::Connector(boost::asio::io_context& ioContext, DbConnectionObservations& db) :
+StationShard Connector::_shard{};
+
+Connector::Connector(boost::asio::io_context& ioContext, ObservationsStorage& db) :
 		_ioContext{ioContext},
 		_db{db}
 {}
@@ -46,6 +48,11 @@ void Connector::publish(const Event& e)
 {
 	MeteoServer::getEventManager().publish(e);
 }
+
+void Connector::publish(const Event& e, const CassUuid& station)
+{
+	MeteoServer::getEventManager().publish(e, station);
+}
 #endif
 
 std::string Connector::getStatus() const
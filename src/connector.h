@@ -27,7 +27,10 @@
 #include <memory>
 
 #include <boost/asio.hpp>
-#include <cassobs/dbconnection_observations.h>
+
+#include "storage/observations_storage.h"
+#include "station_shard.h"
+#include "monitoring/profiled_db_connection.h"
 
 
 namespace meteodata
@@ -59,6 +62,31 @@ public:
 
 	virtual std::string getStatus() const;
 
+	/**
+	 * @brief Set the portion of the stations the connectors of this
+	 * process are responsible for
+	 *
+	 * This must be called before any connector is started, by default,
+	 * connectors handle all the stations.
+	 *
+	 * @param shard The shard of this process
+	 */
+	static void setShard(const StationShard& shard)
+	{
+		_shard = shard;
+	}
+
+	/**
+	 * @brief Get the portion of the stations the connectors of this
+	 * process are responsible for
+	 *
+	 * @return The shard of this process
+	 */
+	static const StationShard& getShard()
+	{
+		return _shard;
+	}
+
 protected:
 	/**
 	 * @brief Construct a connector
@@ -69,10 +97,11 @@ protected:
 	 * Boost::Asio asynchronous operations
 	 * @param db The handle to the database
 	 */
-	Connector(boost::asio::io_context& ioContext, DbConnectionObservations& db);
+	Connector(boost::asio::io_context& ioContext, ObservationsStorage& db);
 
 #ifdef EVENT_MANAGER_ON
 	void publish(const Event& e);
+	void publish(const Event& e, const CassUuid& station);
 #endif
 
 	/**
@@ -81,9 +110,11 @@ protected:
 	 */
 	boost::asio::io_context& _ioContext;
 	/**
-	 * @brief The connection to the observations/climatology database
+	 * @brief The connection to the observations/climatology database,
+	 * profiled, the derived classes set the caller the calls are
+	 * attributed to
 	 */
-	DbConnectionObservations& _db;
+	ProfiledDbConnection _db;
 
 	struct Status {
 		date::sys_seconds activeSince;
@@ -95,6 +126,28 @@ protected:
 	};
 
 	Status _status;
+
+	/**
+	 * @brief Tell whether a station must be handled by this process
+	 *
+	 * Connectors loading their stations from the database must skip the
+	 * stations for which this method returns false, they are handled by
+	 * another meteodata instance.
+	 *
+	 * @param station The station
+	 * @return True if, and only if, the station belongs to the shard of
+	 * this process
+	 */
+	static bool ownsStation(const CassUuid& station)
+	{
+		return _shard.owns(station);
+	}
+
+private:
+	/**
+	 * @brief The shard of this process
+	 */
+	static StationShard _shard;
 };
 }
 
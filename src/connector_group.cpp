@@ -27,8 +27,8 @@
 #include <string>
 
 #include <boost/asio.hpp>
-#include <cassobs/dbconnection_observations.h>
 
+#include "storage/observations_storage.h"
 #include "connector.h"
 #include "connector_group.h"
 
@@ -36,7 +36,7 @@ namespace meteodata
 {
 
 ConnectorGroup::ConnectorGroup(boost::asio::io_context& ioContext,
-				   DbConnectionObservations& db):
+				   ObservationsStorage& db):
 		Connector(ioContext, db)
 {}
 
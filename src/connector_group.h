@@ -29,7 +29,8 @@
 #include <vector>
 
 #include <boost/asio.hpp>
-#include <cassobs/dbconnection_observations.h>
+
+#include "storage/observations_storage.h"
 
 namespace meteodata
 {
@@ -39,7 +40,7 @@ namespace meteodata
 class ConnectorGroup : public Connector
 {
 public:
-	ConnectorGroup(boost::asio::io_context& ioContext, DbConnectionObservations& db);
+	ConnectorGroup(boost::asio::io_context& ioContext, ObservationsStorage& db);
 
 	~ConnectorGroup() override;
 
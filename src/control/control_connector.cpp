@@ -38,6 +38,7 @@
 #include "control/connectors_query_handler.h"
 #include "control/exporters_query_handler.h"
 #include "control/general_query_handler.h"
+#include "control/db_query_handler.h"
 
 namespace ip = boost::asio::ip;
 namespace asio = boost::asio;
@@ -59,7 +60,9 @@ ControlConnector::ControlConnector(boost::asio::io_context& ioContext,
 	auto connectorsHandler = std::make_unique<ConnectorsQueryHandler>(meteoServer);
 	auto exportersHandler = std::make_unique<ExportersQueryHandler>(meteoServer);
 	auto generalHandler = std::make_unique<GeneralQueryHandler>(meteoServer);
+	auto dbHandler = std::make_unique<DbQueryHandler>();
 
+	exportersHandler->setNext(std::move(dbHandler));
 	connectorsHandler->setNext(std::move(exportersHandler));
 	generalHandler->setNext(std::move(connectorsHandler));
 	_queryHandlerChain = std::move(generalHandler);
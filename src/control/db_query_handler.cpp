@@ -0,0 +1,71 @@
+/**
+ * @file db_query_handler.cpp
+ * @brief Implementation of the DbQueryHandler class
+ * @author Laurent Georget
+ * @date 2026-10-18
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <sstream>
+#include <string>
+
+#include "control/db_query_handler.h"
+#include "monitoring/db_profiler.h"
+
+namespace meteodata {
+
+DbQueryHandler::DbQueryHandler() :
+	QueryHandler{"db"}
+{
+	_commands.push_back(NamedCommand{ "stats", static_cast<Command>(&DbQueryHandler::stats) });
+	_commands.push_back(NamedCommand{ "reset", static_cast<Command>(&DbQueryHandler::reset) });
+	_commands.push_back(NamedCommand{ "help", static_cast<Command>(&DbQueryHandler::help) });
+	_defaultCommand = "stats";
+}
+
+std::string DbQueryHandler::stats(const std::string& caller)
+{
+	std::ostringstream os;
+	DbProfiler::instance().report(os, caller);
+	return os.str();
+}
+
+std::string DbQueryHandler::reset(const std::string&)
+{
+	DbProfiler::instance().reset();
+	return "OK";
+}
+
+std::string DbQueryHandler::help(const std::string&)
+{
+	return R"(The "db" queries are used to profile the calls made to the
+observations database by the various components of Meteodata.
+For each method of the database connection and each caller (a connector or
+the REST/UDP servers), the number of calls, the number of failures (calls
+which threw or returned false, which is also how some lookups report a
+missing value), and the total, mean, median (p50), 99th percentile (p99)
+and maximum durations are reported, from the most expensive to the cheapest.
+The percentiles are estimated to within a factor of two.
+
+Available commands :
+- stats [caller]: display the statistics, for all the callers or only one
+- reset: forget the statistics collected so far
+- help: displays this message)";
+}
+
+}
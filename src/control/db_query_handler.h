@@ -0,0 +1,47 @@
+/**
+ * @file db_query_handler.h
+ * @brief Definition of the DbQueryHandler class
+ * @author Laurent Georget
+ * @date 2026-10-18
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef DB_QUERY_HANDLER_H
+#define DB_QUERY_HANDLER_H
+
+#include <string>
+
+#include "query_handler.h"
+
+namespace meteodata
+{
+
+class DbQueryHandler : public QueryHandler
+{
+public:
+	DbQueryHandler();
+	std::string stats(const std::string&);
+	std::string reset(const std::string&);
+	std::string help(const std::string&);
+};
+
+}
+
+
+#endif // DB_QUERY_HANDLER_H
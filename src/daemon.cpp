@@ -66,6 +66,9 @@ int main(int argc, char** argv)
 		("pguser", po::value<std::string>(&serverConfig.pguser), "PostgreSQL database username")
 		("pgpassword", po::value<std::string>(&serverConfig.pgpassword), "PostgreSQL database password")
 		("pghost", po::value<std::string>(&serverConfig.pgaddress), "PostgreSQL database IP address or domain name")
+		("storage", po::value<std::string>(&serverConfig.storage.backend), "storage backend, 'cassandra' (Cassandra and PostgreSQL databases) or 'memory' (in-process stand-in keeping everything in memory, for benchmarks and load tests), defaults to 'cassandra'")
+		("station-table", po::value<std::string>(&serverConfig.storage.stationTable), "with the 'memory' storage, file listing the stations and connectors to serve")
+		("storage-latency", po::value<unsigned long>(&serverConfig.storage.latency), "with the 'memory' storage, delay in microseconds added to each call, defaults to 0")
 		("jobs-db-user", po::value<std::string>(&serverConfig.jobsDbUsername), "asynchronous jobs database username")
 		("jobs-db-password", po::value<std::string>(&serverConfig.jobsDbPassword), "asynchronous jobs database password")
 		("jobs-db-host", po::value<std::string>(&serverConfig.jobsDbAddress), "asynchronous jobs database IP address or domain name")
@@ -78,6 +81,15 @@ int main(int argc, char** argv)
 		("objenious-key", po::value<std::string>(&serverConfig.objeniousApiKey), "api.objenious.com key")
 		("meteofrance-key", po::value<std::string>(&serverConfig.meteofranceApiKey), "Météo France developer portal API key")
 		("ffvl-partner-key", po::value<std::string>(&serverConfig.ffvlPartnerKey), "FFVL partner key necessary to send data their way")
+		("max-loop-lag", po::value<unsigned long>(&serverConfig.maxLoopLag), "delay in seconds above which the threads listening to ASIO events are deemed unresponsive and the systemd watchdog is not notified anymore, defaults to 10")
+		("db-slow-call-threshold", po::value<unsigned long>(&serverConfig.dbSlowCallThreshold), "duration in milliseconds above which a call to the database is logged, 0 to disable, defaults to 1000")
+		("trace-file", po::value<std::string>(&serverConfig.traceFile), "file to append a sample of the ingestion traces to, one JSON object per line")
+		("trace-sample-rate", po::value<unsigned int>(&serverConfig.traceSampleRate), "write one ingestion trace out of this number to the trace file, defaults to 0 (no trace written)")
+		("capture-file", po::value<std::string>(&serverConfig.captureFile), "file to append the raw messages received (MQTT, UDP, HTTP imports) to, for replaying them later with meteodata-replay")
+		("vp2-realtime-period", po::value<unsigned long>(&serverConfig.vp2RealtimePeriod), "period in seconds at which real-time data is requested from the direct-connect Vantage Pro 2 stations between archive downloads, defaults to 0 (never)")
+		("shard-id", po::value<unsigned int>(&serverConfig.shardId), "index, from 0, of the shard of stations handled by this instance, defaults to 0")
+		("shard-count", po::value<unsigned int>(&serverConfig.shardCount), "number of meteodata instances sharing the stations, defaults to 1 (this instance handles all the stations)")
+		("time-acceleration", po::value<double>(&serverConfig.timeAcceleration), "number of simulated seconds per real second for the schedulers, to run throughput tests faster than the real time, defaults to 1 (real time)")
 	;
 
 	po::options_description desc("Allowed options");
@@ -143,6 +155,11 @@ int main(int argc, char** argv)
 		return 0;
 	}
 
+	if (!(serverConfig.timeAcceleration > 0)) {
+		std::cerr << "The time acceleration must be strictly positive" << std::endl;
+		return 1;
+	}
+
 	daemonized = !vm.count("no-daemon");
 	serverConfig.publishJobs = !vm.count("no-async-jobs");
 
@@ -238,8 +255,12 @@ int main(int argc, char** argv)
 		std::vector<std::thread> workers;
 		// start all the workers
 		for (unsigned long i = 0 ; i < threads ; i++) {
-			workers.emplace_back([&]() { ioContext.run(); });
+			workers.emplace_back([&]() {
+				server.getLoopLagMonitor().registerWorker();
+				ioContext.run();
+			});
 		}
+		server.getLoopLagMonitor().start();
 		if (daemonized)
 			sd_notifyf(0, "READY=1\n" "STATUS=Data collection started\n" "MAINPID=%d", getpid());
 		// and wait for them to die
@@ -31,11 +31,12 @@
 #include <boost/system/error_code.hpp>
 #include <boost/asio.hpp>
 #include <date/date.h>
-#include <cassobs/dbconnection_observations.h>
+#include "storage/observations_storage.h"
 #include "async_job_publisher.h"
 
 #include "time_offseter.h"
 #include "async_job_publisher.h"
+#include "monitoring/profiled_db_connection.h"
 
 
 namespace meteodata
@@ -52,7 +53,7 @@ using namespace meteodata;
 class AbstractWeatherlinkDownloader : public std::enable_shared_from_this<AbstractWeatherlinkDownloader>
 {
 public:
-	AbstractWeatherlinkDownloader(const CassUuid& station, DbConnectionObservations& db,
+	AbstractWeatherlinkDownloader(const CassUuid& station, ObservationsStorage& db,
 				  TimeOffseter&& to, AsyncJobPublisher* jobPublisher = nullptr) :
 			_db{db},
 			_jobPublisher{jobPublisher},
@@ -74,7 +75,7 @@ public:
 		_timeOffseter.setMayStoreInsideMeasurements(storeInsideMeasurement);
 	}
 
-	AbstractWeatherlinkDownloader(const CassUuid& station, DbConnectionObservations& db,
+	AbstractWeatherlinkDownloader(const CassUuid& station, ObservationsStorage& db,
 				  TimeOffseter::PredefinedTimezone tz, AsyncJobPublisher* jobPublisher = nullptr) :
 			_db{db},
 			_jobPublisher{jobPublisher},
@@ -101,7 +102,7 @@ protected:
 	 * @brief A connection to the observations database, to store the data
 	 * that is downloaded
 	 */
-	DbConnectionObservations& _db;
+	ProfiledDbConnection _db;
 
 	/**
 	 * @brief An optional asynchronous job publisher, to schedule climatology
@@ -34,9 +34,9 @@
 #include <cassandra.h>
 #include <date/date.h>
 #include <date/tz.h>
-#include <cassobs/dbconnection_observations.h>
 #include <cassobs/message.h>
 
+#include "storage/observations_storage.h"
 #include "../time_offseter.h"
 
 namespace meteodata
@@ -59,7 +59,7 @@ template<typename Msg, char separator = ',', int headerLines = 1>
 class CsvImporter
 {
 public:
-	CsvImporter(const CassUuid& station, const std::string& timezone, DbConnectionObservations& db) :
+	CsvImporter(const CassUuid& station, const std::string& timezone, ObservationsStorage& db) :
 			_station{station},
 			_db{db},
 			_tz{TimeOffseter::getTimeOffseterFor(timezone)}
@@ -150,7 +150,7 @@ public:
 
 private:
 	CassUuid _station;
-	DbConnectionObservations& _db;
+	ObservationsStorage& _db;
 	TimeOffseter _tz;
 	std::vector<std::string> _fields;
 };
@@ -33,8 +33,8 @@
 #include <cassandra.h>
 #include <date/date.h>
 #include <date/tz.h>
-#include <cassobs/dbconnection_observations.h>
 
+#include "storage/observations_storage.h"
 #include "../time_offseter.h"
 
 namespace meteodata
@@ -54,13 +54,13 @@ using namespace meteodata;
 class MileosImporter
 {
 public:
-	MileosImporter(const CassUuid& station, const std::string& timezone, DbConnectionObservations& db);
+	MileosImporter(const CassUuid& station, const std::string& timezone, ObservationsStorage& db);
 	bool import(std::istream& input, date::sys_seconds& start, date::sys_seconds& end,
 				bool updateLastArchiveDownloadTime = false);
 
 private:
 	CassUuid _station;
-	DbConnectionObservations& _db;
+	ObservationsStorage& _db;
 	TimeOffseter _tz;
 	std::vector<std::string> _fields;
 };
@@ -48,7 +48,7 @@ namespace meteodata
 namespace asio = boost::asio;
 namespace chrono = std::chrono;
 
-class DbConnectionObservations;
+class ObservationsStorage;
 
 /**
  * @brief A class able to store an archive page downloaded from a Monitor II (R)
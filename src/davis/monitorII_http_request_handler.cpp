@@ -38,10 +38,11 @@
 #include "async_job_publisher.h"
 #include "davis/monitorII_archive_entry.h"
 #include "davis/monitorII_http_request_handler.h"
+#include "monitoring/ingestion_trace.h"
 
 namespace meteodata
 {
-MonitorIIHttpRequestHandler::MonitorIIHttpRequestHandler(DbConnectionObservations& db,
+MonitorIIHttpRequestHandler::MonitorIIHttpRequestHandler(ObservationsStorage& db,
 	const std::shared_ptr<AsyncJobPublisher>& jobPublisher) :
 		_db{db},
 		_jobPublisher{jobPublisher}
@@ -127,6 +128,7 @@ void MonitorIIHttpRequestHandler::postArchivePage(const Request& request, Respon
 {
 	CassUuid uuid;
 	if (getUuidAndCheckAccess(request, response, uuid, url)) {
+		IngestionTrace::setCurrentStation(uuid);
 		const std::string& content = request.body();
 		std::size_t size = content.size();
 		if (size % sizeof(MonitorIIArchiveEntry::DataPoint) != 0) {
@@ -169,7 +171,9 @@ void MonitorIIHttpRequestHandler::postArchivePage(const Request& request, Respon
 
 				Observation o = message.getObservation(uuid);
 				allObs.push_back(o);
+				IngestionTrace::markCurrent(IngestionTrace::Stage::DECODED);
 				ret = _db.insertV2DataPoint(o);
+				IngestionTrace::markCurrent(IngestionTrace::Stage::STORED);
 			} else {
 				std::cerr << SD_WARNING << "[MonitorII HTTP " << uuid << "] measurement: "
 					  << "record looks invalid for station " << name << ", discarding..." << std::endl;
@@ -188,9 +192,11 @@ void MonitorIIHttpRequestHandler::postArchivePage(const Request& request, Respon
 				std::cerr << SD_ERR << "[MonitorII HTTP " << uuid << "] management: "
 					  << "couldn't update last archive download time for station " << name << std::endl;
 
+			IngestionTrace::markCurrent(IngestionTrace::Stage::STORED);
 			if (_jobPublisher) {
 				_jobPublisher->publishJobsForPastDataInsertion(uuid, oldestArchive, newestArchive);
 			}
+			IngestionTrace::markCurrent(IngestionTrace::Stage::PUBLISHED);
 		} else {
 			std::cerr << SD_ERR << "[MonitorII HTTP " << uuid << "] measurement: " << "failed to store archive for station "
 				  << name << "! Aborting" << std::endl;
@@ -23,11 +23,12 @@
 
 #include <iostream>
 #include <chrono>
+#include <vector>
 
 #include <date/date.h>
 #include <date/tz.h>
-#include <cassobs/dbconnection_observations.h>
 
+#include "storage/observations_storage.h"
 #include "vantagepro2_archive_page.h"
 #include "vantagepro2_message.h"
 #include "vantagepro2_archive_message.h"
@@ -62,20 +63,26 @@ bool VantagePro2ArchivePage::isRelevant(const VantagePro2ArchiveMessage::Archive
 	return false;
 }
 
-bool VantagePro2ArchivePage::store(DbConnectionObservations& db, const CassUuid& station)
+std::vector<Observation> VantagePro2ArchivePage::decode(const CassUuid& station)
 {
-	bool ret = true;
 	std::vector<Observation> allObs;
-	for (int i = 0 ; i < NUMBER_OF_DATA_POINTS_PER_PAGE && ret ; i++) {
+	allObs.reserve(NUMBER_OF_DATA_POINTS_PER_PAGE);
+	for (int i = 0 ; i < NUMBER_OF_DATA_POINTS_PER_PAGE ; i++) {
 		if (isRelevant(_page.points[i])) {
 			VantagePro2ArchiveMessage msg{_page.points[i], _timeOffseter};
-			if (msg.looksValid(_beginning)) {
-				Observation o = msg.getObservation(station);
-				ret = db.insertV2DataPoint(o);
-				allObs.push_back(std::move(o));
-			}
+			if (msg.looksValid(_beginning))
+				allObs.push_back(msg.getObservation(station));
 		}
 	}
+	return allObs;
+}
+
+bool VantagePro2ArchivePage::store(ObservationsStorage& db, const CassUuid& station)
+{
+	bool ret = true;
+	std::vector<Observation> allObs = decode(station);
+	for (auto it = allObs.begin() ; it != allObs.end() && ret ; ++it)
+		ret = db.insertV2DataPoint(*it);
 	ret = ret && db.insertV2DataPointsInTimescaleDB(allObs.begin(), allObs.end());
 	return ret;
 }
@@ -27,8 +27,10 @@
 #include <cstdint>
 #include <iterator>
 #include <chrono>
+#include <vector>
 
 #include <boost/asio.hpp>
+#include <cassobs/observation.h>
 
 #include "vantagepro2_archive_message.h"
 #include "../time_offseter.h"
@@ -44,7 +46,7 @@ namespace meteodata
 namespace asio = boost::asio;
 namespace chrono = std::chrono;
 
-class DbConnectionObservations;
+class ObservationsStorage;
 
 /**
  * @brief A class able to store an archive page downloaded from a VantagePro2 (R)
@@ -77,8 +79,24 @@ public:
 	bool isValid() const;
 
 	/**
+	 * @brief Parse the relevant archive entries of the page
+	 *
+	 * This also updates the timestamp of the most recent archive entry.
+	 *
+	 * @param station The station the page comes from
+	 * @return The observations to insert into the database
+	 */
+	std::vector<Observation> decode(const CassUuid& station);
+
+	/**
+	 * @brief Parse the relevant archive entries of the page and insert
+	 * them into the database
+	 *
+	 * @param db The database connection
+	 * @param station The station the page comes from
+	 * @return True if, and only if, all the entries have been stored
 	 */
-	bool store(DbConnectionObservations& db, const CassUuid& station);
+	bool store(ObservationsStorage& db, const CassUuid& station);
 
 	/**
 	 * @brief Give the timestamp of the most recent relevant archive entry
@@ -26,6 +26,7 @@
 #include <iterator>
 #include <chrono>
 #include <cstring>
+#include <utility>
 #include <systemd/sd-daemon.h>
 #include <systemd/sd-journal.h>
 
@@ -40,7 +41,10 @@
 #include "davis/vantagepro2_connector.h"
 #include "davis/vantagepro2_message.h"
 #include "davis/vantagepro2_archive_page.h"
+#include "async_archive_writer.h"
 #include "event/new_datapoint_event.h"
+#include "event/new_realtime_observation_event.h"
+#include "monitoring/metrics.h"
 
 namespace ip = boost::asio::ip;
 namespace asio = boost::asio;
@@ -53,15 +57,48 @@ namespace meteodata
 using namespace std::placeholders;
 using namespace date;
 
+namespace
+{
+	Gauge& connectedStations()
+	{
+		static Gauge& gauge = MetricsRegistry::instance().gauge("meteodata_vp2_connected_stations",
+			"Number of direct-connect VP2 stations currently connected");
+		return gauge;
+	}
+
+	Counter& archivePagesReceived()
+	{
+		static Counter& counter = MetricsRegistry::instance().counter("meteodata_vp2_archive_pages_total",
+			"Number of archive pages received from direct-connect VP2 stations");
+		return counter;
+	}
+
+	Counter& connectionsFailed()
+	{
+		static Counter& counter = MetricsRegistry::instance().counter("meteodata_vp2_failures_total",
+			"Number of direct-connect VP2 connections aborted by an error");
+		return counter;
+	}
+}
+
 VantagePro2Connector::VantagePro2Connector(boost::asio::io_context& ioContext,
-	DbConnectionObservations& db,
-	const std::shared_ptr<AsyncJobPublisher>& jobPublisher) :
+	ObservationsStorage& db,
+	const std::shared_ptr<AsyncJobPublisher>& jobPublisher,
+	chrono::seconds realtimePeriod) :
 		Connector{ioContext, db},
 		_sock{ioContext},
 		_timer{ioContext},
 		_setTimeTimer{ioContext},
+		_realtimePeriod{realtimePeriod},
 		_jobPublisher{jobPublisher}
 {
+	_db.setCaller("vantagepro2");
+}
+
+VantagePro2Connector::~VantagePro2Connector()
+{
+	if (_started)
+		connectedStations().add(-1);
 }
 
 void VantagePro2Connector::start()
@@ -75,20 +112,21 @@ void VantagePro2Connector::start()
 	_sock.set_option(keepaliveInterval);
 	_sock.set_option(keepaliveProbes);
 
-	_currentState = State::STARTING;
-
 	_status.shortStatus = "Starting";
 	_status.activeSince = date::floor<chrono::seconds>(chrono::system_clock::now());
 	_status.lastReloaded = _status.activeSince;
 	_status.nbDownloads = 0;
 
-	handleEvent(sys::errc::make_error_code(sys::errc::success));
+	if (!_started) {
+		_started = true;
+		connectedStations().add(1);
+	}
+
+	run();
 }
 
-std::shared_ptr<VantagePro2Connector::ArchiveRequestParams>
-VantagePro2Connector::buildArchiveRequestParams(const date::sys_seconds& time)
+void VantagePro2Connector::buildArchiveRequestParams(const date::sys_seconds& time)
 {
-	auto buffer = std::make_shared<VantagePro2Connector::ArchiveRequestParams>();
 	auto timeStation = _timeOffseter.convertToLocalTime(time);
 	auto daypoint = date::floor<date::days>(timeStation);
 	auto ymd = date::year_month_day(daypoint);   // calendar date
@@ -101,37 +139,61 @@ VantagePro2Connector::buildArchiveRequestParams(const date::sys_seconds& time)
 	auto h = tod.hours().count();
 	auto min = tod.minutes().count();
 
-	buffer->date = ((y - 2000) << 9) + (m << 5) + d;
-	buffer->time = h * 100 + min;
-	VantagePro2Message::computeCRC(buffer.get(), 6);
-
-	return buffer;
+	_archiveRequestParams.date = ((y - 2000) << 9) + (m << 5) + d;
+	_archiveRequestParams.time = h * 100 + min;
+	VantagePro2Message::computeCRC(&_archiveRequestParams, 6);
 }
 
-std::shared_ptr<VantagePro2Connector::SettimeRequestParams> VantagePro2Connector::buildSettimeParams()
+void VantagePro2Connector::buildSettimeParams()
 {
-	auto buffer = std::make_shared<VantagePro2Connector::SettimeRequestParams>();
-
 	auto nowLocal = date::floor<chrono::seconds>(_timeOffseter.convertToLocalTime(chrono::system_clock::now()));
 	auto daypoint = date::floor<date::days>(nowLocal);
 	auto ymd = date::year_month_day(daypoint);   // calendar date
 	auto tod = date::make_time(nowLocal - daypoint); // Yields time_of_day type
 
-	buffer->seconds = tod.seconds().count();
-	buffer->minutes = tod.minutes().count();
-	buffer->hours = tod.hours().count();
-	buffer->day = unsigned(ymd.day());
-	buffer->month = unsigned(ymd.month());
-	buffer->year = int(ymd.year()) - 1900;
-	VantagePro2Message::computeCRC(buffer.get(), sizeof(VantagePro2Connector::SettimeRequestParams));
+	_settimeParams.seconds = tod.seconds().count();
+	_settimeParams.minutes = tod.minutes().count();
+	_settimeParams.hours = tod.hours().count();
+	_settimeParams.day = unsigned(ymd.day());
+	_settimeParams.month = unsigned(ymd.month());
+	_settimeParams.year = int(ymd.year()) - 1900;
+	VantagePro2Message::computeCRC(&_settimeParams, sizeof(SettimeRequestParams));
+}
 
-	return buffer;
+auto VantagePro2Connector::resume()
+{
+	auto self(std::static_pointer_cast<VantagePro2Connector>(shared_from_this()));
+	return [this, self, generation = _generation](const sys::error_code& ec, auto&&...) {
+		if (generation != _generation)
+			return;
+		// disarm the deadline, even if it has already expired
+		_operation++;
+		_timer.cancel();
+		if (ec == asio::error::operation_aborted && std::exchange(_timedOut, false))
+			run(sys::errc::make_error_code(sys::errc::timed_out));
+		else
+			run(ec);
+	};
 }
 
-void VantagePro2Connector::waitForNextMeasure()
+void VantagePro2Connector::armDeadline(chrono::steady_clock::duration timeout)
 {
 	auto self(std::static_pointer_cast<VantagePro2Connector>(shared_from_this()));
+	_timedOut = false;
+	_timer.expires_after(timeout);
+	_timer.async_wait([this, self, operation = ++_operation](const sys::error_code& e) {
+		if (e || operation != _operation)
+			return;
+		// The operation handler will resume the engine with the
+		// timeout, the client might leave us before we reach this point
+		_timedOut = true;
+		if (_sock.is_open())
+			_sock.cancel();
+	});
+}
 
+void VantagePro2Connector::waitForNextMeasure()
+{
 	// reset the counters
 	_timeouts = 0;
 	_transmissionErrors = 0;
@@ -139,42 +201,33 @@ void VantagePro2Connector::waitForNextMeasure()
 	auto now = chrono::system_clock::now();
 	auto tp = chrono::minutes(_pollingPeriod) -
 		(now.time_since_epoch() % chrono::minutes(_pollingPeriod));
-	sd_journal_send("MESSAGE=Next measurement scheduled will be taken in %dmin %02ds",
-			chrono::duration_cast<chrono::minutes>(tp).count(),
-			chrono::duration_cast<chrono::seconds>(tp % chrono::minutes(1)).count(),
-			"PRIORITY=%i", LOG_INFO,
-			"STATION=%s", _stationUuid,
-			"CATEGORY=schedule",
-			"CONNECTOR_TYPE=vp2_directconnect",
-			NULL);
-	_timer.expires_after(tp);
 	_status.nextDownload = date::floor<chrono::seconds>(now + tp);
-	_status.shortStatus = "Waiting for the next measure";
-	_timer.async_wait([this, self](const sys::error_code& e) { checkDeadline(e); });
-}
-
-
-void VantagePro2Connector::checkDeadline(const sys::error_code& e)
-{
-	/* if the timer has been cancelled, then give up, we have nothing more
-	 * to do here. It's our original caller's responsability to restart us
-	 * if needs be */
-	if (e == sys::errc::operation_canceled)
-		return;
 
-	// verify that the timeout is not spurious
-	if (_timer.expires_at() <= chrono::steady_clock::now()) {
-		_timeouts++;
-		// The client might leave us before we reach this point
-		if (_sock.is_open())
-			_sock.cancel();
-		handleEvent(sys::errc::make_error_code(sys::errc::timed_out));
+	// In real-time mode, poll the current conditions until the next
+	// archive download, unless it's imminent
+	_realtimeTickDue = _realtimePeriod > chrono::seconds::zero() && tp > _realtimePeriod + chrono::seconds(10);
+	if (_realtimeTickDue) {
+		_timer.expires_after(_realtimePeriod);
+		_status.shortStatus = "Waiting for the next real-time data";
 	} else {
-		/* spurious handler call, restart the timer without changing the
-		 * deadline */
-		auto self(std::static_pointer_cast<VantagePro2Connector>(shared_from_this()));
-		_timer.async_wait([this, self](const sys::error_code& e) { checkDeadline(e); });
+		sd_journal_send("MESSAGE=Next measurement scheduled will be taken in %dmin %02ds",
+				chrono::duration_cast<chrono::minutes>(tp).count(),
+				chrono::duration_cast<chrono::seconds>(tp % chrono::minutes(1)).count(),
+				"PRIORITY=%i", LOG_INFO,
+				"STATION=%s", _stationUuid,
+				"CATEGORY=schedule",
+				"CONNECTOR_TYPE=vp2_directconnect",
+				NULL);
+		_timer.expires_after(tp);
+		_status.shortStatus = "Waiting for the next measure";
 	}
+
+	auto self(std::static_pointer_cast<VantagePro2Connector>(shared_from_this()));
+	_timer.async_wait([this, self, generation = _generation](const sys::error_code& e) {
+		if (e || generation != _generation)
+			return;
+		run();
+	});
 }
 
 void VantagePro2Connector::handleSetTimeDeadline(const sys::error_code& e)
@@ -184,12 +237,7 @@ void VantagePro2Connector::handleSetTimeDeadline(const sys::error_code& e)
 
 	// verify that the timeout is not spurious
 	if (_setTimeTimer.expires_at() <= chrono::steady_clock::now()) {
-		sd_journal_send("MESSAGE=Station clock due to be set ASAP",
-			"PRIORITY=%i", LOG_DEBUG,
-			"STATION=%s", _stationUuid,
-			"CATEGORY=source",
-			"CONNECTOR_TYPE=vp2_directconnect",
-			NULL);
+		log(LOG_DEBUG, "source", "Station clock due to be set ASAP");
 		/* This timer does not interrupt the normal handling of events
 		 * but signals with a flag that the time should be set */
 		_setTimeRequested = true;
@@ -201,10 +249,53 @@ void VantagePro2Connector::handleSetTimeDeadline(const sys::error_code& e)
 	}
 }
 
+void VantagePro2Connector::startArchiveWriter()
+{
+	_archiveWriter = std::make_unique<AsyncArchiveWriter>(_db, _station, "vantagepro2", "VP2 DirectConnect",
+		[this, weakSelf = weak_from_this()](const date::sys_seconds&, const date::sys_seconds& newest) {
+			// Called from the writers pool, publish from the I/O
+			// thread so that the subscribers do not run on the
+			// pool. Do not take a reference to the connector here,
+			// the pool must never be the one destroying it, the
+			// writer would wait for itself.
+			asio::post(_ioContext, [this, weakSelf, newest]() {
+				auto self = weakSelf.lock();
+				if (!self)
+					return;
+				NewDatapointEvent event{_station, date::floor<chrono::seconds>(chrono::system_clock::now()), newest};
+				publish(event);
+				publish(event, _station);
+			});
+		}
+	);
+}
+
+void VantagePro2Connector::waitForArchiveWriter()
+{
+	_archiveWriter->finish([this, weakSelf = weak_from_this(), generation = _generation](bool success, const date::sys_seconds& oldest, const date::sys_seconds& newest) {
+		// Called from the writers pool, resume the engine from the I/O
+		// thread, the reference to the connector is only taken there
+		asio::post(_ioContext, [this, weakSelf, generation, success, oldest, newest]() {
+			auto self = weakSelf.lock();
+			if (!self || generation != _generation)
+				return;
+			if (oldest < _oldestArchive)
+				_oldestArchive = oldest;
+			if (newest > _newestArchive)
+				_newestArchive = newest;
+			run(success ?
+				sys::errc::make_error_code(sys::errc::success) :
+				sys::errc::make_error_code(sys::errc::io_error));
+		});
+	});
+}
+
 void VantagePro2Connector::stop()
 {
-	/* hijack the state machine to force STOPPED state */
-	_currentState = State::STOPPED;
+	/* forget about all pending operations */
+	_generation++;
+	_operation++;
+	_stopped = true;
 	/* cancel all asynchronous event handlers */
 	_timer.cancel();
 	_setTimeTimer.cancel();
@@ -222,764 +313,481 @@ void VantagePro2Connector::stop()
 
 void VantagePro2Connector::reload()
 {
-	// reset the state machine, disregarding what was going on
+	if (_stopped)
+		return;
+
+	// restart the engine from the beginning, disregarding what was going
+	// on
+	_generation++;
+	_operation++;
 	_timer.cancel();
 	_setTimeTimer.cancel();
-	flushSocketAndRetry(State::SENDING_WAKE_UP_STATION, [this]() { sendRequest(_echoRequest, sizeof(_echoRequest) - 1); });
+	if (_sock.is_open())
+		_sock.cancel();
+	_coro = asio::coroutine{};
+	_flushBeforeRetry = true;
+	_timeouts = 0;
+	_transmissionErrors = 0;
 	_status.lastReloaded = date::floor<chrono::seconds>(chrono::system_clock::now());
+	run();
 }
 
-void VantagePro2Connector::sendRequest(const char* req, int reqsize)
+void VantagePro2Connector::sendRequest(const void* req, std::size_t reqsize)
 {
-	auto self(std::static_pointer_cast<VantagePro2Connector>(shared_from_this()));
-	countdown(chrono::seconds(6));
-	async_write(_sock, asio::buffer(req, reqsize), [this, self](const sys::error_code& ec, std::size_t) {
-		if (ec == sys::errc::operation_canceled)
-			return;
-		_timer.cancel();
-		handleEvent(ec);
-	});
-}
-
-template<typename T>
-void VantagePro2Connector::sendBuffer(const std::shared_ptr<T>& buffer, int reqsize)
-{
-	auto self(std::static_pointer_cast<VantagePro2Connector>(shared_from_this()));
-	countdown(chrono::seconds(6));
-
-	// passing buffer to the lambda keeps the buffer alive
-	async_write(_sock, asio::buffer(buffer.get(), reqsize),
-				[this, self, buffer](const sys::error_code& ec, std::size_t) {
-					if (ec == sys::errc::operation_canceled)
-						return;
-					_timer.cancel();
-					handleEvent(ec);
-				});
+	armDeadline(chrono::seconds(6));
+	async_write(_sock, asio::buffer(req, reqsize), resume());
 }
 
 void VantagePro2Connector::recvWakeUp()
 {
-	auto self(std::static_pointer_cast<VantagePro2Connector>(shared_from_this()));
-	countdown(chrono::seconds(2));
-	async_read_until(_sock, _discardBuffer, "\n\r", [this, self](const sys::error_code& ec, std::size_t n) {
-		if (ec == sys::errc::operation_canceled)
-			return;
-		_timer.cancel();
-		_discardBuffer.consume(n);
-		handleEvent(ec);
+	armDeadline(chrono::seconds(2));
+	async_read_until(_sock, _discardBuffer, "\n\r", [this, handler = resume()](const sys::error_code& ec, std::size_t n) {
+		if (!ec)
+			_discardBuffer.consume(n);
+		handler(ec);
 	});
 }
 
 void VantagePro2Connector::recvOk()
 {
-	auto self(std::static_pointer_cast<VantagePro2Connector>(shared_from_this()));
-	countdown(chrono::seconds(6));
-	async_read_until(_sock, _discardBuffer, "OK\n\r", [this, self](const sys::error_code& ec, std::size_t n) {
-		if (ec == sys::errc::operation_canceled)
-			return;
-		_timer.cancel();
-		_discardBuffer.consume(n);
-		handleEvent(ec);
+	armDeadline(chrono::seconds(6));
+	async_read_until(_sock, _discardBuffer, "OK\n\r", [this, handler = resume()](const sys::error_code& ec, std::size_t n) {
+		if (!ec)
+			_discardBuffer.consume(n);
+		handler(ec);
 	});
 }
 
-void VantagePro2Connector::sendAck()
+template<typename Handler>
+void VantagePro2Connector::readAck(Handler&& handler)
 {
-	sendRequest(_ack, 1);
-}
-
-void VantagePro2Connector::sendNak()
-{
-	sendRequest(_nak, 1);
-}
-
-void VantagePro2Connector::sendAbort()
-{
-	sendRequest(_abort, 1);
-}
-
-void VantagePro2Connector::recvAck()
-{
-	auto self(std::static_pointer_cast<VantagePro2Connector>(shared_from_this()));
-	countdown(chrono::seconds(6));
-	async_read(_sock, asio::buffer(&_ackBuffer, 1), [this, self](const sys::error_code& ec, std::size_t) {
-		if (ec == sys::errc::operation_canceled)
-			return;
-		_timer.cancel();
-		if (_ackBuffer == '\n' || _ackBuffer == '\r') {
+	async_read(_sock, asio::buffer(&_ackBuffer, 1), [this, handler = std::forward<Handler>(handler)](const sys::error_code& ec, std::size_t) mutable {
+		if (!ec && (_ackBuffer == '\n' || _ackBuffer == '\r')) {
 			//we eat some garbage, discard and carry on
-			recvAck();
+			readAck(std::move(handler));
 		} else {
-			handleEvent(ec);
+			handler(ec);
 		}
 	});
 }
 
+void VantagePro2Connector::recvAck()
+{
+	armDeadline(chrono::seconds(6));
+	readAck(resume());
+}
+
 template<typename MutableBuffer>
 void VantagePro2Connector::recvData(const MutableBuffer& buffer)
 {
-	auto self(std::static_pointer_cast<VantagePro2Connector>(shared_from_this()));
-	countdown(chrono::seconds(6));
-	async_read(_sock, buffer, [this, self](const sys::error_code& ec, std::size_t) {
-		if (ec == sys::errc::operation_canceled)
-			return;
-		_timer.cancel();
-		handleEvent(ec);
-	});
+	armDeadline(chrono::seconds(6));
+	async_read(_sock, buffer, resume());
 }
 
-template<typename Restarter>
-void VantagePro2Connector::flushSocketAndRetry(State restartState, Restarter restart)
+void VantagePro2Connector::flushSocket()
 {
-	auto self(std::static_pointer_cast<VantagePro2Connector>(shared_from_this()));
 	// wait before flushing in order not to leave garbage behind
-	_timer.expires_from_now(chrono::seconds(10));
-	_timer.async_wait([restartState, restart, this, self](const sys::error_code& ec) {
-		if (ec == sys::errc::operation_canceled)
+	_timer.expires_after(chrono::seconds(10));
+	_timer.async_wait([this, handler = resume()](const sys::error_code& ec) mutable {
+		sys::error_code e;
+		std::size_t available = ec ? 0 : _sock.available(e);
+		if (ec || e || available == 0) {
+			handler(ec ? ec : e);
 			return;
-		if (_sock.available() > 0) {
-			auto bufs = _discardBuffer.prepare(512);
-			std::size_t bytes = _sock.receive(bufs);
-			_discardBuffer.commit(bytes);
-			_discardBuffer.consume(_discardBuffer.size());
 		}
-		_currentState = restartState;
-		restart();
+		// there's something to read, the read won't block
+		_discardBuffer.consume(_discardBuffer.size());
+		_sock.async_read_some(_discardBuffer.prepare(available), [this, handler = std::move(handler)](const sys::error_code& ec, std::size_t n) {
+			_discardBuffer.commit(n);
+			_discardBuffer.consume(_discardBuffer.size());
+			handler(ec);
+		});
 	});
 }
 
-template<typename Restarter>
-void VantagePro2Connector::handleGenericErrors(const sys::error_code& e, State restartState, Restarter restart)
+bool VantagePro2Connector::retryAfter(const sys::error_code& ec)
 {
-	/* In case of success, we are done here, the main code in the state
-	 * machine will do its job
-	 *
-	 * if the operation has been canceled, then we let the control to the
-	 * timer handler running concurrently
-	 * For example:
-	 * Normal execution:
-	 * - the async_wait is started on the timer
-	 * - the async_read starts on the socket
-	 * - the async_read completes with success
-	 * - the async_wait gets cancelled
-	 *   => we let the async_read handler send its success event to the
-	 *   state machine
-	 *   (the timer's operation_canceled event has been discarded in
-	 *   checkDeadline, above)
-	 *
-	 * Timeout execution:
-	 * - the async_wait is started on the timer
-	 * - the async_read starts on the socket
-	 * - the async_wait completes before the async_read
-	 * - the async_read gets cancelled
-	 *   => we let the async_wait handler send its timed_out event to the
-	 *   state machine and discard the socket's operation_canceled event
-	 */
-	if (e == sys::errc::success || e == sys::errc::operation_canceled) {
-		return;
-	} else if (e == sys::errc::timed_out) {
+	if (ec == sys::errc::timed_out) {
 		if (++_timeouts < 5) {
-			_currentState = restartState;
-			flushSocketAndRetry(restartState, restart);
-		} else {
-			sd_journal_send("MESSAGE=Too many timeouts, aborting connection",
-				"PRIORITY=%i", LOG_CRIT,
-				"STATION=%s", _stationUuid,
-				"CATEGORY=source",
-				"CONNECTOR_TYPE=vp2_directconnect",
-				NULL);
-			stop();
+			_flushBeforeRetry = true;
+			return true;
 		}
+		fail("Too many timeouts, aborting connection", "source");
 	} else { /* TCP reset by peer, etc. */
-		sd_journal_send("MESSAGE=Unknown network error, aborting connection",
-			"PRIORITY=%i", LOG_CRIT,
-			"STATION=%s", _stationUuid,
-			"CATEGORY=source",
-			"CONNECTOR_TYPE=vp2_directconnect",
-			NULL);
-		stop();
+		fail("Unknown network error, aborting connection", "source");
 	}
+	return false;
 }
 
-void VantagePro2Connector::handleEvent(const sys::error_code& e)
+bool VantagePro2Connector::retryAfterTransmissionError(const char* message)
 {
-	auto requestEcho = [this]() { sendRequest(_echoRequest, sizeof(_echoRequest) - 1); };
-	auto requestStation = [this]() { sendRequest(_getStationRequest, sizeof(_getStationRequest) - 1); };
-	auto requestMainMode = [this]() { sendRequest(_mainModeRequest, sizeof(_mainModeRequest) - 1); };
-	auto requestTimezone = [this]() { sendRequest(_getTimezoneRequest, sizeof(_getTimezoneRequest) - 1); };
-	auto requestArchive = [this]() { sendRequest(_getArchiveRequest, sizeof(_getArchiveRequest) - 1); };
-	auto requestSetTime = [this]() { sendRequest(_settimeRequest, sizeof(_settimeRequest) - 1); };
-
-	switch (_currentState) {
-		case State::STARTING:
-			_currentState = State::SENDING_WAKE_UP_STATION;
-			requestEcho();
-			_status.shortStatus = "Waking up station";
-			break;
+	if (++_transmissionErrors < 5) {
+		_flushBeforeRetry = true;
+		return true;
+	}
+	fail(message);
+	return false;
+}
 
-		case State::WAITING_NEXT_MEASURE_TICK:
-			if (e == sys::errc::timed_out) {
-				_currentState = State::SENDING_WAKE_UP_ARCHIVE;
-				sd_journal_send("MESSAGE=New measurement due",
-					"PRIORITY=%i", LOG_DEBUG,
-					"STATION=%s", _stationUuid,
-					"CATEGORY=schedule",
-					"CONNECTOR_TYPE=vp2_directconnect",
-					NULL);
-				requestEcho();
-				_status.shortStatus = "Waking up station";
-			} else {
-				waitForNextMeasure();
-				_status.shortStatus = "Waiting for next measurement time";
-			}
-			break;
+void VantagePro2Connector::log(int priority, const char* category, const char* message)
+{
+	sd_journal_send("MESSAGE=%s", message,
+		"PRIORITY=%i", priority,
+		"STATION=%s", _stationUuid,
+		"CATEGORY=%s", category,
+		"CONNECTOR_TYPE=vp2_directconnect",
+		NULL);
+}
 
-		case State::SENDING_WAKE_UP_STATION:
-			handleGenericErrors(e, State::SENDING_WAKE_UP_STATION, requestEcho);
-			if (e == sys::errc::success) {
-				_currentState = State::WAITING_ECHO_STATION;
-				recvWakeUp();
-			}
-			break;
+void VantagePro2Connector::fail(const char* message, const char* category)
+{
+	connectionsFailed().increment();
+	log(LOG_CRIT, category, message);
+	stop();
+}
 
-		case State::WAITING_ECHO_STATION:
-			handleGenericErrors(e, State::SENDING_WAKE_UP_STATION, requestEcho);
-			if (e == sys::errc::success) {
-				_currentState = State::SENDING_REQ_STATION;
-				requestStation();
-				_status.shortStatus = "Waiting for station identification";
-			}
-			break;
+bool VantagePro2Connector::identifyStation()
+{
+	// From documentation, latitude, longitude and elevation are stored contiguously
+	// in this order in the station's EEPROM
+	time_t lastArchiveDownloadTime;
+	bool storeInsideMeasurements;
+	bool found = _db.getStationByCoords(_coords[2], _coords[0], _coords[1], _station, _stationName,
+		_pollingPeriod, lastArchiveDownloadTime, &storeInsideMeasurements);
+	if (!found) {
+		sd_journal_send("MESSAGE=Unidentifiable station (%.2f,%.2f,%d) has showed up", _coords[0], _coords[1], _coords[2],
+			"PRIORITY=%i", LOG_CRIT,
+			"CATEGORY=configuration",
+			"CONNECTOR_TYPE=vp2_directconnect",
+			NULL);
+		return false;
+	}
 
-		case State::SENDING_REQ_STATION:
-			handleGenericErrors(e, State::SENDING_REQ_STATION, requestStation);
-			if (e == sys::errc::success) {
-				_currentState = State::WAITING_ACK_STATION;
-				recvAck();
-			}
-			break;
+	cass_uuid_string(_station, _stationUuid);
+	_timeOffseter.setLatitude(_coords[0]);
+	_timeOffseter.setLongitude(_coords[1]);
+	_timeOffseter.setElevation(_coords[2]);
+	_timeOffseter.setMeasureStep(_pollingPeriod);
+	_timeOffseter.setMayStoreInsideMeasurements(storeInsideMeasurements);
+	_lastArchive = date::sys_seconds(chrono::seconds(lastArchiveDownloadTime));
+	sd_journal_send("MESSAGE=Station %s is connected", _stationName.c_str(),
+		"PRIORITY=%i", LOG_INFO,
+		"STATION=%s", _stationUuid,
+		"CATEGORY=source",
+		"CONNECTOR_TYPE=vp2_directconnect",
+		NULL);
+	return true;
+}
 
-		case State::WAITING_ACK_STATION:
-			handleGenericErrors(e, State::SENDING_REQ_STATION, requestStation);
-			if (e == sys::errc::success) {
-				if (_ackBuffer != 0x06) {
-					if (++_transmissionErrors < 5) {
-						flushSocketAndRetry(State::SENDING_REQ_STATION, requestStation);
-					} else {
-						sd_journal_send("MESSAGE=Station did not acknowledge the identification request, aborting",
-							"PRIORITY=%i", LOG_CRIT,
-							"CATEGORY=communication",
-							"CONNECTOR_TYPE=vp2_directconnect",
-							NULL);
-						stop();
-					}
-				} else {
-					_currentState = State::WAITING_DATA_STATION;
-					recvData(asio::buffer(_coords));
-				}
+/* Each exchange with the station is a loop that is started over after a
+ * recoverable error: retryAfter() and retryAfterTransmissionError() count
+ * the errors and ask for the socket to be flushed before the next attempt.
+ * No variable can live across a BOOST_ASIO_CORO_YIELD, everything the engine
+ * needs to remember is a member of the connector. */
+void VantagePro2Connector::run(sys::error_code ec)
+{
+	BOOST_ASIO_CORO_REENTER(_coro) {
+		_status.shortStatus = "Waking up station";
+		for (;;) {
+			if (_flushBeforeRetry) {
+				_flushBeforeRetry = false;
+				BOOST_ASIO_CORO_YIELD flushSocket();
 			}
-			break;
-
-		case State::WAITING_DATA_STATION:
-			handleGenericErrors(e, State::SENDING_REQ_STATION, requestStation);
-			if (e == sys::errc::success) {
-				if (!VantagePro2Message::validateCRC(_coords, sizeof(_coords))) {
-					if (++_transmissionErrors < 5) {
-						flushSocketAndRetry(State::SENDING_REQ_STATION, requestStation);
-					} else {
-						sd_journal_send("MESSAGE=Transmission error during the identification request, aborting",
-							"PRIORITY=%i", LOG_CRIT,
-							"CATEGORY=communication",
-							"CONNECTOR_TYPE=vp2_directconnect",
-							NULL);
-						stop();
-					}
-				} else {
-					// From documentation, latitude, longitude and elevation are stored contiguously
-					// in this order in the station's EEPROM
-					time_t lastArchiveDownloadTime;
-					bool storeInsideMeasurements;
-					bool found = _db.getStationByCoords(_coords[2], _coords[0], _coords[1], _station, _stationName,
-						_pollingPeriod, lastArchiveDownloadTime, &storeInsideMeasurements);
-					cass_uuid_string(_station, _stationUuid);
-					_timeOffseter.setLatitude(_coords[0]);
-					_timeOffseter.setLongitude(_coords[1]);
-					_timeOffseter.setElevation(_coords[2]);
-					_timeOffseter.setMeasureStep(_pollingPeriod);
-					_timeOffseter.setMayStoreInsideMeasurements(storeInsideMeasurements);
-					_lastArchive = date::sys_seconds(chrono::seconds(lastArchiveDownloadTime));
-					if (found) {
-						sd_journal_send("MESSAGE=Station %s is connected", _stationName,
-							"PRIORITY=%i", LOG_INFO,
-							"STATION=%s", _stationUuid,
-							"CATEGORY=source",
-							"CONNECTOR_TYPE=vp2_directconnect",
-							NULL);
-						_currentState = State::SENDING_REQ_MAIN_MODE;
-						requestMainMode();
-						_status.shortStatus = "Waiting for station ack to main configuration";
-					} else {
-						sd_journal_send("MESSAGE=Unidentifiable station (%.2f,%.2f,%d) has showed up", _coords[0], _coords[1], _coords[2],
-							"PRIORITY=%i", LOG_CRIT,
-							"CATEGORY=configuration",
-							"CONNECTOR_TYPE=vp2_directconnect",
-							NULL);
-						stop();
-					}
-				}
+			BOOST_ASIO_CORO_YIELD sendRequest(_echoRequest, sizeof(_echoRequest) - 1);
+			if (ec) { if (retryAfter(ec)) continue; return; }
+			BOOST_ASIO_CORO_YIELD recvWakeUp();
+			if (ec) { if (retryAfter(ec)) continue; return; }
+
+			_status.shortStatus = "Waiting for station identification";
+			BOOST_ASIO_CORO_YIELD sendRequest(_getStationRequest, sizeof(_getStationRequest) - 1);
+			if (ec) { if (retryAfter(ec)) continue; return; }
+			BOOST_ASIO_CORO_YIELD recvAck();
+			if (ec) { if (retryAfter(ec)) continue; return; }
+			if (_ackBuffer != _ack[0]) {
+				if (retryAfterTransmissionError("Station did not acknowledge the identification request, aborting"))
+					continue;
+				return;
 			}
-			break;
-
-		case State::SENDING_REQ_MAIN_MODE:
-			handleGenericErrors(e, State::SENDING_REQ_MAIN_MODE, requestMainMode);
-			if (e == sys::errc::success) {
-				_currentState = State::WAITING_ACK_MAIN_MODE;
-				recvOk();
+			BOOST_ASIO_CORO_YIELD recvData(asio::buffer(_coords));
+			if (ec) { if (retryAfter(ec)) continue; return; }
+			if (!VantagePro2Message::validateCRC(_coords, sizeof(_coords))) {
+				if (retryAfterTransmissionError("Transmission error during the identification request, aborting"))
+					continue;
+				return;
 			}
 			break;
+		}
 
-		case State::WAITING_ACK_MAIN_MODE:
-			handleGenericErrors(e, State::SENDING_REQ_MAIN_MODE, requestMainMode);
-			if (e == sys::errc::success) {
-				_currentState = State::SENDING_REQ_TIMEZONE;
-				requestTimezone();
-			} else {
-				sd_journal_send("MESSAGE=Transmission error during ACK_MAIN_MODE command, aborting",
-					"PRIORITY=%i", LOG_CRIT,
-					"STATION=%s", _stationUuid,
-					"CATEGORY=communication",
-					"CONNECTOR_TYPE=vp2_directconnect",
-					NULL);
-				stop();
-			}
-			break;
+		if (!identifyStation()) {
+			stop();
+			return;
+		}
 
-		case State::SENDING_REQ_TIMEZONE:
-			handleGenericErrors(e, State::SENDING_REQ_TIMEZONE, requestTimezone);
-			if (e == sys::errc::success) {
-				_currentState = State::WAITING_ACK_TIMEZONE;
-				recvAck();
-				_status.shortStatus = "Waiting for station timezone";
+		_status.shortStatus = "Waiting for station ack to main configuration";
+		for (;;) {
+			if (_flushBeforeRetry) {
+				_flushBeforeRetry = false;
+				BOOST_ASIO_CORO_YIELD flushSocket();
 			}
-			break;
-
-		case State::WAITING_ACK_TIMEZONE:
-			handleGenericErrors(e, State::SENDING_REQ_TIMEZONE, requestTimezone);
-			if (e == sys::errc::success) {
-				if (_ackBuffer != 0x06) {
-					if (++_transmissionErrors < 5) {
-						flushSocketAndRetry(State::SENDING_REQ_TIMEZONE, requestTimezone);
-					} else {
-						sd_journal_send("MESSAGE=Transmission error at ACK_TIMEZONE, aborting",
-							"PRIORITY=%i", LOG_CRIT,
-							"STATION=%s", _stationUuid,
-							"CATEGORY=communication",
-							"CONNECTOR_TYPE=vp2_directconnect",
-							NULL);
-						stop();
-					}
-				} else {
-					_currentState = State::WAITING_DATA_TIMEZONE;
-					recvData(asio::buffer(&_timezoneBuffer, sizeof(_timezoneBuffer)));
-				}
+			BOOST_ASIO_CORO_YIELD sendRequest(_mainModeRequest, sizeof(_mainModeRequest) - 1);
+			if (ec) { if (retryAfter(ec)) continue; return; }
+			BOOST_ASIO_CORO_YIELD recvOk();
+			if (ec) {
+				fail("Transmission error during ACK_MAIN_MODE command, aborting");
+				return;
 			}
 			break;
+		}
 
-		case State::WAITING_DATA_TIMEZONE:
-			handleGenericErrors(e, State::SENDING_REQ_TIMEZONE, requestTimezone);
-			if (e == sys::errc::success) {
-				if (!VantagePro2Message::validateCRC(_coords, sizeof(_coords))) {
-					if (++_transmissionErrors < 5) {
-						flushSocketAndRetry(State::SENDING_REQ_TIMEZONE, requestTimezone);
-					} else {
-						sd_journal_send("MESSAGE=Transmission error at DATA_TIMEZONE, aborting",
-							"PRIORITY=%i", LOG_CRIT,
-							"STATION=%s", _stationUuid,
-							"CATEGORY=communication",
-							"CONNECTOR_TYPE=vp2_directconnect",
-							NULL);
-						stop();
-					}
-				} else {
-					_timeOffseter.prepare(_timezoneBuffer);
-					_archivePage.prepare(_lastArchive, &_timeOffseter);
-					chrono::system_clock::time_point now = chrono::system_clock::now();
-					std::string lastArchive = date::format("%Y-%m-%dT%H:%M:%SZ", _lastArchive);
-					sd_journal_send("MESSAGE=Last data from station dates back from %s", lastArchive.c_str(),
-						"PRIORITY=%i", LOG_DEBUG,
-						"STATION=%s", _stationUuid,
-						"CATEGORY=storage",
-						"CONNECTOR_TYPE=vp2_directconnect",
-						NULL);
-					if ((now - _lastArchive) > chrono::minutes(_pollingPeriod)) {
-						sd_journal_send("MESSAGE=Station disconnected for too long, retrieving the archives...",
-							"PRIORITY=%i", LOG_NOTICE,
-							"STATION=%s", _stationUuid,
-							"CATEGORY=source",
-							"CONNECTOR_TYPE=vp2_directconnect",
-							NULL);
-						_currentState = State::SENDING_WAKE_UP_ARCHIVE;
-						requestEcho();
-					} else {
-						_currentState = State::SENDING_WAKE_UP_SETTIME;
-						requestEcho();
-					}
-				}
+		_status.shortStatus = "Waiting for station timezone";
+		for (;;) {
+			if (_flushBeforeRetry) {
+				_flushBeforeRetry = false;
+				BOOST_ASIO_CORO_YIELD flushSocket();
 			}
-			break;
-
-		case State::SENDING_WAKE_UP_ARCHIVE:
-			handleGenericErrors(e, State::SENDING_WAKE_UP_ARCHIVE, requestEcho);
-			if (e == sys::errc::success) {
-				_currentState = State::WAITING_ECHO_ARCHIVE;
-				recvWakeUp();
-				_status.shortStatus = "Waiting for archive download";
+			BOOST_ASIO_CORO_YIELD sendRequest(_getTimezoneRequest, sizeof(_getTimezoneRequest) - 1);
+			if (ec) { if (retryAfter(ec)) continue; return; }
+			BOOST_ASIO_CORO_YIELD recvAck();
+			if (ec) { if (retryAfter(ec)) continue; return; }
+			if (_ackBuffer != _ack[0]) {
+				if (retryAfterTransmissionError("Transmission error at ACK_TIMEZONE, aborting"))
+					continue;
+				return;
 			}
-			break;
-
-		case State::WAITING_ECHO_ARCHIVE:
-			handleGenericErrors(e, State::SENDING_WAKE_UP_ARCHIVE, requestEcho);
-			if (e == sys::errc::success) {
-				_currentState = State::SENDING_REQ_ARCHIVE;
-				requestArchive();
+			BOOST_ASIO_CORO_YIELD recvData(asio::buffer(&_timezoneAnswer, sizeof(_timezoneAnswer)));
+			if (ec) { if (retryAfter(ec)) continue; return; }
+			if (!VantagePro2Message::validateCRC(&_timezoneAnswer, sizeof(_timezoneAnswer))) {
+				if (retryAfterTransmissionError("Transmission error at DATA_TIMEZONE, aborting"))
+					continue;
+				return;
 			}
 			break;
+		}
 
-		case State::SENDING_REQ_ARCHIVE:
-			handleGenericErrors(e, State::SENDING_REQ_ARCHIVE, requestArchive);
-			if (e == sys::errc::success) {
-				_currentState = State::WAITING_ACK_ARCHIVE;
-				recvAck();
-			}
-			break;
+		_timeOffseter.prepare(_timezoneAnswer.timezone);
+		_archivePage.prepare(_lastArchive, &_timeOffseter);
+		{
+			std::string lastArchive = date::format("%Y-%m-%dT%H:%M:%SZ", _lastArchive);
+			sd_journal_send("MESSAGE=Last data from station dates back from %s", lastArchive.c_str(),
+				"PRIORITY=%i", LOG_DEBUG,
+				"STATION=%s", _stationUuid,
+				"CATEGORY=storage",
+				"CONNECTOR_TYPE=vp2_directconnect",
+				NULL);
+		}
+		_archiveDue = chrono::system_clock::now() - _lastArchive > chrono::minutes(_pollingPeriod);
+		if (_archiveDue)
+			log(LOG_NOTICE, "source", "Station disconnected for too long, retrieving the archives...");
 
-		case State::WAITING_ACK_ARCHIVE:
-			handleGenericErrors(e, State::SENDING_REQ_ARCHIVE, requestArchive);
-			if (e == sys::errc::success) {
-				if (_ackBuffer != 0x06) {
-					if (++_transmissionErrors < 5) {
-						flushSocketAndRetry(State::SENDING_REQ_ARCHIVE, requestArchive);
-					} else {
-						sd_journal_send("MESSAGE=Transmission error at REQ_ARCHIVE, aborting",
-							"PRIORITY=%i", LOG_CRIT,
-							"STATION=%s",
-							"CATEGORY=communication",
-							"CONNECTOR_TYPE=vp2_directconnect",
-							NULL);
-						stop();
+		for (;;) {
+			if (_archiveDue) {
+				_status.shortStatus = "Waiting for archive download";
+				for (;;) {
+					if (_flushBeforeRetry) {
+						_flushBeforeRetry = false;
+						BOOST_ASIO_CORO_YIELD flushSocket();
 					}
-				} else {
-					_currentState = State::SENDING_ARCHIVE_PARAMS;
-					auto buffer = buildArchiveRequestParams(_lastArchive);
-					sendBuffer(buffer, sizeof(ArchiveRequestParams));
+					BOOST_ASIO_CORO_YIELD sendRequest(_echoRequest, sizeof(_echoRequest) - 1);
+					if (ec) { if (retryAfter(ec)) continue; return; }
+					BOOST_ASIO_CORO_YIELD recvWakeUp();
+					if (ec) { if (retryAfter(ec)) continue; return; }
+					BOOST_ASIO_CORO_YIELD sendRequest(_getArchiveRequest, sizeof(_getArchiveRequest) - 1);
+					if (ec) { if (retryAfter(ec)) continue; return; }
+					BOOST_ASIO_CORO_YIELD recvAck();
+					if (ec) { if (retryAfter(ec)) continue; return; }
+					if (_ackBuffer != _ack[0]) {
+						if (retryAfterTransmissionError("Transmission error at REQ_ARCHIVE, aborting"))
+							continue;
+						return;
+					}
+					break;
 				}
-			}
-			break;
 
-		case State::SENDING_ARCHIVE_PARAMS:
-			// We cannot retry anything here, we are in the middle of a request, just give up
-			if (e != sys::errc::success) {
-				sd_journal_send("MESSAGE=Transmission error at SENDING_ARCHIVE_PARAMS, aborting",
-						"PRIORITY=%i", LOG_CRIT,
-						"STATION=%s", _stationUuid,
-						"CATEGORY=communication",
-						"CONNECTOR_TYPE=vp2_directconnect",
-						NULL);
-				stop();
-			} else {
-				_currentState = State::WAITING_ACK_ARCHIVE_PARAMS;
-				recvAck();
-			}
-			break;
-
-		case State::WAITING_ACK_ARCHIVE_PARAMS:
-			// We cannot retry anything here, we are in the middle of a request, just give up
-			if (e != sys::errc::success) {
-				sd_journal_send("MESSAGE=Transmission error at ACK_ARCHIVE_PARAMS, aborting",
-						"PRIORITY=%i", LOG_CRIT,
-						"STATION=%s", _stationUuid,
-						"CATEGORY=communication",
-						"CONNECTOR_TYPE=vp2_directconnect",
-						NULL);
-				stop();
-			} else {
-				if (_ackBuffer != 0x06) {
-					sd_journal_send("MESSAGE=Transmission error at ACK_ARCHIVE_PARAMS, aborting",
-							"PRIORITY=%i", LOG_CRIT,
-							"STATION=%s", _stationUuid,
-							"CATEGORY=communication",
-							"CONNECTOR_TYPE=vp2_directconnect",
-							NULL);
-					stop();
-				} else {
-					_currentState = State::WAITING_ARCHIVE_NB_PAGES;
-					recvData(asio::buffer(&_archiveSize, sizeof(_archiveSize)));
+				// We cannot retry anything from now on, we are in the
+				// middle of a request, just give up on errors
+				buildArchiveRequestParams(_lastArchive);
+				BOOST_ASIO_CORO_YIELD sendRequest(&_archiveRequestParams, sizeof(_archiveRequestParams));
+				if (ec) {
+					fail("Transmission error at SENDING_ARCHIVE_PARAMS, aborting");
+					return;
+				}
+				BOOST_ASIO_CORO_YIELD recvAck();
+				if (ec || _ackBuffer != _ack[0]) {
+					fail("Transmission error at ACK_ARCHIVE_PARAMS, aborting");
+					return;
+				}
+				BOOST_ASIO_CORO_YIELD recvData(asio::buffer(&_archiveSize, sizeof(_archiveSize)));
+				if (ec) {
+					fail("Transmission error at ARCHIVE_NB_PAGES, aborting");
+					return;
 				}
-			}
-			break;
 
-		case State::WAITING_ARCHIVE_NB_PAGES:
-			// We cannot retry anything here, we are in the middle of a request, just give up
-			if (e != sys::errc::success) {
-				sd_journal_send("MESSAGE=Transmission error at ARCHIVE_NB_PAGES, aborting",
-						"PRIORITY=%i", LOG_CRIT,
-						"STATION=%s", _stationUuid,
-						"CATEGORY=communication",
-						"CONNECTOR_TYPE=vp2_directconnect",
-						NULL);
-				stop();
-			} else {
-				if (VantagePro2Message::validateCRC(&_archiveSize, sizeof(_archiveSize))) {
-					_currentState = State::SENDING_ACK_ARCHIVE_DOWNLOAD;
+				if (!VantagePro2Message::validateCRC(&_archiveSize, sizeof(_archiveSize))) {
+					log(LOG_ERR, "communication", "Wrong CRC at ARCHIVE_NB_PAGES");
+					BOOST_ASIO_CORO_YIELD sendRequest(_abort, 1);
+					if (ec) {
+						fail("Transmission error at ABORT_ARCHIVE_DOWNLOAD, aborting");
+						return;
+					}
+				} else {
+					startArchiveWriter();
 					sd_journal_send("MESSAGE=Expecting %d pages, first record at %d", _archiveSize.pagesLeft, _archiveSize.index,
 							"PRIORITY=%i", LOG_DEBUG,
 							"STATION=%s", _stationUuid,
 							"CATEGORY=communication",
 							"CONNECTOR_TYPE=vp2_directconnect",
 							NULL);
-					sendAck();
 					_status.shortStatus = "Downloading " + std::to_string(_archiveSize.pagesLeft) + " archive pages";
-				} else {
-					_currentState = State::SENDING_ABORT_ARCHIVE_DOWNLOAD;
-					sd_journal_send("MESSAGE=Wrong CRC at ARCHIVE_NB_PAGES",
-							"PRIORITY=%i", LOG_ERR,
-							"STATION=%s", _stationUuid,
-							"CATEGORY=communication",
-							"CONNECTOR_TYPE=vp2_directconnect",
-							NULL);
-					sendAbort();
-				}
-			}
-			break;
-
-		case State::SENDING_ABORT_ARCHIVE_DOWNLOAD:
-			// We cannot retry anything here, we are in the middle of a request, just give up
-			if (e != sys::errc::success) {
-				sd_journal_send("MESSAGE=Transmission error at ABORT_ARCHIVE_DOWNLOAD, aborting",
-						"PRIORITY=%i", LOG_CRIT,
-						"STATION=%s", _stationUuid,
-						"CATEGORY=communication",
-						"CONNECTOR_TYPE=vp2_directconnect",
-						NULL);
-				stop();
-			} else {
-				_currentState = State::WAITING_NEXT_MEASURE_TICK;
-				waitForNextMeasure();
-			}
-			break;
+					BOOST_ASIO_CORO_YIELD sendRequest(_ack, 1);
+					if (ec) {
+						fail("Transmission error at ARCHIVE_DOWNLOAD, aborting");
+						return;
+					}
 
-		case State::WAITING_ARCHIVE_PAGE:
-			// We cannot retry anything here, we are in the middle of a request, just give up
-			if (e != sys::errc::success) {
-				sd_journal_send("MESSAGE=Transmission error at WAITING_ARCHIVE_PAGE, aborting",
-						"PRIORITY=%i", LOG_CRIT,
-						"STATION=%s", _stationUuid,
-						"CATEGORY=communication",
-						"CONNECTOR_TYPE=vp2_directconnect",
-						NULL);
-				stop();
-			} else {
-				if (_archivePage.isValid()) {
-					bool ret = _archivePage.store(_db, _station);
-					if (ret) {
-						sd_journal_send("MESSAGE=Archive page stored, now updating the last archive timestamp",
-								"PRIORITY=%i", LOG_INFO,
-								"STATION=%s", _stationUuid,
-								"CATEGORY=storage",
-								"CONNECTOR_TYPE=vp2_directconnect",
-								NULL);
-
-						if (_archivePage.lastArchiveRecordDateTime() > _newestArchive) {
-							_newestArchive = _archivePage.lastArchiveRecordDateTime();
-							time_t lastArchiveDownloadTime = chrono::system_clock::to_time_t(_newestArchive);
-							ret = _db.updateLastArchiveDownloadTime(_station, lastArchiveDownloadTime);
-							publish(NewDatapointEvent{_station, _newestArchive, date::floor<chrono::seconds>(chrono::system_clock::now())});
+					while (_archiveSize.pagesLeft) {
+						BOOST_ASIO_CORO_YIELD recvData(_archivePage.getBuffer());
+						if (ec) {
+							fail("Transmission error at WAITING_ARCHIVE_PAGE, aborting");
+							return;
 						}
-						if (_archivePage.lastArchiveRecordDateTime() < _oldestArchive) {
-							_oldestArchive = _archivePage.lastArchiveRecordDateTime();
+						if (_archivePage.isValid()) {
+							// Acknowledge the page right away and let the
+							// writer store it in the background, the next
+							// page will be transferred meanwhile
+							if (!_archiveWriter->enqueue(_archivePage.decode(_station))) {
+								fail("Couldn't store the archive page", "storage");
+								return;
+							}
+							_archiveSize.pagesLeft--;
+							archivePagesReceived().increment();
+							BOOST_ASIO_CORO_YIELD sendRequest(_ack, 1);
+						} else {
+							if (++_transmissionErrors > 100) {
+								fail("Received too many incorrect archive data, aborting");
+								return;
+							}
+							log(LOG_ERR, "communication", "Received incorrect archive data, retrying");
+							BOOST_ASIO_CORO_YIELD sendRequest(_nak, 1);
 						}
-						if (!ret) {
-							sd_journal_send("MESSAGE=Couldn't update last archive download time",
-									"PRIORITY=%i", LOG_ERR,
-									"STATION=%s", _stationUuid,
-									"CATEGORY=storage",
-									"CONNECTOR_TYPE=vp2_directconnect",
-									NULL);
+						if (ec) {
+							fail("Transmission error at ARCHIVE_DOWNLOAD, aborting");
+							return;
 						}
-					} else {
-						sd_journal_send("MESSAGE=Couldn't store the archive page",
-								"PRIORITY=%i", LOG_CRIT,
-								"STATION=%s", _stationUuid,
-								"CATEGORY=storage",
-								"CONNECTOR_TYPE=vp2_directconnect",
-								NULL);
-						stop();
 					}
-					_archiveSize.pagesLeft--;
-					_currentState = State::SENDING_ARCHIVE_PAGE_ANSWER;
-					sendAck();
-				} else {
-					_currentState = State::SENDING_ARCHIVE_PAGE_ANSWER;
-					_transmissionErrors++;
-					if (_transmissionErrors > 100) {
-						sd_journal_send("MESSAGE=Received too many incorrect archive data, aborting",
-								"PRIORITY=%i", LOG_CRIT,
-								"STATION=%s", _stationUuid,
-								"CATEGORY=communication",
-								"CONNECTOR_TYPE=vp2_directconnect",
-								NULL);
-						stop();
+
+					_status.shortStatus = "Storing the archive";
+					BOOST_ASIO_CORO_YIELD waitForArchiveWriter();
+					// The writer is done, nothing is left on the writers pool
+					_archiveWriter.reset();
+					if (ec) {
+						fail("Couldn't store the archive, aborting", "storage");
+						return;
 					}
-					sd_journal_send("MESSAGE=Received incorrect archive data, retrying",
-							"PRIORITY=%i", LOG_ERR,
-							"STATION=%s", _stationUuid,
-							"CATEGORY=communication",
-							"CONNECTOR_TYPE=vp2_directconnect",
-							NULL);
-					sendNak();
-				}
-			}
-			break;
 
-		case State::SENDING_ACK_ARCHIVE_DOWNLOAD:
-		case State::SENDING_ARCHIVE_PAGE_ANSWER:
-			// We cannot retry anything here, we are in the middle of a request, just give up
-			if (e != sys::errc::success) {
-				sd_journal_send("MESSAGE=Transmission error at ARCHIVE_DOWNLOAD, aborting",
-						"PRIORITY=%i", LOG_CRIT,
-						"STATION=%s", _stationUuid,
-						"CATEGORY=communication",
-						"CONNECTOR_TYPE=vp2_directconnect",
-						NULL);
-				stop();
-			} else {
-				if (_archiveSize.pagesLeft) {
-					_currentState = State::WAITING_ARCHIVE_PAGE;
-					recvData(_archivePage.getBuffer());
-				} else {
 					_status.nbDownloads++;
 					_status.lastDownload = date::floor<chrono::seconds>(chrono::system_clock::now());
 					_lastArchive = _newestArchive;
-					sd_journal_send("MESSAGE=Data collected and stored succesfully",
-							"PRIORITY=%i", LOG_INFO,
-							"STATION=%s", _stationUuid,
-							"CATEGORY=measurement",
-							"CONNECTOR_TYPE=vp2_directconnect",
-							NULL);
+					log(LOG_INFO, "measurement", "Data collected and stored succesfully");
 
 					if (_jobPublisher && date::floor<date::days>(_oldestArchive) < date::floor<date::days>(chrono::system_clock::now())) {
 						_jobPublisher->publishJobsForPastDataInsertion(_station, _oldestArchive, _newestArchive);
 					}
-
-					if (_setTimeRequested) {
-						_currentState = State::SENDING_WAKE_UP_SETTIME;
-						requestEcho();
-						_status.shortStatus = "Setting the station clock";
-					} else {
-						_currentState = State::WAITING_NEXT_MEASURE_TICK;
-						waitForNextMeasure();
-					}
 				}
 			}
-			break;
 
-		case State::SENDING_WAKE_UP_SETTIME:
-			handleGenericErrors(e, State::SENDING_WAKE_UP_SETTIME, requestEcho);
-			if (e == sys::errc::success) {
-				_currentState = State::WAITING_ECHO_SETTIME;
-				recvWakeUp();
-			}
-			break;
+			if (_setTimeRequested) {
+				_status.shortStatus = "Setting the station clock";
+				for (;;) {
+					if (_flushBeforeRetry) {
+						_flushBeforeRetry = false;
+						BOOST_ASIO_CORO_YIELD flushSocket();
+					}
+					BOOST_ASIO_CORO_YIELD sendRequest(_echoRequest, sizeof(_echoRequest) - 1);
+					if (ec) { if (retryAfter(ec)) continue; return; }
+					BOOST_ASIO_CORO_YIELD recvWakeUp();
+					if (ec) { if (retryAfter(ec)) continue; return; }
+					BOOST_ASIO_CORO_YIELD sendRequest(_settimeRequest, sizeof(_settimeRequest) - 1);
+					if (ec) { if (retryAfter(ec)) continue; return; }
+					BOOST_ASIO_CORO_YIELD recvAck();
+					if (ec) { if (retryAfter(ec)) continue; return; }
+					if (_ackBuffer != _ack[0]) {
+						if (retryAfterTransmissionError("Transmission error at SETTIME, aborting"))
+							continue;
+						return;
+					}
+					break;
+				}
 
-		case State::WAITING_ECHO_SETTIME:
-			handleGenericErrors(e, State::SENDING_WAKE_UP_SETTIME, requestEcho);
-			if (e == sys::errc::success) {
-				_currentState = State::SENDING_SETTIME;
-				requestSetTime();
+				buildSettimeParams();
+				BOOST_ASIO_CORO_YIELD sendRequest(&_settimeParams, sizeof(_settimeParams));
+				// We cannot retry anything here, we are in the middle of a request, just give up
+				if (ec) {
+					fail("Transmission error at SETTIME_PARAMS, aborting");
+					return;
+				}
+				BOOST_ASIO_CORO_YIELD recvAck();
+				if (ec || _ackBuffer != _ack[0])
+					log(LOG_ERR, "communication", "Transmission error at TIME_SET, aborting");
+				else
+					log(LOG_INFO, "configuration", "Time set");
+
+				_setTimeRequested = false;
+				_setTimeTimer.expires_after(chrono::hours(1));
+				_setTimeTimer.async_wait([this, self = shared_from_this()](const sys::error_code& e) {
+					handleSetTimeDeadline(e);
+				});
 			}
-			break;
 
-		case State::SENDING_SETTIME:
-			handleGenericErrors(e, State::SENDING_SETTIME, requestSetTime);
-			if (e == sys::errc::success) {
-				_currentState = State::WAITING_ACK_SETTIME;
-				recvAck();
-			}
-			break;
+			for (;;) {
+				BOOST_ASIO_CORO_YIELD waitForNextMeasure();
+				if (!_realtimeTickDue)
+					break;
 
-		case State::WAITING_ACK_SETTIME:
-			handleGenericErrors(e, State::SENDING_SETTIME, requestSetTime);
-			if (e == sys::errc::success) {
-				if (_ackBuffer != 0x06) {
-					if (++_transmissionErrors < 5) {
-						flushSocketAndRetry(State::SENDING_SETTIME, requestSetTime);
+				_status.shortStatus = "Waking up station";
+				for (;;) {
+					if (_flushBeforeRetry) {
+						_flushBeforeRetry = false;
+						BOOST_ASIO_CORO_YIELD flushSocket();
+					}
+					BOOST_ASIO_CORO_YIELD sendRequest(_echoRequest, sizeof(_echoRequest) - 1);
+					if (ec) { if (retryAfter(ec)) continue; return; }
+					BOOST_ASIO_CORO_YIELD recvWakeUp();
+					if (ec) { if (retryAfter(ec)) continue; return; }
+					BOOST_ASIO_CORO_YIELD sendRequest(VantagePro2LoopMessage::LOOP_REQUEST, sizeof(VantagePro2LoopMessage::LOOP_REQUEST) - 1);
+					if (ec) { if (retryAfter(ec)) continue; return; }
+					BOOST_ASIO_CORO_YIELD recvAck();
+					if (ec) { if (retryAfter(ec)) continue; return; }
+					if (_ackBuffer == _nak[0]) {
+						// The console is too old to know about LOOP2
+						// packets, stick to the archive
+						log(LOG_WARNING, "communication", "Station does not support the LPS command, disabling real-time data");
+						_realtimePeriod = chrono::seconds::zero();
+						break;
+					}
+					if (_ackBuffer != _ack[0]) {
+						if (retryAfterTransmissionError("Transmission error at ACK_LOOP, aborting"))
+							continue;
+						return;
+					}
+					BOOST_ASIO_CORO_YIELD recvData(_loopMessage.getBuffer());
+					if (ec) { if (retryAfter(ec)) continue; return; }
+					if (_loopMessage.looksValid()) {
+						// Real-time data is not stored, the archive remains
+						// the reference, it's only handed over to the
+						// subscribers interested in the current conditions
+						auto now = date::floor<chrono::seconds>(chrono::system_clock::now());
+						publish(NewRealtimeObservationEvent{_station, _loopMessage.getObservation(_station, now)}, _station);
 					} else {
-						sd_journal_send("MESSAGE=Transmission error at SETTIME, aborting",
-								"PRIORITY=%i", LOG_CRIT,
-								"STATION=%s", _stationUuid,
-								"CATEGORY=communication",
-								"CONNECTOR_TYPE=vp2_directconnect",
-								NULL);
-						stop();
+						// Not worth a retry, the next packets are due soon
+						log(LOG_WARNING, "communication", "Received incorrect real-time data, discarding");
 					}
-				} else {
-					_currentState = State::SENDING_SETTIME_PARAMS;
-					auto buffer = buildSettimeParams();
-					sendBuffer(buffer, sizeof(SettimeRequestParams));
+					break;
 				}
 			}
-			break;
-
-		case State::SENDING_SETTIME_PARAMS:
-			// We cannot retry anything here, we are in the middle of a request, just give up
-			if (e != sys::errc::success) {
-				sd_journal_send("MESSAGE=Transmission error at SETTIME_PARAMS, aborting",
-						"PRIORITY=%i", LOG_CRIT,
-						"STATION=%s", _stationUuid,
-						"CATEGORY=communication",
-						"CONNECTOR_TYPE=vp2_directconnect",
-						NULL);
-				stop();
-			} else {
-				_currentState = State::WAITING_ACK_TIME_SET;
-				recvAck();
-			}
-			break;
-
-		case State::WAITING_ACK_TIME_SET:
-			// We cannot retry anything here, we are in the middle of a request, just give up
-			if (e != sys::errc::success || _ackBuffer != 0x06) {
-				sd_journal_send("MESSAGE=Transmission error at TIME_SET, aborting",
-						"PRIORITY=%i", LOG_ERR,
-						"STATION=%s", _stationUuid,
-						"CATEGORY=communication",
-						"CONNECTOR_TYPE=vp2_directconnect",
-						NULL);
-			} else {
-				sd_journal_send("MESSAGE=Time set",
-						"PRIORITY=%i", LOG_INFO,
-						"STATION=%s", _stationUuid,
-						"CATEGORY=configuration",
-						"CONNECTOR_TYPE=vp2_directconnect",
-						NULL);
-			}
 
-			_setTimeRequested = false;
-			_setTimeTimer.expires_from_now(chrono::hours(1));
-			{
-				auto self(std::static_pointer_cast<VantagePro2Connector>(shared_from_this()));
-				_setTimeTimer.async_wait([this, self](const sys::error_code& e) {
-					handleSetTimeDeadline(e);
-				});
-				_currentState = State::WAITING_NEXT_MEASURE_TICK;
-				waitForNextMeasure();
-			}
-			break;
-
-		case State::STOPPED:
-			/* discard everything, only spurious events from cancelled
-				operations can get here */
-			break;
+			log(LOG_DEBUG, "schedule", "New measurement due");
+			_archiveDue = true;
+		}
 	}
 }
 
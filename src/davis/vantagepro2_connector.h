@@ -34,14 +34,18 @@
 #include <boost/system/error_code.hpp>
 #include <boost/asio.hpp>
 #include <boost/asio/basic_waitable_timer.hpp>
+#include <boost/asio/coroutine.hpp>
 #include <cassandra.h>
 #include <date/date.h>
 #include <date/tz.h>
 
 #include "connector.h"
+#include "time_offseter.h"
 #include "async_job_publisher.h"
+#include "async_archive_writer.h"
 #include "davis/vantagepro2_message.h"
 #include "davis/vantagepro2_archive_page.h"
+#include "davis/vantagepro2_loop_message.h"
 
 
 namespace meteodata
@@ -58,6 +62,12 @@ using namespace meteodata;
 /**
  * @brief A Connector designed for the VantagePro2 (R) station by Davis
  * Instruments (R)
+ *
+ * The connector talks to the station over a single TCP connection, it owns
+ * all the buffers used for the exchanges and reuses them for the whole
+ * lifetime of the connection. Each read or write is given a deadline, when it
+ * expires the pending operation is cancelled and the engine resumes with a
+ * timeout.
  */
 class VantagePro2Connector : public Connector
 {
@@ -69,9 +79,15 @@ public:
 	 * network operations
 	 * @param db The handle to the database
 	 * @param db The handle to the asynchronous jobs database
+	 * @param realtimePeriod The period at which LOOP packets are requested
+	 * from the station between archive downloads, or 0 to only download
+	 * the archive
 	 */
-	VantagePro2Connector(boost::asio::io_context& ioContext, DbConnectionObservations& db,
-		const std::shared_ptr<AsyncJobPublisher>& jobPublisher = nullptr);
+	VantagePro2Connector(boost::asio::io_context& ioContext, ObservationsStorage& db,
+		const std::shared_ptr<AsyncJobPublisher>& jobPublisher = nullptr,
+		chrono::seconds realtimePeriod = chrono::seconds{0});
+
+	~VantagePro2Connector() override;
 
 	//main loop
 	void start() override;
@@ -106,44 +122,6 @@ public:
 	std::string getStatus() const override;
 
 private:
-	/**
-	 * @brief Represent a state in the state machine
-	 */
-	enum class State
-	{
-		STARTING,                       /*!< Initial state                                                      */
-		WAITING_NEXT_MEASURE_TICK,      /*!< Waiting for the timer to hit the deadline for the next measurement */
-		SENDING_WAKE_UP_STATION,        /*!< Waiting for the wake up request to be sent                         */
-		WAITING_ECHO_STATION,           /*!< Waiting for the station to answer the wake up request              */
-		SENDING_REQ_STATION,            /*!< Waiting for the identification request to be sent                  */
-		WAITING_ACK_STATION,            /*!< Waiting for the identification request to be acknowledgement       */
-		WAITING_DATA_STATION,           /*!< Waiting for the station to answer the identification               */
-		SENDING_REQ_MAIN_MODE,          /*!< Waiting for the RXTEST command (switch to main mode) to be sent    */
-		WAITING_ACK_MAIN_MODE,          /*!< Waiting for the station to acknowledge the RXTEST command          */
-		SENDING_REQ_TIMEZONE,           /*!< Waiting for the timezone information request to be sent            */
-		WAITING_ACK_TIMEZONE,           /*!< Waiting for the station to acknowledge the timezone information request */
-		WAITING_DATA_TIMEZONE,          /*!< Waiting for the station to answer the timezone information request */
-		SENDING_WAKE_UP_ARCHIVE,        /*!< Waiting for the wake up order to be sent to download archive       */
-		WAITING_ECHO_ARCHIVE,           /*!< Waiting for the station to answer the wake up request to start downloading archive */
-		SENDING_REQ_ARCHIVE,            /*!< Waiting for the archive request to be sent                         */
-		WAITING_ACK_ARCHIVE,            /*!< Waiting for the archive request acknowledgement                    */
-		SENDING_ARCHIVE_PARAMS,         /*!< Waiting for the archive download parameters to be sent             */
-		WAITING_ACK_ARCHIVE_PARAMS,     /*!< Waiting for the archive download parameters acknowledgement        */
-		WAITING_ARCHIVE_NB_PAGES,       /*!< Waiting for the archive size                                       */
-		SENDING_ACK_ARCHIVE_DOWNLOAD,   /*!< Waiting for the archive download acknowledgement to be sent        */
-		SENDING_ABORT_ARCHIVE_DOWNLOAD, /*!< Waiting for the archive download abortion notice to be sent        */
-		WAITING_ARCHIVE_PAGE,           /*!< Waiting for the next page of archive                               */
-		SENDING_ARCHIVE_PAGE_ANSWER,    /*!< Waiting for the archive page confirmation to be sent               */
-		SENDING_WAKE_UP_SETTIME,        /*!< Waiting for the wake up order to be sent to set the clock          */
-		WAITING_ECHO_SETTIME,           /*!< Waiting for the station to answer the wake up request to set the clock */
-		SENDING_SETTIME,                /*!< Waiting for the time setting request to be sent                    */
-		WAITING_ACK_SETTIME,            /*!< Waiting for the station to acknowledge the time setting request    */
-		SENDING_SETTIME_PARAMS,         /*!< Waiting for the time setting parameters to be sent                 */
-		WAITING_ACK_TIME_SET,           /*!< Waiting for the station to confirm the completion of the time setting */
-		STOPPED                         /*!< Final state for cleanup operations                                 */
-	};
-	/* Events have type sys::error_code */
-
 	/**
 	 * @brief The buffer that can be sent to the station to set the clock
 	 */
@@ -181,48 +159,86 @@ private:
 	} __attribute((packed));
 
 	/**
-	 * @brief Check an event and handle generic errors such as timeouts and
-	 * I/O errors
+	 * @brief The answer of the station to the timezone information request
+	 */
+	struct TimezoneAnswer
+	{
+		TimeOffseter::VantagePro2TimezoneBuffer timezone; /*!< The EEPROM bytes */
+		uint16_t crc;                                     /*!< The CRC of the above field */
+	} __attribute((packed));
+
+	/**
+	 * @brief The protocol engine, a stackless coroutine
 	 *
-	 * This method can be called upon receiving an event from the station,
-	 * it does nothing in case of a success or a cancelation event. It calls
-	 * the restart function in case of a timeout or an I/O error if the
-	 * maximum number of (respectively) timeouts and transmission errors has
-	 * not reached a predefined threshold and aborts the connection in any
-	 * other case.
+	 * The whole conversation with the station, from the identification
+	 * to the periodic archive downloads, is written sequentially in this
+	 * method. Each asynchronous operation started by the engine resumes
+	 * it upon completion, with the outcome of the operation (success,
+	 * timeout, I/O error, etc.) as parameter.
 	 *
-	 * @tparam Restarter the type of the function to call to retry the
-	 * operation
-	 * @param e the event from the station
-	 * @param restartState the state in which the state machine must jump
-	 * before calling the restart function
-	 * @param restart a function to call to retry the current operation
-	 * (which is about to fail)
+	 * @param ec The outcome of the last asynchronous operation
 	 */
-	template<typename Restarter>
-	void handleGenericErrors(const sys::error_code& e, State restartState, Restarter restart);
+	void run(sys::error_code ec = {});
 
 	/**
-	 * @brief Transition function of the state machine
+	 * @brief Build the completion handler of an asynchronous operation
+	 * started by the engine
 	 *
-	 * Thi smethod receives an event from the station and reacts according
-	 * to the current state before waiting for the next event.
+	 * The handler disarms the deadline of the operation and resumes the
+	 * engine, unless the connector has been stopped or reloaded since the
+	 * operation was started. An operation cancelled by its deadline
+	 * resumes the engine with a timeout.
+	 */
+	auto resume();
+
+	/**
+	 * @brief Cancel the pending socket operation if it does not complete
+	 * before a duration
 	 *
-	 * @param e an event from the station (success, timeout, I/O error,
-	 * etc.)
+	 * @param timeout The maximum duration of the operation
 	 */
-	void handleEvent(const sys::error_code& e);
+	void armDeadline(chrono::steady_clock::duration timeout);
 
 	/**
-	 * @brief Verify that the timer that has just expired really means that
-	 * the associated deadline has expired
+	 * @brief Decide whether the current exchange with the station can be
+	 * tried again after an I/O error or a timeout
 	 *
-	 * This method is associated with \a _timer .
+	 * The connection is aborted after five timeouts in a row or after any
+	 * other I/O error (TCP reset by peer, etc.).
 	 *
-	 * @param e an error code which is positioned to a specific value if the
-	 * timer has been interrupted before the deadline
+	 * @param ec The error
+	 * @return True if the exchange must be started over, false if the
+	 * connector has been stopped
+	 */
+	bool retryAfter(const sys::error_code& ec);
+
+	/**
+	 * @brief Decide whether the current exchange with the station can be
+	 * tried again after a garbled answer
+	 *
+	 * @param message The message to log if the connection gets aborted
+	 * @return True if the exchange must be started over, false if the
+	 * connector has been stopped
+	 */
+	bool retryAfterTransmissionError(const char* message);
+
+	/**
+	 * @brief Log a message about the station
+	 *
+	 * @param priority The syslog priority of the message
+	 * @param category The category of the message
+	 * @param message The message
+	 */
+	void log(int priority, const char* category, const char* message);
+
+	/**
+	 * @brief Log a critical error and abort the connection
+	 *
+	 * @param message The message
+	 * @param category The category of the message
 	 */
-	void checkDeadline(const sys::error_code& e);
+	void fail(const char* message, const char* category = "communication");
+
 	/**
 	 * @brief Verify that the timer that has just expired really means that
 	 * the associated deadline has expired
@@ -234,47 +250,22 @@ private:
 	 */
 	void handleSetTimeDeadline(const sys::error_code& e);
 
-
 	/**
-	 * @brief Program the timer to send a timeout event when the clock hit
-	 * the next multiple of five minutes
+	 * @brief Program the timer to resume the engine when the clock hits
+	 * the next multiple of the polling period, or earlier to get the
+	 * real-time data
+	 *
+	 * \a _realtimeTickDue tells which deadline has been picked.
 	 */
 	void waitForNextMeasure();
 
-	/**
-	 * Wait on the main timer for a set duration (from now) and call checkDeadline
-	 * when it expires
-	 * @tparam Rep The duration template parameter
-	 * @tparam Period The ratio duration template parameter
-	 * @param expiryTime The expiry time after which the checkDeadline will be called
-	 * (unless the timer is cancelled)
-	 */
-	template<typename Rep, typename Period>
-	void countdown(const std::chrono::duration<Rep, Period>& expiryTime)
-	{
-		auto self(std::static_pointer_cast<VantagePro2Connector>(shared_from_this()));
-		_timer.expires_after(expiryTime);
-		_timer.async_wait([this, self](const sys::error_code& e) { checkDeadline(e); });
-	}
-
 	/**
 	 * @brief Send a message to the station
 	 *
 	 * @param req the request
 	 * @param reqsize the request size
 	 */
-	void sendRequest(const char* req, int reqsize);
-
-	/**
-	 * @brief Send a buffer over to the station
-	 *
-	 * @tparam PODType The type of the buffer that is to be sent, it must
-	 * be a packed structure
-	 * @param req A shared pointer onto the buffer
-	 * @param reqsize The size in bytes of the buffer
-	 */
-	template<typename PODType>
-	void sendBuffer(const std::shared_ptr<PODType>& req, int reqsize);
+	void sendRequest(const void* req, std::size_t reqsize);
 	/**
 	 * @brief Wait for the station to answer a wake up request
 	 */
@@ -283,74 +274,68 @@ private:
 	 * @brief Wait for the station to acknowledge last request
 	 */
 	void recvAck();
+	/**
+	 * @brief Read an acknowledgement, discarding the line endings the
+	 * station may send before
+	 *
+	 * @tparam Handler The type of the completion handler
+	 * @param handler The completion handler
+	 */
+	template<typename Handler>
+	void readAck(Handler&& handler);
 	/**
 	 * @brief Wait for the station to acknowledge last request (in a
 	 * human-readable form, i.e. by sending "OK")
 	 */
 	void recvOk();
-	/**
-	 * @brief Send an acknowledgement (ACK) to the station
-	 */
-	void sendAck();
-	/**
-	 * @brief Send a negative acknowledgement (NAK) to the station
-	 */
-	void sendNak();
-	/**
-	 * @brief Send a notice to the station that the current request
-	 * is cancelled
-	 */
-	void sendAbort();
 	/**
 	 * @brief Wait for the station to answer the request
 	 *
 	 * @tparam MutableBuffer the type of the buffer in which the answer
 	 * must be stored
-	 * @param buffer the buffer in which the answere must be stored, this
-	 * function will not send the success event until the buffer is full
+	 * @param buffer the buffer in which the answer must be stored, the
+	 * engine is not resumed until the buffer is full
 	 */
 	template<typename MutableBuffer>
 	void recvData(const MutableBuffer& buffer);
 	/**
 	 * @brief Empty the communication buffer
 	 *
-	 * @tparam Restarter the type of the function to call to retry the
-	 * operation
-	 * @param restartState the state in which the state machine must jump
-	 * before calling the restart function
-	 * @param restart a function to call to retry the current operation
-	 * (which is about to fail)
+	 * The socket is left alone for a while first so that the station has
+	 * finished sending whatever garbage it had to send.
 	 */
-	template<typename Restarter>
-	void flushSocketAndRetry(State restartState, Restarter restart);
+	void flushSocket();
 
 	/**
-	 * @brief Construct an \a ArchiveRequestParams from the timestamp
-	 * of an archive entry retrieved from the station
+	 * @brief Identify the station from the coordinates it has sent
 	 *
-	 * After the return of this method, the caller is the only owner
-	 * of the \a ArchiveRequestParams returned by this function. The
-	 * \a ArchiveRequestParams is returned as a shared pointer so that
-	 * it can be shared easily with an asynchronous I/O function.
+	 * @return True if the station is known, false otherwise
+	 */
+	bool identifyStation();
+
+	/**
+	 * @brief Prepare the writer for the archive pages about to be
+	 * downloaded
+	 */
+	void startArchiveWriter();
+	/**
+	 * @brief Tell the writer that all pages have been downloaded, and
+	 * resume the engine once they have been stored
+	 */
+	void waitForArchiveWriter();
+
+	/**
+	 * @brief Fill \a _archiveRequestParams from the timestamp of an
+	 * archive entry retrieved from the station
 	 *
 	 * @param time The timestamp of an entry which must exist in the
 	 * station's archive (otherwise the entire archive will be downloaded)
-	 *
-	 * @return A shared pointer on a newly built \a ArchiveRequestParams
 	 */
-	std::shared_ptr<ArchiveRequestParams> buildArchiveRequestParams(const date::sys_seconds& time);
+	void buildArchiveRequestParams(const date::sys_seconds& time);
 	/**
-	 * @brief Construct an \a SettimeRequestParams from the current
-	 * server (POSIX) time
-	 *
-	 * After the return of this method, the caller is the only owner
-	 * of the \a SettimeRequestParams returned by this function. The
-	 * \a SettimeRequestParams is returned as a shared pointer so that
-	 * it can be shared easily with an asynchronous I/O function.
-	 *
-	 * @return A shared pointer on a newly built \a SettimeRequestParams
+	 * @brief Fill \a _settimeParams from the current server (POSIX) time
 	 */
-	std::shared_ptr<SettimeRequestParams> buildSettimeParams();
+	void buildSettimeParams();
 
 	/**
 	 * @brief The TCP socket used to communicate to the meteo
@@ -359,9 +344,50 @@ private:
 	boost::asio::ip::tcp::socket _sock;
 
 	/**
-	 * @brief The current state of the state machine
+	 * @brief The current position of the protocol engine
+	 */
+	asio::coroutine _coro;
+	/**
+	 * @brief The number of times the engine has been restarted or stopped
+	 *
+	 * Handlers of operations started before a restart compare it to the
+	 * value they have captured and drop their result if it has changed.
+	 */
+	unsigned int _generation = 0;
+	/**
+	 * @brief The number of deadlines armed so far, used to ignore the
+	 * deadlines of operations that have completed already
+	 */
+	unsigned int _operation = 0;
+	/**
+	 * @brief Whether the pending socket operation has been cancelled by
+	 * its deadline
+	 */
+	bool _timedOut = false;
+	/**
+	 * @brief Whether the socket must be flushed before the next exchange
+	 * with the station
+	 */
+	bool _flushBeforeRetry = false;
+	/**
+	 * @brief Whether the last tick of the timer is for real-time data
+	 * rather than for the archive
 	 */
-	State _currentState = State::STOPPED;
+	bool _realtimeTickDue = false;
+	/**
+	 * @brief Whether the archive must be downloaded before waiting for
+	 * the next tick
+	 */
+	bool _archiveDue = false;
+	/**
+	 * @brief Whether the connector has been stopped
+	 */
+	bool _stopped = false;
+	/**
+	 * @brief Whether the connector has been started and is counted among
+	 * the connected stations
+	 */
+	bool _started = false;
 	/**
 	 * @brief A Boost::Asio timer used to time out on network operations and
 	 * to wait between two measurements
@@ -433,7 +459,7 @@ private:
 	/**
 	 * @brief A buffer to receive the timezone setting of the station
 	 */
-	TimeOffseter::VantagePro2TimezoneBuffer _timezoneBuffer{};
+	TimezoneAnswer _timezoneAnswer{};
 
 	/**
 	 * @brief A type of buffer able to receive the answer of the station to
@@ -454,6 +480,16 @@ private:
 	 */
 	ArchiveSizeBuffer _archiveSize{};
 
+	/**
+	 * @brief The parameters of the last archive download request
+	 */
+	ArchiveRequestParams _archiveRequestParams{};
+
+	/**
+	 * @brief The parameters of the last clock setting request
+	 */
+	SettimeRequestParams _settimeParams{};
+
 	/**
 	 * @brief An \a ArchivePage which will receive all downloaded archive
 	 * entries from the station
@@ -461,11 +497,25 @@ private:
 	 * The \a VantagePro2Connector uses only one \a VantagePro2ArchivePage even if
 	 * typically several pages are sent during a download. The buffer is recycled
 	 * for each page. Before receiving a new page, the connector must call
-	 * \ref VantagePro2ArchivePage::storeToMessages to save the data in the
+	 * \ref VantagePro2ArchivePage::decode to extract the data in the
 	 * current page before the buffer can be reused.
 	 */
 	VantagePro2ArchivePage _archivePage{};
 
+	/**
+	 * @brief The period at which real-time data is requested from the
+	 * station, 0 if the real-time mode is disabled
+	 *
+	 * The real-time mode is also disabled if the station turns out not to
+	 * support the LPS command.
+	 */
+	chrono::seconds _realtimePeriod;
+
+	/**
+	 * @brief The buffer receiving the LOOP and LOOP2 packets
+	 */
+	VantagePro2LoopMessage _loopMessage{&_timeOffseter};
+
 	/**
 	 * @brief The timestamp (in POSIX time) of the last archive entry
 	 * retrieved from the station
@@ -490,6 +540,14 @@ private:
 	 */
 	std::shared_ptr<AsyncJobPublisher> _jobPublisher;
 
+	/**
+	 * @brief The writer storing the archive pages in the background while
+	 * the next ones are downloaded
+	 *
+	 * It exists only during an archive download.
+	 */
+	std::unique_ptr<AsyncArchiveWriter> _archiveWriter;
+
 	/**
 	 * @brief The \a TimeOffseter to use to convert timestamps between the
 	 * station's time and POSIX time
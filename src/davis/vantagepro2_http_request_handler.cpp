@@ -35,13 +35,15 @@
 #include "cassandra.h"
 #include "cassandra_utils.h"
 #include "time_offseter.h"
+#include "archive_cleanup.h"
 #include "async_job_publisher.h"
 #include "davis/vantagepro2_archive_message.h"
 #include "davis/vantagepro2_http_request_handler.h"
+#include "monitoring/ingestion_trace.h"
 
 namespace meteodata
 {
-VantagePro2HttpRequestHandler::VantagePro2HttpRequestHandler(DbConnectionObservations& db,
+VantagePro2HttpRequestHandler::VantagePro2HttpRequestHandler(ObservationsStorage& db,
 	const std::shared_ptr<AsyncJobPublisher>& jobPublisher) :
 		_db{db},
 		_jobPublisher{jobPublisher}
@@ -133,6 +135,7 @@ void VantagePro2HttpRequestHandler::postArchivePage(const Request& request, Resp
 {
 	CassUuid uuid;
 	if (getUuidAndCheckAccess(request, response, uuid, url)) {
+		IngestionTrace::setCurrentStation(uuid);
 		const std::string& content = request.body();
 		std::size_t size = content.size();
 		if (size % sizeof(VantagePro2ArchiveMessage::ArchiveDataPoint) != 0) {
@@ -195,19 +198,19 @@ void VantagePro2HttpRequestHandler::postArchivePage(const Request& request, Resp
 			}
 		}
 
-		// Remove the data that may already be in place to replace it
-		// with the archive (which may or may not be available at the
-		// same measurement interval)
-		auto day = date::floor<date::days>(oldestArchive);
-		auto lastDay = date::floor<date::days>(newestArchive);
-		while (day <= lastDay) {
-			ret = _db.deleteDataPoints(uuid, day, oldestArchive, newestArchive);
+		IngestionTrace::markCurrent(IngestionTrace::Stage::DECODED);
 
+		// Remove the realtime data that may already be in place to
+		// replace it with the archive (which may or may not be available
+		// at the same measurement interval), the archive records already
+		// stored are simply overwritten
+		if (!allObs.empty()) {
+			ret = deleteSupersededRealtimeObservations(_db, uuid, start, oldestArchive, newestArchive,
+				chrono::minutes{pollingPeriod});
 			if (!ret)
 				std::cerr << SD_ERR << "[VP2 HTTP " << uuid << "] management: "
 					  << "couldn't delete temporary realtime observations for station " << name
 					  << std::endl;
-			day += date::days(1);
 		}
 
 		for (auto& o : allObs) {
@@ -224,9 +227,11 @@ void VantagePro2HttpRequestHandler::postArchivePage(const Request& request, Resp
 				std::cerr << SD_ERR << "[VP2 HTTP " << uuid << "] management: "
 						  << "couldn't update last archive download time for station " << name << std::endl;
 
+			IngestionTrace::markCurrent(IngestionTrace::Stage::STORED);
 			if (_jobPublisher) {
 				_jobPublisher->publishJobsForPastDataInsertion(uuid, oldestArchive, newestArchive);
 			}
+			IngestionTrace::markCurrent(IngestionTrace::Stage::PUBLISHED);
 		} else {
 			std::cerr << SD_ERR << "[VP2 HTTP " << uuid << "] measurement: " << "failed to store archive for station "
 					  << name << "! Aborting" << std::endl;
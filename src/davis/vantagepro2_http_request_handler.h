@@ -29,7 +29,6 @@
 #include <boost/asio.hpp>
 #include <systemd/sd-daemon.h>
 #include <date/date.h>
-#include <cassobs/dbconnection_observations.h>
 
 #include <map>
 #include <memory>
@@ -37,12 +36,14 @@
 #include <tuple>
 #include <regex>
 
+#include "storage/observations_storage.h"
 #include "async_job_publisher.h"
 #include "http_connection.h"
 #include "cassandra.h"
 #include "cassandra_utils.h"
 #include "time_offseter.h"
 #include "davis/vantagepro2_archive_message.h"
+#include "monitoring/profiled_db_connection.h"
 
 namespace meteodata
 {
@@ -53,13 +54,13 @@ public:
 	using Request = boost::beast::http::request<boost::beast::http::string_body>;
 	using Response = boost::beast::http::response<boost::beast::http::string_body>;
 
-	explicit VantagePro2HttpRequestHandler(DbConnectionObservations& db,
+	explicit VantagePro2HttpRequestHandler(ObservationsStorage& db,
 		const std::shared_ptr<AsyncJobPublisher>& jobPublisher = nullptr);
 
 	void processRequest(const Request& request, Response& response);
 
 private:
-	DbConnectionObservations& _db;
+	ProfiledDbConnection _db;
 
 	std::shared_ptr<AsyncJobPublisher> _jobPublisher;
 
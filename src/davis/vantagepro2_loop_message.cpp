@@ -0,0 +1,94 @@
+/**
+ * @file vantagepro2_loop_message.cpp
+ * @brief Implementation of the VantagePro2LoopMessage class
+ * @author Laurent Georget
+ * @date 2026-10-18
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <cstring>
+
+#include <date/date.h>
+#include <cassobs/observation.h>
+
+#include "vantagepro2_loop_message.h"
+#include "vantagepro2_message.h"
+#include "../time_offseter.h"
+
+namespace chrono = std::chrono;
+
+namespace meteodata
+{
+
+VantagePro2LoopMessage::VantagePro2LoopMessage(const TimeOffseter* timeOffseter) :
+	_timeOffseter{timeOffseter}
+{}
+
+bool VantagePro2LoopMessage::looksValid() const
+{
+	return std::memcmp(_l1.header, "LOO", 3) == 0 && _l1.packetType == 0 &&
+	       std::memcmp(_l2.header, "LOO", 3) == 0 && _l2.packetType == 1 &&
+	       isValid();
+}
+
+Observation VantagePro2LoopMessage::getObservation(const CassUuid& station, const date::sys_seconds& timestamp) const
+{
+	Observation result;
+
+	result.station = station;
+	result.day = date::floor<date::days>(timestamp);
+	result.time = timestamp;
+	result.barometer = {_l2.barometer != 0, from_inHg_to_bar(_l2.barometer)};
+	result.dewpoint = {_l2.dewPoint != 255, from_Farenheit_to_Celsius(_l2.dewPoint)};
+	for (int i = 0 ; i < 2 ; i++)
+		result.extrahum[i] = {_l1.extraHum[i] != 255, _l1.extraHum[i]};
+	for (int i = 0 ; i < 3 ; i++)
+		result.extratemp[i] = {_l1.extraTemp[i] != 255, from_Farenheit_to_Celsius(_l1.extraTemp[i] - 90)};
+	result.heatindex = {_l2.heatIndex != 255, from_Farenheit_to_Celsius(_l2.heatIndex)};
+	for (int i = 0 ; i < 2 ; i++) {
+		result.leaftemp[i] = {_l1.leafTemp[i] != 255, from_Farenheit_to_Celsius(_l1.leafTemp[i] - 90)};
+		result.leafwetnesses[i] = {_l1.leafWetnesses[i] <= 15, _l1.leafWetnesses[i]};
+	}
+	result.outsidehum = {_l1.outsideHumidity != 255, _l1.outsideHumidity};
+	result.outsidetemp = {_l1.outsideTemperature != 32767, from_Farenheit_to_Celsius(_l1.outsideTemperature / 10.)};
+	result.rainrate = {_l1.rainRate != 65535, from_rainrate_to_mm(_l1.rainRate)};
+	for (int i = 0 ; i < 4 ; i++) {
+		result.soilmoistures[i] = {_l1.soilMoistures[i] != 255, _l1.soilMoistures[i]};
+		result.soiltemp[i] = {_l1.soilTemp[i] != 255, from_Farenheit_to_Celsius(_l1.soilTemp[i] - 90)};
+	}
+	result.solarrad = {_l2.solarRad != 32767, _l2.solarRad};
+	result.thswindex = {_l2.thswIndex != 255, from_Farenheit_to_Celsius(_l2.thswIndex)};
+	result.uv = {_l2.uv != 255, _l2.uv};
+	result.windchill = {_l2.windChill != 255, from_Farenheit_to_Celsius(_l2.windChill)};
+	// 0 means there is no wind direction, north is 360
+	result.winddir = {_l2.windDir != 0 && _l2.windDir != 32767, _l2.windDir % 360};
+	// the gust is the highest 2s-wind speed over the last ten minutes,
+	// the averages are in tenths of mph
+	result.windgust = {_l2.tenMinWindGust != 255, from_mph_to_kph(_l2.tenMinWindGust)};
+	result.windspeed = {_l2.twoMinAvgWindSpeed != 32767, from_mph_to_kph(_l2.twoMinAvgWindSpeed / 10.)};
+
+	if (_timeOffseter && _timeOffseter->mayStoreInsideMeasurements()) {
+		result.insidehum = {_l1.insideHumidity != 255, _l1.insideHumidity};
+		result.insidetemp = {_l1.insideTemperature != 32767, from_Farenheit_to_Celsius(_l1.insideTemperature / 10.0)};
+	}
+
+	return result;
+}
+
+}
@@ -0,0 +1,87 @@
+/**
+ * @file vantagepro2_loop_message.h
+ * @brief Definition of the VantagePro2LoopMessage class
+ * @author Laurent Georget
+ * @date 2026-10-18
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VANTAGEPRO2LOOPMESSAGE_H
+#define VANTAGEPRO2LOOPMESSAGE_H
+
+#include <cassandra.h>
+#include <date/date.h>
+#include <cassobs/observation.h>
+
+#include "vantagepro2_message.h"
+#include "../time_offseter.h"
+
+namespace meteodata
+{
+
+/**
+ * @brief A pair of LOOP and LOOP2 packets received from a VantagePro2 (R)
+ * station, by Davis Instruments (R), in answer to the "LPS 3 2" command
+ *
+ * Unlike archive records, LOOP packets are real-time snapshots of the console
+ * sensors, without any timestamp: the observation is dated with the time of
+ * reception. They are not meant to be stored in the database, the archive
+ * records remain the reference, but they give the current conditions between
+ * two archive downloads.
+ */
+class VantagePro2LoopMessage : public VantagePro2Message
+{
+public:
+	/**
+	 * @brief Construct the message
+	 *
+	 * @param timeOffseter The \a TimeOffseter knowing the settings of the
+	 * station
+	 */
+	explicit VantagePro2LoopMessage(const TimeOffseter* timeOffseter);
+
+	/**
+	 * @brief Check that the buffer received contains a LOOP packet
+	 * followed by a LOOP2 packet, both correctly transmitted
+	 *
+	 * @return True if, and only if, the packets can be decoded
+	 */
+	bool looksValid() const;
+
+	/**
+	 * @brief Decode the LOOP and LOOP2 packets
+	 *
+	 * @param station The station the packets come from
+	 * @param timestamp The time at which the packets have been received
+	 * @return The real-time observation
+	 */
+	Observation getObservation(const CassUuid& station, const date::sys_seconds& timestamp) const;
+
+	/**
+	 * @brief The command to send to the station to receive one LOOP and
+	 * one LOOP2 packet
+	 */
+	static constexpr char LOOP_REQUEST[] = "LPS 3 2\n";
+
+private:
+	const TimeOffseter* _timeOffseter;
+};
+
+}
+
+#endif /* VANTAGEPRO2LOOPMESSAGE_H */
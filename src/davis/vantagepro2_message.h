@@ -112,7 +112,7 @@ public:
 	void populateDataPoint(const CassUuid station, CassStatement* const statement) const override;
 	void populateV2DataPoint(const CassUuid station, CassStatement* const statement) const override;
 
-private:
+protected:
 	/**
 	 * @brief A Loop1 message, used by VantagePro2 (R) stations, and
 	 * documented by Davis Instruments (R)
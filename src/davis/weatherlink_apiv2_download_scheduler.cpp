@@ -21,6 +21,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
 #include <iostream>
 #include <memory>
 #include <functional>
@@ -28,14 +29,15 @@
 #include <unordered_map>
 #include <memory>
 #include <mutex>
+#include <optional>
 
 #include <boost/system/error_code.hpp>
 #include <boost/asio/basic_waitable_timer.hpp>
 #include <boost/property_tree/ptree.hpp>
 #include <date/date.h>
 #include <cassandra.h>
-#include <cassobs/dbconnection_observations.h>
 
+#include "storage/observations_storage.h"
 #include "../time_offseter.h"
 #include "weatherlink_apiv2_download_scheduler.h"
 #include "weatherlink_apiv2_downloader.h"
@@ -54,32 +56,19 @@ namespace meteodata
 using namespace date;
 
 WeatherlinkApiv2DownloadScheduler::WeatherlinkApiv2DownloadScheduler(
-	asio::io_context& ioContext, DbConnectionObservations& db,
+	asio::io_context& ioContext, ObservationsStorage& db,
 	std::string apiId, std::string apiSecret,
 	const std::shared_ptr<AsyncJobPublisher>& jobPublisher) :
-		AbstractDownloadScheduler{chrono::minutes{POLLING_PERIOD}, ioContext, db},
+		AbstractDownloadScheduler{chrono::minutes{POLLING_PERIOD}, ioContext, db, "weatherlink_v2"},
 		_apiId{std::move(apiId)},
 		_apiSecret{std::move(apiSecret)},
 		_jobPublisher{jobPublisher}
 {
 }
 
-void WeatherlinkApiv2DownloadScheduler::add(const CassUuid& station, bool archived,
-		const std::map<int, CassUuid>& mapping,
-		const std::map<int, std::map<std::string, std::string>>& parsers,
-		const std::string& weatherlinkId, TimeOffseter&& to)
-{
-	std::lock_guard<std::recursive_mutex> lock{_downloadersMutex};
-	_downloadersAPIv2.emplace_back(
-		archived,
-		std::make_shared<WeatherlinkApiv2Downloader>(station, weatherlinkId, mapping, parsers,
-			_apiId, _apiSecret, _db, std::forward<TimeOffseter&&>(to), _jobPublisher.get())
-	);
-}
-
 void WeatherlinkApiv2DownloadScheduler::download()
 {
-	auto now = chrono::system_clock::now();
+	auto now = SystemClock::now();
 	auto daypoint = date::floor<date::days>(now);
 	auto tod = date::make_time(now - daypoint); // Yields time_of_day type
 	auto minutes = tod.minutes().count();
@@ -123,29 +112,44 @@ void WeatherlinkApiv2DownloadScheduler::downloadArchives(int minutes)
 
 void WeatherlinkApiv2DownloadScheduler::reloadStations()
 {
-	std::lock_guard<std::recursive_mutex> lock{_downloadersMutex};
-
-	_downloadersAPIv2.clear();
-
-	std::vector<std::tuple<CassUuid, bool, std::map<int, CassUuid>, std::string, std::map<int, std::map<std::string, std::string>>>> weatherlinkAPIv2Stations;
+	std::vector<StationDetails> weatherlinkAPIv2Stations;
 	_db.getAllWeatherlinkAPIv2Stations(weatherlinkAPIv2Stations);
-
-	CurlWrapper client;
-	std::unordered_map<std::string, pt::ptree> stations =
-		WeatherlinkApiv2Downloader::downloadAllStations(client, _apiId, _apiSecret);
-
-	for (const auto& station : weatherlinkAPIv2Stations) {
-		auto st = stations.find(std::get<3>(station));
-		if (st == stations.end()) {
-			std::cout << SD_ERR << "[Weatherlink_v2 " << std::get<0>(station) << "] management: "
-					  << "station is absent from the list of stations available in the API, is it unlinked?"
-					  << std::endl;
-			continue;
-		}
-		add(std::get<0>(station), std::get<1>(station), std::get<2>(station),
-			std::get<4>(station), std::get<3>(station),
-			TimeOffseter::getTimeOffseterFor(st->second.get("time_zone", std::string{"UTC"})));
+	weatherlinkAPIv2Stations.erase(std::remove_if(weatherlinkAPIv2Stations.begin(), weatherlinkAPIv2Stations.end(),
+		[](const StationDetails& station) { return !ownsStation(std::get<0>(station)); }),
+		weatherlinkAPIv2Stations.end());
+
+	// The list of stations from the API is only needed to build the
+	// downloaders of new or modified stations, don't fetch it if all the
+	// stations are unchanged, and don't hold the lock (and block the
+	// downloads) during the request
+	bool needsBuilding;
+	{
+		std::lock_guard<std::recursive_mutex> lock{_downloadersMutex};
+		needsBuilding = _downloadersAPIv2.needsBuilding(weatherlinkAPIv2Stations);
 	}
+	std::unordered_map<std::string, pt::ptree> stations;
+	if (needsBuilding) {
+		CurlWrapper client;
+		stations = WeatherlinkApiv2Downloader::downloadAllStations(client, _apiId, _apiSecret);
+	}
+
+	std::lock_guard<std::recursive_mutex> lock{_downloadersMutex};
+	ReloadSummary summary = _downloadersAPIv2.reconcile(std::move(weatherlinkAPIv2Stations),
+		[this, &stations](const StationDetails& station) -> std::optional<std::pair<bool, std::shared_ptr<WeatherlinkApiv2Downloader>>> {
+			auto st = stations.find(std::get<3>(station));
+			if (st == stations.end()) {
+				std::cout << SD_ERR << "[Weatherlink_v2 " << std::get<0>(station) << "] management: "
+						  << "station is absent from the list of stations available in the API, is it unlinked?"
+						  << std::endl;
+				return std::nullopt;
+			}
+			return std::make_pair(std::get<1>(station), std::make_shared<WeatherlinkApiv2Downloader>(
+				std::get<0>(station), std::get<3>(station), std::get<2>(station), std::get<4>(station),
+				_apiId, _apiSecret, _db,
+				TimeOffseter::getTimeOffseterFor(st->second.get("time_zone", std::string{"UTC"})),
+				_jobPublisher.get()));
+		});
+	std::cerr << SD_INFO << "[Weatherlink_v2] management: " << "Stations reloaded: " << summary << std::endl;
 }
 
 }
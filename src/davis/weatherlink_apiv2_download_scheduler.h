@@ -32,6 +32,7 @@
 #include <memory>
 #include <mutex>
 #include <thread>
+#include <tuple>
 
 #include <systemd/sd-daemon.h>
 #include <boost/system/error_code.hpp>
@@ -39,8 +40,8 @@
 #include <boost/asio.hpp>
 #include <boost/asio/basic_waitable_timer.hpp>
 #include <cassandra.h>
-#include <cassobs/dbconnection_observations.h>
 
+#include "storage/observations_storage.h"
 #include "async_job_publisher.h"
 #include "davis/weatherlink_apiv2_downloader.h"
 #include "abstract_download_scheduler.h"
@@ -48,6 +49,7 @@
 #include "curl_wrapper.h"
 #include "cassandra_utils.h"
 #include "connector.h"
+#include "downloader_set.h"
 
 namespace meteodata
 {
@@ -64,17 +66,21 @@ class WeatherlinkApiv2DownloadScheduler : public AbstractDownloadScheduler
 {
 public:
 	WeatherlinkApiv2DownloadScheduler(asio::io_context& ioContext,
-		DbConnectionObservations& db, std::string apiId, std::string apiSecret,
+		ObservationsStorage& db, std::string apiId, std::string apiSecret,
 		const std::shared_ptr<AsyncJobPublisher>& jobPublisher = nullptr);
-	void add(const CassUuid& station, bool archived, const std::map<int, CassUuid>& substations,
-		const std::map<int, std::map<std::string, std::string>>& parsers,
-		const std::string& weatherlinkId, TimeOffseter&& to);
 
 private:
+	/**
+	 * @brief The configuration of a station: its UUID, whether it is an
+	 * archived station, its substations, its Weatherlink id and its
+	 * sensors parsers
+	 */
+	using StationDetails = std::tuple<CassUuid, bool, std::map<int, CassUuid>, std::string, std::map<int, std::map<std::string, std::string>>>;
+
 	const std::string _apiId;
 	const std::string _apiSecret;
 	std::shared_ptr<AsyncJobPublisher> _jobPublisher;
-	std::vector<std::pair<bool, std::shared_ptr<WeatherlinkApiv2Downloader>>> _downloadersAPIv2;
+	DownloaderSet<StationDetails, std::pair<bool, std::shared_ptr<WeatherlinkApiv2Downloader>>> _downloadersAPIv2;
 	std::recursive_mutex _downloadersMutex;
 	bool _mustStop = false;
 
@@ -100,7 +106,10 @@ private:
 	{
 		try {
 			auto start = std::chrono::steady_clock::now();
-			downloadMethod(_client);
+			{
+				IngestionTrace trace{_tracePath};
+				downloadMethod(_client);
+			}
 			auto end = std::chrono::steady_clock::now();
 
 			if (end - start < std::chrono::milliseconds(100)) {
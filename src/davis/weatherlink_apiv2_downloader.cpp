@@ -30,6 +30,7 @@
 #include <utility>
 #include <cstring>
 #include <cctype>
+#include <optional>
 #include <systemd/sd-daemon.h>
 #include <unistd.h>
 
@@ -38,11 +39,13 @@
 #include <boost/asio/streambuf.hpp>
 #include <boost/asio/ssl.hpp>
 #include <cassandra.h>
-#include <cassobs/dbconnection_observations.h>
 #include <cassobs/dto/download.h>
 #include <date/date.h>
 
+#include "storage/observations_storage.h"
 #include "meteo_server.h"
+#include "archive_pipeline.h"
+#include "archive_cleanup.h"
 #include "time_offseter.h"
 #include "http_utils.h"
 #include "cassandra_utils.h"
@@ -53,6 +56,7 @@
 #include "davis/weatherlink_apiv2_archive_message.h"
 #include "davis/weatherlink_apiv2_downloader.h"
 #include "davis/weatherlink_apiv2_download_scheduler.h"
+#include "monitoring/ingestion_trace.h"
 
 #if EVENT_MANAGER_ON
 #include "event/event_manager.h"
@@ -101,7 +105,7 @@ WeatherlinkApiv2Downloader::WeatherlinkApiv2Downloader(const CassUuid& station,
 	std::map<int, CassUuid> mapping,
 	std::map<int, std::map<std::string, std::string>> parsers,
 	const std::string& apiKey, const std::string& apiSecret,
-	DbConnectionObservations& db, TimeOffseter&& to, AsyncJobPublisher* jobPublisher) :
+	ObservationsStorage& db, TimeOffseter&& to, AsyncJobPublisher* jobPublisher) :
 		AbstractWeatherlinkDownloader(station, db, std::forward<TimeOffseter&&>(to), jobPublisher),
 		_apiKey(apiKey),
 		_apiSecret(apiSecret),
@@ -116,7 +120,7 @@ WeatherlinkApiv2Downloader::WeatherlinkApiv2Downloader(const CassUuid& station,
 	std::map<int, CassUuid> mapping,
 	std::map<int, std::map<std::string, std::string>> parsers,
 	const std::string& apiKey, const std::string& apiSecret,
-	DbConnectionObservations& db, TimeOffseter::PredefinedTimezone tz, AsyncJobPublisher* jobPublisher) :
+	ObservationsStorage& db, TimeOffseter::PredefinedTimezone tz, AsyncJobPublisher* jobPublisher) :
 		AbstractWeatherlinkDownloader(station, db, tz, jobPublisher),
 		_apiKey(apiKey),
 		_apiSecret(apiSecret),
@@ -183,7 +187,7 @@ void WeatherlinkApiv2Downloader::downloadRealTime(CurlWrapper& client)
 	}
 }
 
-void WeatherlinkApiv2Downloader::downloadOnlyRealTime(DbConnectionObservations& db, CurlWrapper& client,
+void WeatherlinkApiv2Downloader::downloadOnlyRealTime(ObservationsStorage& db, CurlWrapper& client,
 	const CassUuid& station, const std::string& weatherlinkId,
 	const std::string& apiKey, const std::string& apiSecret
 )
@@ -217,6 +221,7 @@ void WeatherlinkApiv2Downloader::ingestRealTime()
 {
 	std::vector<Download> downloads;
 	_db.selectDownloadsByStation(_station, DOWNLOAD_CONNECTOR_ID, downloads);
+	IngestionTrace::markCurrent(IngestionTrace::Stage::RECEIVED);
 
 	if (downloads.empty()) {
 		std::cout << SD_WARNING << "[Weatherlink_v2 " << _station << "] measurement: "
@@ -236,6 +241,7 @@ void WeatherlinkApiv2Downloader::ingestRealTime()
 		} else {
 			_db.updateDownloadStatus(d.station, chrono::system_clock::to_time_t(d.datetime), true, "completed");
 		}
+		IngestionTrace::markCurrent(IngestionTrace::Stage::STORED);
 	}
 }
 
@@ -254,6 +260,8 @@ bool WeatherlinkApiv2Downloader::doProcessRealtimeMessage(const std::string& con
 		else
 			page.parse(contentStream, _substations, u, _parsers);
 
+		IngestionTrace::markCurrent(IngestionTrace::Stage::DECODED);
+
 		for (auto&& it = page.begin() ; it != page.end() && inserted ; ++it) {
 			auto o = it->getObservation(u);
 			allObs.push_back(o);
@@ -265,6 +273,7 @@ bool WeatherlinkApiv2Downloader::doProcessRealtimeMessage(const std::string& con
 		}
 	}
 	inserted = _db.insertV2DataPointsInTimescaleDB(allObs.begin(), allObs.end());
+	IngestionTrace::markCurrent(IngestionTrace::Stage::STORED);
 
 #if EVENT_MANAGER_ON
 	if (inserted) {
@@ -275,6 +284,7 @@ bool WeatherlinkApiv2Downloader::doProcessRealtimeMessage(const std::string& con
 		}
 	}
 #endif
+	IngestionTrace::markCurrent(IngestionTrace::Stage::PUBLISHED);
 
 	return inserted;
 }
@@ -347,31 +357,49 @@ void WeatherlinkApiv2Downloader::download(CurlWrapper& client, bool force)
 		return;
 	}
 
-	while (date < end) {
-		auto datePlus24Hours = date + chrono::hours{24};
-
-		std::ostringstream query;
-		query << "/v2/historic/" << _weatherlinkId << "?" << "api-key=" << _apiKey
-			  << "&" << "start-timestamp=" << std::to_string(chrono::system_clock::to_time_t(date))
-			  << "&" << "end-timestamp=" << std::to_string(chrono::system_clock::to_time_t(datePlus24Hours));
-		std::string queryStr = query.str();
-		std::cout << SD_DEBUG << "[Weatherlink_v2 " << _station << "] protocol: " << "GET " << queryStr << " HTTP/1.1 "
-			  << "Host: " << WeatherlinkApiv2DownloadScheduler::APIHOST << " " << "Accept: application/json ";
-
-		client.setHeader("Accept", "application/json");
-		client.setHeader("X-Api-Secret", _apiSecret);
-
-		CURLcode ret = client.download(BASE_URL + queryStr, [&](const std::string& content) {
-			bool insertionOk = true;
-			auto referenceTimestamp = _lastArchive;
-
-			std::vector<Observation> allObs;
+	// The pages are parsed in the decode thread while _lastArchive may be
+	// updated in the store thread, so parse relative to a snapshot, the
+	// windows do not overlap anyway
+	const date::sys_seconds lastArchive = _lastArchive;
+
+	ArchivePipeline<std::string, std::vector<SubstationArchive>> pipeline;
+	pipeline.run(
+		[&]() -> std::optional<std::string> {
+			if (date >= end)
+				return std::nullopt;
+
+			auto datePlus24Hours = date + chrono::hours{24};
+
+			std::ostringstream query;
+			query << "/v2/historic/" << _weatherlinkId << "?" << "api-key=" << _apiKey
+				  << "&" << "start-timestamp=" << std::to_string(chrono::system_clock::to_time_t(date))
+				  << "&" << "end-timestamp=" << std::to_string(chrono::system_clock::to_time_t(datePlus24Hours));
+			std::string queryStr = query.str();
+			std::cout << SD_DEBUG << "[Weatherlink_v2 " << _station << "] protocol: " << "GET " << queryStr << " HTTP/1.1 "
+				  << "Host: " << WeatherlinkApiv2DownloadScheduler::APIHOST << " " << "Accept: application/json ";
+
+			client.setHeader("Accept", "application/json");
+			client.setHeader("X-Api-Secret", _apiSecret);
+
+			std::string body;
+			CURLcode ret = client.download(BASE_URL + queryStr, [&](const std::string& content) {
+				body = content;
+			});
+
+			if (ret != CURLE_OK)
+				logAndThrowCurlError(client);
+
+			date = datePlus24Hours;
+			return body;
+		},
+		[&](std::string&& content) {
+			std::vector<SubstationArchive> archives;
 			for (const auto& u : _uuids) {
 				std::istringstream contentStream(content); // rewind
 
 				std::cout << SD_DEBUG << "[Weatherlink_v2 " << _station << "] measurement: "
 					  << " parsing output for substation " << u << std::endl;
-				WeatherlinkApiv2ArchivePage page(_lastArchive, &_timeOffseter);
+				WeatherlinkApiv2ArchivePage page(lastArchive, &_timeOffseter);
 				if (_substations.empty())
 					page.parse(contentStream);
 				else
@@ -381,40 +409,47 @@ void WeatherlinkApiv2Downloader::download(CurlWrapper& client, bool force)
 				auto newestTimestamp = page.getNewestMessageTime();
 
 				std::cerr << SD_DEBUG << "[Weatherlink_v2 " << _station << "] measurement: "
-					  << "last archive " << date::format("%F %TZ", _lastArchive) << "\n"
+					  << "last archive " << date::format("%F %TZ", lastArchive) << "\n"
 					  << "oldest timestamp " << date::format("%F %TZ", oldestTimestamp) << "\n"
 					  << "newest timestamp " << date::format("%F %TZ", newestTimestamp)
 					  << std::endl;
 
 				// In case the archive is empty or has corrupted
 				// dates
-				if (oldestTimestamp > newestTimestamp || newestTimestamp <= _lastArchive) {
+				if (oldestTimestamp > newestTimestamp || newestTimestamp <= lastArchive) {
 					std::cerr << SD_WARNING << "[Weatherlink_v2 " << _station << "] measurement: "
 						  << "no new archive observation for substation " << u << std::endl;
 					continue;
 				}
 
+				SubstationArchive archive{u, oldestTimestamp, newestTimestamp, {}};
+				for (const WeatherlinkApiv2ArchiveMessage& m : page)
+					archive.observations.push_back(m.getObservation(u));
+				archives.push_back(std::move(archive));
+			}
+			return archives;
+		},
+		[&](std::vector<SubstationArchive>&& archives) {
+			bool insertionOk = true;
+			auto referenceTimestamp = _lastArchive;
+
+			std::vector<Observation> allObs;
+			for (const SubstationArchive& archive : archives) {
 				// This is used to trigger the climatology computation later
-				_oldestArchive = std::min(_oldestArchive, oldestTimestamp);
-				_newestArchive = std::max(_newestArchive, newestTimestamp);
-				referenceTimestamp = newestTimestamp;
-
-				auto removedDay = date::floor<date::days>(_lastArchive);
-				while (removedDay <= _newestArchive) {
-					int ret = _db.deleteDataPoints(u, removedDay, oldestTimestamp, newestTimestamp);
-
-					if (!ret)
-						std::cerr << SD_ERR << "[Weatherlink_v2 " << _station << "] management: "
-							  << "couldn't delete temporary realtime observations" << std::endl;
-					removedDay += date::days(1);
-				}
-				for (const WeatherlinkApiv2ArchiveMessage& m : page) {
-					auto o = m.getObservation(u);
+				_oldestArchive = std::min(_oldestArchive, archive.oldest);
+				_newestArchive = std::max(_newestArchive, archive.newest);
+				referenceTimestamp = archive.newest;
+
+				if (!deleteSupersededRealtimeObservations(_db, archive.station, _lastArchive, archive.oldest, archive.newest,
+						chrono::minutes{_pollingPeriod}))
+					std::cerr << SD_ERR << "[Weatherlink_v2 " << _station << "] management: "
+						  << "couldn't delete temporary realtime observations" << std::endl;
+				for (const Observation& o : archive.observations) {
 					allObs.push_back(o);
 					int ret = _db.insertV2DataPoint(o);
 					if (!ret) {
 						std::cerr << SD_ERR << "[Weatherlink_v2 " << _station << "] measurement: "
-								  << "failed to insert archive observation for substation " << u << std::endl;
+								  << "failed to insert archive observation for substation " << archive.station << std::endl;
 						insertionOk = false;
 					}
 				}
@@ -438,17 +473,16 @@ void WeatherlinkApiv2Downloader::download(CurlWrapper& client, bool force)
 			}
 
 			bool ret = _db.insertV2DataPointsInTimescaleDB(allObs.begin(), allObs.end());
-			if (!insertionOk) {
+			if (!ret) {
 				std::cerr << SD_ERR << "[Weatherlink_v2 " << _station << "] measurement: "
 					  << "couldn't insert data in TimescaleDB" << std::endl;
 			}
-		});
-
-		if (ret != CURLE_OK)
-			logAndThrowCurlError(client);
 
-		date += chrono::hours{24};
-	}
+			// Do not go on with the next windows if this one could not
+			// be stored, the last archive download time would skip over it
+			return insertionOk;
+		}
+	);
 }
 
 void WeatherlinkApiv2Downloader::logAndThrowCurlError(CurlWrapper& client)
@@ -35,7 +35,7 @@
 #include <boost/asio.hpp>
 #include <boost/asio/ssl.hpp>
 #include <boost/property_tree/ptree.hpp>
-#include <cassobs/dbconnection_observations.h>
+#include "storage/observations_storage.h"
 #include "async_job_publisher.h"
 
 #include "../time_offseter.h"
@@ -60,18 +60,18 @@ public:
 	WeatherlinkApiv2Downloader(const CassUuid& station, std::string  weatherlinkId,
 		std::map<int, CassUuid>  mapping, std::map<int, std::map<std::string, std::string>> parsers,
 		const std::string& apiKey, const std::string& apiSecret,
-		DbConnectionObservations& db, TimeOffseter&& to, AsyncJobPublisher* jobPublisher = nullptr);
+		ObservationsStorage& db, TimeOffseter&& to, AsyncJobPublisher* jobPublisher = nullptr);
 	WeatherlinkApiv2Downloader(const CassUuid& station, std::string  weatherlinkId,
 		std::map<int, CassUuid>  mapping, std::map<int, std::map<std::string, std::string>> parsers,
 		const std::string& apiKey, const std::string& apiSecret,
-		DbConnectionObservations& db, TimeOffseter::PredefinedTimezone tz, AsyncJobPublisher* jobPublisher = nullptr);
+		ObservationsStorage& db, TimeOffseter::PredefinedTimezone tz, AsyncJobPublisher* jobPublisher = nullptr);
 	void download(CurlWrapper& client, bool force = false);
 	void downloadRealTime(CurlWrapper& client);
 	void ingestRealTime();
 	static std::unordered_map<std::string, boost::property_tree::ptree>
 	downloadAllStations(CurlWrapper& client, const std::string& apiId, const std::string& apiSecret);
 
-	static void downloadOnlyRealTime(DbConnectionObservations& db, CurlWrapper& client,
+	static void downloadOnlyRealTime(ObservationsStorage& db, CurlWrapper& client,
 		const CassUuid& station, const std::string& weatherlinkId,
 		const std::string& apiKey, const std::string& apiSecret
 	);
@@ -107,6 +107,18 @@ private:
 
 	std::map<CassUuid, float> _lastDayRainfall;
 
+	/**
+	 * @brief The archive of one substation parsed from a page of the
+	 * Weatherlink API, ready to be stored
+	 */
+	struct SubstationArchive
+	{
+		CassUuid station;
+		date::sys_seconds oldest;
+		date::sys_seconds newest;
+		std::vector<Observation> observations;
+	};
+
 	void initialize();
 
 	float getDayRainfall(const CassUuid& uuid, const date::sys_seconds& datetime = date::floor<std::chrono::seconds>(std::chrono::system_clock::now()));
@@ -21,6 +21,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <memory>
 #include <iostream>
 #include <fstream>
 #include <unistd.h>
@@ -34,9 +35,9 @@
 #include <boost/asio.hpp>
 #include <boost/asio/ssl.hpp>
 #include <boost/program_options.hpp>
-#include <cassobs/dbconnection_observations.h>
 #include <cassandra.h>
 
+#include "storage/observations_storage.h"
 #include "config.h"
 #include "../cassandra_utils.h"
 #include "weatherlink_apiv2_downloader.h"
@@ -73,6 +74,7 @@ int main(int argc, char** argv)
 	std::string pguser;
 	std::string pgpassword;
 	std::string pgaddress;
+	StorageConfiguration storageConfig;
 	std::vector<std::string> namedStations;
 	std::string weatherlinkApiV2Key;
 	std::string weatherlinkApiV2Secret;
@@ -85,6 +87,9 @@ int main(int argc, char** argv)
 		("pguser", po::value<std::string>(&pguser), "PostgreSQL database username")
 		("pgpassword", po::value<std::string>(&pgpassword), "PostgreSQL database password")
 		("pghost", po::value<std::string>(&pgaddress), "PostgreSQL database IP address or domain name")
+		("storage", po::value<std::string>(&storageConfig.backend), "storage backend, 'cassandra' (Cassandra and PostgreSQL databases) or 'memory' (in-process stand-in keeping everything in memory, for benchmarks), defaults to 'cassandra'")
+		("station-table", po::value<std::string>(&storageConfig.stationTable), "with the 'memory' storage, file listing the stations and connectors to serve")
+		("storage-latency", po::value<unsigned long>(&storageConfig.latency), "with the 'memory' storage, delay in microseconds added to each call, defaults to 0")
 		("weatherlink-apiv2-key,k", po::value<std::string>(&weatherlinkApiV2Key), "api.weatherlink.com/v2/ key")
 		("weatherlink-apiv2-secret,s", po::value<std::string>(&weatherlinkApiV2Secret), "api.weatherlink.com/v2/ secret")
 	;
@@ -155,7 +160,9 @@ int main(int argc, char** argv)
 
 		// Start the Weatherlink downloaders workers (one per Weatherlink station)
 		std::vector<std::tuple<CassUuid, bool, std::map<int, CassUuid>, std::string, std::map<int, std::map<std::string, std::string>> >> weatherlinkStations;
-		DbConnectionObservations db{address, user, password, pgaddress, pguser, pgpassword};
+		std::unique_ptr<ObservationsStorage> storage = ObservationsStorage::create(storageConfig,
+			address, user, password, pgaddress, pguser, pgpassword);
+		ObservationsStorage& db = *storage;
 		db.getAllWeatherlinkAPIv2Stations(weatherlinkStations);
 		std::cerr << "Got the list of stations from the db" << std::endl;
 
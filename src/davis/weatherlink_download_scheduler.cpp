@@ -28,14 +28,15 @@
 #include <unordered_map>
 #include <memory>
 #include <mutex>
+#include <optional>
 
 #include <boost/system/error_code.hpp>
 #include <boost/asio/basic_waitable_timer.hpp>
 #include <boost/property_tree/ptree.hpp>
 #include <date/date.h>
 #include <cassandra.h>
-#include <cassobs/dbconnection_observations.h>
 
+#include "storage/observations_storage.h"
 #include "../time_offseter.h"
 #include "weatherlink_download_scheduler.h"
 #include "weatherlink_downloader.h"
@@ -54,23 +55,16 @@ namespace meteodata
 using namespace date;
 
 WeatherlinkDownloadScheduler::WeatherlinkDownloadScheduler(
-	asio::io_context& ioContext, DbConnectionObservations& db,
+	asio::io_context& ioContext, ObservationsStorage& db,
 	const std::shared_ptr<AsyncJobPublisher>& jobPublisher) :
-		AbstractDownloadScheduler{chrono::minutes{POLLING_PERIOD}, ioContext, db},
+		AbstractDownloadScheduler{chrono::minutes{POLLING_PERIOD}, ioContext, db, "weatherlink"},
 		_jobPublisher{jobPublisher}
 {
 }
 
-void WeatherlinkDownloadScheduler::add(const CassUuid& station, const std::string& auth, const std::string& apiToken,
-				       TimeOffseter::PredefinedTimezone tz)
-{
-	std::lock_guard<std::recursive_mutex> lock{_downloadersMutex};
-	_downloaders.emplace_back(std::make_shared<WeatherlinkDownloader>(station, auth, apiToken, _db, tz, _jobPublisher.get()));
-}
-
 void WeatherlinkDownloadScheduler::download()
 {
-	auto now = chrono::system_clock::now();
+	auto now = SystemClock::now();
 	auto daypoint = date::floor<date::days>(now);
 	auto tod = date::make_time(now - daypoint); // Yields time_of_day type
 	auto minutes = tod.minutes().count();
@@ -102,15 +96,19 @@ void WeatherlinkDownloadScheduler::downloadArchives(int minutes)
 
 void WeatherlinkDownloadScheduler::reloadStations()
 {
-	std::lock_guard<std::recursive_mutex> lock{_downloadersMutex};
-	_downloaders.clear();
-
-	std::vector<std::tuple<CassUuid, std::string, std::string, int>> weatherlinkStations;
+	std::vector<StationDetails> weatherlinkStations;
 	_db.getAllWeatherlinkStations(weatherlinkStations);
-	for (const auto& station : weatherlinkStations) {
-		add(std::get<0>(station), std::get<1>(station), std::get<2>(station),
-			TimeOffseter::PredefinedTimezone(std::get<3>(station)));
-	}
+
+	std::lock_guard<std::recursive_mutex> lock{_downloadersMutex};
+	ReloadSummary summary = _downloaders.reconcile(std::move(weatherlinkStations),
+		[this](const StationDetails& station) -> std::optional<std::shared_ptr<WeatherlinkDownloader>> {
+			if (!ownsStation(std::get<0>(station)))
+				return std::nullopt;
+			return std::make_shared<WeatherlinkDownloader>(std::get<0>(station), std::get<1>(station),
+				std::get<2>(station), _db, TimeOffseter::PredefinedTimezone(std::get<3>(station)),
+				_jobPublisher.get());
+		});
+	std::cerr << SD_INFO << "[Weatherlink] management: " << "Stations reloaded: " << summary << std::endl;
 }
 
 }
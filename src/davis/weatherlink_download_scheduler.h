@@ -32,6 +32,7 @@
 #include <memory>
 #include <mutex>
 #include <thread>
+#include <tuple>
 
 #include <systemd/sd-daemon.h>
 #include <boost/system/error_code.hpp>
@@ -39,8 +40,8 @@
 #include <boost/asio.hpp>
 #include <boost/asio/basic_waitable_timer.hpp>
 #include <cassandra.h>
-#include <cassobs/dbconnection_observations.h>
 
+#include "storage/observations_storage.h"
 #include "async_job_publisher.h"
 #include "davis/weatherlink_downloader.h"
 #include "davis/weatherlink_apiv2_downloader.h"
@@ -49,6 +50,7 @@
 #include "curl_wrapper.h"
 #include "cassandra_utils.h"
 #include "connector.h"
+#include "downloader_set.h"
 
 namespace meteodata
 {
@@ -65,14 +67,18 @@ class WeatherlinkDownloadScheduler : public AbstractDownloadScheduler
 {
 public:
 	WeatherlinkDownloadScheduler(asio::io_context& ioContext,
-		DbConnectionObservations& db,
+		ObservationsStorage& db,
 		const std::shared_ptr<AsyncJobPublisher>& jobPublisher = nullptr);
-	void add(const CassUuid& station, const std::string& auth, const std::string& apiToken,
-		TimeOffseter::PredefinedTimezone tz);
 
 private:
+	/**
+	 * @brief The configuration of a station: its UUID, its
+	 * authentication string, its API token and its timezone
+	 */
+	using StationDetails = std::tuple<CassUuid, std::string, std::string, int>;
+
 	std::shared_ptr<AsyncJobPublisher> _jobPublisher;
-	std::vector<std::shared_ptr<WeatherlinkDownloader>> _downloaders;
+	DownloaderSet<StationDetails, std::shared_ptr<WeatherlinkDownloader>> _downloaders;
 	std::recursive_mutex _downloadersMutex;
 	bool _mustStop = false;
 
@@ -89,7 +95,10 @@ private:
 	{
 		try {
 			auto start = std::chrono::steady_clock::now();
-			downloadMethod(_client);
+			{
+				IngestionTrace trace{_tracePath};
+				downloadMethod(_client);
+			}
 			auto end = std::chrono::steady_clock::now();
 
 			if (end - start < std::chrono::milliseconds(100)) {
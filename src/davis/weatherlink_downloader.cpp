@@ -38,8 +38,8 @@
 #include <boost/asio/streambuf.hpp>
 #include <boost/asio/basic_waitable_timer.hpp>
 #include <cassandra.h>
-#include <cassobs/dbconnection_observations.h>
 
+#include "storage/observations_storage.h"
 #include "../http_utils.h"
 #include "../time_offseter.h"
 #include "weatherlink_apiv1_realtime_message.h"
@@ -48,6 +48,7 @@
 #include "vantagepro2_message.h"
 #include "vantagepro2_archive_page.h"
 #include "../curl_wrapper.h"
+#include "../archive_cleanup.h"
 
 namespace asio = boost::asio;
 namespace ip = boost::asio::ip;
@@ -65,7 +66,7 @@ const std::string WeatherlinkDownloader::REALTIME_BASE_URL =
 const std::string WeatherlinkDownloader::ARCHIVE_BASE_URL = std::string{"http://"} + WeatherlinkDownloadScheduler::HOST;
 
 WeatherlinkDownloader::WeatherlinkDownloader(const CassUuid& station, std::string auth,
-			std::string apiToken, DbConnectionObservations& db,
+			std::string apiToken, ObservationsStorage& db,
 			TimeOffseter::PredefinedTimezone tz, AsyncJobPublisher* jobPublisher) :
 		AbstractWeatherlinkDownloader(station, db, tz),
 		_authentication{std::move(auth)},
@@ -227,37 +228,25 @@ void WeatherlinkDownloader::download(CurlWrapper& client)
 			}
 		}
 
-		auto day = date::floor<date::days>(start);
-		auto lastDay = date::floor<date::days>(end);
-		int i = 0;
-		int LOG_FLOODING_LIMIT = 100;
-		while (day <= lastDay) {
-			ret = _db.deleteDataPoints(_station, day, start, end);
-
+		if (!messages.empty()) {
+			ret = deleteSupersededRealtimeObservations(_db, _station, _lastArchive, start, end,
+				chrono::minutes{_pollingPeriod});
 			if (!ret)
 				std::cerr << SD_ERR << "[Weatherlink_v1 " << _station << "] management: "
 					  << "couldn't delete temporary realtime observations "
 					  << "between " << date::format("%Y-%m-%dT%H:%M", start)
 					  << " and " << date::format("%Y-%m-%dT%H:%M", end)
 					  << std::endl;
-			day += date::days(1);
-
-			// avoid flooding the log too much
-			if (i % LOG_FLOODING_LIMIT == 0) {
-				std::cerr << SD_DEBUG << "[Weatherlink_v1 " << _station << "] measurement: "
-					  << "Data deleted until "
-					  << date::format("%Y-%m-%dT%H:%M", end)
+			else
+				std::cerr << SD_INFO << "[Weatherlink_v1 " << _station << "] management: "
+					  << "Deleted temporary data "
+					  << "between " << date::format("%Y-%m-%dT%H:%M", start)
+					  << " and " << date::format("%Y-%m-%dT%H:%M", end)
 					  << std::endl;
-			}
-			i++;
 		}
-		std::cerr << SD_INFO << "[Weatherlink_v1 " << _station << "] management: "
-			  << "Deleted temporary data "
-			  << "between " << date::format("%Y-%m-%dT%H:%M", start)
-			  << " and " << date::format("%Y-%m-%dT%H:%M", end)
-			  << std::endl;
 
-		i = 0;
+		int i = 0;
+		int LOG_FLOODING_LIMIT = 100;
 		std::vector<Observation> allObs;
 		for (auto&& message : messages) {
 			auto lastArchive = message.getTimestamp();
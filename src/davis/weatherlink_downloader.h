@@ -37,7 +37,7 @@
 #include <cassandra.h>
 #include <date/date.h>
 #include <date/tz.h>
-#include <cassobs/dbconnection_observations.h>
+#include "storage/observations_storage.h"
 #include "async_job_publisher.h"
 
 #include "abstract_weatherlink_downloader.h"
@@ -61,7 +61,7 @@ class WeatherlinkDownloader : public AbstractWeatherlinkDownloader
 {
 public:
 	WeatherlinkDownloader(const CassUuid& station, std::string auth, std::string apiToken,
-		DbConnectionObservations& db, TimeOffseter::PredefinedTimezone tz, AsyncJobPublisher* jobPublisher = nullptr);
+		ObservationsStorage& db, TimeOffseter::PredefinedTimezone tz, AsyncJobPublisher* jobPublisher = nullptr);
 	void download(CurlWrapper& client);
 	void downloadRealTime(CurlWrapper& client);
 
@@ -21,6 +21,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <memory>
 #include <iostream>
 #include <fstream>
 #include <unistd.h>
@@ -33,9 +34,9 @@
 
 #include <boost/asio.hpp>
 #include <boost/program_options.hpp>
-#include <cassobs/dbconnection_observations.h>
 #include <cassandra.h>
 
+#include "storage/observations_storage.h"
 #include "config.h"
 #include "../cassandra_utils.h"
 #include "../curl_wrapper.h"
@@ -72,6 +73,7 @@ int main(int argc, char** argv)
 	std::string pguser;
 	std::string pgpassword;
 	std::string pgaddress;
+	StorageConfiguration storageConfig;
 	std::vector<std::string> namedStations;
 
 	po::options_description config("Configuration");
@@ -82,6 +84,9 @@ int main(int argc, char** argv)
 		("pguser", po::value<std::string>(&pguser), "PostgreSQL database username")
 		("pgpassword", po::value<std::string>(&pgpassword), "PostgreSQL database password")
 		("pghost", po::value<std::string>(&pgaddress), "PostgreSQL database IP address or domain name")
+		("storage", po::value<std::string>(&storageConfig.backend), "storage backend, 'cassandra' (Cassandra and PostgreSQL databases) or 'memory' (in-process stand-in keeping everything in memory, for benchmarks), defaults to 'cassandra'")
+		("station-table", po::value<std::string>(&storageConfig.stationTable), "with the 'memory' storage, file listing the stations and connectors to serve")
+		("storage-latency", po::value<unsigned long>(&storageConfig.latency), "with the 'memory' storage, delay in microseconds added to each call, defaults to 0")
 		("weatherlink-apiv2-key,k", po::value<std::string>(), "Ignored")
 		("weatherlink-apiv2-secret,s", po::value<std::string>(), "Ignored")
 	;
@@ -151,7 +156,9 @@ int main(int argc, char** argv)
 
 		// Start the Weatherlink downloaders workers (one per Weatherlink station)
 		std::vector<std::tuple<CassUuid, std::string, std::string, int>> weatherlinkStations;
-		DbConnectionObservations db{address, user, password, pgaddress, pguser, pgpassword};
+		std::unique_ptr<ObservationsStorage> storage = ObservationsStorage::create(storageConfig,
+			address, user, password, pgaddress, pguser, pgpassword);
+		ObservationsStorage& db = *storage;
 		db.getAllWeatherlinkStations(weatherlinkStations);
 		std::cerr << "Got the list of stations from the db" << std::endl;
 
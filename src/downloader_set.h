@@ -0,0 +1,214 @@
+/**
+ * @file downloader_set.h
+ * @brief Definition of the DownloaderSet class
+ * @author Laurent Georget
+ * @date 2026-10-18
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DOWNLOADER_SET_H
+#define DOWNLOADER_SET_H
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <optional>
+#include <ostream>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <cassandra.h>
+
+#include "cassandra_utils.h"
+
+namespace meteodata
+{
+
+/**
+ * @brief The outcome of the reload of a \a DownloaderSet
+ */
+struct ReloadSummary
+{
+	std::size_t added = 0;   /*!< The number of new stations */
+	std::size_t updated = 0; /*!< The number of stations whose downloader has been rebuilt */
+	std::size_t removed = 0; /*!< The number of stations dropped */
+	std::size_t kept = 0;    /*!< The number of downloaders left untouched */
+};
+
+inline std::ostream& operator<<(std::ostream& os, const ReloadSummary& summary)
+{
+	os << summary.added << " added, " << summary.updated << " updated, "
+	   << summary.removed << " removed, " << summary.kept << " unchanged";
+	return os;
+}
+
+/**
+ * @brief The downloaders of a scheduler, one per station, with the
+ * configuration each of them has been built from
+ *
+ * Upon a reload, the scheduler hands over the new configuration of all its
+ * stations, the set only builds the downloaders of the stations that are new
+ * or whose configuration has changed, and drops those of the stations that
+ * are gone. The other downloaders are kept as they are, with their cached
+ * state.
+ *
+ * The set is not thread-safe, schedulers protect it with the same mutex as
+ * before.
+ *
+ * @tparam Details The configuration of a station as read from the database,
+ * a tuple whose first element is the UUID of the station
+ * @tparam Entry What the scheduler stores for each station, typically a
+ * shared pointer to the downloader
+ */
+template<typename Details, typename Entry>
+class DownloaderSet
+{
+public:
+	/**
+	 * @brief Build the downloader of a station, or nothing if the station
+	 * must be skipped
+	 */
+	using Factory = std::function<std::optional<Entry>(const Details&)>;
+
+	/**
+	 * @brief Replace the stations by a new list, reusing the downloaders
+	 * of the stations whose configuration is unchanged
+	 *
+	 * The downloaders are ordered like the stations in the list.
+	 *
+	 * @param stations The new configuration of all the stations
+	 * @param make The function to call to build the downloaders of the
+	 * stations that are new or modified
+	 * @return What has changed
+	 */
+	ReloadSummary reconcile(std::vector<Details>&& stations, const Factory& make)
+	{
+		// Build the new set aside and only replace the current one at
+		// the end so that it is left intact if the factory throws
+		ReloadSummary changes;
+		std::map<CassUuid, Slot> slots;
+		std::vector<Entry> entries;
+		entries.reserve(stations.size());
+
+		for (auto&& details : stations) {
+			const CassUuid& uuid = std::get<0>(details);
+			if (slots.count(uuid))
+				continue;
+
+			auto it = _slots.find(uuid);
+			if (it != _slots.end() && it->second.details == details) {
+				entries.push_back(it->second.entry);
+				slots.emplace(uuid, it->second);
+				changes.kept++;
+				continue;
+			}
+
+			std::optional<Entry> entry = make(details);
+			if (!entry)
+				continue;
+
+			if (it != _slots.end())
+				changes.updated++;
+			else
+				changes.added++;
+			entries.push_back(*entry);
+			CassUuid key = uuid;
+			slots.emplace(key, Slot{std::move(details), std::move(*entry)});
+		}
+
+		// whatever is not in the new set is gone from the configuration
+		for (const auto& slot : _slots) {
+			if (!slots.count(slot.first))
+				changes.removed++;
+		}
+		_slots = std::move(slots);
+		_entries = std::move(entries);
+		return changes;
+	}
+
+	/**
+	 * @brief Tell whether a reconciliation with a new list of stations
+	 * would have to build some downloaders
+	 *
+	 * Schedulers whose factory needs an expensive resource (a download
+	 * for instance) use it to get that resource beforehand, without
+	 * holding their mutex.
+	 *
+	 * @param stations The new configuration of all the stations
+	 * @return True if and only if some stations are new or modified
+	 */
+	bool needsBuilding(const std::vector<Details>& stations) const
+	{
+		for (const auto& details : stations) {
+			auto it = _slots.find(std::get<0>(details));
+			if (it == _slots.end() || !(it->second.details == details))
+				return true;
+		}
+		return false;
+	}
+
+	/**
+	 * @brief Drop all the downloaders
+	 */
+	void clear()
+	{
+		_slots.clear();
+		_entries.clear();
+	}
+
+	typename std::vector<Entry>::const_iterator begin() const
+	{
+		return _entries.begin();
+	}
+
+	typename std::vector<Entry>::const_iterator end() const
+	{
+		return _entries.end();
+	}
+
+	std::size_t size() const
+	{
+		return _entries.size();
+	}
+
+	bool empty() const
+	{
+		return _entries.empty();
+	}
+
+private:
+	struct Slot
+	{
+		Details details;
+		Entry entry;
+	};
+
+	/**
+	 * @brief The configuration and downloader of each station
+	 */
+	std::map<CassUuid, Slot> _slots;
+	/**
+	 * @brief The downloaders, in the order of the last reload
+	 */
+	std::vector<Entry> _entries;
+};
+
+}
+
+#endif /* DOWNLOADER_SET_H */
@@ -39,7 +39,7 @@ namespace meteodata
 namespace chrono = std::chrono;
 namespace json = boost::json;
 
-Cpl01PluviometerMessage::Cpl01PluviometerMessage(DbConnectionObservations& db):
+Cpl01PluviometerMessage::Cpl01PluviometerMessage(ObservationsStorage& db):
 	_db{db}
 {}
 
@@ -33,10 +33,11 @@
 #include <boost/json.hpp>
 #include <date/date.h>
 #include <cassobs/observation.h>
-#include <cassobs/dbconnection_observations.h>
 #include <cassandra.h>
 
+#include "storage/observations_storage.h"
 #include "liveobjects/liveobjects_message.h"
+#include "monitoring/profiled_db_connection.h"
 
 namespace meteodata
 {
@@ -47,7 +48,7 @@ namespace meteodata
 class Cpl01PluviometerMessage : public LiveobjectsMessage
 {
 public:
-	explicit Cpl01PluviometerMessage(DbConnectionObservations& db);
+	explicit Cpl01PluviometerMessage(ObservationsStorage& db);
 
 	void ingest(const CassUuid& station, const std::string& payload, const date::sys_seconds& datetime) override;
 
@@ -66,7 +67,7 @@ private:
 	/**
 	 * A reference to the database connection, to get or store cached values
 	 */
-	DbConnectionObservations& _db;
+	ProfiledDbConnection _db;
 
 	/**
 	 * @brief A struct used to store observation values to then populate the
@@ -41,7 +41,7 @@ namespace meteodata
 namespace chrono = std::chrono;
 namespace json = boost::json;
 
-ThplloraMessage::ThplloraMessage(DbConnectionObservations& db, std::optional<int> forcedRainfallCount):
+ThplloraMessage::ThplloraMessage(ObservationsStorage& db, std::optional<int> forcedRainfallCount):
 	_db{db},
 	_forcedRainfallCount{forcedRainfallCount}
 {}
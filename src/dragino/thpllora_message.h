@@ -34,10 +34,11 @@
 #include <boost/json.hpp>
 #include <date/date.h>
 #include <cassobs/observation.h>
-#include <cassobs/dbconnection_observations.h>
 #include <cassandra.h>
 
+#include "storage/observations_storage.h"
 #include "liveobjects/liveobjects_message.h"
+#include "monitoring/profiled_db_connection.h"
 
 namespace meteodata
 {
@@ -48,7 +49,7 @@ namespace meteodata
 class ThplloraMessage : public LiveobjectsMessage
 {
 public:
-	ThplloraMessage(DbConnectionObservations& db, std::optional<int> forceRainfallCount = std::nullopt);
+	ThplloraMessage(ObservationsStorage& db, std::optional<int> forceRainfallCount = std::nullopt);
 
 	/**
 	 * @brief Parse the payload to build a specific datapoint for a given
@@ -78,7 +79,7 @@ private:
 	/**
 	 * A reference to the database connection, to get or store cached values
 	 */
-	DbConnectionObservations& _db;
+	ProfiledDbConnection _db;
 
 	/**
 	 * @brief A struct used to store observation values to then populate the
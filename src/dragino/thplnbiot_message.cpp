@@ -41,7 +41,7 @@ namespace meteodata
 
 namespace chrono = std::chrono;
 
-ThplnbiotMessage::ThplnbiotMessage(DbConnectionObservations& db):
+ThplnbiotMessage::ThplnbiotMessage(ObservationsStorage& db):
 	_db{db}
 {}
 
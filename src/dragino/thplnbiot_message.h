@@ -35,6 +35,7 @@
 #include <cassandra.h>
 
 #include "cassobs/dbconnection_observations.h"
+#include "monitoring/profiled_db_connection.h"
 
 
 namespace meteodata
@@ -46,7 +47,7 @@ namespace meteodata
 class ThplnbiotMessage
 {
 public:
-	explicit ThplnbiotMessage(DbConnectionObservations& db);
+	explicit ThplnbiotMessage(ObservationsStorage& db);
 
 	/**
 	 * @brief Parse the payload to build a specific datapoint for a given
@@ -63,7 +64,7 @@ public:
 	std::vector<Observation> getObservations(const CassUuid& station) const;
 
 private:
-	DbConnectionObservations& _db;
+	ProfiledDbConnection _db;
 
 	bool validateInput(const std::string& payload);
 
@@ -40,7 +40,7 @@ namespace meteodata
 namespace chrono = std::chrono;
 namespace json = boost::json;
 
-ThwloraMessage::ThwloraMessage(DbConnectionObservations& db):
+ThwloraMessage::ThwloraMessage(ObservationsStorage& db):
 	_db{db}
 {}
 
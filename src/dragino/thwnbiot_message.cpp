@@ -41,7 +41,7 @@ namespace meteodata
 
 namespace chrono = std::chrono;
 
-ThwnbiotMessage::ThwnbiotMessage(DbConnectionObservations& db):
+ThwnbiotMessage::ThwnbiotMessage(ObservationsStorage& db):
 	_db{db}
 {}
 
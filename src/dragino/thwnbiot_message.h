@@ -35,6 +35,7 @@
 #include <cassandra.h>
 
 #include "cassobs/dbconnection_observations.h"
+#include "monitoring/profiled_db_connection.h"
 
 
 namespace meteodata
@@ -46,7 +47,7 @@ namespace meteodata
 class ThwnbiotMessage
 {
 public:
-	explicit ThwnbiotMessage(DbConnectionObservations& db);
+	explicit ThwnbiotMessage(ObservationsStorage& db);
 
 	/**
 	 * @brief Parse the payload to build a specific datapoint for a given
@@ -61,7 +62,7 @@ public:
 	std::vector<Observation> getObservations(const CassUuid& station) const;
 
 private:
-	DbConnectionObservations& _db;
+	ProfiledDbConnection _db;
 
 	bool validateInput(const std::string& payload);
 
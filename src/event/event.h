@@ -45,6 +45,7 @@ class Event
 public:
 	enum class EventType {
 		NewDatapoint,
+		NewRealtimeObservation,
 	};
 
 	virtual Event::EventType getEventType() const = 0;
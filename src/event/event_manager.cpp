@@ -122,7 +122,7 @@ void EventManager::publish(const Event& event)
 	std::lock_guard<std::mutex> guardOnSubs{_mutex};
 	auto it = _subscriptions.find(event.getEventType());
 	if (it != _subscriptions.end()) {
-		for (auto it2 = it->second.begin() ; it2 != it->second.end() ; ++it2) {
+		for (auto it2 = it->second.begin() ; it2 != it->second.end() ;) {
 			const std::weak_ptr<Subscriber>& s = *it2;
 			auto sub = s.lock();
 			if (sub) {
@@ -142,7 +142,7 @@ void EventManager::publish(const Event& event, const CassUuid& station)
 	auto key = std::make_pair(event.getEventType(), station);
 	auto it3 = _subscriptionsForStation.find(key);
 	if (it3 != _subscriptionsForStation.end()) {
-		for (auto it4 = it3->second.begin() ; it4 != it3->second.end() ; ++it4) {
+		for (auto it4 = it3->second.begin() ; it4 != it3->second.end() ;) {
 			const std::weak_ptr<Subscriber>& s = *it4;
 			auto sub = s.lock();
 			if (sub) {
@@ -66,6 +66,14 @@ public:
 		return m_station;
 	}
 
+	date::sys_seconds getReceivedAt() const {
+		return m_receivedAt;
+	}
+
+	date::sys_seconds getMeasuredAt() const {
+		return m_measuredAt;
+	}
+
 	void dispatch(Subscriber& visitor) const override;
 
 private:
@@ -0,0 +1,44 @@
+/**
+ * @file new_realtime_observation_event.cpp
+ * @brief Implementation of the NewRealtimeObservationEvent class
+ * @author Laurent Georget
+ * @date 2026-10-18
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <cassandra.h>
+#include <cassobs/observation.h>
+
+#include "new_realtime_observation_event.h"
+#include "event/subscriber.h"
+
+namespace meteodata
+{
+
+NewRealtimeObservationEvent::NewRealtimeObservationEvent(const CassUuid& station, const Observation& observation) :
+	m_station{station},
+	m_observation{observation}
+{}
+
+void NewRealtimeObservationEvent::dispatch(Subscriber& visitor) const
+{
+	visitor.handle(*this);
+}
+
+}
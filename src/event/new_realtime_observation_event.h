@@ -0,0 +1,74 @@
+/**
+ * @file new_realtime_observation_event.h
+ * @brief Definition of the NewRealtimeObservationEvent class
+ * @author Laurent Georget
+ * @date 2026-10-18
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NEW_REALTIME_OBSERVATION_EVENT_H
+#define NEW_REALTIME_OBSERVATION_EVENT_H
+
+#include <string>
+
+#include <cassandra.h>
+#include <cassobs/observation.h>
+
+#include "event/event.h"
+
+namespace meteodata
+{
+
+/**
+ * @brief An event signaling a real-time observation received from a station
+ *
+ * Contrary to \a NewDatapointEvent, the observation is not in the database:
+ * it is carried by the event itself and subscribers must keep a copy if they
+ * need it later.
+ */
+class NewRealtimeObservationEvent : public Event
+{
+public:
+	NewRealtimeObservationEvent(const CassUuid& station, const Observation& observation);
+
+	Event::EventType getEventType() const override {
+		return Event::EventType::NewRealtimeObservation;
+	}
+
+	std::string getEventName() const override {
+		return "new real-time observation";
+	}
+
+	CassUuid getStation() const {
+		return m_station;
+	}
+
+	const Observation& getObservation() const {
+		return m_observation;
+	}
+
+	void dispatch(Subscriber& visitor) const override;
+
+private:
+	CassUuid m_station;
+	Observation m_observation;
+};
+
+}
+
+#endif
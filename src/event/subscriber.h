@@ -29,6 +29,9 @@
 namespace meteodata
 {
 
+class NewDatapointEvent;
+class NewRealtimeObservationEvent;
+
 /**
  * @brief The base class for all event
  */
@@ -37,6 +40,8 @@ class Subscriber
 public:
 	virtual ~Subscriber() = default;
 	virtual void handle(const Event& event) {}
+	virtual void handle(const NewDatapointEvent& event) {}
+	virtual void handle(const NewRealtimeObservationEvent& event) {}
 };
 
 }
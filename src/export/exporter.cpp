@@ -22,14 +22,14 @@
  */
 
 #include <boost/asio.hpp>
-#include <cassobs/dbconnection_observations.h>
 
+#include "storage/observations_storage.h"
 #include "exporter.h"
 
 namespace meteodata
 {
 
-Exporter::Exporter(boost::asio::io_context& ioContext, DbConnectionObservations& db) :
+Exporter::Exporter(boost::asio::io_context& ioContext, ObservationsStorage& db) :
 		_ioContext{ioContext},
 		_db{db}
 {}
@@ -27,7 +27,8 @@
 #include <memory>
 
 #include <boost/asio.hpp>
-#include <cassobs/dbconnection_observations.h>
+
+#include "storage/observations_storage.h"
 
 
 namespace meteodata
@@ -61,7 +62,7 @@ protected:
 	 * Boost::Asio asynchronous operations
 	 * @param db The handle to the database
 	 */
-	Exporter(boost::asio::io_context& ioContext, DbConnectionObservations& db);
+	Exporter(boost::asio::io_context& ioContext, ObservationsStorage& db);
 
 	/**
 	 * @brief The Boost::Asio service to use for asynchronous
@@ -71,7 +72,7 @@ protected:
 	/**
 	 * @brief The connection to the observations/climatology database
 	 */
-	DbConnectionObservations& _db;
+	ObservationsStorage& _db;
 };
 }
 
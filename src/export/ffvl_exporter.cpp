@@ -28,10 +28,10 @@
 #include <boost/asio/basic_waitable_timer.hpp>
 #include <date/date.h>
 #include <cassandra.h>
-#include <cassobs/dbconnection_observations.h>
 #include <cassobs/dto/exported_station.h>
 #include <systemd/sd-daemon.h>
 
+#include "storage/observations_storage.h"
 #include "ffvl_exporter.h"
 #include "curl_wrapper.h"
 #include "http_utils.h"
@@ -48,7 +48,7 @@ using namespace date;
 
 FfvlExporter::FfvlExporter(
 		asio::io_context& ioContext,
-		DbConnectionObservations& db,
+		ObservationsStorage& db,
 		const std::string& ffvlPartnerKey
 	) :
 	Exporter{ioContext, db},
@@ -84,6 +84,11 @@ void FfvlExporter::reloadStations()
 	bool ok = _db.selectExportedStations("ffvl", ffvl);
 	if (ok) {
 		_stations.clear();
+		// Not filtered by shard: the exports are triggered by the
+		// events of the instance that ingests the data, which is not
+		// necessarily the station's shard for the listeners (VP2,
+		// UDP, REST), so every instance subscribes to all the stations
+		// and only ever exports those it has received data for
 		for (auto&& s : ffvl) {
 			_stations[s.station] = s.param;
 		}
@@ -94,6 +99,7 @@ void FfvlExporter::reloadStations()
 	em.unsubscribeFromAll(self);
 	for (auto&& [s,p] : _stations) {
 		em.subscribe(self, Event::EventType::NewDatapoint, s);
+		em.subscribe(self, Event::EventType::NewRealtimeObservation, s);
 	}
 }
 
@@ -136,6 +142,24 @@ void FfvlExporter::handle(const NewDatapointEvent& event)
 	}
 }
 
+void FfvlExporter::handle(const NewRealtimeObservationEvent& event)
+{
+	std::lock_guard<std::mutex> guardOnStations{_stationsMutex};
+	CassUuid st = event.getStation();
+	auto it = _stations.find(st);
+	if (it == _stations.end())
+		return;
+
+	_realtimeObservations[st] = event.getObservation();
+	auto now = chrono::steady_clock::now();
+	auto last = _lastRealtimeExports.find(st);
+	if (last == _lastRealtimeExports.end() || now - last->second >= MIN_REALTIME_EXPORT_INTERVAL) {
+		_lastRealtimeExports[st] = now;
+		_timer.cancel();
+		postStationExportJob(st);
+	}
+}
+
 void FfvlExporter::postStationExportJob(const CassUuid& station)
 {
 	auto self{std::static_pointer_cast<FfvlExporter>(shared_from_this())};
@@ -152,6 +176,14 @@ void FfvlExporter::exportLastDatapoint(const CassUuid& station)
 	Observation values;
 	time_t now = chrono::system_clock::to_time_t(chrono::system_clock::now());
 	_db.getLastDataBefore(station, now, values);
+	{
+		// Prefer the real-time data if it's more recent than the
+		// archive
+		std::lock_guard<std::mutex> guardOnStations{_stationsMutex};
+		auto it = _realtimeObservations.find(station);
+		if (it != _realtimeObservations.end() && it->second.time > values.time)
+			values = it->second;
+	}
 
 	// Format the URL
 	std::ostringstream os;
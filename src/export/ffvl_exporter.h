@@ -33,12 +33,13 @@
 
 #include <boost/asio.hpp>
 #include <cassandra.h>
-#include <cassobs/dbconnection_observations.h>
 #include <cassobs/dto/exported_station.h>
 
+#include "storage/observations_storage.h"
 #include "event/event.h"
 #include "event/subscriber.h"
 #include "event/new_datapoint_event.h"
+#include "event/new_realtime_observation_event.h"
 #include "export/exporter.h"
 #include "cassandra_utils.h"
 #include "curl_wrapper.h"
@@ -66,7 +67,7 @@ public:
 	 * events, timers, and callbacks
 	 * @param db the Météodata observations database connector
 	 */
-	FfvlExporter(asio::io_context& ioContext, DbConnectionObservations& db,
+	FfvlExporter(asio::io_context& ioContext, ObservationsStorage& db,
 		const std::string& ffvlPartnerKey);
 
 	/**
@@ -85,7 +86,8 @@ public:
 	void reload();
 
 	void handle(const Event& event) override;
-	void handle(const NewDatapointEvent& event);
+	void handle(const NewDatapointEvent& event) override;
+	void handle(const NewRealtimeObservationEvent& event) override;
 
 private:
 	std::string _partnerKey;
@@ -102,6 +104,18 @@ private:
 
 	std::map<CassUuid, std::string> _stations;
 
+	/**
+	 * @brief The last real-time observation received for each station,
+	 * fresher than what's in the database
+	 */
+	std::map<CassUuid, Observation> _realtimeObservations;
+
+	/**
+	 * @brief The time of the last export triggered by real-time data for
+	 * each station
+	 */
+	std::map<CassUuid, chrono::steady_clock::time_point> _lastRealtimeExports;
+
 	asio::steady_timer _timer;
 
 	std::mutex _stationsMutex;
@@ -120,6 +134,13 @@ private:
 	void exportLastDatapoint(const CassUuid& station);
 
 	constexpr static char BASE_URL[] = "https://balisemeteo.com/ws2/push_data.php";
+
+	/**
+	 * @brief The minimum delay between two exports triggered by real-time
+	 * data for the same station, real-time observations received in
+	 * between only update the cache
+	 */
+	constexpr static chrono::seconds MIN_REALTIME_EXPORT_INTERVAL{60};
 };
 
 }
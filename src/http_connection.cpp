@@ -25,16 +25,24 @@
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/basic_waitable_timer.hpp>
 #include <boost/system/error_code.hpp>
+#include <array>
 #include <chrono>
+#include <sstream>
+#include <string>
 
-#include <cassobs/dbconnection_observations.h>
 
+#include "storage/observations_storage.h"
 #include "http_connection.h"
 #include "async_job_publisher.h"
 #include "davis/vantagepro2_http_request_handler.h"
 #include "davis/monitorII_http_request_handler.h"
 #include "cimel/cimel_http_request_handler.h"
 #include "liveobjects/liveobjects_http_decoding_request_handler.h"
+#include "monitoring/metrics.h"
+#include "monitoring/loop_lag_monitor.h"
+#include "monitoring/db_profiler.h"
+#include "monitoring/ingestion_trace.h"
+#include "capture/traffic_capture.h"
 
 namespace meteodata
 {
@@ -44,7 +52,42 @@ namespace chrono = std::chrono;
 namespace sys = boost::system;
 using tcp = boost::asio::ip::tcp;
 
-HttpConnection::HttpConnection(boost::asio::io_context& io, DbConnectionObservations& db,
+namespace
+{
+	/**
+	 * @brief The metrics of one route of the REST server, looked up once
+	 * in the registry
+	 */
+	struct RouteMetrics
+	{
+		Histogram& duration;
+		/**
+		 * @brief The requests counters, by class of status (1xx to 5xx)
+		 */
+		std::array<Counter*, 5> requests;
+
+		explicit RouteMetrics(const std::string& route) :
+			duration{MetricsRegistry::instance().histogram("meteodata_http_request_duration_seconds",
+				"Time taken to process the requests received by the REST server", {{"route", route}})}
+		{
+			for (std::size_t i = 0 ; i < requests.size() ; i++) {
+				requests[i] = &MetricsRegistry::instance().counter("meteodata_http_requests_total",
+					"Number of requests received by the REST server",
+					{{"route", route}, {"status", std::to_string(i + 1) + "xx"}});
+			}
+		}
+
+		void record(chrono::steady_clock::duration elapsed, unsigned int status)
+		{
+			duration.observe(elapsed);
+			std::size_t statusClass = status / 100;
+			if (statusClass >= 1 && statusClass <= requests.size())
+				requests[statusClass - 1]->increment();
+		}
+	};
+}
+
+HttpConnection::HttpConnection(boost::asio::io_context& io, ObservationsStorage& db,
 		const std::shared_ptr<AsyncJobPublisher>& jobPublisher) :
 	_ioContext{io},
 	_db{db},
@@ -105,22 +148,59 @@ void HttpConnection::readRequest()
 void HttpConnection::processRequest()
 {
 	auto url = _request.target();
+	auto start = chrono::steady_clock::now();
+	static RouteMetrics otherMetrics{"other"};
+	RouteMetrics* routeMetrics = &otherMetrics;
+	LoopLagMonitor::Activity activity{"HTTP request processing"};
+	DbProfiler::CallerScope callerScope{"rest"};
+
+	TrafficCapture& capture = TrafficCapture::instance();
+	if (capture.isEnabled() && url.substr(0, 9) == "/imports/") {
+		std::ostringstream header;
+		header << _request.base();
+		capture.record(CapturedMessage::Type::HTTP, header.str(), _request.body());
+	}
 
 	if (url.substr(0, 13) == "/imports/vp2/") {
+		static RouteMetrics vp2Metrics{"vp2"};
+		routeMetrics = &vp2Metrics;
+		static const IngestionTrace::Path tracePath{"http_vp2"};
+		IngestionTrace trace{tracePath, start};
 		VantagePro2HttpRequestHandler handler{_db, _jobPublisher};
 		handler.processRequest(_request, _response);
 	} else if (url.substr(0, 19) == "/imports/monitorII/") {
+		static RouteMetrics monitorIIMetrics{"monitorII"};
+		routeMetrics = &monitorIIMetrics;
+		static const IngestionTrace::Path tracePath{"http_monitorII"};
+		IngestionTrace trace{tracePath, start};
 		MonitorIIHttpRequestHandler handler{_db, _jobPublisher};
 		handler.processRequest(_request, _response);
 	} else if (url.substr(0, 15) == "/imports/cimel/") {
+		static RouteMetrics cimelMetrics{"cimel"};
+		routeMetrics = &cimelMetrics;
+		static const IngestionTrace::Path tracePath{"http_cimel"};
+		IngestionTrace trace{tracePath, start};
 		CimelHttpRequestHandler handler{_db, _jobPublisher};
 		handler.processRequest(_request, _response);
 	} else if (url.substr(0, 28) == "/imports/decode/liveobjects") {
+		static RouteMetrics liveobjectsMetrics{"liveobjects"};
+		routeMetrics = &liveobjectsMetrics;
 		LiveobjectsHttpDecodingRequestHandler handler{_db};
 		handler.processRequest(_request, _response);
+	} else if (url == "/metrics" && _request.method() == http::verb::get) {
+		static RouteMetrics metricsMetrics{"metrics"};
+		routeMetrics = &metricsMetrics;
+		std::ostringstream os;
+		MetricsRegistry::instance().render(os);
+		_response.result(http::status::ok);
+		_response.set(http::field::content_type, "text/plain; version=0.0.4");
+		_response.body() = os.str();
 	} else {
 		_response.result(http::status::not_found);
 	}
+
+	routeMetrics->record(chrono::steady_clock::now() - start, _response.result_int());
+
 	_timeout.expires_from_now(chrono::seconds(60));
 	writeResponse();
 }
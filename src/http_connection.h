@@ -29,8 +29,8 @@
 #include <boost/beast.hpp>
 #include <boost/asio.hpp>
 #include <boost/asio/ip/tcp.hpp>
-#include <cassobs/dbconnection_observations.h>
 
+#include "storage/observations_storage.h"
 #include "async_job_publisher.h"
 
 namespace meteodata
@@ -38,7 +38,7 @@ namespace meteodata
 class HttpConnection : public std::enable_shared_from_this<HttpConnection>
 {
 public: 
-	HttpConnection(boost::asio::io_context& io, DbConnectionObservations& db,
+	HttpConnection(boost::asio::io_context& io, ObservationsStorage& db,
 		const std::shared_ptr<AsyncJobPublisher>& jobPublisher = nullptr);
 	void start();
 	inline boost::asio::ip::tcp::socket& getSocket() { return _socket; }
@@ -46,7 +46,7 @@ public:
 
 private:
 	boost::asio::io_context& _ioContext;
-	DbConnectionObservations& _db;
+	ObservationsStorage& _db;
 	std::shared_ptr<AsyncJobPublisher> _jobPublisher;
 	boost::asio::ip::tcp::socket _socket;
 	boost::beast::flat_buffer _buffer{4096};
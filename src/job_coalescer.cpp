@@ -0,0 +1,93 @@
+/**
+ * @file job_coalescer.cpp
+ * @brief Implementation of the JobCoalescer class
+ * @author Laurent Georget
+ * @date 2026-10-18
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include <date/date.h>
+
+#include "job_coalescer.h"
+#include "date_utils.h"
+
+namespace meteodata
+{
+
+namespace chrono = std::chrono;
+
+JobCoalescer::JobCoalescer(Granularity granularity) :
+	_granularity{granularity}
+{}
+
+void JobCoalescer::add(const DbConnectionJobs::StationJob& job)
+{
+	date::sys_seconds begin = date::floor<chrono::seconds>(job.begin);
+	date::sys_seconds end = date::floor<chrono::seconds>(job.end);
+	if (end < begin)
+		std::swap(begin, end);
+	_jobs[job.station].push_back(CoalescedJob{job.station, begin, end, {job.id}});
+	_size++;
+}
+
+std::size_t JobCoalescer::size() const
+{
+	return _size;
+}
+
+bool JobCoalescer::mergeable(const CoalescedJob& previous, const CoalescedJob& next) const
+{
+	if (_granularity == Granularity::MONTH)
+		return to_year_month(next.begin) <= to_year_month(previous.end) + date::months{1};
+	else
+		return date::floor<date::days>(next.begin) <= date::floor<date::days>(previous.end) + date::days{1};
+}
+
+std::vector<JobCoalescer::CoalescedJob> JobCoalescer::coalesce()
+{
+	std::vector<CoalescedJob> result;
+
+	for (auto&& [station, jobs] : _jobs) {
+		std::sort(jobs.begin(), jobs.end(), [](const CoalescedJob& j1, const CoalescedJob& j2) {
+			return j1.begin < j2.begin;
+		});
+
+		auto current = jobs.begin();
+		for (auto it = std::next(current) ; it != jobs.end() ; ++it) {
+			if (mergeable(*current, *it)) {
+				current->end = std::max(current->end, it->end);
+				current->ids.insert(current->ids.end(), it->ids.begin(), it->ids.end());
+			} else {
+				result.push_back(std::move(*current));
+				current = it;
+			}
+		}
+		if (current != jobs.end())
+			result.push_back(std::move(*current));
+	}
+
+	_jobs.clear();
+	_size = 0;
+	return result;
+}
+
+} // meteodata
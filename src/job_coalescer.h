@@ -0,0 +1,117 @@
+/**
+ * @file job_coalescer.h
+ * @brief Definition of the JobCoalescer class
+ * @author Laurent Georget
+ * @date 2026-10-18
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JOB_COALESCER_H
+#define JOB_COALESCER_H
+
+#include <map>
+#include <vector>
+
+#include <cassandra.h>
+#include <cassobs/dbconnection_jobs.h>
+#include <date/date.h>
+
+#include "cassandra_utils.h"
+
+namespace meteodata
+{
+
+/**
+ * @brief Merge the jobs claimed by a worker into the minimal set of disjoint
+ * date ranges per station
+ *
+ * Stations that backfill several days produce many jobs whose date ranges
+ * overlap or touch. Instead of recomputing the same days over and over, the
+ * workers claim all the pending jobs, feed them to a JobCoalescer and compute
+ * each merged range once. All the jobs merged into a range are then marked
+ * as finished with the outcome of this range.
+ */
+class JobCoalescer
+{
+public:
+	using JobId = decltype(DbConnectionJobs::StationJob::id);
+
+	/**
+	 * @brief The resolution at which the jobs are compared
+	 *
+	 * Minmax jobs are computed day by day, two jobs are merged if they
+	 * share a day or if one begins the day after the other ends. Month
+	 * minmax jobs are computed month by month, so jobs covering the same
+	 * month or consecutive months are merged.
+	 */
+	enum class Granularity
+	{
+		DAY,
+		MONTH
+	};
+
+	/**
+	 * @brief A merged range of jobs for a given station
+	 */
+	struct CoalescedJob
+	{
+		CassUuid station;
+		date::sys_seconds begin;
+		date::sys_seconds end;
+		std::vector<JobId> ids;
+	};
+
+	explicit JobCoalescer(Granularity granularity);
+
+	/**
+	 * @brief Record a claimed job
+	 *
+	 * @param job A job retrieved from the jobs database
+	 */
+	void add(const DbConnectionJobs::StationJob& job);
+
+	/**
+	 * @brief Get the number of jobs added since the last call to
+	 * coalesce()
+	 *
+	 * @return The number of pending jobs
+	 */
+	std::size_t size() const;
+
+	/**
+	 * @brief Merge all the jobs added so far and clear the coalescer
+	 *
+	 * @return The merged jobs, sorted by station then by date, each
+	 * range being disjoint from and not adjacent to the others for the same
+	 * station
+	 */
+	std::vector<CoalescedJob> coalesce();
+
+private:
+	Granularity _granularity;
+
+	std::map<CassUuid, std::vector<CoalescedJob>> _jobs;
+
+	std::size_t _size = 0;
+
+	bool mergeable(const CoalescedJob& previous, const CoalescedJob& next) const;
+};
+
+} // meteodata
+
+#endif //JOB_COALESCER_H
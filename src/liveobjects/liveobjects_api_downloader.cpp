@@ -24,17 +24,19 @@
 #include <string>
 #include <tuple>
 #include <map>
+#include <optional>
 
 #include <boost/system/error_code.hpp>
 #include <boost/asio.hpp>
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/json_parser.hpp>
 #include <boost/json.hpp>
-#include <cassobs/dbconnection_observations.h>
 #include <date/date.h>
 #include <systemd/sd-daemon.h>
 #include <cassandra.h>
 
+#include "storage/observations_storage.h"
+#include "archive_pipeline.h"
 #include "liveobjects_api_downloader.h"
 #include "liveobjects_message.h"
 #include "time_offseter.h"
@@ -58,7 +60,7 @@ namespace json = boost::json;
 using namespace meteodata;
 
 LiveobjectsApiDownloader::LiveobjectsApiDownloader(const CassUuid& station, const std::string& liveobjectsId,
-	DbConnectionObservations& db, const std::string& apiKey, AsyncJobPublisher* jobPublisher) :
+	ObservationsStorage& db, const std::string& apiKey, AsyncJobPublisher* jobPublisher) :
 		_station{station},
 		_liveobjectsUrn{liveobjectsId},
 		_db{db},
@@ -145,64 +147,108 @@ void LiveobjectsApiDownloader::download(CurlWrapper& client, const date::sys_sec
 			  << _lastArchive << "; last available is " << lastAvailable << "\n" << "(approximately "
 			  << date::floor<date::days>(lastAvailable - _lastArchive) << " days)" << std::endl;
 
-	bool insertionOk = true;
 	date::sys_seconds newest = force ? beginDate : _lastArchive;
 	date::sys_seconds oldest = date::floor<chrono::seconds>(chrono::system_clock::now());
 	date::sys_seconds date = beginDate;
-	do {
-		date::sys_seconds datep1 = date + chrono::hours{24}; // about right
-
-		std::ostringstream osDate;
-		osDate << date::format("%FT%TZ", date);
-		std::ostringstream osDatep1;
-		osDatep1 << date::format("%FT%TZ", datep1);
-
-		json::object body{
-			{ "size", PAGE_SIZE },
-			{ "query", json::object{
-				{ "bool", json::object{
-					{ "must", json::array{ {
-						{ "term", {
-							{ "streamId", _liveobjectsUrn }
-						} }
-					} } },
-					{ "filter", json::array{ {
-						{ "range", {
-							{ "timestamp", {
-								{ "gt", osDate.str() },
-								{ "lte", osDatep1.str() }
+
+	// The next request starts after the last message of the previous page,
+	// so the JSON is read in the fetch stage to know where to go on from.
+	// The messages themselves are decoded in the store stage because they
+	// need the database to retrieve cached values.
+	ArchivePipeline<pt::ptree, pt::ptree> pipeline;
+	bool insertionOk = pipeline.run(
+		[&]() -> std::optional<pt::ptree> {
+			if (date >= endDate)
+				return std::nullopt;
+
+			date::sys_seconds datep1 = date + chrono::hours{24}; // about right
+
+			std::ostringstream osDate;
+			osDate << date::format("%FT%TZ", date);
+			std::ostringstream osDatep1;
+			osDatep1 << date::format("%FT%TZ", datep1);
+
+			json::object body{
+				{ "size", PAGE_SIZE },
+				{ "query", json::object{
+					{ "bool", json::object{
+						{ "must", json::array{ {
+							{ "term", {
+								{ "streamId", _liveobjectsUrn }
+							} }
+						} } },
+						{ "filter", json::array{ {
+							{ "range", {
+								{ "timestamp", {
+									{ "gt", osDate.str() },
+									{ "lte", osDatep1.str() }
+								} }
 							} }
-						} }
-					} } }
-				} }
-			} },
-			{ "sort", json::array{ {
-				{ "timestamp", {
-					{ "order", "asc" }
-				} }
-			} } }
-		};
-
-
-		client.setHeader("X-API-Key", _apiKey);
-		client.setHeader("Content-Type", "application/json");
-		client.setHeader("Accept", "application/json");
-
-		std::cout << SD_DEBUG << "[Liveobjects " << _station << "] protocol: "
-				  << "POST " << SEARCH_ROUTE << " HTTP/1.1\n"
-				  << "Host: " << APIHOST << "\n"
-				  << "Accept: application/json\n"
-				  << body << "\n";
-
-		CURLcode ret = client.post(std::string{BASE_URL} + SEARCH_ROUTE,
-				json::serialize(body),
-				[&](const std::string& body) {
-			try {
-				std::istringstream responseStream(body);
-				pt::ptree jsonTree;
-				pt::read_json(responseStream, jsonTree);
-
-				for (auto&& entry : jsonTree) {
+						} } }
+					} }
+				} },
+				{ "sort", json::array{ {
+					{ "timestamp", {
+						{ "order", "asc" }
+					} }
+				} } }
+			};
+
+
+			client.setHeader("X-API-Key", _apiKey);
+			client.setHeader("Content-Type", "application/json");
+			client.setHeader("Accept", "application/json");
+
+			std::cout << SD_DEBUG << "[Liveobjects " << _station << "] protocol: "
+					  << "POST " << SEARCH_ROUTE << " HTTP/1.1\n"
+					  << "Host: " << APIHOST << "\n"
+					  << "Accept: application/json\n"
+					  << body << "\n";
+
+			std::optional<pt::ptree> page;
+			CURLcode ret = client.post(std::string{BASE_URL} + SEARCH_ROUTE,
+					json::serialize(body),
+					[&](const std::string& body) {
+				try {
+					std::istringstream responseStream(body);
+					pt::ptree jsonTree;
+					pt::read_json(responseStream, jsonTree);
+
+					// the entries are sorted by timestamp
+					date::sys_seconds last = date;
+					if (jsonTree.begin() != jsonTree.end()) {
+						std::istringstream is{jsonTree.back().second.get<std::string>("timestamp", "")};
+						is >> date::parse("%Y-%m-%dT%H:%M:%S", last);
+					}
+					if (date >= last) {
+						// we've not made any progress, force advance the date in
+						// order not to keep stuck
+						date = datep1;
+					} else {
+						date = last;
+					}
+					page = std::move(jsonTree);
+				} catch (const std::exception& e) {
+					std::cerr << SD_ERR << "[Liveobjects " << _station << "] protocol: "
+							  << "Failed to receive or parse an Liveobjects data message: " << e.what() << std::endl;
+				}
+			});
+
+			if (ret != CURLE_OK) {
+				logAndThrowCurlError(client);
+			}
+
+			// if the page could not be parsed, stop there and retry later
+			// from the last archive stored
+			return page;
+		},
+		[](pt::ptree&& page) {
+			return std::move(page);
+		},
+		[&](pt::ptree&& page) {
+			bool pageOk = true;
+			for (auto&& entry : page) {
+				try {
 					date::sys_seconds timestamp;
 					auto m = LiveobjectsMessage::parseMessage(_db, entry.second, _station, timestamp, forcedMsgType);
 					if (m && m->looksValid()) {
@@ -212,7 +258,7 @@ void LiveobjectsApiDownloader::download(CurlWrapper& client, const date::sys_sec
 						if (!ret) {
 							std::cerr << SD_ERR << "[Liveobjects " << _station << "] measurement: "
 									  << "Failed to insert archive observation for station " << _stationName << std::endl;
-							insertionOk = false;
+							pageOk = false;
 						} else {
 							m->cacheValues(_station);
 							if (timestamp > newest) {
@@ -223,24 +269,14 @@ void LiveobjectsApiDownloader::download(CurlWrapper& client, const date::sys_sec
 							}
 						}
 					}
+				} catch (const std::exception& e) {
+					std::cerr << SD_ERR << "[Liveobjects " << _station << "] protocol: "
+							  << "Failed to parse an Liveobjects data message: " << e.what() << std::endl;
 				}
-				if (date >= newest) {
-					// we've not made any progress, force advance the date in
-					// order not to keep stuck
-					date = datep1;
-				} else {
-					date = newest;
-				}
-			} catch (const std::exception& e) {
-				std::cerr << SD_ERR << "[Liveobjects " << _station << "] protocol: "
-						  << "Failed to receive or parse an Liveobjects data message: " << e.what() << std::endl;
 			}
-		});
-
-		if (ret != CURLE_OK) {
-			logAndThrowCurlError(client);
+			return pageOk;
 		}
-	} while (insertionOk && date < endDate);
+	);
 
 	if (insertionOk && (!force || newest > _lastArchive)) {
 		std::cout << SD_DEBUG << "[Liveobjects " << _station << "] measurement: "
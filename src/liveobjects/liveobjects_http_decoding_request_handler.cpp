@@ -46,7 +46,7 @@ namespace pt = boost::property_tree;
 namespace json = boost::json;
 namespace sys = boost::system;
 
-LiveobjectsHttpDecodingRequestHandler::LiveobjectsHttpDecodingRequestHandler(DbConnectionObservations& db) :
+LiveobjectsHttpDecodingRequestHandler::LiveobjectsHttpDecodingRequestHandler(ObservationsStorage& db) :
 	_db{db}
 {
 	std::vector<std::tuple<CassUuid, std::string, std::string>> liveobjectsStations;
@@ -37,6 +37,7 @@
 
 #include "../http_connection.h"
 #include "cassandra_utils.h"
+#include "monitoring/profiled_db_connection.h"
 
 namespace meteodata
 {
@@ -47,12 +48,12 @@ public:
 	using Request = boost::beast::http::request<boost::beast::http::string_body>;
 	using Response = boost::beast::http::response<boost::beast::http::string_body>;
 
-	explicit LiveobjectsHttpDecodingRequestHandler(DbConnectionObservations& db);
+	explicit LiveobjectsHttpDecodingRequestHandler(ObservationsStorage& db);
 
 	void processRequest(const Request& request, Response& response);
 
 private:
-	DbConnectionObservations& _db;
+	ProfiledDbConnection _db;
 
 	std::map<std::string, CassUuid> _stations;
 
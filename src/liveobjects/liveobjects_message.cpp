@@ -72,7 +72,7 @@ bool LiveobjectsMessage::validateInput(const std::string& payload, std::initiali
 	return true;
 }
 
-std::unique_ptr<LiveobjectsMessage> LiveobjectsMessage::instantiateMessage(DbConnectionObservations& db,
+std::unique_ptr<LiveobjectsMessage> LiveobjectsMessage::instantiateMessage(ObservationsStorage& db,
 	const std::string& sensor, int port, const CassUuid& station, std::optional<float> forcedBaseValue)
 {
 	if (sensor == "dragino-cpl01-pluviometer" && port == 2) {
@@ -123,7 +123,7 @@ std::unique_ptr<LiveobjectsMessage> LiveobjectsMessage::instantiateMessage(DbCon
 	return {};
 }
 
-std::unique_ptr<LiveobjectsMessage> LiveobjectsMessage::parseMessage(DbConnectionObservations& db,
+std::unique_ptr<LiveobjectsMessage> LiveobjectsMessage::parseMessage(ObservationsStorage& db,
 	const boost::property_tree::ptree& json, const CassUuid& station, date::sys_seconds& timestamp,
 	const std::string& forcedMsgType)
 {
@@ -27,13 +27,14 @@
 #include <memory>
 #include <initializer_list>
 
-#include <cassobs/dbconnection_observations.h>
 #include <cassandra.h>
 #include <cassobs/observation.h>
 #include <boost/property_tree/ptree.hpp>
 #include <boost/json.hpp>
 #include <date/date.h>
 
+#include "storage/observations_storage.h"
+
 namespace meteodata {
 
 class LiveobjectsMessage
@@ -106,7 +107,7 @@ public:
 	}
 
 	static std::unique_ptr<LiveobjectsMessage> instantiateMessage(
-		DbConnectionObservations& db,
+		ObservationsStorage& db,
 		const std::string& payload,
 		int port,
 		const CassUuid& station,
@@ -114,7 +115,7 @@ public:
 	);
 
 	static std::unique_ptr<LiveobjectsMessage> parseMessage(
-		DbConnectionObservations& db,
+		ObservationsStorage& db,
 		const boost::property_tree::ptree& json,
 		const CassUuid& station,
 		date::sys_seconds& timestamp,
@@ -25,12 +25,13 @@
 #include <chrono>
 #include <thread>
 #include <mutex>
+#include <optional>
 
 #include <systemd/sd-daemon.h>
 #include <boost/asio/basic_waitable_timer.hpp>
 #include <cassandra.h>
-#include <cassobs/dbconnection_observations.h>
 
+#include "storage/observations_storage.h"
 #include "../time_offseter.h"
 #include "mbdata_download_scheduler.h"
 #include "mbdata_txt_downloader.h"
@@ -43,21 +44,16 @@ namespace meteodata
 
 using namespace date;
 
-MBDataDownloadScheduler::MBDataDownloadScheduler(asio::io_context& ioContext, DbConnectionObservations& db) :
-	AbstractDownloadScheduler{chrono::minutes{POLLING_PERIOD}, ioContext, db}
+MBDataDownloadScheduler::MBDataDownloadScheduler(asio::io_context& ioContext, ObservationsStorage& db) :
+	AbstractDownloadScheduler{chrono::minutes{POLLING_PERIOD}, ioContext, db, "mbdata"}
 {
 }
 
-void MBDataDownloadScheduler::add(const std::tuple<CassUuid, std::string, std::string, bool, int, std::string>& downloadDetails)
-{
-	std::lock_guard<std::recursive_mutex> lock{_downloadersMutex};
-	_downloaders.emplace_back(std::make_shared<MBDataTxtDownloader>(_db, downloadDetails));
-}
-
 void MBDataDownloadScheduler::download()
 {
 	for (const auto& _downloader : _downloaders) {
 		try {
+			IngestionTrace trace{_tracePath};
 			_downloader->ingest();
 		} catch (const std::runtime_error& e) {
 			std::cerr << SD_ERR << "[MBDataTxt] protocol: " << "Runtime error, impossible to ingest data " << e.what()
@@ -68,14 +64,17 @@ void MBDataDownloadScheduler::download()
 
 void MBDataDownloadScheduler::reloadStations()
 {
-	std::lock_guard<std::recursive_mutex> lock{_downloadersMutex};
-	_downloaders.clear();
-
-	std::vector<std::tuple<CassUuid, std::string, std::string, bool, int, std::string>> mbDataTxtStations;
+	std::vector<StationDetails> mbDataTxtStations;
 	_db.getMBDataTxtStations(mbDataTxtStations);
-	for (const auto& station : mbDataTxtStations) {
-		add(station);
-	}
+
+	std::lock_guard<std::recursive_mutex> lock{_downloadersMutex};
+	ReloadSummary summary = _downloaders.reconcile(std::move(mbDataTxtStations),
+		[this](const StationDetails& station) -> std::optional<std::shared_ptr<MBDataTxtDownloader>> {
+			if (!ownsStation(std::get<0>(station)))
+				return std::nullopt;
+			return std::make_shared<MBDataTxtDownloader>(_db, station);
+		});
+	std::cerr << SD_INFO << "[MBDataTxt] management: " << "Stations reloaded: " << summary << std::endl;
 }
 
 }
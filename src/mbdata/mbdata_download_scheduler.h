@@ -30,20 +30,22 @@
 #include <chrono>
 #include <map>
 #include <mutex>
+#include <tuple>
 
 #include <boost/system/error_code.hpp>
 #include <boost/asio/ssl.hpp>
 #include <boost/asio.hpp>
 #include <boost/asio/basic_waitable_timer.hpp>
 #include <cassandra.h>
-#include <cassobs/dbconnection_observations.h>
 
+#include "storage/observations_storage.h"
 #include "async_job_publisher.h"
 #include "time_offseter.h"
 #include "curl_wrapper.h"
 #include "connector.h"
 #include "abstract_download_scheduler.h"
 #include "mbdata/mbdata_txt_downloader.h"
+#include "downloader_set.h"
 
 namespace meteodata
 {
@@ -71,18 +73,19 @@ public:
 	 * events, timers, and callbacks
 	 * @param db the Météodata observations database connector
 	 */
-	MBDataDownloadScheduler(asio::io_context& ioContext, DbConnectionObservations& db);
+	MBDataDownloadScheduler(asio::io_context& ioContext, ObservationsStorage& db);
 
+private:
 	/**
-	 * @brief Add a station to download the data for
+	 * @brief The configuration of a station, as expected by the
+	 * MBDataTxtDownloader constructor
 	 */
-	void add(const std::tuple<CassUuid, std::string, std::string, bool, int, std::string>& downloadDetails);
+	using StationDetails = std::tuple<CassUuid, std::string, std::string, bool, int, std::string>;
 
-private:
 	/**
 	 * @brief The list of all downloaders (one per station)
 	 */
-	std::vector<std::shared_ptr<MBDataTxtDownloader>> _downloaders;
+	DownloaderSet<StationDetails, std::shared_ptr<MBDataTxtDownloader>> _downloaders;
 
 	/**
 	 * @brief The synchronization mutex to safely reload the list of
@@ -98,7 +101,7 @@ private:
 private:
 	/**
 	 * @brief Reload the list of MBData stations from the database and
-	 * recreate all downloaders
+	 * update the downloaders of the stations that have changed
 	 */
 	void reloadStations() override;
 
@@ -27,9 +27,9 @@
 #include <regex>
 #include <optional>
 
-#include <cassobs/dbconnection_observations.h>
 #include <date/date.h>
 
+#include "storage/observations_storage.h"
 #include "../../time_offseter.h"
 #include "abstract_mbdata_message.h"
 #include "mbdata_weatherlink_message.h"
@@ -80,7 +80,7 @@ private:
 		return content;
 	}
 
-	static std::optional<float> getDayRainfall(DbConnectionObservations& db,
+	static std::optional<float> getDayRainfall(ObservationsStorage& db,
 		const CassUuid& station, const TimeOffseter& timeOffseter)
 	{
 		time_t lastUpdateTimestamp;
@@ -108,7 +108,7 @@ private:
 
 public:
 	static inline AbstractMBDataMessage::ptr
-	chose(DbConnectionObservations& db, const CassUuid& station, const std::string& type, std::istream& entry,
+	chose(ObservationsStorage& db, const CassUuid& station, const std::string& type, std::istream& entry,
 		  const TimeOffseter& timeOffseter)
 	{
 		using namespace date;
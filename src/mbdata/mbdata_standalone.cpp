@@ -21,6 +21,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <memory>
 #include <iostream>
 #include <iterator>
 #include <map>
@@ -35,6 +36,7 @@
 #include "../curl_wrapper.h"
 #include "mbdata_messages/mbdata_message_factory.h"
 #include "mbdata_txt_downloader.h"
+#include "storage/observations_storage.h"
 #include "config.h"
 
 #define DEFAULT_CONFIG_FILE "/etc/meteodata/db_credentials"
@@ -50,6 +52,7 @@ int main(int argc, char** argv)
 	std::string pguser;
 	std::string pgpassword;
 	std::string pgaddress;
+	StorageConfiguration storageConfig;
 	std::vector<std::string> namedStations;
 
 	po::options_description config("Configuration");
@@ -60,6 +63,9 @@ int main(int argc, char** argv)
 		("pguser", po::value<std::string>(&pguser), "PostgreSQL database username")
 		("pgpassword", po::value<std::string>(&pgpassword), "PostgreSQL database password")
 		("pghost", po::value<std::string>(&pgaddress), "PostgreSQL database IP address or domain name")
+		("storage", po::value<std::string>(&storageConfig.backend), "storage backend, 'cassandra' (Cassandra and PostgreSQL databases) or 'memory' (in-process stand-in keeping everything in memory, for benchmarks), defaults to 'cassandra'")
+		("station-table", po::value<std::string>(&storageConfig.stationTable), "with the 'memory' storage, file listing the stations and connectors to serve")
+		("storage-latency", po::value<unsigned long>(&storageConfig.latency), "with the 'memory' storage, delay in microseconds added to each call, defaults to 0")
 	;
 
 	po::options_description desc("Allowed options");
@@ -124,7 +130,9 @@ int main(int argc, char** argv)
 		cass_log_set_callback(logCallback, nullptr);
 
 		std::vector<std::tuple<CassUuid, std::string, std::string, bool, int, std::string>> mbDataTxtStations;
-		DbConnectionObservations db{address, user, password, pgaddress, pguser, pgpassword};
+		std::unique_ptr<ObservationsStorage> storage = ObservationsStorage::create(storageConfig,
+			address, user, password, pgaddress, pguser, pgpassword);
+		ObservationsStorage& db = *storage;
 		db.getMBDataTxtStations(mbDataTxtStations);
 		std::cerr << "Got the list of stations from the db" << std::endl;
 
@@ -34,14 +34,15 @@
 #include <boost/asio/basic_waitable_timer.hpp>
 #include <boost/asio/io_context.hpp>
 #include <date/date.h>
-#include <cassobs/dbconnection_observations.h>
 #include <cassobs/dto/download.h>
 
+#include "storage/observations_storage.h"
 #include "../cassandra_utils.h"
 #include "mbdata_txt_downloader.h"
 #include "mbdata_messages/mbdata_message_factory.h"
 #include "../time_offseter.h"
 #include "../curl_wrapper.h"
+#include "../monitoring/ingestion_trace.h"
 
 namespace asio = boost::asio;
 namespace args = std::placeholders;
@@ -53,7 +54,7 @@ using namespace date;
 
 const std::string MBDataTxtDownloader::DOWNLOAD_CONNECTOR_ID = "mbdatatxt";
 
-MBDataTxtDownloader::MBDataTxtDownloader(DbConnectionObservations& db,
+MBDataTxtDownloader::MBDataTxtDownloader(ObservationsStorage& db,
 	const std::tuple<CassUuid, std::string, std::string, bool, int, std::string>& downloadDetails)
 		:
 		_db(db),
@@ -105,6 +106,7 @@ bool MBDataTxtDownloader::doProcess(const std::string& body)
 	cass_uuid_string(_station, uuidStr);
 
 	Observation o = m->getObservation(_station);
+	IngestionTrace::markCurrent(IngestionTrace::Stage::DECODED);
 	bool ret = _db.insertV2DataPoint(o) && _db.insertV2DataPointInTimescaleDB(o);
 	if (ret) {
 		std::cout << SD_INFO << "[MBData " << _station << "] measurement: " << "Data from station " << _stationName
@@ -122,6 +124,7 @@ bool MBDataTxtDownloader::doProcess(const std::string& body)
 			  << "Failed to update the last insertion time of station " << _stationName << std::endl;
 		return false;
 	}
+	IngestionTrace::markCurrent(IngestionTrace::Stage::STORED);
 
 	std::optional<float> rainfallSince0h = m->getRainfallSince0h();
 	if (rainfallSince0h) {
@@ -138,11 +141,13 @@ bool MBDataTxtDownloader::doProcess(const std::string& body)
 
 void MBDataTxtDownloader::download(CurlWrapper& client)
 {
+	IngestionTrace::setCurrentStation(_station);
 	std::cout << SD_INFO << "[MBData " << _station << "] measurement: " << "Downloading a MBData file for station "
 		  << _stationName << " (" << _query << ")" << std::endl;
 
 
 	CURLcode ret = client.download(_query, [&](const std::string& body) {
+		IngestionTrace::markCurrent(IngestionTrace::Stage::RECEIVED);
 		doProcess(body);
 	});
 
@@ -153,7 +158,7 @@ void MBDataTxtDownloader::download(CurlWrapper& client)
 	}
 }
 
-void MBDataTxtDownloader::downloadOnly(DbConnectionObservations& db, CurlWrapper& client,
+void MBDataTxtDownloader::downloadOnly(ObservationsStorage& db, CurlWrapper& client,
 	const std::tuple<CassUuid, std::string, std::string, bool, int, std::string>& downloadDetails)
 {
 	std::ostringstream queryStr;
@@ -187,8 +192,10 @@ void MBDataTxtDownloader::downloadOnly(DbConnectionObservations& db, CurlWrapper
 
 void MBDataTxtDownloader::ingest()
 {
+	IngestionTrace::setCurrentStation(_station);
 	std::vector<Download> downloads;
 	_db.selectDownloadsByStation(_station, DOWNLOAD_CONNECTOR_ID, downloads);
+	IngestionTrace::markCurrent(IngestionTrace::Stage::RECEIVED);
 
 	if (downloads.empty()) {
 		std::cout << SD_WARNING << "[MBDataTxt " << _station << "] measurement: "
@@ -208,6 +215,7 @@ void MBDataTxtDownloader::ingest()
 		} else {
 			_db.updateDownloadStatus(d.station, chrono::system_clock::to_time_t(d.datetime), true, "completed");
 		}
+		IngestionTrace::markCurrent(IngestionTrace::Stage::STORED);
 	}
 }
 
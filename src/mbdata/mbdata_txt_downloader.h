@@ -33,10 +33,11 @@
 #include <boost/asio/io_context.hpp>
 #include <cassandra.h>
 #include <date/date.h>
-#include <cassobs/dbconnection_observations.h>
 
+#include "storage/observations_storage.h"
 #include "../time_offseter.h"
 #include "../curl_wrapper.h"
+#include "../monitoring/profiled_db_connection.h"
 
 namespace meteodata
 {
@@ -51,17 +52,17 @@ using namespace meteodata;
 class MBDataTxtDownloader : public std::enable_shared_from_this<MBDataTxtDownloader>
 {
 public:
-	MBDataTxtDownloader(DbConnectionObservations& db,
+	MBDataTxtDownloader(ObservationsStorage& db,
 		const std::tuple<CassUuid, std::string, std::string, bool, int, std::string>& downloadDetails);
 	void start();
 	void stop();
 	void download(CurlWrapper& client);
-	static void downloadOnly(DbConnectionObservations& db, CurlWrapper& client,
+	static void downloadOnly(ObservationsStorage& db, CurlWrapper& client,
 		const std::tuple<CassUuid, std::string, std::string, bool, int, std::string>& downloadDetails);
 	void ingest();
 
 private:
-	DbConnectionObservations& _db;
+	ProfiledDbConnection _db;
 	CassUuid _station;
 	std::string _stationName;
 	std::string _query;
@@ -35,11 +35,11 @@
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/json_parser.hpp>
 #include <boost/json.hpp>
-#include <cassobs/dbconnection_observations.h>
 #include <date/date.h>
 #include <systemd/sd-daemon.h>
 #include <cassandra.h>
 
+#include "storage/observations_storage.h"
 #include "meteo_france/meteo_france_api_6m_downloader.h"
 #include "meteo_france/meteo_france_api_downloader.h"
 #include "meteo_france/mf_radome_message.h"
@@ -59,7 +59,7 @@ namespace pt = boost::property_tree;
 using namespace meteodata;
 
 MeteoFranceApi6mDownloader::MeteoFranceApi6mDownloader(
-	DbConnectionObservations& db, const std::string& apiKey,
+	ObservationsStorage& db, const std::string& apiKey,
 	AsyncJobPublisher* jobPublisher) :
 		_db{db},
 		_jobPublisher{jobPublisher},
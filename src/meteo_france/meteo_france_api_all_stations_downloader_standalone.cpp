@@ -30,7 +30,6 @@
 #include <thread>
 
 #include <cassandra.h>
-#include <cassobs/dbconnection_observations.h>
 #include <boost/asio.hpp>
 #include <date/date.h>
 #include <boost/program_options.hpp>
@@ -38,6 +37,7 @@
 #include <boost/json/src.hpp>
 
 #include "cassandra_utils.h"
+#include "storage/observations_storage.h"
 #include "config.h"
 #include "curl_wrapper.h"
 #include "meteo_france_api_6m_downloader.h"
@@ -75,6 +75,7 @@ int main(int argc, char** argv)
 	std::string pguser;
 	std::string pgpassword;
 	std::string pgaddress;
+	StorageConfiguration storageConfig;
 	std::string apiKey;
 	std::vector<std::string> namedStations;
 	std::string begin;
@@ -92,6 +93,9 @@ int main(int argc, char** argv)
 		("pguser", po::value<std::string>(&pguser), "PostgreSQL database username")
 		("pgpassword", po::value<std::string>(&pgpassword), "PostgreSQL database password")
 		("pghost", po::value<std::string>(&pgaddress), "PostgreSQL database IP address or domain name")
+		("storage", po::value<std::string>(&storageConfig.backend), "storage backend, 'cassandra' (Cassandra and PostgreSQL databases) or 'memory' (in-process stand-in keeping everything in memory, for benchmarks), defaults to 'cassandra'")
+		("station-table", po::value<std::string>(&storageConfig.stationTable), "with the 'memory' storage, file listing the stations and connectors to serve")
+		("storage-latency", po::value<unsigned long>(&storageConfig.latency), "with the 'memory' storage, delay in microseconds added to each call, defaults to 0")
 	;
 
 	po::options_description desc("Allowed options");
@@ -129,7 +133,9 @@ int main(int argc, char** argv)
 		return 0;
 	}
 
-	DbConnectionObservations db{address, user, password, pgaddress, pguser, pgpassword};
+	std::unique_ptr<ObservationsStorage> storage = ObservationsStorage::create(storageConfig,
+		address, user, password, pgaddress, pguser, pgpassword);
+	ObservationsStorage& db = *storage;
 
 	sys_seconds beginDate;
 	if (vm.count("begin")) {
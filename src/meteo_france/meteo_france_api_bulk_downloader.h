@@ -32,10 +32,10 @@
 
 #include <boost/property_tree/json_parser.hpp>
 #include <boost/system/error_code.hpp>
-#include <cassobs/dbconnection_observations.h>
 #include <cassandra.h>
 #include <date/date.h>
 
+#include "storage/observations_storage.h"
 #include "curl_wrapper.h"
 #include "async_job_publisher.h"
 
@@ -59,7 +59,7 @@ public:
 	 * @param jobPublisher an optional component able to scheduler recomputation
 	 * of the climatology
 	 */
-	MeteoFranceApiBulkDownloader(DbConnectionObservations& db,
+	MeteoFranceApiBulkDownloader(ObservationsStorage& db,
 		const std::string& apiKey,
 		AsyncJobPublisher* jobPublisher = nullptr);
 
@@ -85,7 +85,7 @@ private:
 	/**
 	 * @brief The observations database (part Cassandra, part SQL) connector
 	 */
-	DbConnectionObservations& _db;
+	ObservationsStorage& _db;
 
 	/**
 	 * @brief The component able to schedule recomputations of climatology over
@@ -33,8 +33,8 @@
 #include <boost/asio/basic_waitable_timer.hpp>
 #include <date/date.h>
 #include <cassandra.h>
-#include <cassobs/dbconnection_observations.h>
 
+#include "storage/observations_storage.h"
 #include "meteo_france/meteo_france_api_download_scheduler.h"
 #include "meteo_france/meteo_france_api_downloader.h"
 #include "meteo_france/meteo_france_api_bulk_downloader.h"
@@ -49,9 +49,9 @@ namespace meteodata
 using namespace date;
 
 MeteoFranceApiDownloadScheduler::MeteoFranceApiDownloadScheduler(
-	asio::io_context& ioContext, DbConnectionObservations& db,
+	asio::io_context& ioContext, ObservationsStorage& db,
 	std::string apiKey, const std::shared_ptr<AsyncJobPublisher>& jobPublisher) :
-		AbstractDownloadScheduler{chrono::minutes{POLLING_PERIOD}, ioContext, db},
+		AbstractDownloadScheduler{chrono::minutes{POLLING_PERIOD}, ioContext, db, "meteofrance"},
 		_apiKey{std::move(apiKey)},
 		_jobPublisher{jobPublisher}
 {
@@ -68,7 +68,7 @@ void MeteoFranceApiDownloadScheduler::download()
 	if (_mustStop)
 		return;
 
-	auto now = chrono::system_clock::now();
+	auto now = SystemClock::now();
 	auto daypoint = date::floor<date::days>(now);
 	auto tod = date::make_time(now - daypoint); // Yields time_of_day type
 	auto minutes = tod.minutes().count();
@@ -89,7 +89,10 @@ void MeteoFranceApiDownloadScheduler::download()
 	for (; d <= now ; d += chrono::minutes{POLLING_PERIOD}) {
 		if (_mustStop)
 			break;
-		downloader6m.download(_client, date::floor<chrono::seconds>(d));
+		{
+			IngestionTrace trace{_tracePath};
+			downloader6m.download(_client, date::floor<chrono::seconds>(d));
+		}
 		ret = _db.insertLastSchedulerDownloadTime(SCHEDULER_ID, std::max(lastDownload, chrono::system_clock::to_time_t(d)));
 		if (!ret) {
 			std::cerr << SD_ERR << "[MeteoFrance] protocol: " << "Failed to update the last download time "
@@ -99,6 +102,7 @@ void MeteoFranceApiDownloadScheduler::download()
 	}
 
 	for (const auto& it : _downloaders) {
+		IngestionTrace trace{_tracePath};
 		it->download(_client);
 	}
 }
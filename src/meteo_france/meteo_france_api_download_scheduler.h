@@ -38,8 +38,8 @@
 #include <boost/asio.hpp>
 #include <boost/asio/basic_waitable_timer.hpp>
 #include <cassandra.h>
-#include <cassobs/dbconnection_observations.h>
 
+#include "storage/observations_storage.h"
 #include "async_job_publisher.h"
 #include "meteo_france/meteo_france_api_downloader.h"
 #include "abstract_download_scheduler.h"
@@ -62,7 +62,7 @@ class MeteoFranceApiDownloadScheduler : public AbstractDownloadScheduler
 {
 public:
 	MeteoFranceApiDownloadScheduler(asio::io_context& ioContext,
-		DbConnectionObservations& db, std::string apiKey,
+		ObservationsStorage& db, std::string apiKey,
 		const std::shared_ptr<AsyncJobPublisher>& jobPublisher = nullptr);
 	void add(const CassUuid& station, const std::string& mfId);
 
@@ -81,7 +81,10 @@ private:
 	{
 		try {
 			auto start = chrono::steady_clock::now();
-			downloadMethod(_client);
+			{
+				IngestionTrace trace{_tracePath};
+				downloadMethod(_client);
+			}
 			auto end = chrono::steady_clock::now();
 
 			if (end - start < chrono::milliseconds(MeteoFranceApiDownloader::MIN_DELAY)) {
@@ -33,11 +33,11 @@
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/json_parser.hpp>
 #include <boost/json.hpp>
-#include <cassobs/dbconnection_observations.h>
 #include <date/date.h>
 #include <systemd/sd-daemon.h>
 #include <cassandra.h>
 
+#include "storage/observations_storage.h"
 #include "meteo_france/meteo_france_api_downloader.h"
 #include "meteo_france/mf_radome_message.h"
 #include "async_job_publisher.h"
@@ -61,7 +61,7 @@ namespace json = boost::json;
 using namespace meteodata;
 
 MeteoFranceApiDownloader::MeteoFranceApiDownloader(const CassUuid& station, const std::string& mfId,
-	DbConnectionObservations& db, const std::string& apiKey, AsyncJobPublisher* jobPublisher) :
+	ObservationsStorage& db, const std::string& apiKey, AsyncJobPublisher* jobPublisher) :
 		_station{station},
 		_mfId{mfId},
 		_db{db},
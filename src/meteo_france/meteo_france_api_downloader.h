@@ -32,14 +32,15 @@
 
 #include <boost/property_tree/json_parser.hpp>
 #include <boost/system/error_code.hpp>
-#include <cassobs/dbconnection_observations.h>
 #include <cassandra.h>
 #include <date/date.h>
 
+#include "storage/observations_storage.h"
 #include "time_offseter.h"
 #include "curl_wrapper.h"
 #include "async_job_publisher.h"
 #include "liveobjects/liveobjects_message.h"
+#include "monitoring/profiled_db_connection.h"
 
 namespace meteodata
 {
@@ -66,7 +67,7 @@ public:
 	 * of the climatology
 	 */
 	MeteoFranceApiDownloader(const CassUuid& station, const std::string& mfId,
-		DbConnectionObservations& db, const std::string& apiKey,
+		ObservationsStorage& db, const std::string& apiKey,
 		AsyncJobPublisher* jobPublisher = nullptr);
 
 	/**
@@ -115,7 +116,7 @@ private:
 	/**
 	 * @brief The observations database (part Cassandra, part SQL) connector
 	 */
-	DbConnectionObservations& _db;
+	ProfiledDbConnection _db;
 
 	/**
 	 * @brief The component able to schedule recomputations of climatology over
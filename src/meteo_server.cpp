@@ -55,6 +55,11 @@
 #include "control/control_connector.h"
 #include "virtual/virtual_computation_scheduler.h"
 #include "export/ffvl_exporter.h"
+#include "monitoring/db_profiler.h"
+#include "monitoring/ingestion_trace.h"
+#include "capture/traffic_capture.h"
+#include "storage/jobs_storage.h"
+#include "simulated_clock.h"
 
 namespace asio = boost::asio;
 namespace ip = boost::asio::ip;
@@ -84,15 +89,29 @@ EventManager MeteoServer::_eventManager{};
 MeteoServer::MeteoServer(boost::asio::io_context& ioContext, MeteoServer::MeteoServerConfiguration&& config) :
 	_ioContext{ioContext},
 	_vp2DirectConnectAcceptor{ioContext},
-	_db{config.address, config.user, config.password, config.pgaddress, config.pguser, config.pgpassword},
+	_storage{ObservationsStorage::create(config.storage, config.address, config.user, config.password,
+		config.pgaddress, config.pguser, config.pgpassword)},
+	_db{*_storage},
 	_vp2DirectConnectorStopped{true},
 	_controlConnectionStopped{true},
 	_signalTimer{ioContext},
 	_configuration{config},
 	_controlAcceptor{ioContext},
-	_watchdog{ioContext}
+	_loopLagMonitor{ioContext, chrono::seconds{config.maxLoopLag}},
+	_watchdog{ioContext, &_loopLagMonitor}
 {
 	_configuration.password.clear();
+	if (_configuration.timeAcceleration != 1.0) {
+		SimulatedTime::accelerate(_configuration.timeAcceleration);
+		std::cerr << SD_WARNING << "[Server] management: " << "The schedulers run on a simulated time "
+			  << _configuration.timeAcceleration << " times faster than the real time" << std::endl;
+	}
+	Connector::setShard(StationShard{_configuration.shardId, _configuration.shardCount});
+	DbProfiler::instance().setSlowCallThreshold(chrono::milliseconds{_configuration.dbSlowCallThreshold});
+	if (!_configuration.traceFile.empty() && _configuration.traceSampleRate)
+		IngestionTrace::setSampling(_configuration.traceFile, _configuration.traceSampleRate);
+	if (!_configuration.captureFile.empty())
+		TrafficCapture::instance().open(_configuration.captureFile);
 	signal(SIGINT, catchSignal);
 	signal(SIGTERM, catchSignal);
 	pollSignal(sys::errc::make_error_code(sys::errc::success));
@@ -103,12 +122,16 @@ MeteoServer::MeteoServer(boost::asio::io_context& ioContext, MeteoServer::MeteoS
 
 	if (_configuration.publishJobs) {
 		_jobPublisher = std::make_shared<AsyncJobPublisher>(
-				ioContext, config.jobsDbAddress, config.jobsDbUsername,
-				config.jobsDbPassword, config.jobsDbDatabase
+				ioContext, JobsStorage::create(config.storage, config.jobsDbAddress,
+				config.jobsDbUsername, config.jobsDbPassword, config.jobsDbDatabase)
 		);
 	}
 	_configuration.jobsDbPassword.clear();
 
+	if (_configuration.shardCount > 1) {
+		std::cerr << SD_INFO << "[Server] management: " << "Handling shard " << _configuration.shardId
+			  << " of " << _configuration.shardCount << std::endl;
+	}
 	std::cerr << SD_INFO << "[Server] management: " << "Meteodata has started succesfully" << std::endl;
 }
 
@@ -152,6 +175,118 @@ void MeteoServer::pollSignal(const sys::error_code& e)
 
 void MeteoServer::start()
 {
+	// Open the listeners first, so that the stations can connect as soon
+	// as the I/O threads run, the download schedulers load their stations
+	// in the background
+	if (_configuration.startVp2) {
+		_vp2DirectConnectorStopped = false;
+		_vp2DirectConnectorsGroup = std::make_shared<ConnectorGroup>(_ioContext, _db);
+		_connectors.emplace("vp2_directconnect", _vp2DirectConnectorsGroup);
+		// Listen on the Meteodata port for incoming stations (one connector per direct-connect station)
+		_vp2DirectConnectAcceptor.open(ip::tcp::v4());
+		_vp2DirectConnectAcceptor.set_option(ip::tcp::acceptor::reuse_address(true));
+		_vp2DirectConnectAcceptor.bind(ip::tcp::endpoint{ip::tcp::v4(), 5886});
+		_vp2DirectConnectAcceptor.listen();
+		startAcceptingVp2DirectConnect();
+	}
+
+	if (_configuration.startUdp) {
+		_udpConnection = std::make_shared<UdpConnection>(_ioContext, _db);
+		_connectors.emplace("udp", _udpConnection);
+		_udpConnection->start();
+	}
+
+	if (_configuration.startRest) {
+		// Start the Web server for the REST API
+		auto restWebServer = std::make_shared<RestWebServer>(
+			_ioContext, _db, _jobPublisher
+		);
+		restWebServer->start();
+		_connectors.emplace("rest", restWebServer);
+	}
+
+	if (_configuration.startSynop) {
+		// Start the Synop downloader worker (one for all the SYNOP stations in
+		// the same group)
+		auto synopDownloader = std::make_shared<SynopDownloadScheduler>(_ioContext, _db);
+		synopDownloader->startInBackground(_warmupPool);
+		_connectors.emplace("synop", synopDownloader);
+	}
+
+	if (_configuration.startShip) {
+		// Start the Meteo France SHIP and BUOY downloader (one for all SHIP and BUOY messages)
+		auto meteofranceDownloader = std::make_shared<ShipAndBuoyDownloader>(_ioContext, _db, _jobPublisher);
+		meteofranceDownloader->startInBackground(_warmupPool);
+		_connectors.emplace("ship", meteofranceDownloader);
+	}
+
+	if (_configuration.startMeteoFrance) {
+		// Start the Meteo France API download scheduler (one for all
+		// SYNOP and RADOME stations, there's one downloader per
+		// station but they all share the same HTTP client)
+		auto meteofranceScheduler = std::make_shared<MeteoFranceApiDownloadScheduler>(
+			_ioContext,
+			_db,
+			std::move(_configuration.meteofranceApiKey),
+			_jobPublisher
+		);
+		meteofranceScheduler->startInBackground(_warmupPool);
+		_connectors.emplace("meteofrance", meteofranceScheduler);
+	}
+
+	if (_configuration.startStatic) {
+		auto statICDownloadScheduler = std::make_shared<StatICDownloadScheduler>(_ioContext, _db);
+		statICDownloadScheduler->startInBackground(_warmupPool);
+		_connectors.emplace("static", statICDownloadScheduler);
+	}
+
+	if (_configuration.startWeatherlink) {
+		// Start the Weatherlink download schedulers (one for all Weatherlink stations, one downloader per station but
+		// they share a single HTTP client)
+		auto weatherlinkScheduler = std::make_shared<WeatherlinkDownloadScheduler>(
+			_ioContext, _db, _jobPublisher
+		);
+		weatherlinkScheduler->startInBackground(_warmupPool);
+		_connectors.emplace("weatherlink", weatherlinkScheduler);
+	}
+
+	if (_configuration.startWeatherlinkV2) {
+		// Start the Weatherlink APIv2 download schedulers (one for all Weatherlink stations, one downloader per station
+		// but they share a single HTTP client)
+		auto weatherlinkApiv2Scheduler = std::make_shared<WeatherlinkApiv2DownloadScheduler>(
+			_ioContext, _db,
+			std::move(_configuration.weatherlinkApiV2Key), std::move(_configuration.weatherlinkApiV2Secret),
+			_jobPublisher
+		);
+		weatherlinkApiv2Scheduler->startInBackground(_warmupPool);
+		_connectors.emplace("weatherlink_v2", weatherlinkApiv2Scheduler);
+	}
+
+	if (_configuration.startFieldclimate) {
+		// Start the FieldClimate download scheduler (one for all Pessl stations, one downloader per station but they
+		// share a single HTTP client)
+		auto fieldClimateScheduler = std::make_shared<FieldClimateApiDownloadScheduler>(
+			_ioContext, _db,
+			_configuration.fieldClimateApiKey, _configuration.fieldClimateApiSecret,
+			_jobPublisher
+		);
+		fieldClimateScheduler->startInBackground(_warmupPool);
+		_connectors.emplace("fieldclimate", fieldClimateScheduler);
+	}
+
+	if (_configuration.startMbdata) {
+		auto mbdataDownloadScheduler = std::make_shared<MBDataDownloadScheduler>(_ioContext, _db);
+		mbdataDownloadScheduler->startInBackground(_warmupPool);
+		_connectors.emplace("mbdata", mbdataDownloadScheduler);
+	}
+
+	if (_configuration.startVirtual) {
+		// Start the virtual observations computing connector
+		auto virtualComputingScheduler = std::make_shared<VirtualComputationScheduler>(_ioContext, _db, _jobPublisher);
+		virtualComputingScheduler->startInBackground(_warmupPool);
+		_connectors.emplace("virtual", virtualComputingScheduler);
+	}
+
 	if (_configuration.startMqtt) {
 		// Start the MQTT subscribers (one per server and station type/API)
 		std::vector<std::tuple<CassUuid, std::string, int, std::string, std::unique_ptr<char[]>, size_t, std::string, int>> mqttStations;
@@ -170,6 +305,11 @@ void MeteoServer::start()
 				std::get<3>(station), std::string(std::get<4>(station).get(), std::get<5>(station))};
 
 			const CassUuid& uuid = std::get<0>(station);
+			// don't create subscribers for brokers with no station to
+			// handle in this instance
+			if (!Connector::getShard().owns(uuid))
+				continue;
+
 			const std::string& topic = std::get<6>(station);
 			TimeOffseter::PredefinedTimezone tz{std::get<7>(station)};
 			if (topic.substr(0, 4) == "vp2/") {
@@ -232,140 +372,31 @@ void MeteoServer::start()
 		int mqttIndex = 0;
 		for (auto&& mqttSubscriber : vp2MqttSubscribers) {
 			mqttIndex++;
-			mqttSubscriber.second->start();
+			startFromIoContext(mqttSubscriber.second);
 			_connectors.emplace("mqtt_" + std::to_string(mqttIndex) + "_vp2_" + mqttSubscriber.first.host, mqttSubscriber.second);
 		}
 		if (liveobjectsMqttSubscriber) {
 			mqttIndex++;
-			liveobjectsMqttSubscriber->start();
+			startFromIoContext(liveobjectsMqttSubscriber);
 			_connectors.emplace("mqtt_" + std::to_string(mqttIndex) + "_liveobjects", liveobjectsMqttSubscriber);
 		}
 		for (auto&& mqttSubscriber : liveobjectsExternalMqttSubscribers) {
 			mqttIndex++;
-			mqttSubscriber.second->start();
+			startFromIoContext(mqttSubscriber.second);
 			_connectors.emplace("mqtt_" + std::to_string(mqttIndex) + "_external_liveobjects", mqttSubscriber.second);
 		}
 		for (auto&& mqttSubscriber : genericMqttSubscribers) {
 			mqttIndex++;
-			mqttSubscriber.second->start();
+			startFromIoContext(mqttSubscriber.second);
 			_connectors.emplace("mqtt_" + std::to_string(mqttIndex) + "_generic_" + mqttSubscriber.first.host, mqttSubscriber.second);
 		}
 		for (auto&& mqttSubscriber : chirpstackMqttSubscribers) {
 			mqttIndex++;
-			mqttSubscriber.second->start();
+			startFromIoContext(mqttSubscriber.second);
 			_connectors.emplace("mqtt_" + std::to_string(mqttIndex) + "_chirpstack_" + mqttSubscriber.first.host, mqttSubscriber.second);
 		}
 	}
 
-	if (_configuration.startSynop) {
-		// Start the Synop downloader worker (one for all the SYNOP stations in
-		// the same group)
-		auto synopDownloader = std::make_shared<SynopDownloadScheduler>(_ioContext, _db);
-		synopDownloader->start();
-		_connectors.emplace("synop", synopDownloader);
-	}
-
-	if (_configuration.startShip) {
-		// Start the Meteo France SHIP and BUOY downloader (one for all SHIP and BUOY messages)
-		auto meteofranceDownloader = std::make_shared<ShipAndBuoyDownloader>(_ioContext, _db, _jobPublisher);
-		meteofranceDownloader->start();
-		_connectors.emplace("ship", meteofranceDownloader);
-	}
-
-	if (_configuration.startMeteoFrance) {
-		// Start the Meteo France API download scheduler (one for all
-		// SYNOP and RADOME stations, there's one downloader per
-		// station but they all share the same HTTP client)
-		auto meteofranceScheduler = std::make_shared<MeteoFranceApiDownloadScheduler>(
-			_ioContext,
-			_db,
-			std::move(_configuration.meteofranceApiKey),
-			_jobPublisher
-		);
-		meteofranceScheduler->start();
-		_connectors.emplace("meteofrance", meteofranceScheduler);
-	}
-
-	if (_configuration.startStatic) {
-		auto statICDownloadScheduler = std::make_shared<StatICDownloadScheduler>(_ioContext, _db);
-		statICDownloadScheduler->start();
-		_connectors.emplace("static", statICDownloadScheduler);
-	}
-
-	if (_configuration.startWeatherlink) {
-		// Start the Weatherlink download schedulers (one for all Weatherlink stations, one downloader per station but
-		// they share a single HTTP client)
-		auto weatherlinkScheduler = std::make_shared<WeatherlinkDownloadScheduler>(
-			_ioContext, _db, _jobPublisher
-		);
-		weatherlinkScheduler->start();
-		_connectors.emplace("weatherlink", weatherlinkScheduler);
-	}
-
-	if (_configuration.startWeatherlinkV2) {
-		// Start the Weatherlink APIv2 download schedulers (one for all Weatherlink stations, one downloader per station
-		// but they share a single HTTP client)
-		auto weatherlinkApiv2Scheduler = std::make_shared<WeatherlinkApiv2DownloadScheduler>(
-			_ioContext, _db,
-			std::move(_configuration.weatherlinkApiV2Key), std::move(_configuration.weatherlinkApiV2Secret),
-			_jobPublisher
-		);
-		weatherlinkApiv2Scheduler->start();
-		_connectors.emplace("weatherlink_v2", weatherlinkApiv2Scheduler);
-	}
-
-	if (_configuration.startFieldclimate) {
-		// Start the FieldClimate download scheduler (one for all Pessl stations, one downloader per station but they
-		// share a single HTTP client)
-		auto fieldClimateScheduler = std::make_shared<FieldClimateApiDownloadScheduler>(
-			_ioContext, _db,
-			_configuration.fieldClimateApiKey, _configuration.fieldClimateApiSecret,
-			_jobPublisher
-		);
-		fieldClimateScheduler->start();
-		_connectors.emplace("fieldclimate", fieldClimateScheduler);
-	}
-
-	if (_configuration.startMbdata) {
-		auto mbdataDownloadScheduler = std::make_shared<MBDataDownloadScheduler>(_ioContext, _db);
-		mbdataDownloadScheduler->start();
-		_connectors.emplace("mbdata", mbdataDownloadScheduler);
-	}
-
-	if (_configuration.startVirtual) {
-		// Start the virtual observations computing connector
-		auto virtualComputingScheduler = std::make_shared<VirtualComputationScheduler>(_ioContext, _db, _jobPublisher);
-		virtualComputingScheduler->start();
-		_connectors.emplace("virtual", virtualComputingScheduler);
-	}
-
-	if (_configuration.startRest) {
-		// Start the Web server for the REST API
-		auto restWebServer = std::make_shared<RestWebServer>(
-			_ioContext, _db, _jobPublisher
-		);
-		restWebServer->start();
-		_connectors.emplace("rest", restWebServer);
-	}
-
-	if (_configuration.startVp2) {
-		_vp2DirectConnectorStopped = false;
-		_vp2DirectConnectorsGroup = std::make_shared<ConnectorGroup>(_ioContext, _db);
-		_connectors.emplace("vp2_directconnect", _vp2DirectConnectorsGroup);
-		// Listen on the Meteodata port for incoming stations (one connector per direct-connect station)
-		_vp2DirectConnectAcceptor.open(ip::tcp::v4());
-		_vp2DirectConnectAcceptor.set_option(ip::tcp::acceptor::reuse_address(true));
-		_vp2DirectConnectAcceptor.bind(ip::tcp::endpoint{ip::tcp::v4(), 5886});
-		_vp2DirectConnectAcceptor.listen();
-		startAcceptingVp2DirectConnect();
-	}
-
-	if (_configuration.startUdp) {
-		_udpConnection = std::make_shared<UdpConnection>(_ioContext, _db);
-		_connectors.emplace("udp", _udpConnection);
-		_udpConnection->start();
-	}
-
 	int lock = -1;
 	_lockFileDescriptor = open(SOCKET_LOCK_PATH, O_WRONLY | O_CREAT, 0644);
 	if (_lockFileDescriptor >= 0) {
@@ -433,6 +464,8 @@ void MeteoServer::stop()
 		_watchdog.stop();
 		std::cerr << SD_INFO << "[Server] management: Stopped watchdog" << std::endl;
 	}
+
+	_loopLagMonitor.stop();
 }
 
 void MeteoServer::startAcceptingVp2DirectConnect()
@@ -440,7 +473,8 @@ void MeteoServer::startAcceptingVp2DirectConnect()
 	if (_vp2DirectConnectorStopped)
 		return;
 
-	auto newConnector = std::make_shared<VantagePro2Connector>(_ioContext, _db, _jobPublisher);
+	auto newConnector = std::make_shared<VantagePro2Connector>(_ioContext, _db, _jobPublisher,
+		chrono::seconds{_configuration.vp2RealtimePeriod});
 	_vp2DirectConnectAcceptor.async_accept(newConnector->socket(), [this, newConnector](const boost::system::error_code& error) {
 		runNewVp2DirectConnector(newConnector, error);
 	});
@@ -457,6 +491,11 @@ void MeteoServer::runNewVp2DirectConnector(const std::shared_ptr<VantagePro2Conn
 	}
 }
 
+void MeteoServer::startFromIoContext(const std::shared_ptr<Connector>& connector)
+{
+	asio::post(_ioContext, [connector]() { connector->start(); });
+}
+
 void MeteoServer::startAcceptingControlConnection()
 {
 	if (_controlConnectionStopped)
@@ -26,8 +26,6 @@
 
 #include <boost/asio.hpp>
 #include <boost/system/error_code.hpp>
-#include <cassobs/dbconnection_observations.h>
-#include <cassobs/dbconnection_jobs.h>
 
 #include "meteo_server.h"
 #include "connector.h"
@@ -37,7 +35,9 @@
 #include "davis/vantagepro2_connector.h"
 #include "control/control_connector.h"
 #include "udp_connection.h"
+#include "storage/observations_storage.h"
 #include "monitoring/watchdog.h"
+#include "monitoring/loop_lag_monitor.h"
 #include "event/event_manager.h"
 #include "config.h"
 
@@ -122,6 +122,7 @@ public:
 		std::string pgaddress;
 		std::string pguser;
 		std::string pgpassword;
+		StorageConfiguration storage;
 		std::string jobsDbAddress;
 		std::string jobsDbUsername;
 		std::string jobsDbPassword;
@@ -133,6 +134,15 @@ public:
 		std::string objeniousApiKey;
 		std::string meteofranceApiKey;
 		std::string ffvlPartnerKey;
+		unsigned long vp2RealtimePeriod = 0;
+		unsigned long maxLoopLag = 10;
+		unsigned long dbSlowCallThreshold = 1000;
+		std::string traceFile;
+		unsigned int traceSampleRate = 0;
+		std::string captureFile;
+		unsigned int shardId = 0;
+		unsigned int shardCount = 1;
+		double timeAcceleration = 1.0;
 		bool publishJobs = true;
 		bool startMqtt = true;
 		bool startSynop = true;
@@ -173,6 +183,12 @@ public:
 
 	static EventManager& getEventManager() { return _eventManager; }
 
+	/**
+	 * @brief Get the monitor of the I/O threads responsiveness, the
+	 * threads running the I/O context must register to it
+	 */
+	LoopLagMonitor& getLoopLagMonitor() { return _loopLagMonitor; }
+
 private:
 	boost::asio::io_context& _ioContext;
 	/**
@@ -189,9 +205,15 @@ private:
 	std::shared_ptr<UdpConnection> _udpConnection;
 
 	/**
-	 * @brief The connection to the observations/climatology database
+	 * @brief The storage of the observations, the connection to the
+	 * observations/climatology database or its in-memory stand-in
+	 */
+	std::unique_ptr<ObservationsStorage> _storage;
+
+	/**
+	 * @brief The storage, for short
 	 */
-	DbConnectionObservations _db;
+	ObservationsStorage& _db;
 
 	std::shared_ptr<AsyncJobPublisher> _jobPublisher;
 
@@ -203,6 +225,8 @@ private:
 
 	bool _controlConnectionStopped;
 
+	LoopLagMonitor _loopLagMonitor;
+
 	Watchdog _watchdog;
 
 	/**
@@ -213,6 +237,15 @@ private:
 
 	int _lockFileDescriptor = -1;
 
+	constexpr static std::size_t WARMUP_THREADS = 4;
+
+	/**
+	 * @brief The threads loading the stations of the download schedulers
+	 * at startup, so that the I/O threads are free to serve the
+	 * listeners meanwhile
+	 */
+	boost::asio::thread_pool _warmupPool{WARMUP_THREADS};
+
 	asio::basic_waitable_timer<chrono::steady_clock> _signalTimer;
 
 	void pollSignal(const boost::system::error_code& e);
@@ -259,6 +292,17 @@ private:
 	 */
 	void runNewControlConnector(const std::shared_ptr<ControlConnector>& c, const boost::system::error_code& error);
 
+	/**
+	 * @brief Start a connector from one of the I/O threads
+	 *
+	 * This is meant for connectors whose start() blocks (to connect to
+	 * a broker for instance), so that they start in parallel once the I/O
+	 * threads run instead of one after the other.
+	 *
+	 * @param connector The connector to start
+	 */
+	void startFromIoContext(const std::shared_ptr<Connector>& connector);
+
 	std::map<std::string, std::weak_ptr<Connector>> _connectors;
 	std::map<std::string, std::weak_ptr<Exporter>> _exporters;
 
@@ -23,7 +23,9 @@
 
 #include <chrono>
 #include <iostream>
+#include <vector>
 
+#include <boost/asio/post.hpp>
 #include <date/date.h>
 #include <cassobs/dbconnection_jobs.h>
 #include <systemd/sd-daemon.h>
@@ -32,6 +34,7 @@
 #include "minmax_computer.h"
 #include "cassandra_utils.h"
 #include "date_utils.h"
+#include "job_coalescer.h"
 
 namespace meteodata {
 
@@ -52,7 +55,7 @@ void MinmaxWorker::checkDeadline(const sys::error_code& e)
 	if (e == sys::errc::operation_canceled)
 		return;
 
-	if (_timer.expires_at() <= chrono::steady_clock::now()) {
+	if (_timer.expires_at() <= SteadyClock::now()) {
 		if (!_stopped)
 			processJobs();
 	} else {
@@ -80,28 +83,53 @@ void MinmaxWorker::processJobs()
 	if (_stopped)
 		return;
 
+	/* Claim all the pending jobs (up to a limit) and merge them so that
+	 * each day is computed only once per station */
+	JobCoalescer coalescer{JobCoalescer::Granularity::DAY};
 	std::optional<DbConnectionJobs::StationJob> nextMinmaxJob = _dbJobs.retrieveMinmax();
-	if (nextMinmaxJob && !_stopped) {
+	while (nextMinmaxJob && !_stopped) {
+		coalescer.add(*nextMinmaxJob);
+		if (coalescer.size() >= MAX_JOBS_PER_BATCH)
+			break;
+		nextMinmaxJob = _dbJobs.retrieveMinmax();
+	}
+
+	if (coalescer.size() > 0) {
+		std::size_t claimed = coalescer.size();
+		std::vector<JobCoalescer::CoalescedJob> jobs = coalescer.coalesce();
+		if (jobs.size() < claimed) {
+			std::cerr << SD_DEBUG << "Coalesced " << claimed << " minmax jobs into "
+				<< jobs.size() << " computations" << std::endl;
+		}
+
 		MinmaxComputer computer{_dbMinmax};
-		do {
-			bool result = computer.computeMinmax(nextMinmaxJob->station, nextMinmaxJob->begin, nextMinmaxJob->end);
-			date::sys_days b{date::floor<date::days>(nextMinmaxJob->begin)};
-			date::sys_days e{date::floor<date::days>(nextMinmaxJob->end)};
+		for (auto&& job : jobs) {
+			bool result = computer.computeMinmax(job.station, job.begin, job.end);
+			date::sys_days b{date::floor<date::days>(job.begin)};
+			date::sys_days e{date::floor<date::days>(job.end)};
 			if (result) {
 				std::cerr << SD_INFO << "Minmax computed for station "
-					<< nextMinmaxJob->station << " between times "
+					<< job.station << " between times "
 					<< b << " and " << e << std::endl;
-				_dbJobs.markJobAsFinished(nextMinmaxJob->id, std::time(nullptr), 0);
-				if (to_year_month(b) < to_year_month(chrono::system_clock::now()))
-					_dbJobs.publishMonthMinmax(nextMinmaxJob->station, chrono::system_clock::to_time_t(b), chrono::system_clock::to_time_t(e));
+				for (auto&& id : job.ids)
+					_dbJobs.markJobAsFinished(id, chrono::system_clock::to_time_t(SystemClock::now()), 0);
+				if (to_year_month(b) < to_year_month(SystemClock::now()))
+					_dbJobs.publishMonthMinmax(job.station, chrono::system_clock::to_time_t(b), chrono::system_clock::to_time_t(e));
 			} else {
 				std::cerr << SD_ERR << "Minmax computation failed at least partially for station "
-					<< nextMinmaxJob->station << " between times "
+					<< job.station << " between times "
 					<< b << " and " << e << std::endl;
-				_dbJobs.markJobAsFinished(nextMinmaxJob->id, std::time(nullptr), 1);
+				for (auto&& id : job.ids)
+					_dbJobs.markJobAsFinished(id, chrono::system_clock::to_time_t(SystemClock::now()), 1);
 			}
-			nextMinmaxJob = _dbJobs.retrieveMinmax();
-		} while (nextMinmaxJob);
+		}
+
+		/* There might be more jobs waiting, do not wait before claiming
+		 * them */
+		if (!_stopped) {
+			boost::asio::post(_ioContext, [this]() { processJobs(); });
+			return;
+		}
 	}
 
 	_timer.expires_after(WAITING_DELAY);
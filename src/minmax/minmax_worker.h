@@ -32,6 +32,8 @@
 #include <cassobs/dbconnection_jobs.h>
 #include <cassobs/dbconnection_minmax.h>
 
+#include "simulated_clock.h"
+
 namespace meteodata
 {
 
@@ -62,7 +64,7 @@ public:
 private:
 	boost::asio::io_context& _ioContext;
 
-	boost::asio::basic_waitable_timer<std::chrono::steady_clock> _timer;
+	SteadyTimer _timer;
 
 	DbConnectionMinmax _dbMinmax;
 
@@ -75,6 +77,11 @@ private:
 	bool _stopped = true;
 
 	constexpr static std::chrono::seconds WAITING_DELAY{30};
+
+	/**
+	 * @brief The maximum number of jobs claimed at once to be coalesced
+	 */
+	constexpr static std::size_t MAX_JOBS_PER_BATCH = 500;
 };
 
 }
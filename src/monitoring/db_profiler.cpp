@@ -0,0 +1,142 @@
+/**
+ * @file db_profiler.cpp
+ * @brief Implementation of the DbProfiler class
+ * @author Laurent Georget
+ * @date 2026-10-18
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <systemd/sd-daemon.h>
+#include <date/date.h>
+
+#include "db_profiler.h"
+
+namespace meteodata
+{
+
+namespace
+{
+	double toMilliseconds(chrono::nanoseconds d)
+	{
+		return chrono::duration<double, std::milli>(d).count();
+	}
+}
+
+thread_local const char* DbProfiler::_currentCaller = nullptr;
+
+DbProfiler::DbProfiler() :
+	_since{chrono::system_clock::now()}
+{
+}
+
+DbProfiler& DbProfiler::instance()
+{
+	static DbProfiler profiler;
+	return profiler;
+}
+
+void DbProfiler::record(const char* method, const char* caller, chrono::steady_clock::duration duration, bool success)
+{
+	auto ns = chrono::duration_cast<chrono::nanoseconds>(duration);
+	auto us = chrono::duration_cast<chrono::microseconds>(duration).count();
+	std::size_t bucket = 0;
+	while (bucket < BUCKETS - 1 && us >= (1LL << bucket))
+		bucket++;
+
+	{
+		std::lock_guard<std::mutex> lock{_mutex};
+		CallStats& stats = _stats[{caller, method}];
+		stats.count++;
+		if (!success)
+			stats.failures++;
+		stats.total += ns;
+		stats.max = std::max(stats.max, ns);
+		stats.buckets[bucket]++;
+	}
+
+	auto threshold = _slowCallThreshold.load();
+	if (threshold > 0 && duration.count() > threshold) {
+		std::cerr << SD_WARNING << "[DB] performance: " << "Slow call to " << method << " from " << caller
+			  << ": " << toMilliseconds(ns) << "ms" << (success ? "" : " (failed)") << std::endl;
+	}
+}
+
+chrono::nanoseconds DbProfiler::CallStats::quantile(double q) const
+{
+	std::uint64_t rank = std::max<std::uint64_t>(1, q * count);
+	std::uint64_t cumulated = 0;
+	for (std::size_t i = 0 ; i < BUCKETS - 1 ; i++) {
+		cumulated += buckets[i];
+		if (cumulated >= rank)
+			return std::min<chrono::nanoseconds>(chrono::microseconds{1LL << i}, max);
+	}
+	return max;
+}
+
+void DbProfiler::report(std::ostream& os, const std::string& caller) const
+{
+	using Entry = std::pair<std::pair<std::string_view, std::string_view>, CallStats>;
+	std::vector<Entry> entries;
+	chrono::system_clock::time_point since;
+	{
+		std::lock_guard<std::mutex> lock{_mutex};
+		since = _since;
+		for (auto&& entry : _stats) {
+			if (caller.empty() || entry.first.first == caller)
+				entries.emplace_back(entry);
+		}
+	}
+	std::sort(entries.begin(), entries.end(), [](const Entry& e1, const Entry& e2) {
+		return e1.second.total > e2.second.total;
+	});
+
+	os << "Database calls since " << date::format("%Y-%m-%dT%H:%M:%SZ", date::floor<chrono::seconds>(since))
+	   << " (durations in ms)\n";
+	os << std::left << std::setw(24) << "caller" << std::setw(36) << "method" << std::right
+	   << std::setw(10) << "count" << std::setw(10) << "failures"
+	   << std::setw(12) << "total" << std::setw(10) << "mean"
+	   << std::setw(10) << "p50" << std::setw(10) << "p99" << std::setw(10) << "max" << "\n";
+	os << std::fixed << std::setprecision(3);
+	for (auto&& [key, stats] : entries) {
+		os << std::left << std::setw(24) << key.first << std::setw(36) << key.second << std::right
+		   << std::setw(10) << stats.count << std::setw(10) << stats.failures
+		   << std::setw(12) << toMilliseconds(stats.total)
+		   << std::setw(10) << toMilliseconds(stats.total / stats.count)
+		   << std::setw(10) << toMilliseconds(stats.quantile(0.5))
+		   << std::setw(10) << toMilliseconds(stats.quantile(0.99))
+		   << std::setw(10) << toMilliseconds(stats.max) << "\n";
+	}
+}
+
+void DbProfiler::reset()
+{
+	std::lock_guard<std::mutex> lock{_mutex};
+	_stats.clear();
+	_since = chrono::system_clock::now();
+}
+
+}
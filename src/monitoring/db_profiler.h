@@ -0,0 +1,193 @@
+/**
+ * @file db_profiler.h
+ * @brief Definition of the DbProfiler class
+ * @author Laurent Georget
+ * @date 2026-10-18
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DB_PROFILER_H
+#define DB_PROFILER_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace meteodata
+{
+
+namespace chrono = std::chrono;
+
+/**
+ * @brief The process-wide statistics of the calls to the database, per
+ * method and per caller
+ *
+ * The calls are recorded by the ProfiledDbConnection wrappers (see
+ * profiled_db_connection.h). For each method and each caller (a connector,
+ * a downloader, etc.), the profiler counts the calls and the failures and
+ * keeps the total and maximum durations and a coarse distribution of the
+ * durations, in power-of-two buckets, from which the median and the 99th
+ * percentile are estimated. The statistics are dumped on demand, with the
+ * "db stats" command of meteodatactl.
+ *
+ * The calls slower than a configurable threshold are also logged
+ * individually.
+ */
+class DbProfiler
+{
+public:
+	/**
+	 * @brief Get the profiler of the process
+	 */
+	static DbProfiler& instance();
+
+	/**
+	 * @brief Record a call to the database
+	 *
+	 * @param method The name of the method called, it must be a string
+	 * literal (or live as long as the program)
+	 * @param caller The component which made the call, with the same
+	 * lifetime requirement
+	 * @param duration The duration of the call
+	 * @param success False if the call threw or returned false
+	 */
+	void record(const char* method, const char* caller, chrono::steady_clock::duration duration, bool success);
+
+	/**
+	 * @brief Set the duration above which a call is logged
+	 *
+	 * @param threshold The threshold, zero disables the logging
+	 */
+	void setSlowCallThreshold(chrono::steady_clock::duration threshold)
+	{
+		_slowCallThreshold = threshold.count();
+	}
+
+	/**
+	 * @brief Write the statistics in a table, from the most expensive
+	 * method and caller pair to the cheapest
+	 *
+	 * @param os The stream to write to
+	 * @param caller If not empty, only the calls made by this caller
+	 * are reported
+	 */
+	void report(std::ostream& os, const std::string& caller = {}) const;
+
+	/**
+	 * @brief Forget all the statistics recorded so far
+	 */
+	void reset();
+
+	/**
+	 * @brief Get the caller set for the current thread by the innermost
+	 * CallerScope
+	 *
+	 * @return The caller, or "unattributed" if there is no scope active
+	 */
+	static const char* currentCaller()
+	{
+		return _currentCaller ? _currentCaller : "unattributed";
+	}
+
+	/**
+	 * @brief The attribution of the database calls of the current thread
+	 * to a caller, for the duration of the object lifetime
+	 *
+	 * This is used for the components which do not know who they work
+	 * for, such as the messages parsing payloads and looking up the
+	 * database cache: the connector calling them opens a scope.
+	 */
+	class CallerScope
+	{
+	public:
+		/**
+		 * @brief Attribute the calls to a caller
+		 *
+		 * @param caller The caller, it must be a string literal (or
+		 * live as long as the program)
+		 */
+		explicit CallerScope(const char* caller) :
+			_previous{_currentCaller}
+		{
+			_currentCaller = caller;
+		}
+
+		~CallerScope()
+		{
+			_currentCaller = _previous;
+		}
+
+		CallerScope(const CallerScope&) = delete;
+		CallerScope& operator=(const CallerScope&) = delete;
+
+	private:
+		const char* _previous;
+	};
+
+private:
+	DbProfiler();
+
+	/**
+	 * @brief The number of buckets of the distributions, bucket i
+	 * counts the calls lasting less than 2^i microseconds (and more than
+	 * the upper bound of the previous one), the last one is unbounded
+	 */
+	static constexpr std::size_t BUCKETS = 32;
+
+	struct CallStats
+	{
+		std::uint64_t count = 0;
+		std::uint64_t failures = 0;
+		chrono::nanoseconds total{0};
+		chrono::nanoseconds max{0};
+		std::array<std::uint64_t, BUCKETS> buckets{};
+
+		/**
+		 * @brief Estimate a quantile of the durations
+		 *
+		 * @param q The quantile, between 0 and 1
+		 * @return The upper bound of the bucket containing the
+		 * quantile, capped by the maximum duration
+		 */
+		chrono::nanoseconds quantile(double q) const;
+	};
+
+	mutable std::mutex _mutex;
+	/**
+	 * @brief The statistics, indexed by caller and method, the strings
+	 * are compared by content since the same literal can have several
+	 * addresses
+	 */
+	std::map<std::pair<std::string_view, std::string_view>, CallStats> _stats;
+	chrono::system_clock::time_point _since;
+
+	std::atomic<chrono::steady_clock::rep> _slowCallThreshold{0};
+
+	static thread_local const char* _currentCaller;
+};
+
+}
+
+#endif /* DB_PROFILER_H */
@@ -0,0 +1,151 @@
+/**
+ * @file ingestion_trace.cpp
+ * @brief Implementation of the IngestionTrace class
+ * @author Laurent Georget
+ * @date 2026-10-18
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+
+#include <systemd/sd-daemon.h>
+#include <cassandra.h>
+#include <date/date.h>
+
+#include "ingestion_trace.h"
+#include "metrics.h"
+#include "cassandra_utils.h"
+
+namespace meteodata
+{
+
+namespace
+{
+	constexpr const char* STAGE_NAMES[IngestionTrace::STAGES] = {
+		"receive", "decode", "store", "publish"
+	};
+
+	struct Sampler
+	{
+		std::mutex mutex;
+		std::ofstream file;
+		unsigned int rate = 0;
+		std::atomic<std::uint64_t> traces{0};
+	};
+
+	Sampler& getSampler()
+	{
+		static Sampler sampler;
+		return sampler;
+	}
+
+	double toMilliseconds(chrono::steady_clock::duration d)
+	{
+		return chrono::duration<double, std::milli>(d).count();
+	}
+}
+
+thread_local IngestionTrace* IngestionTrace::_current = nullptr;
+
+IngestionTrace::Path::Path(std::string name) :
+	_name{std::move(name)},
+	_total{MetricsRegistry::instance().histogram("meteodata_ingestion_duration_seconds",
+		"Time taken to process a message, from its receipt to the end of its processing", {{"path", _name}})}
+{
+	for (std::size_t i = 0 ; i < STAGES ; i++) {
+		_stages[i] = &MetricsRegistry::instance().histogram("meteodata_ingestion_stage_duration_seconds",
+			"Time spent in each stage of the processing of a message", {{"path", _name}, {"stage", STAGE_NAMES[i]}});
+	}
+}
+
+IngestionTrace::IngestionTrace(const Path& path, chrono::steady_clock::time_point received) :
+	_path{path},
+	_received{received},
+	_lastMark{received},
+	_previous{_current}
+{
+	_current = this;
+}
+
+IngestionTrace::~IngestionTrace()
+{
+	_current = _previous;
+
+	auto total = chrono::steady_clock::now() - _received;
+	for (std::size_t i = 0 ; i < STAGES ; i++) {
+		if (_marked[i])
+			_path._stages[i]->observe(_durations[i]);
+	}
+	_path._total.observe(total);
+
+	Sampler& sampler = getSampler();
+	if (sampler.rate && sampler.traces.fetch_add(1, std::memory_order_relaxed) % sampler.rate == 0)
+		sample(total);
+}
+
+void IngestionTrace::mark(Stage stage)
+{
+	auto now = chrono::steady_clock::now();
+	auto i = static_cast<std::size_t>(stage);
+	_durations[i] += now - _lastMark;
+	_marked[i] = true;
+	_lastMark = now;
+}
+
+void IngestionTrace::setSampling(const std::string& traceFile, unsigned int rate)
+{
+	Sampler& sampler = getSampler();
+	std::lock_guard<std::mutex> lock{sampler.mutex};
+	sampler.file.open(traceFile, std::ios::app);
+	if (!sampler.file) {
+		std::cerr << SD_ERR << "[Server] management: " << "Cannot open the trace file " << traceFile
+			  << ", the ingestion traces will not be sampled" << std::endl;
+		sampler.rate = 0;
+		return;
+	}
+	sampler.rate = rate;
+}
+
+void IngestionTrace::sample(chrono::steady_clock::duration total) const
+{
+	auto receivedAt = chrono::system_clock::now() - chrono::duration_cast<chrono::system_clock::duration>(total);
+
+	std::ostringstream os;
+	os << R"({"path":")" << _path.getName() << R"(","received":")"
+	   << date::format("%Y-%m-%dT%H:%M:%SZ", date::floor<chrono::milliseconds>(receivedAt)) << '"';
+	if (_hasStation)
+		os << R"(,"station":")" << _station << '"';
+	for (std::size_t i = 0 ; i < STAGES ; i++) {
+		if (_marked[i])
+			os << ",\"" << STAGE_NAMES[i] << "_ms\":" << toMilliseconds(_durations[i]);
+	}
+	os << R"(,"total_ms":)" << toMilliseconds(total) << "}\n";
+
+	Sampler& sampler = getSampler();
+	std::lock_guard<std::mutex> lock{sampler.mutex};
+	sampler.file << os.str() << std::flush;
+}
+
+}
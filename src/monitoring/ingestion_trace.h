@@ -0,0 +1,192 @@
+/**
+ * @file ingestion_trace.h
+ * @brief Definition of the IngestionTrace class
+ * @author Laurent Georget
+ * @date 2026-10-18
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INGESTION_TRACE_H
+#define INGESTION_TRACE_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+#include <cassandra.h>
+
+#include "monitoring/metrics.h"
+
+namespace meteodata
+{
+
+namespace chrono = std::chrono;
+
+/**
+ * @brief The timing of the processing of a message (a datagram, a MQTT
+ * message, an HTTP request, a periodic download) from its receipt to the
+ * publication of the jobs and events following the storage of its data
+ *
+ * A trace is an object living on the stack of the thread processing the
+ * message, from the receipt of the message, or from the moment it is taken
+ * out of a queue, in which case the receipt time is given, to the end of the
+ * processing. While it lives, it is the current trace of the thread and the
+ * code handling the message marks the end of each stage with markCurrent(),
+ * without having to pass the trace around. The time elapsed since the
+ * previous mark is credited to the stage marked, so a stage marked several
+ * times (for instance, once per page of a download) accumulates its
+ * durations. The stages not marked are not
+ * reported.
+ *
+ * When the trace is destroyed, the durations of the stages and the total
+ * duration are recorded in histograms labelled with the path the message took
+ * (see IngestionTrace::Path) and, if the sampling is enabled, one trace out of
+ * N is written to a trace file, one JSON object per line.
+ */
+class IngestionTrace
+{
+public:
+	/**
+	 * @brief The stages of the processing of a message
+	 */
+	enum class Stage : std::size_t
+	{
+		RECEIVED, //!< the message has been received, or taken out of a queue
+		DECODED,  //!< the message has been parsed into observations
+		STORED,   //!< the observations have been written to the database
+		PUBLISHED //!< the jobs and events have been published
+	};
+
+	static constexpr std::size_t STAGES = 4;
+
+	/**
+	 * @brief A path messages take in Meteodata, typically a connector, and
+	 * the histograms of the durations of its stages
+	 *
+	 * A path is expected to be created once and to live as long as the
+	 * traces using it, so that the histograms are looked up only once.
+	 */
+	class Path
+	{
+	public:
+		/**
+		 * @brief Create a path
+		 *
+		 * @param name The name of the path, used as the label of the
+		 * histograms
+		 */
+		explicit Path(std::string name);
+
+		const std::string& getName() const
+		{
+			return _name;
+		}
+
+	private:
+		std::string _name;
+		std::array<Histogram*, STAGES> _stages;
+		Histogram& _total;
+
+		friend class IngestionTrace;
+	};
+
+	/**
+	 * @brief Start a trace and make it the current trace of the thread
+	 *
+	 * @param path The path the message takes
+	 * @param received When the message has been received
+	 */
+	explicit IngestionTrace(const Path& path, chrono::steady_clock::time_point received = chrono::steady_clock::now());
+
+	/**
+	 * @brief Finish the trace, record it and restore the previous current
+	 * trace of the thread
+	 */
+	~IngestionTrace();
+
+	IngestionTrace(const IngestionTrace&) = delete;
+	IngestionTrace& operator=(const IngestionTrace&) = delete;
+
+	/**
+	 * @brief Mark the end of a stage
+	 *
+	 * @param stage The stage just completed
+	 */
+	void mark(Stage stage);
+
+	/**
+	 * @brief Mark the end of a stage of the current trace of the thread,
+	 * if there is one
+	 *
+	 * @param stage The stage just completed
+	 */
+	static void markCurrent(Stage stage)
+	{
+		if (_current)
+			_current->mark(stage);
+	}
+
+	/**
+	 * @brief Tell which station the message of the current trace of the
+	 * thread comes from, if there is one, for the trace file
+	 *
+	 * @param station The station
+	 */
+	static void setCurrentStation(const CassUuid& station)
+	{
+		if (_current) {
+			_current->_station = station;
+			_current->_hasStation = true;
+		}
+	}
+
+	/**
+	 * @brief Write a sample of the traces to a file
+	 *
+	 * This must be called before any trace is recorded.
+	 *
+	 * @param traceFile The file to append the traces to
+	 * @param rate One trace out of rate is written, zero disables the
+	 * sampling
+	 */
+	static void setSampling(const std::string& traceFile, unsigned int rate);
+
+private:
+	const Path& _path;
+	chrono::steady_clock::time_point _received;
+	chrono::steady_clock::time_point _lastMark;
+	std::array<chrono::steady_clock::duration, STAGES> _durations{};
+	std::array<bool, STAGES> _marked{};
+	CassUuid _station{};
+	bool _hasStation = false;
+	IngestionTrace* _previous;
+
+	static thread_local IngestionTrace* _current;
+
+	/**
+	 * @brief Write the trace to the trace file
+	 *
+	 * @param total The total duration of the processing
+	 */
+	void sample(chrono::steady_clock::duration total) const;
+};
+
+}
+
+#endif /* INGESTION_TRACE_H */
@@ -0,0 +1,212 @@
+/**
+ * @file loop_lag_monitor.cpp
+ * @brief Implementation of the LoopLagMonitor class
+ * @author Laurent Georget
+ * @date 2026-10-18
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <systemd/sd-daemon.h>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+
+#include "loop_lag_monitor.h"
+#include "metrics.h"
+
+namespace meteodata
+{
+
+namespace
+{
+	long long toMilliseconds(chrono::steady_clock::duration d)
+	{
+		return chrono::duration_cast<chrono::milliseconds>(d).count();
+	}
+}
+
+thread_local LoopLagMonitor::Worker* LoopLagMonitor::_currentWorker = nullptr;
+
+LoopLagMonitor::LoopLagMonitor(asio::io_context& ioContext, chrono::steady_clock::duration maxLag) :
+	_ioContext{ioContext},
+	_maxLag{maxLag},
+	_lagHistogram{MetricsRegistry::instance().histogram("meteodata_io_loop_lag_seconds",
+		"Delay between the posting of a handler to the I/O context and its execution")}
+{
+}
+
+LoopLagMonitor::~LoopLagMonitor()
+{
+	stop();
+}
+
+void LoopLagMonitor::registerWorker()
+{
+	std::lock_guard<std::mutex> lock{_mutex};
+	Worker& worker = _workers.emplace_back();
+	worker.monitor = this;
+	worker.index = _workers.size() - 1;
+	worker.lag = &MetricsRegistry::instance().gauge("meteodata_io_thread_lag_milliseconds",
+		"Delay before the last probe run by an I/O thread was executed", {{"thread", std::to_string(worker.index)}});
+	_currentWorker = &worker;
+}
+
+void LoopLagMonitor::start()
+{
+	std::lock_guard<std::mutex> lock{_mutex};
+	if (!_stopped)
+		return;
+	_stopped = false;
+	_thread = std::thread{[this]() { monitor(); }};
+}
+
+void LoopLagMonitor::stop()
+{
+	{
+		std::lock_guard<std::mutex> lock{_mutex};
+		_stopped = true;
+	}
+	_condition.notify_all();
+	if (_thread.joinable())
+		_thread.join();
+}
+
+void LoopLagMonitor::monitor()
+{
+	std::unique_lock<std::mutex> lock{_mutex};
+	postProbes();
+	for (;;) {
+		_condition.wait_for(lock, PROBE_PERIOD, [this]() { return _stopped; });
+		if (_stopped)
+			return;
+
+		auto now = chrono::steady_clock::now();
+		bool roundOver = _pendingProbes == 0;
+		chrono::steady_clock::duration lag = roundOver ?
+			chrono::steady_clock::duration{_roundMaxLag.load()} :
+			now - _roundStart;
+
+		bool healthy = lag <= _maxLag;
+		if (!healthy && !_stalledReported) {
+			reportStall(lag);
+			_stalledReported = true;
+		} else if (healthy && _stalledReported) {
+			std::cerr << SD_NOTICE << "[Server] management: " << "The I/O threads are responsive again" << std::endl;
+			_stalledReported = false;
+		}
+		_healthy = healthy;
+
+		// Report each activity holding a thread for too long once
+		for (Worker& worker : _workers) {
+			const char* activity = worker.activity;
+			const char* subject = worker.subject;
+			auto since = worker.activitySince.load();
+			if (activity && since != worker.reportedSince &&
+			    now - chrono::steady_clock::time_point{chrono::steady_clock::duration{since}} > _maxLag) {
+				worker.reportedSince = since;
+				std::cerr << SD_WARNING << "[Server] management: " << "I/O thread " << worker.index
+					  << " has been busy with '" << activity << " " << subject << "' for "
+					  << toMilliseconds(now - chrono::steady_clock::time_point{chrono::steady_clock::duration{since}})
+					  << "ms" << std::endl;
+			}
+		}
+
+		if (roundOver)
+			postProbes();
+	}
+}
+
+void LoopLagMonitor::postProbes()
+{
+	_roundStart = chrono::steady_clock::now();
+	_roundMaxLag = 0;
+	unsigned int probes = std::max<std::size_t>(1, _workers.size());
+	_pendingProbes = probes;
+	for (unsigned int i = 0 ; i < probes ; i++) {
+		asio::post(_ioContext, [this, posted = _roundStart]() {
+			auto lag = chrono::steady_clock::now() - posted;
+			_lagHistogram.observe(lag);
+			if (_currentWorker && _currentWorker->lag)
+				_currentWorker->lag->set(toMilliseconds(lag));
+
+			auto ticks = lag.count();
+			auto max = _roundMaxLag.load();
+			while (ticks > max && !_roundMaxLag.compare_exchange_weak(max, ticks))
+				;
+			_pendingProbes--;
+		});
+	}
+}
+
+void LoopLagMonitor::reportStall(chrono::steady_clock::duration lag)
+{
+	auto now = chrono::steady_clock::now();
+	std::cerr << SD_ERR << "[Server] management: " << "The I/O threads are lagging by " << toMilliseconds(lag)
+		  << "ms, holding back the watchdog" << std::endl;
+	for (const Worker& worker : _workers) {
+		const char* activity = worker.activity;
+		const char* subject = worker.subject;
+		if (!activity)
+			continue;
+		auto since = chrono::steady_clock::time_point{chrono::steady_clock::duration{worker.activitySince.load()}};
+		std::cerr << SD_ERR << "[Server] management: " << "I/O thread " << worker.index << " is busy with '"
+			  << activity << " " << subject << "' since " << toMilliseconds(now - since) << "ms" << std::endl;
+	}
+}
+
+LoopLagMonitor::Activity::Activity(const char* description, const char* subject) :
+	_description{description},
+	_subject{subject},
+	_start{chrono::steady_clock::now()}
+{
+	Worker* worker = _currentWorker;
+	if (!worker)
+		return;
+
+	_previous = worker->activity;
+	_previousSubject = worker->subject;
+	_previousSince = worker->activitySince;
+	worker->activitySince = _start.time_since_epoch().count();
+	worker->subject = subject;
+	worker->activity = description;
+}
+
+LoopLagMonitor::Activity::~Activity()
+{
+	Worker* worker = _currentWorker;
+	if (!worker)
+		return;
+
+	worker->activity = _previous;
+	worker->subject = _previousSubject;
+	worker->activitySince = _previousSince;
+
+	auto duration = chrono::steady_clock::now() - _start;
+	if (duration > worker->monitor->_maxLag) {
+		std::cerr << SD_WARNING << "[Server] management: " << "'" << _description << " " << _subject << "' held I/O thread "
+			  << worker->index << " for " << toMilliseconds(duration) << "ms" << std::endl;
+	}
+}
+
+}
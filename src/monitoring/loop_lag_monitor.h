@@ -0,0 +1,222 @@
+/**
+ * @file loop_lag_monitor.h
+ * @brief Definition of the LoopLagMonitor class
+ * @author Laurent Georget
+ * @date 2026-10-18
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LOOP_LAG_MONITOR_H
+#define LOOP_LAG_MONITOR_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include <boost/asio/io_context.hpp>
+
+#include "monitoring/metrics.h"
+
+namespace meteodata
+{
+
+namespace asio = boost::asio;
+namespace chrono = std::chrono;
+
+/**
+ * @brief The probe measuring how late the handlers posted to the I/O
+ * context are run
+ *
+ * A handler blocking an I/O thread (a sleep, a slow synchronous database
+ * query, etc.) delays all the handlers queued behind it. The monitor posts
+ * timestamped probes to the I/O context from its own thread, one per worker
+ * thread, and measures the time it takes for them to run. The lag is
+ * exported in the metrics and, when it exceeds a threshold, the monitor
+ * reports itself as unhealthy so that the watchdog stops notifying systemd.
+ *
+ * To tell what a busy thread is doing, the long handlers declare their
+ * activity with a LoopLagMonitor::Activity object: the monitor logs the
+ * activity of the threads that have not run their probe in time and the
+ * activities that have held a thread for longer than the threshold.
+ */
+class LoopLagMonitor
+{
+public:
+	/**
+	 * @brief Construct the monitor
+	 *
+	 * @param ioContext The I/O context to monitor
+	 * @param maxLag The lag above which the I/O context is deemed
+	 * unresponsive
+	 */
+	LoopLagMonitor(asio::io_context& ioContext, chrono::steady_clock::duration maxLag);
+
+	~LoopLagMonitor();
+
+	LoopLagMonitor(const LoopLagMonitor&) = delete;
+	LoopLagMonitor& operator=(const LoopLagMonitor&) = delete;
+
+	/**
+	 * @brief Declare the calling thread as an I/O worker thread
+	 *
+	 * This must be called by each thread running the I/O context, before
+	 * running it.
+	 */
+	void registerWorker();
+
+	/**
+	 * @brief Start probing the I/O context
+	 */
+	void start();
+
+	/**
+	 * @brief Stop probing the I/O context and wait for the monitor thread
+	 * to exit
+	 */
+	void stop();
+
+	/**
+	 * @brief Tell whether the I/O context is responsive
+	 *
+	 * @return False if, and only if, the last probes have run, or are
+	 * still waiting to be run, later than the maximum lag
+	 */
+	bool isHealthy() const
+	{
+		return _healthy;
+	}
+
+	/**
+	 * @brief The declaration of what the current I/O thread is busy with,
+	 * for the duration of the object lifetime
+	 *
+	 * This is a no-op on threads that are not registered workers.
+	 */
+	class Activity
+	{
+	public:
+		/**
+		 * @brief Declare an activity
+		 *
+		 * @param description A description of the activity, it must be a
+		 * string literal (or live as long as the program)
+		 * @param subject What the activity is about, for instance the
+		 * name of a connector, with the same lifetime requirement
+		 */
+		explicit Activity(const char* description, const char* subject = "");
+		~Activity();
+
+		Activity(const Activity&) = delete;
+		Activity& operator=(const Activity&) = delete;
+
+	private:
+		const char* _description;
+		const char* _subject;
+		chrono::steady_clock::time_point _start;
+		const char* _previous = nullptr;
+		const char* _previousSubject = "";
+		chrono::steady_clock::rep _previousSince = 0;
+	};
+
+private:
+	/**
+	 * @brief What a worker thread is busy with, published for the monitor
+	 * thread
+	 */
+	struct Worker
+	{
+		LoopLagMonitor* monitor;
+		unsigned int index;
+		std::atomic<const char*> activity{nullptr};
+		std::atomic<const char*> subject{""};
+		std::atomic<chrono::steady_clock::rep> activitySince{0};
+		/**
+		 * @brief The start of the last activity reported as overrunning
+		 * by the monitor thread, not to report it at every round
+		 */
+		chrono::steady_clock::rep reportedSince = 0;
+		Gauge* lag = nullptr;
+	};
+
+	asio::io_context& _ioContext;
+	chrono::steady_clock::duration _maxLag;
+
+	/**
+	 * @brief The worker threads, in a deque so that their address is
+	 * stable, protected by the mutex
+	 */
+	std::deque<Worker> _workers;
+
+	/**
+	 * @brief The worker structure of the current thread, if it is a
+	 * registered worker thread
+	 */
+	static thread_local Worker* _currentWorker;
+
+	/**
+	 * @brief The number of probes of the current round not yet run
+	 */
+	std::atomic<unsigned int> _pendingProbes{0};
+	/**
+	 * @brief The highest lag measured in the current round, in steady
+	 * clock ticks
+	 */
+	std::atomic<chrono::steady_clock::rep> _roundMaxLag{0};
+	chrono::steady_clock::time_point _roundStart;
+
+	std::atomic<bool> _healthy{true};
+	bool _stalledReported = false;
+
+	Histogram& _lagHistogram;
+
+	bool _stopped = true;
+	std::mutex _mutex;
+	std::condition_variable _condition;
+	std::thread _thread;
+
+	/**
+	 * @brief The time between two rounds of probes
+	 */
+	static constexpr chrono::milliseconds PROBE_PERIOD{500};
+
+	/**
+	 * @brief The body of the monitor thread
+	 */
+	void monitor();
+
+	/**
+	 * @brief Post a probe to the I/O context for each worker thread
+	 */
+	void postProbes();
+
+	/**
+	 * @brief Log what the worker threads are busy with, called when the
+	 * probes are late
+	 *
+	 * @param lag How late the oldest probe is
+	 */
+	void reportStall(chrono::steady_clock::duration lag);
+};
+
+}
+
+#endif /* LOOP_LAG_MONITOR_H */
@@ -0,0 +1,211 @@
+/**
+ * @file metrics.cpp
+ * @brief Implementation of the MetricsRegistry class and the metrics
+ * @author Laurent Georget
+ * @date 2026-10-18
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "metrics.h"
+
+namespace meteodata
+{
+
+namespace
+{
+	void writeEscaped(std::ostream& os, const std::string& value)
+	{
+		for (char c : value) {
+			if (c == '\\')
+				os << "\\\\";
+			else if (c == '"')
+				os << "\\\"";
+			else if (c == '\n')
+				os << "\\n";
+			else
+				os << c;
+		}
+	}
+
+	std::string formatBound(double bound)
+	{
+		std::ostringstream os;
+		os << bound;
+		return os.str();
+	}
+
+	/**
+	 * @brief Write the labels of a metric, plus an optional extra one
+	 * (the "le" label of histogram buckets)
+	 */
+	void writeLabels(std::ostream& os, const MetricsRegistry::Labels& labels,
+		const char* extraName = nullptr, const std::string& extraValue = {})
+	{
+		if (labels.empty() && !extraName)
+			return;
+
+		os << '{';
+		bool first = true;
+		for (auto&& [name, value] : labels) {
+			if (!first)
+				os << ',';
+			first = false;
+			os << name << "=\"";
+			writeEscaped(os, value);
+			os << '"';
+		}
+		if (extraName) {
+			if (!first)
+				os << ',';
+			os << extraName << "=\"" << extraValue << '"';
+		}
+		os << '}';
+	}
+}
+
+Histogram::Histogram(std::vector<double> bounds) :
+	_bounds{std::move(bounds)},
+	_buckets{new std::atomic<std::uint64_t>[_bounds.size() + 1]}
+{
+	for (std::size_t i = 0 ; i <= _bounds.size() ; i++)
+		_buckets[i] = 0;
+}
+
+void Histogram::observe(chrono::steady_clock::duration duration)
+{
+	double seconds = chrono::duration<double>(duration).count();
+	std::size_t bucket = std::lower_bound(_bounds.begin(), _bounds.end(), seconds) - _bounds.begin();
+	_buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+	_count.fetch_add(1, std::memory_order_relaxed);
+	_sumNanoseconds.fetch_add(chrono::duration_cast<chrono::nanoseconds>(duration).count(), std::memory_order_relaxed);
+}
+
+const std::vector<double> MetricsRegistry::DEFAULT_BUCKETS = {
+	0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1, 2.5, 5, 10, 30, 60
+};
+
+MetricsRegistry& MetricsRegistry::instance()
+{
+	static MetricsRegistry registry;
+	return registry;
+}
+
+MetricsRegistry::Family& MetricsRegistry::getFamily(const std::string& name, const std::string& help, Type type)
+{
+	auto it = _families.find(name);
+	if (it == _families.end()) {
+		it = _families.emplace(name, Family{}).first;
+		it->second.type = type;
+		it->second.help = help;
+	} else if (it->second.type != type) {
+		throw std::logic_error("Metric " + name + " registered with two different types");
+	}
+	return it->second;
+}
+
+Counter& MetricsRegistry::counter(const std::string& name, const std::string& help, const Labels& labels)
+{
+	std::lock_guard<std::mutex> lock{_mutex};
+	auto& metrics = getFamily(name, help, Type::COUNTER).counters;
+	auto it = metrics.find(labels);
+	if (it == metrics.end())
+		it = metrics.emplace(labels, std::make_unique<Counter>()).first;
+	return *it->second;
+}
+
+Gauge& MetricsRegistry::gauge(const std::string& name, const std::string& help, const Labels& labels)
+{
+	std::lock_guard<std::mutex> lock{_mutex};
+	auto& metrics = getFamily(name, help, Type::GAUGE).gauges;
+	auto it = metrics.find(labels);
+	if (it == metrics.end())
+		it = metrics.emplace(labels, std::make_unique<Gauge>()).first;
+	return *it->second;
+}
+
+Histogram& MetricsRegistry::histogram(const std::string& name, const std::string& help, const Labels& labels,
+	const std::vector<double>& bounds)
+{
+	std::lock_guard<std::mutex> lock{_mutex};
+	auto& metrics = getFamily(name, help, Type::HISTOGRAM).histograms;
+	auto it = metrics.find(labels);
+	if (it == metrics.end())
+		it = metrics.emplace(labels, std::make_unique<Histogram>(bounds)).first;
+	return *it->second;
+}
+
+void MetricsRegistry::render(std::ostream& os) const
+{
+	std::lock_guard<std::mutex> lock{_mutex};
+	for (auto&& [name, family] : _families) {
+		os << "# HELP " << name << " " << family.help << "\n";
+		switch (family.type) {
+			case Type::COUNTER:
+				os << "# TYPE " << name << " counter\n";
+				for (auto&& [labels, counter] : family.counters) {
+					os << name;
+					writeLabels(os, labels);
+					os << " " << counter->value() << "\n";
+				}
+				break;
+			case Type::GAUGE:
+				os << "# TYPE " << name << " gauge\n";
+				for (auto&& [labels, gauge] : family.gauges) {
+					os << name;
+					writeLabels(os, labels);
+					os << " " << gauge->value() << "\n";
+				}
+				break;
+			case Type::HISTOGRAM:
+				os << "# TYPE " << name << " histogram\n";
+				for (auto&& [labels, histogram] : family.histograms) {
+					// buckets are cumulative in the exposition format
+					std::uint64_t cumulated = 0;
+					for (std::size_t i = 0 ; i < histogram->_bounds.size() ; i++) {
+						cumulated += histogram->_buckets[i].load(std::memory_order_relaxed);
+						os << name << "_bucket";
+						writeLabels(os, labels, "le", formatBound(histogram->_bounds[i]));
+						os << " " << cumulated << "\n";
+					}
+					cumulated += histogram->_buckets[histogram->_bounds.size()].load(std::memory_order_relaxed);
+					os << name << "_bucket";
+					writeLabels(os, labels, "le", "+Inf");
+					os << " " << cumulated << "\n";
+					os << name << "_sum";
+					writeLabels(os, labels);
+					os << " " << histogram->_sumNanoseconds.load(std::memory_order_relaxed) / 1e9 << "\n";
+					os << name << "_count";
+					writeLabels(os, labels);
+					os << " " << histogram->_count.load(std::memory_order_relaxed) << "\n";
+				}
+				break;
+		}
+	}
+}
+
+}
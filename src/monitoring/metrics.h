@@ -0,0 +1,233 @@
+/**
+ * @file metrics.h
+ * @brief Definition of the MetricsRegistry class and the metrics
+ * @author Laurent Georget
+ * @date 2026-10-18
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace meteodata
+{
+
+namespace chrono = std::chrono;
+
+/**
+ * @brief A value that only goes up, such as a number of messages received
+ */
+class Counter
+{
+public:
+	void increment(std::uint64_t n = 1)
+	{
+		_value.fetch_add(n, std::memory_order_relaxed);
+	}
+
+	std::uint64_t value() const
+	{
+		return _value.load(std::memory_order_relaxed);
+	}
+
+private:
+	std::atomic<std::uint64_t> _value{0};
+};
+
+/**
+ * @brief A value that goes up and down, such as the length of a queue
+ */
+class Gauge
+{
+public:
+	void set(std::int64_t value)
+	{
+		_value.store(value, std::memory_order_relaxed);
+	}
+
+	void add(std::int64_t n)
+	{
+		_value.fetch_add(n, std::memory_order_relaxed);
+	}
+
+	std::int64_t value() const
+	{
+		return _value.load(std::memory_order_relaxed);
+	}
+
+private:
+	std::atomic<std::int64_t> _value{0};
+};
+
+/**
+ * @brief A distribution of durations, in fixed buckets
+ */
+class Histogram
+{
+public:
+	/**
+	 * @brief Build a histogram
+	 *
+	 * @param bounds The upper bounds of the buckets, in seconds, in
+	 * increasing order (the +Inf bucket is implicit)
+	 */
+	explicit Histogram(std::vector<double> bounds);
+
+	/**
+	 * @brief Record a duration
+	 *
+	 * @param duration The duration
+	 */
+	void observe(chrono::steady_clock::duration duration);
+
+	/**
+	 * @brief Measure the time spent in a scope and record it in a
+	 * histogram when leaving it
+	 */
+	class ScopedTimer
+	{
+	public:
+		explicit ScopedTimer(Histogram& histogram) :
+			_histogram{histogram},
+			_start{chrono::steady_clock::now()}
+		{}
+
+		~ScopedTimer()
+		{
+			_histogram.observe(chrono::steady_clock::now() - _start);
+		}
+
+		ScopedTimer(const ScopedTimer&) = delete;
+		ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+	private:
+		Histogram& _histogram;
+		chrono::steady_clock::time_point _start;
+	};
+
+private:
+	std::vector<double> _bounds;
+	/**
+	 * @brief The number of observations in each bucket, not cumulative,
+	 * the last one is the +Inf bucket
+	 */
+	std::unique_ptr<std::atomic<std::uint64_t>[]> _buckets;
+	std::atomic<std::uint64_t> _count{0};
+	std::atomic<std::uint64_t> _sumNanoseconds{0};
+
+	friend class MetricsRegistry;
+};
+
+/**
+ * @brief The process-wide collection of metrics, exposed in the Prometheus
+ * text format on the REST server
+ *
+ * Metrics are identified by their name and their labels. Looking a metric up
+ * takes a lock, the hot paths are expected to do it once and keep the
+ * reference, which remains valid as long as the process runs; updating a
+ * metric only costs an atomic operation.
+ */
+class MetricsRegistry
+{
+public:
+	using Labels = std::map<std::string, std::string>;
+
+	/**
+	 * @brief The default buckets of the histograms, in seconds, from 5ms
+	 * to one minute
+	 */
+	static const std::vector<double> DEFAULT_BUCKETS;
+
+	/**
+	 * @brief Get the registry of the process
+	 */
+	static MetricsRegistry& instance();
+
+	/**
+	 * @brief Get a counter, created on first use
+	 *
+	 * @param name The name of the metric, conventionally ending in _total
+	 * @param help The description of the metric
+	 * @param labels The labels distinguishing the counter in its family
+	 * @return The counter
+	 */
+	Counter& counter(const std::string& name, const std::string& help, const Labels& labels = {});
+
+	/**
+	 * @brief Get a gauge, created on first use
+	 *
+	 * @param name The name of the metric
+	 * @param help The description of the metric
+	 * @param labels The labels distinguishing the gauge in its family
+	 * @return The gauge
+	 */
+	Gauge& gauge(const std::string& name, const std::string& help, const Labels& labels = {});
+
+	/**
+	 * @brief Get a histogram, created on first use
+	 *
+	 * @param name The name of the metric, conventionally ending in _seconds
+	 * @param help The description of the metric
+	 * @param labels The labels distinguishing the histogram in its family
+	 * @param bounds The upper bounds of the buckets, only used when the
+	 * histogram is created
+	 * @return The histogram
+	 */
+	Histogram& histogram(const std::string& name, const std::string& help, const Labels& labels = {},
+		const std::vector<double>& bounds = DEFAULT_BUCKETS);
+
+	/**
+	 * @brief Write all the metrics in the Prometheus text exposition format
+	 *
+	 * @param os The stream to write to
+	 */
+	void render(std::ostream& os) const;
+
+private:
+	MetricsRegistry() = default;
+
+	enum class Type { COUNTER, GAUGE, HISTOGRAM };
+
+	struct Family
+	{
+		Type type;
+		std::string help;
+		std::map<Labels, std::unique_ptr<Counter>> counters;
+		std::map<Labels, std::unique_ptr<Gauge>> gauges;
+		std::map<Labels, std::unique_ptr<Histogram>> histograms;
+	};
+
+	mutable std::mutex _mutex;
+	std::map<std::string, Family> _families;
+
+	Family& getFamily(const std::string& name, const std::string& help, Type type);
+};
+
+}
+
+#endif /* METRICS_H */
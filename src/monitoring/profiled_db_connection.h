@@ -0,0 +1,181 @@
+/**
+ * @file profiled_db_connection.h
+ * @brief Definition of the BasicProfiledDbConnection class
+ * @author Laurent Georget
+ * @date 2026-10-18
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PROFILED_DB_CONNECTION_H
+#define PROFILED_DB_CONNECTION_H
+
+#include <chrono>
+#include <type_traits>
+#include <utility>
+
+#include "monitoring/db_profiler.h"
+#include "storage/observations_storage.h"
+
+namespace meteodata
+{
+
+namespace chrono = std::chrono;
+
+/**
+ * @brief A wrapper around a database connection recording the duration and
+ * the outcome of each call in the DbProfiler
+ *
+ * The wrapper has the same interface as the connection for the methods used
+ * in Meteodata, it can replace a reference to the connection as a class
+ * member and be passed to the functions expecting the connection itself.
+ * The wrapped connection can be anything with this interface, not only an
+ * ObservationsStorage, so that the profiling can also be exercised on
+ * a partial stand-in database.
+ *
+ * A call fails when it throws or when it returns false, the latter is also
+ * how the lookups such as getCachedInt report a missing value.
+ *
+ * @tparam Db The type of the wrapped connection
+ */
+template<typename Db>
+class BasicProfiledDbConnection
+{
+public:
+	/**
+	 * @brief Wrap a connection
+	 *
+	 * @param db The connection to the database
+	 * @param caller The component making the calls, it must be a string
+	 * literal (or live as long as the program), if it is null, the calls
+	 * are attributed to the current DbProfiler::CallerScope
+	 */
+	explicit BasicProfiledDbConnection(Db& db, const char* caller = nullptr) :
+		_db{db},
+		_caller{caller}
+	{}
+
+	/**
+	 * @brief Change the component the calls are attributed to
+	 *
+	 * @param caller The component making the calls, with the same
+	 * lifetime requirement as in the constructor
+	 */
+	void setCaller(const char* caller)
+	{
+		_caller = caller;
+	}
+
+	/**
+	 * @brief Give the wrapped connection, for the components taking it
+	 * as a parameter (the calls they make are not profiled unless they
+	 * wrap it themselves)
+	 */
+	operator Db&() const
+	{
+		return _db;
+	}
+
+#define METEODATA_PROFILED_DB_METHOD(method) \
+	template<typename... Args> \
+	decltype(auto) method(Args&&... args) const \
+	{ \
+		return profile(#method, [&]() -> decltype(auto) { return _db.method(std::forward<Args>(args)...); }); \
+	}
+
+	METEODATA_PROFILED_DB_METHOD(cacheFloat)
+	METEODATA_PROFILED_DB_METHOD(cacheInt)
+	METEODATA_PROFILED_DB_METHOD(deleteDataPoints)
+	METEODATA_PROFILED_DB_METHOD(getAllCimelStations)
+	METEODATA_PROFILED_DB_METHOD(getAllFieldClimateApiStations)
+	METEODATA_PROFILED_DB_METHOD(getAllIcaos)
+	METEODATA_PROFILED_DB_METHOD(getAllLiveobjectsStations)
+	METEODATA_PROFILED_DB_METHOD(getAllNbiotStations)
+	METEODATA_PROFILED_DB_METHOD(getAllVirtualStations)
+	METEODATA_PROFILED_DB_METHOD(getAllWeatherlinkAPIv2Stations)
+	METEODATA_PROFILED_DB_METHOD(getAllWeatherlinkStations)
+	METEODATA_PROFILED_DB_METHOD(getCachedFloat)
+	METEODATA_PROFILED_DB_METHOD(getCachedInt)
+	METEODATA_PROFILED_DB_METHOD(getDataBetween)
+	METEODATA_PROFILED_DB_METHOD(getDeferredSynops)
+	METEODATA_PROFILED_DB_METHOD(getLastConfiguration)
+	METEODATA_PROFILED_DB_METHOD(getLastDataBefore)
+	METEODATA_PROFILED_DB_METHOD(getLastSchedulerDownloadTime)
+	METEODATA_PROFILED_DB_METHOD(getMBDataTxtStations)
+	METEODATA_PROFILED_DB_METHOD(getMeteoFranceStations)
+	METEODATA_PROFILED_DB_METHOD(getMqttStations)
+	METEODATA_PROFILED_DB_METHOD(getOneConfiguration)
+	METEODATA_PROFILED_DB_METHOD(getRainfall)
+	METEODATA_PROFILED_DB_METHOD(getStatICTxtStations)
+	METEODATA_PROFILED_DB_METHOD(getStationByCoords)
+	METEODATA_PROFILED_DB_METHOD(getStationCoordinates)
+	METEODATA_PROFILED_DB_METHOD(getStationDetails)
+	METEODATA_PROFILED_DB_METHOD(getStationLocation)
+	METEODATA_PROFILED_DB_METHOD(insertCollection)
+	METEODATA_PROFILED_DB_METHOD(insertLastSchedulerDownloadTime)
+	METEODATA_PROFILED_DB_METHOD(insertV2DataPoint)
+	METEODATA_PROFILED_DB_METHOD(insertV2DataPoints)
+	METEODATA_PROFILED_DB_METHOD(insertV2DataPointInTimescaleDB)
+	METEODATA_PROFILED_DB_METHOD(insertV2DataPointsInTimescaleDB)
+	METEODATA_PROFILED_DB_METHOD(insertV2EntireDayValues)
+	METEODATA_PROFILED_DB_METHOD(insertV2Tn)
+	METEODATA_PROFILED_DB_METHOD(insertV2Tx)
+	METEODATA_PROFILED_DB_METHOD(selectDownloadsByStation)
+	METEODATA_PROFILED_DB_METHOD(selectExportedStations)
+	METEODATA_PROFILED_DB_METHOD(updateConfigurationStatus)
+	METEODATA_PROFILED_DB_METHOD(updateDownloadStatus)
+	METEODATA_PROFILED_DB_METHOD(updateLastArchiveDownloadTime)
+
+#undef METEODATA_PROFILED_DB_METHOD
+
+private:
+	Db& _db;
+	const char* _caller;
+
+	template<typename Call>
+	decltype(auto) profile(const char* method, Call&& call) const
+	{
+		using Result = decltype(call());
+		const char* caller = _caller ? _caller : DbProfiler::currentCaller();
+		auto start = chrono::steady_clock::now();
+		try {
+			if constexpr (std::is_void_v<Result>) {
+				call();
+				DbProfiler::instance().record(method, caller, chrono::steady_clock::now() - start, true);
+			} else {
+				Result result = call();
+				bool success = true;
+				if constexpr (std::is_same_v<std::decay_t<Result>, bool>)
+					success = result;
+				DbProfiler::instance().record(method, caller, chrono::steady_clock::now() - start, success);
+				return result;
+			}
+		} catch (...) {
+			DbProfiler::instance().record(method, caller, chrono::steady_clock::now() - start, false);
+			throw;
+		}
+	}
+};
+
+/**
+ * @brief The profiled connection to the observations database
+ */
+using ProfiledDbConnection = BasicProfiledDbConnection<ObservationsStorage>;
+
+}
+
+#endif /* PROFILED_DB_CONNECTION_H */
@@ -39,8 +39,9 @@ namespace args = std::placeholders;
 namespace meteodata
 {
 
-Watchdog::Watchdog(asio::io_context& ioContext) :
-	_timer{ioContext}
+Watchdog::Watchdog(asio::io_context& ioContext, const LoopLagMonitor* lagMonitor) :
+	_timer{ioContext},
+	_lagMonitor{lagMonitor}
 {
 }
 
@@ -91,6 +92,10 @@ void Watchdog::checkDeadline(const sys::error_code& e)
 
 void Watchdog::sendNotification()
 {
+	// A handler ran, but the I/O threads are too slow to be considered
+	// alive, let systemd restart us if it lasts
+	if (_lagMonitor && !_lagMonitor->isHealthy())
+		return;
 	sd_notify(0, "WATCHDOG=1");
 }
 
@@ -31,6 +31,8 @@
 #include <boost/asio/basic_waitable_timer.hpp>
 #include <boost/asio/io_context.hpp>
 
+#include "monitoring/loop_lag_monitor.h"
+
 namespace meteodata
 {
 
@@ -58,8 +60,10 @@ public:
 	 *
 	 * @param ioContext the Boost object used to process asynchronous
 	 * events, timers, and callbacks
+	 * @param lagMonitor the monitor of the I/O threads responsiveness, the
+	 * notifications are withheld while it reports the threads as lagging
 	 */
-	explicit Watchdog(asio::io_context& ioContext);
+	explicit Watchdog(asio::io_context& ioContext, const LoopLagMonitor* lagMonitor = nullptr);
 
 	/**
 	 * @brief Start the periodic watchdog notification
@@ -86,6 +90,8 @@ private:
 
 	chrono::microseconds _period;
 
+	const LoopLagMonitor* _lagMonitor;
+
 	bool _stopped = true;
 
 private:
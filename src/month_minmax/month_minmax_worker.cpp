@@ -23,7 +23,9 @@
 
 #include <chrono>
 #include <iostream>
+#include <vector>
 
+#include <boost/asio/post.hpp>
 #include <date/date.h>
 #include <cassobs/dbconnection_minmax.h>
 #include <cassobs/dbconnection_jobs.h>
@@ -33,6 +35,7 @@
 #include "month_minmax_worker.h"
 #include "month_minmax/month_minmax_computer.h"
 #include "cassandra_utils.h"
+#include "job_coalescer.h"
 
 namespace meteodata {
 
@@ -54,7 +57,7 @@ void MonthMinmaxWorker::checkDeadline(const sys::error_code& e)
 	if (e == sys::errc::operation_canceled)
 		return;
 
-	if (_timer.expires_at() <= chrono::steady_clock::now()) {
+	if (_timer.expires_at() <= SteadyClock::now()) {
 		if (!_stopped)
 			processJobs();
 	} else {
@@ -82,26 +85,52 @@ void MonthMinmaxWorker::processJobs()
 	if (_stopped)
 		return;
 
+	/* Claim all the pending jobs (up to a limit) and merge them so that
+	 * each month is computed only once per station, even if the minmax
+	 * worker has published several jobs for it in the meantime */
+	JobCoalescer coalescer{JobCoalescer::Granularity::MONTH};
 	std::optional<DbConnectionJobs::StationJob> nextMonthMinmaxJob = _dbJobs.retrieveMonthMinmax();
-	if (nextMonthMinmaxJob && !_stopped) {
+	while (nextMonthMinmaxJob && !_stopped) {
+		coalescer.add(*nextMonthMinmaxJob);
+		if (coalescer.size() >= MAX_JOBS_PER_BATCH)
+			break;
+		nextMonthMinmaxJob = _dbJobs.retrieveMonthMinmax();
+	}
+
+	if (coalescer.size() > 0) {
+		std::size_t claimed = coalescer.size();
+		std::vector<JobCoalescer::CoalescedJob> jobs = coalescer.coalesce();
+		if (jobs.size() < claimed) {
+			std::cerr << SD_DEBUG << "Coalesced " << claimed << " month minmax jobs into "
+				<< jobs.size() << " computations" << std::endl;
+		}
+
 		MonthMinmaxComputer computer{_dbMonthMinmax, _dbNormals};
-		do {
-			bool result = computer.computeMonthMinmax(nextMonthMinmaxJob->station, nextMonthMinmaxJob->begin, nextMonthMinmaxJob->end);
-			date::sys_days b{date::floor<date::days>(nextMonthMinmaxJob->begin)};
-			date::sys_days e{date::floor<date::days>(nextMonthMinmaxJob->end)};
+		for (auto&& job : jobs) {
+			bool result = computer.computeMonthMinmax(job.station, job.begin, job.end);
+			date::sys_days b{date::floor<date::days>(job.begin)};
+			date::sys_days e{date::floor<date::days>(job.end)};
 			if (result) {
 				std::cerr << SD_INFO << "Month minmax computed for station "
-					<< nextMonthMinmaxJob->station << " between times "
+					<< job.station << " between times "
 					<< b << " and " << e << std::endl;
-				_dbJobs.markJobAsFinished(nextMonthMinmaxJob->id, std::time(nullptr), 0);
+				for (auto&& id : job.ids)
+					_dbJobs.markJobAsFinished(id, chrono::system_clock::to_time_t(SystemClock::now()), 0);
 			} else {
 				std::cerr << SD_ERR << "Month minmax computation failed at least partially for station "
-					<< nextMonthMinmaxJob->station << " between times "
+					<< job.station << " between times "
 					<< b << " and " << e << std::endl;
-				_dbJobs.markJobAsFinished(nextMonthMinmaxJob->id, std::time(nullptr), 1);
+				for (auto&& id : job.ids)
+					_dbJobs.markJobAsFinished(id, chrono::system_clock::to_time_t(SystemClock::now()), 1);
 			}
-			nextMonthMinmaxJob = _dbJobs.retrieveMonthMinmax();
-		} while (nextMonthMinmaxJob);
+		}
+
+		/* There might be more jobs waiting, do not wait before claiming
+		 * them */
+		if (!_stopped) {
+			boost::asio::post(_ioContext, [this]() { processJobs(); });
+			return;
+		}
 	}
 
 	_timer.expires_after(WAITING_DELAY);
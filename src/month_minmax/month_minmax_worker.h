@@ -33,6 +33,8 @@
 #include <cassobs/dbconnection_month_minmax.h>
 #include <cassobs/dbconnection_normals.h>
 
+#include "simulated_clock.h"
+
 namespace meteodata
 {
 
@@ -67,7 +69,7 @@ public:
 private:
 	boost::asio::io_context& _ioContext;
 
-	boost::asio::basic_waitable_timer<std::chrono::steady_clock> _timer;
+	SteadyTimer _timer;
 
 	DbConnectionMonthMinmax _dbMonthMinmax;
 
@@ -82,6 +84,11 @@ private:
 	bool _stopped = true;
 
 	constexpr static std::chrono::seconds WAITING_DELAY{300};
+
+	/**
+	 * @brief The maximum number of jobs claimed at once to be coalesced
+	 */
+	constexpr static std::size_t MAX_JOBS_PER_BATCH = 500;
 };
 
 }
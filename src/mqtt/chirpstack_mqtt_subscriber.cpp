@@ -28,7 +28,6 @@
 #include <mutex>
 
 #include <mqtt_client_cpp.hpp>
-#include <cassobs/dbconnection_observations.h>
 #include <date/date.h>
 #include <cassandra.h>
 #include <boost/property_tree/json_parser.hpp>
@@ -36,16 +35,22 @@
 #include <systemd/sd-daemon.h>
 #include <openssl/evp.h>
 
+#include "storage/observations_storage.h"
 #include "mqtt_subscriber.h"
 #include "chirpstack_mqtt_subscriber.h"
 #include "cassandra_utils.h"
+#include "monitoring/ingestion_trace.h"
+
+#ifdef EVENT_MANAGER_ON
+#include "event/new_datapoint_event.h"
+#endif
 
 namespace meteodata
 {
 namespace pt = boost::property_tree;
 
 ChirpstackMqttSubscriber::ChirpstackMqttSubscriber(const MqttSubscriber::MqttSubscriptionDetails& details,
-	asio::io_context& ioContext, DbConnectionObservations& db,
+	asio::io_context& ioContext, ObservationsStorage& db,
 	const std::shared_ptr<AsyncJobPublisher>& jobPublisher) :
 		MqttSubscriber{details, ioContext, db, jobPublisher}
 {
@@ -70,7 +75,7 @@ bool ChirpstackMqttSubscriber::handleSubAck(packet_id_t packetId, std::vector<mq
 	return true;
 }
 
-void ChirpstackMqttSubscriber::processArchive(const std::string_view& topicName, const std::string_view& content)
+bool ChirpstackMqttSubscriber::processArchive(const std::string_view& topicName, const std::string_view& content)
 {
 	std::lock_guard<std::mutex> lock{_stationsMutex};
 	using date::operator<<;
@@ -78,10 +83,11 @@ void ChirpstackMqttSubscriber::processArchive(const std::string_view& topicName,
 	auto stationIt = _stations.find(topicName);
 	if (stationIt == _stations.end()) {
 		std::cout << SD_NOTICE << "[MQTT protocol]: " << "Unknown topic " << topicName << std::endl;
-		return;
+		return true;
 	}
 
 	const CassUuid& station = std::get<0>(stationIt->second);
+	IngestionTrace::setCurrentStation(station);
 	const std::string& stationName = std::get<1>(stationIt->second);
 	std::cout << SD_DEBUG << "[MQTT Chirpstack " << station << "] measurement: " << "Now receiving for MQTT station "
 			  << stationName << std::endl;
@@ -96,10 +102,13 @@ void ChirpstackMqttSubscriber::processArchive(const std::string_view& topicName,
 	int ret = false;
 	if (msg && msg->looksValid()) {
 		Observation o = msg->getObservation(station);
+		IngestionTrace::markCurrent(IngestionTrace::Stage::DECODED);
 		ret = _db.insertV2DataPoint(o) && _db.insertV2DataPointInTimescaleDB(o);
 	} else {
 		std::cerr << SD_WARNING << "[MQTT Chirpstack " << station << "] measurement: "
 				  << "Record looks invalid, discarding " << std::endl;
+		// nothing to store, do not get the message redelivered
+		return true;
 	}
 
 	if (ret) {
@@ -111,16 +120,24 @@ void ChirpstackMqttSubscriber::processArchive(const std::string_view& topicName,
 			std::cerr << SD_ERR << "[MQTT Chirpstack " << station << "] management: "
 					  << "Couldn't update last archive download time" << std::endl;
 
+		IngestionTrace::markCurrent(IngestionTrace::Stage::STORED);
 		if (_jobPublisher)
 			_jobPublisher->publishJobsForPastDataInsertion(station, timestamp, timestamp);
 
+#ifdef EVENT_MANAGER_ON
+		publish(NewDatapointEvent{station, date::floor<chrono::seconds>(chrono::system_clock::now()), timestamp}, station);
+#endif
+		IngestionTrace::markCurrent(IngestionTrace::Stage::PUBLISHED);
+
 		msg->cacheValues(station);
 	} else {
 		std::cerr << SD_ERR << "[MQTT Chirpstack " << station << "] measurement: "
 				  << "Failed to store archive for MQTT station " << stationName << "! Aborting" << std::endl;
 		// will retry...
-		return;
+		return false;
 	}
+
+	return true;
 }
 
 std::unique_ptr<LiveobjectsMessage> ChirpstackMqttSubscriber::buildMessage(const boost::property_tree::ptree& json, const CassUuid& station, date::sys_seconds& timestamp)
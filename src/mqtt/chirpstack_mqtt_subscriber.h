@@ -26,9 +26,9 @@
 #include <vector>
 #include <boost/asio/io_context.hpp>
 #include <cassandra.h>
-#include <cassobs/dbconnection_observations.h>
 #include <mqtt_client_cpp.hpp>
 
+#include "storage/observations_storage.h"
 #include "async_job_publisher.h"
 #include "liveobjects/liveobjects_message.h"
 #include "mqtt_subscriber.h"
@@ -40,13 +40,13 @@ class ChirpstackMqttSubscriber : public MqttSubscriber
 {
 public:
 	ChirpstackMqttSubscriber(const MqttSubscriptionDetails& details, asio::io_context& ioContext,
-		DbConnectionObservations& db,
+		ObservationsStorage& db,
 		const std::shared_ptr<AsyncJobPublisher>& jobScheduler = nullptr);
 
 protected:
 	bool handleSubAck(packet_id_t packetId, std::vector<mqtt::suback_return_code> results) override;
 
-	void processArchive(const std::string_view& topicName, const std::string_view& content) override;
+	bool processArchive(const std::string_view& topicName, const std::string_view& content) override;
 	std::unique_ptr<LiveobjectsMessage> buildMessage(const boost::property_tree::ptree& json, const CassUuid& station, date::sys_seconds& timestamp);
 
 	const char* getConnectorSuffix() override
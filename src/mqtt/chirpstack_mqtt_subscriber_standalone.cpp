@@ -34,7 +34,6 @@
 #include <system_error>
 
 #include <cassandra.h>
-#include <cassobs/dbconnection_observations.h>
 #include <boost/asio.hpp>
 #include <boost/json/src.hpp>
 #include <mqtt_client_cpp.hpp> // must be kept before boost/program_options.hpp else build breaks (not sure why...)
@@ -42,6 +41,7 @@
 #include <boost/program_options.hpp>
 
 #include "../cassandra_utils.h"
+#include "storage/observations_storage.h"
 #include "config.h"
 #include "mqtt/mqtt_subscriber.h"
 #include "mqtt/chirpstack_mqtt_subscriber.h"
@@ -77,6 +77,7 @@ int main(int argc, char** argv)
 	std::string pguser;
 	std::string pgpassword;
 	std::string pgaddress;
+	StorageConfiguration storageConfig;
 	std::vector<std::string> namedStations;
 	std::string mqttAddress;
 	int mqttPort;
@@ -94,6 +95,9 @@ int main(int argc, char** argv)
 		("pguser", po::value<std::string>(&pguser), "PostgreSQL database username")
 		("pgpassword", po::value<std::string>(&pgpassword), "PostgreSQL database password")
 		("pghost", po::value<std::string>(&pgaddress), "PostgreSQL database IP address or domain name")
+		("storage", po::value<std::string>(&storageConfig.backend), "storage backend, 'cassandra' (Cassandra and PostgreSQL databases) or 'memory' (in-process stand-in keeping everything in memory, for benchmarks), defaults to 'cassandra'")
+		("station-table", po::value<std::string>(&storageConfig.stationTable), "with the 'memory' storage, file listing the stations and connectors to serve")
+		("storage-latency", po::value<unsigned long>(&storageConfig.latency), "with the 'memory' storage, delay in microseconds added to each call, defaults to 0")
 		("mqtt-host", po::value<std::string>(&mqttAddress), "MQTT broker IP address or domain name")
 		("mqtt-port", po::value<int>(&mqttPort), "MQTT port")
 		("mqtt-user", po::value<std::string>(&mqttUser), "MQTT user name")
@@ -163,7 +167,9 @@ int main(int argc, char** argv)
 	cass_log_set_callback(logCallback, nullptr);
 
 	asio::io_context ioContext;
-	DbConnectionObservations db{address, user, password, pgaddress, pguser, pgpassword};
+	std::unique_ptr<ObservationsStorage> storage = ObservationsStorage::create(storageConfig,
+		address, user, password, pgaddress, pguser, pgpassword);
+	ObservationsStorage& db = *storage;
 
 	std::vector<std::tuple<CassUuid, std::string, int, std::string, std::unique_ptr<char[]>, size_t, std::string, int>> mqttStations;
 	db.getMqttStations(mqttStations);
@@ -37,7 +37,7 @@ bool GenericMessage::looksValid() const
 	return _obs.valid;
 }
 
-GenericMessage GenericMessage::buildMessage(DbConnectionObservations& db,
+GenericMessage GenericMessage::buildMessage(ObservationsStorage& db,
 	const boost::property_tree::ptree& json, date::sys_seconds& timestamp)
 {
 	GenericMessage m;
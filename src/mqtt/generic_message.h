@@ -26,13 +26,14 @@
 
 #include <memory>
 
-#include <cassobs/dbconnection_observations.h>
 #include <cassandra.h>
 #include <cassobs/observation.h>
 #include <boost/property_tree/ptree.hpp>
 #include <boost/json.hpp>
 #include <date/date.h>
 
+#include "storage/observations_storage.h"
+
 namespace meteodata {
 
 class GenericMessage
@@ -64,7 +65,7 @@ public:
 	};
 
 	static GenericMessage buildMessage(
-		DbConnectionObservations& db,
+		ObservationsStorage& db,
 		const boost::property_tree::ptree& json,
 		date::sys_seconds& timestamp
 	);
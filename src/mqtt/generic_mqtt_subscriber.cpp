@@ -28,24 +28,29 @@
 #include <mutex>
 
 #include <mqtt_client_cpp.hpp>
-#include <cassobs/dbconnection_observations.h>
 #include <date/date.h>
 #include <cassandra.h>
 #include <boost/property_tree/json_parser.hpp>
 #include <boost/property_tree/ptree.hpp>
 #include <systemd/sd-daemon.h>
 
+#include "storage/observations_storage.h"
 #include "mqtt_subscriber.h"
 #include "generic_mqtt_subscriber.h"
 #include "generic_message.h"
 #include "cassandra_utils.h"
+#include "monitoring/ingestion_trace.h"
+
+#ifdef EVENT_MANAGER_ON
+#include "event/new_datapoint_event.h"
+#endif
 
 namespace meteodata
 {
 namespace pt = boost::property_tree;
 
 GenericMqttSubscriber::GenericMqttSubscriber(const MqttSubscriber::MqttSubscriptionDetails& details,
-	asio::io_context& ioContext, DbConnectionObservations& db,
+	asio::io_context& ioContext, ObservationsStorage& db,
 	const std::shared_ptr<AsyncJobPublisher>& jobPublisher) :
 		MqttSubscriber{details, ioContext, db, jobPublisher}
 {
@@ -70,7 +75,7 @@ bool GenericMqttSubscriber::handleSubAck(packet_id_t packetId, std::vector<mqtt:
 	return true;
 }
 
-void GenericMqttSubscriber::processArchive(const std::string_view& topicName, const std::string_view& content)
+bool GenericMqttSubscriber::processArchive(const std::string_view& topicName, const std::string_view& content)
 {
 	using date::operator<<;
 
@@ -79,10 +84,11 @@ void GenericMqttSubscriber::processArchive(const std::string_view& topicName, co
 	auto stationIt = _stations.find(topicName);
 	if (stationIt == _stations.end()) {
 		std::cout << SD_NOTICE << "[MQTT protocol]: " << "Unknown topic " << topicName << std::endl;
-		return;
+		return true;
 	}
 
 	const CassUuid& station = std::get<0>(stationIt->second);
+	IngestionTrace::setCurrentStation(station);
 	const std::string& stationName = std::get<1>(stationIt->second);
 	std::cout << SD_DEBUG << "[MQTT Generic " << station << "] measurement: " << "Now receiving for MQTT station "
 		  << stationName << std::endl;
@@ -97,10 +103,13 @@ void GenericMqttSubscriber::processArchive(const std::string_view& topicName, co
 	int ret = false;
 	if (msg.looksValid()) {
 		Observation o = msg.getObservation(station);
+		IngestionTrace::markCurrent(IngestionTrace::Stage::DECODED);
 		ret = _db.insertV2DataPoint(o) && _db.insertV2DataPointInTimescaleDB(o);
 	} else {
 		std::cerr << SD_WARNING << "[MQTT Generic " << station << "] measurement: "
 			  << "Record looks invalid, discarding " << std::endl;
+		// nothing to store, do not get the message redelivered
+		return true;
 	}
 
 	if (ret) {
@@ -112,16 +121,24 @@ void GenericMqttSubscriber::processArchive(const std::string_view& topicName, co
 			std::cerr << SD_ERR << "[MQTT Generic " << station << "] management: "
 				  << "Couldn't update last archive download time" << std::endl;
 
+		IngestionTrace::markCurrent(IngestionTrace::Stage::STORED);
 		if (_jobPublisher)
 			_jobPublisher->publishJobsForPastDataInsertion(station, timestamp, timestamp);
 
+#ifdef EVENT_MANAGER_ON
+		publish(NewDatapointEvent{station, date::floor<chrono::seconds>(chrono::system_clock::now()), timestamp}, station);
+#endif
+		IngestionTrace::markCurrent(IngestionTrace::Stage::PUBLISHED);
+
 		msg.cacheValues(station);
 	} else {
 		std::cerr << SD_ERR << "[MQTT Generic " << station << "] measurement: "
 				  << "Failed to store archive for MQTT station " << stationName << "! Aborting" << std::endl;
 		// will retry...
-		return;
+		return false;
 	}
+
+	return true;
 }
 
 GenericMessage GenericMqttSubscriber::buildMessage(const boost::property_tree::ptree& json, const CassUuid& station, date::sys_seconds& timestamp)
@@ -24,8 +24,7 @@
 #include <string>
 #include <mutex>
 
-#include <cassobs/dbconnection_observations.h>
-
+#include "storage/observations_storage.h"
 #include "async_job_publisher.h"
 #include "mqtt/mqtt_subscriber.h"
 #include "mqtt/liveobjects_external_mqtt_subscriber.h"
@@ -39,7 +38,7 @@ LiveobjectsExternalMqttSubscriber::LiveobjectsExternalMqttSubscriber(
 	std::string clientIdentifier,
 	const MqttSubscriber::MqttSubscriptionDetails& details,
 	asio::io_context& ioContext,
-	DbConnectionObservations& db,
+	ObservationsStorage& db,
 	const std::shared_ptr<AsyncJobPublisher>& jobPublisher) :
 		LiveobjectsMqttSubscriber{details, ioContext, db, jobPublisher},
 		_clientIdentifier{std::move(clientIdentifier)}
@@ -27,9 +27,9 @@
 
 #include <boost/asio/io_context.hpp>
 #include <cassandra.h>
-#include <cassobs/dbconnection_observations.h>
 #include <mqtt_client_cpp.hpp>
 
+#include "storage/observations_storage.h"
 #include "liveobjects_mqtt_subscriber.h"
 
 namespace meteodata
@@ -41,7 +41,7 @@ public:
 	LiveobjectsExternalMqttSubscriber(
 		std::string clientIdentifier,
 		const MqttSubscriptionDetails& details, asio::io_context& ioContext,
-		DbConnectionObservations& db,
+		ObservationsStorage& db,
 		const std::shared_ptr<AsyncJobPublisher>& jobPublisher = nullptr);
 
 private:
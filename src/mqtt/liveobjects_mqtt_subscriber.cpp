@@ -29,23 +29,28 @@
 #include <mutex>
 
 #include <mqtt_client_cpp.hpp>
-#include <cassobs/dbconnection_observations.h>
 #include <date/date.h>
 #include <cassandra.h>
 #include <boost/property_tree/json_parser.hpp>
 #include <boost/property_tree/ptree.hpp>
 #include <systemd/sd-daemon.h>
 
+#include "storage/observations_storage.h"
 #include "cassandra_utils.h"
 #include "mqtt/mqtt_subscriber.h"
 #include "mqtt/liveobjects_mqtt_subscriber.h"
+#include "monitoring/ingestion_trace.h"
+
+#ifdef EVENT_MANAGER_ON
+#include "event/new_datapoint_event.h"
+#endif
 
 namespace meteodata
 {
 namespace pt = boost::property_tree;
 
 LiveobjectsMqttSubscriber::LiveobjectsMqttSubscriber(const MqttSubscriber::MqttSubscriptionDetails& details,
-	asio::io_context& ioContext, DbConnectionObservations& db,
+	asio::io_context& ioContext, ObservationsStorage& db,
 	const std::shared_ptr<AsyncJobPublisher>& jobPublisher) :
 		MqttSubscriber{details, ioContext, db, jobPublisher}
 {
@@ -76,7 +81,7 @@ bool LiveobjectsMqttSubscriber::handleSubAck(packet_id_t packetId, std::vector<m
 	return true;
 }
 
-void LiveobjectsMqttSubscriber::processArchive(const std::string_view& topicName, const std::string_view& content)
+bool LiveobjectsMqttSubscriber::processArchive(const std::string_view& topicName, const std::string_view& content)
 {
 	using date::operator<<;
 
@@ -90,10 +95,11 @@ void LiveobjectsMqttSubscriber::processArchive(const std::string_view& topicName
 	auto stationIt = _stations.find(streamId);
 	if (stationIt == _stations.end()) {
 		std::cout << SD_NOTICE << "[MQTT Liveobjects] protocol: " << "Unknown stream id " << streamId << std::endl;
-		return;
+		return true;
 	}
 
 	const CassUuid& station = std::get<0>(stationIt->second);
+	IngestionTrace::setCurrentStation(station);
 	const std::string& stationName = std::get<1>(stationIt->second);
 	std::cout << SD_DEBUG << "[MQTT Liveobjects " << station << "] measurement: " << "Now receiving for MQTT station "
 		  << stationName << std::endl;
@@ -105,10 +111,13 @@ void LiveobjectsMqttSubscriber::processArchive(const std::string_view& topicName
 	int ret = false;
 	if (msg && msg->looksValid()) {
 		Observation o = msg->getObservation(station);
+		IngestionTrace::markCurrent(IngestionTrace::Stage::DECODED);
 		ret = _db.insertV2DataPoint(o) && _db.insertV2DataPointInTimescaleDB(o);
 	} else {
 		std::cerr << SD_WARNING << "[MQTT Liveobjects " << station << "] measurement: "
 			  << "Record looks invalid, discarding " << std::endl;
+		// nothing to store, do not get the message redelivered
+		return true;
 	}
 
 	if (ret) {
@@ -122,14 +131,22 @@ void LiveobjectsMqttSubscriber::processArchive(const std::string_view& topicName
 
 		msg->cacheValues(station);
 
+		IngestionTrace::markCurrent(IngestionTrace::Stage::STORED);
 		if (_jobPublisher)
 			_jobPublisher->publishJobsForPastDataInsertion(station, timestamp, timestamp);
+
+#ifdef EVENT_MANAGER_ON
+		publish(NewDatapointEvent{station, date::floor<chrono::seconds>(chrono::system_clock::now()), timestamp}, station);
+#endif
+		IngestionTrace::markCurrent(IngestionTrace::Stage::PUBLISHED);
 	} else {
 		std::cerr << SD_ERR << "[MQTT Liveobjects " << station << "] measurement: "
 			  << "Failed to store archive for MQTT station " << stationName << "! Aborting" << std::endl;
 		// will retry...
-		return;
+		return false;
 	}
+
+	return true;
 }
 
 void LiveobjectsMqttSubscriber::addStation(const std::string& topic, const CassUuid& station,
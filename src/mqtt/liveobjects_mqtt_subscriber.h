@@ -30,9 +30,9 @@
 
 #include <boost/asio/io_context.hpp>
 #include <cassandra.h>
-#include <cassobs/dbconnection_observations.h>
 #include <mqtt_client_cpp.hpp>
 
+#include "storage/observations_storage.h"
 #include "async_job_publisher.h"
 #include "mqtt_subscriber.h"
 #include "pessl/lorain_message.h"
@@ -44,7 +44,7 @@ class LiveobjectsMqttSubscriber : public MqttSubscriber
 {
 public:
 	LiveobjectsMqttSubscriber(const MqttSubscriptionDetails& details, asio::io_context& ioContext,
-		DbConnectionObservations& db,
+		ObservationsStorage& db,
 		const std::shared_ptr<AsyncJobPublisher>& jobPublisher = nullptr);
 	void addStation(const std::string& topic, const CassUuid& station, TimeOffseter::PredefinedTimezone tz,
 		const std::string& streamId);
@@ -52,7 +52,7 @@ public:
 protected:
 	bool handleConnAck(bool res, mqtt::connect_return_code) override;
 	bool handleSubAck(packet_id_t packetId, std::vector<mqtt::suback_return_code> results) override;
-	void processArchive(const std::string_view& topicName, const std::string_view& content) override;
+	bool processArchive(const std::string_view& topicName, const std::string_view& content) override;
 
 	const char* getConnectorSuffix() override
 	{
@@ -32,7 +32,6 @@
 #include <map>
 
 #include <cassandra.h>
-#include <cassobs/dbconnection_observations.h>
 #include <date/date.h>
 #include <boost/json/src.hpp>
 #include <boost/program_options.hpp>
@@ -41,6 +40,7 @@
 
 #include "cassandra_utils.h"
 #include "liveobjects/liveobjects_message.h"
+#include "storage/observations_storage.h"
 #include "config.h"
 
 /**
@@ -71,6 +71,7 @@ int main(int argc, char** argv)
 	std::string pguser;
 	std::string pgpassword;
 	std::string pgaddress;
+	StorageConfiguration storageConfig;
 	std::string namedStation;
 	std::string file;
 	float baseValue;
@@ -83,6 +84,9 @@ int main(int argc, char** argv)
 		("pguser", po::value<std::string>(&pguser), "PostgreSQL database username")
 		("pgpassword", po::value<std::string>(&pgpassword), "PostgreSQL database password")
 		("pghost", po::value<std::string>(&pgaddress), "PostgreSQL database IP address or domain name")
+		("storage", po::value<std::string>(&storageConfig.backend), "storage backend, 'cassandra' (Cassandra and PostgreSQL databases) or 'memory' (in-process stand-in keeping everything in memory, for benchmarks), defaults to 'cassandra'")
+		("station-table", po::value<std::string>(&storageConfig.stationTable), "with the 'memory' storage, file listing the stations and connectors to serve")
+		("storage-latency", po::value<unsigned long>(&storageConfig.latency), "with the 'memory' storage, delay in microseconds added to each call, defaults to 0")
 	;
 
 	po::options_description desc("Allowed options");
@@ -150,7 +154,9 @@ int main(int argc, char** argv)
 	};
 	cass_log_set_callback(logCallback, nullptr);
 
-	DbConnectionObservations db{address, user, password, pgaddress, pguser, pgpassword};
+	std::unique_ptr<ObservationsStorage> storage = ObservationsStorage::create(storageConfig,
+		address, user, password, pgaddress, pguser, pgpassword);
+	ObservationsStorage& db = *storage;
 
 	std::vector<std::tuple<CassUuid, std::string, int, std::string, std::unique_ptr<char[]>, size_t, std::string, int>> mqttStations;
 	db.getMqttStations(mqttStations);
@@ -29,22 +29,27 @@
 #include <thread>
 #include <mutex>
 #include <cmath>
+#include <random>
 #include <system_error>
 #include <systemd/sd-daemon.h>
 
 #include <cassandra.h>
 #include <boost/asio/basic_waitable_timer.hpp>
-#include <cassobs/dbconnection_observations.h>
+#include <boost/asio/post.hpp>
 #include <mqtt_client_cpp.hpp>
 #include <utility>
 
+#include "storage/observations_storage.h"
 #include "time_offseter.h"
 #include "cassandra_utils.h"
 #include "async_job_publisher.h"
 #include "connector.h"
 #include "mqtt/mqtt_subscriber.h"
-
-#define DEFAULT_VERIFY_PATH "/etc/ssl/certs"
+#include "mqtt/shared_ca_store.h"
+#include "monitoring/metrics.h"
+#include "monitoring/loop_lag_monitor.h"
+#include "monitoring/db_profiler.h"
+#include "capture/traffic_capture.h"
 
 namespace asio = boost::asio;
 namespace chrono = std::chrono;
@@ -56,7 +61,7 @@ namespace meteodata
 using namespace date;
 
 MqttSubscriber::MqttSubscriber(const MqttSubscriber::MqttSubscriptionDetails& details,
-	asio::io_context& ioContext, DbConnectionObservations& db,
+	asio::io_context& ioContext, ObservationsStorage& db,
 	const std::shared_ptr<AsyncJobPublisher>& jobPublisher) :
 		Connector{ioContext, db},
 		_stopped{true},
@@ -69,6 +74,11 @@ MqttSubscriber::MqttSubscriber(const MqttSubscriber::MqttSubscriptionDetails& de
 	_status.activeSince = date::floor<chrono::seconds>(chrono::system_clock::now());
 }
 
+MqttSubscriber::~MqttSubscriber()
+{
+	stopIngestion();
+}
+
 bool operator<(const MqttSubscriber::MqttSubscriptionDetails& s1, const MqttSubscriber::MqttSubscriptionDetails& s2)
 {
 	if (s1.host < s2.host) {
@@ -94,6 +104,9 @@ bool operator==(const MqttSubscriber::MqttSubscriptionDetails& s1, const MqttSub
 
 void MqttSubscriber::addStation(const std::string& topic, const CassUuid& station, TimeOffseter::PredefinedTimezone tz)
 {
+	if (!ownsStation(station))
+		return;
+
 	std::string stationName;
 	int pollingPeriod;
 	time_t lastArchiveDownloadTime;
@@ -158,7 +171,7 @@ void MqttSubscriber::handleClose()
 
 	// wait a little and restart
 	auto self{shared_from_this()};
-	_timer.expires_from_now(chrono::seconds(10));
+	_timer.expires_from_now(getReconnectionDelay());
 	_timer.async_wait([this, self] (const std::error_code& e) { checkRetryStartDeadline(e); });
 }
 
@@ -169,10 +182,22 @@ void MqttSubscriber::handleError(std::error_code const&)
 
 	// wait a little and restart with exponential backoff
 	auto self{shared_from_this()};
-	_timer.expires_from_now(chrono::seconds(10 + static_cast<long>(std::pow(2, std::min(_retries, MAX_RETRIES_EXPONENTIAL_BACKOFF)))));
+	_timer.expires_from_now(getReconnectionDelay());
 	_timer.async_wait([this, self] (const std::error_code& e) { checkRetryStartDeadline(e); });
 }
 
+chrono::milliseconds MqttSubscriber::getReconnectionDelay()
+{
+	// Full jitter: when the broker restarts, all the subscribers get
+	// disconnected at once, spread their reconnections over the whole
+	// backoff window instead of having them all handshake at the same time
+	chrono::milliseconds window = chrono::seconds(10 + static_cast<long>(std::pow(2, std::min(_retries, MAX_RETRIES_EXPONENTIAL_BACKOFF))));
+	std::uniform_int_distribution<chrono::milliseconds::rep> distribution{
+		MIN_RECONNECTION_DELAY.count(), window.count()
+	};
+	return chrono::milliseconds{distribution(_randomGenerator)};
+}
+
 bool MqttSubscriber::handlePubAck(packet_id_t)
 {
 	return true;
@@ -193,27 +218,160 @@ bool MqttSubscriber::handleSubAck(packet_id_t, std::vector<mqtt::suback_return_c
 	return true;
 }
 
-bool MqttSubscriber::handlePublish(std::optional<packet_id_t>, mqtt::publish_options,
+bool MqttSubscriber::handlePublish(std::optional<packet_id_t> packetId, mqtt::publish_options,
 	std::string_view topic, std::string_view contents)
 {
-	processArchive(topic, contents);
+	std::lock_guard<std::mutex> lock{_ingestionMutex};
+	if (_ingestionQueue.size() >= MAX_PENDING_MESSAGES) {
+		// Leave the message unacknowledged, the broker will deliver it
+		// again once the backlog is cleared
+		if (!_redeliveryNeeded)
+			std::cerr << SD_WARNING << "[MQTT] protocol: " << "Ingestion queue full for " << _details.host
+				  << ", leaving messages to the broker" << std::endl;
+		_redeliveryNeeded = true;
+		return true;
+	}
+
+	TrafficCapture::instance().record(CapturedMessage::Type::MQTT, topic, contents);
+	_ingestionQueue.push_back(PendingMessage{_client, packetId, std::string{topic}, std::string{contents}, chrono::steady_clock::now()});
+	_metrics.received->increment();
+	_metrics.queued->add(1);
+	_ingestionCondition.notify_one();
 	return true;
 }
 
+void MqttSubscriber::ingest()
+{
+	// the messages decoded here look up the database cache on their own
+	DbProfiler::CallerScope callerScope{getConnectorSuffix()};
+
+	std::unique_lock<std::mutex> lock{_ingestionMutex};
+	for (;;) {
+		_ingestionCondition.wait(lock, [this]() { return _ingestionStopped || !_ingestionQueue.empty(); });
+		if (_ingestionStopped)
+			return;
+
+		PendingMessage message = std::move(_ingestionQueue.front());
+		_ingestionQueue.pop_front();
+		_metrics.queued->add(-1);
+		lock.unlock();
+
+		bool acknowledge;
+		try {
+			Histogram::ScopedTimer timer{*_metrics.ingestionDuration};
+			IngestionTrace trace{*_tracePath, message.received};
+			trace.mark(IngestionTrace::Stage::RECEIVED);
+			acknowledge = processArchive(message.topic, message.content);
+		} catch (const std::exception& e) {
+			_metrics.failed->increment();
+			std::cerr << SD_ERR << "[MQTT] protocol: " << "Failed to process a message on topic " << message.topic
+				  << ", discarding it: " << e.what() << std::endl;
+			// a message we cannot parse will not get any better by being
+			// delivered again
+			acknowledge = true;
+		}
+
+		// Only QoS 1 messages carry a packet id, we never subscribe with
+		// a higher QoS
+		if (acknowledge && message.packetId) {
+			asio::post(_ioContext, [client = std::move(message.client), packetId = *message.packetId]() {
+				client->async_puback(packetId);
+			});
+		}
+
+		lock.lock();
+		if (!acknowledge)
+			_redeliveryNeeded = true;
+
+		if (_ingestionQueue.empty() && _redeliveryNeeded) {
+			_redeliveryNeeded = false;
+			// Reconnect, the broker redelivers the messages left
+			// unacknowledged since we do not clean the session.
+			// Do not take a reference to the subscriber here, this
+			// thread must never be the one destroying it, it would
+			// have to join itself.
+			asio::post(_ioContext, [this, weakSelf = weak_from_this()]() {
+				auto self = weakSelf.lock(); // we may have been destroyed
+				if (self && !_stopped) {
+					std::cerr << SD_NOTICE << "[MQTT] protocol: " << "Reconnecting to " << _details.host
+						  << " to get the messages not stored delivered again" << std::endl;
+					_client->disconnect();
+				}
+			});
+		}
+	}
+}
+
+void MqttSubscriber::startIngestion()
+{
+	if (_ingestionThread.joinable())
+		return;
+
+	_db.setCaller(getConnectorSuffix());
+	if (!_metrics.received) {
+		MetricsRegistry& registry = MetricsRegistry::instance();
+		MetricsRegistry::Labels labels{{"type", getConnectorSuffix()}};
+		_metrics.received = &registry.counter("meteodata_mqtt_messages_received_total",
+			"Number of messages received from the MQTT brokers", labels);
+		_metrics.failed = &registry.counter("meteodata_mqtt_messages_failed_total",
+			"Number of messages received from the MQTT brokers that could not be processed", labels);
+		_metrics.queued = &registry.gauge("meteodata_mqtt_ingestion_queue_length",
+			"Number of messages received from the MQTT brokers waiting to be processed", labels);
+		_metrics.ingestionDuration = &registry.histogram("meteodata_mqtt_ingestion_duration_seconds",
+			"Time taken to decode and store the messages received from the MQTT brokers", labels);
+		_tracePath.emplace(std::string{"mqtt_"} + getConnectorSuffix());
+	}
+
+	{
+		std::lock_guard<std::mutex> lock{_ingestionMutex};
+		_ingestionStopped = false;
+	}
+	_ingestionThread = std::thread{[this]() { ingest(); }};
+}
+
+void MqttSubscriber::stopIngestion()
+{
+	{
+		std::lock_guard<std::mutex> lock{_ingestionMutex};
+		_ingestionStopped = true;
+		// the messages left are not acknowledged, they will be
+		// delivered again
+		if (_metrics.queued)
+			_metrics.queued->add(-static_cast<std::int64_t>(_ingestionQueue.size()));
+		_ingestionQueue.clear();
+	}
+	_ingestionCondition.notify_all();
+	if (_ingestionThread.joinable()) {
+		// ingest() holds no reference to the subscriber so this
+		// should not happen but a thread joining itself would
+		// terminate the process
+		if (_ingestionThread.get_id() == std::this_thread::get_id())
+			_ingestionThread.detach();
+		else
+			_ingestionThread.join();
+	}
+}
+
 void MqttSubscriber::start()
 {
 	_stopped = false;
+	startIngestion();
 
+	LoopLagMonitor::Activity activity{"connection to the MQTT broker for", getConnectorSuffix()};
 	std::cout << SD_DEBUG << "[MQTT] protocol: " << "About to start the MQTT client  " << std::endl;
 	_client = mqtt::make_tls_client(_ioContext, _details.host, _details.port);
 
 	std::ostringstream clientId;
 	clientId << MqttSubscriber::CLIENT_ID << "-" << std::this_thread::get_id() << ":" << getConnectorSuffix();
+	// the instances sharing the stations may connect to the same broker
+	if (getShard().getCount() > 1)
+		clientId << "-shard" << getShard().getId();
 	_client->set_client_id(clientId.str());
 	_client->set_user_name(_details.user);
 	_client->set_password(_details.password);
 	_client->set_clean_session(false); /* this way, we can catch up on missed packets upon reconnection */
-	_client->get_ssl_context().add_verify_path(DEFAULT_VERIFY_PATH);
+	_client->set_auto_pub_response(false); /* messages are acknowledged once stored, in ingest() */
+	SharedCaStore::applyTo(_client->get_ssl_context());
 	_client->set_keep_alive_sec(60);
 	std::cout << SD_DEBUG << "[MQTT] protocol: " << "Created the client" << std::endl;
 
@@ -278,6 +436,7 @@ void MqttSubscriber::stop()
 	_stopped = true;
 	_timer.cancel();
 	_client->disconnect();
+	stopIngestion();
 }
 
 void MqttSubscriber::reload()
@@ -31,8 +31,14 @@
 #include <map>
 #include <functional>
 #include <optional>
+#include <random>
 #include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
 #include <system_error>
+#include <thread>
 #include <unistd.h>
 
 #include <boost/system/error_code.hpp>
@@ -40,13 +46,15 @@
 #include <cassandra.h>
 #include <date/date.h>
 #include <date/tz.h>
-#include <cassobs/dbconnection_observations.h>
 #include <mqtt_client_cpp.hpp>
 
+#include "storage/observations_storage.h"
 #include "async_job_publisher.h"
 #include "time_offseter.h"
 #include "connector.h"
 #include "davis/vantagepro2_archive_page.h"
+#include "monitoring/metrics.h"
+#include "monitoring/ingestion_trace.h"
 
 namespace meteodata
 {
@@ -67,9 +75,10 @@ public:
 	};
 
 	MqttSubscriber(const MqttSubscriptionDetails& details, asio::io_context& ioContext,
-		DbConnectionObservations& db,
+		ObservationsStorage& db,
 		const std::shared_ptr<AsyncJobPublisher>& jobPublisher = nullptr);
 	void addStation(const std::string& topic, const CassUuid& station, TimeOffseter::PredefinedTimezone tz);
+	~MqttSubscriber() override;
 	void start() override;
 	void stop() override;
 	void reload() override;
@@ -100,6 +109,16 @@ protected:
 
 	static constexpr int MAX_RETRIES_EXPONENTIAL_BACKOFF = 8;
 
+	/**
+	 * @brief The minimum time to wait before reconnecting
+	 */
+	static constexpr std::chrono::milliseconds MIN_RECONNECTION_DELAY{500};
+
+	/**
+	 * @brief The random generator used to spread the reconnections
+	 */
+	std::mt19937 _randomGenerator{std::random_device{}()};
+
 	/**
 	 * @brief The number of times we have tried to restart
 	 */
@@ -111,11 +130,124 @@ protected:
 	 */
 	asio::basic_waitable_timer<std::chrono::steady_clock> _timer;
 
+	/**
+	 * @brief A message received from the broker, waiting to be decoded
+	 * and stored
+	 */
+	struct PendingMessage
+	{
+		/**
+		 * @brief The client the message has been received from, the
+		 * acknowledgement must be sent through it
+		 */
+		decltype(_client) client;
+		/**
+		 * @brief The packet id to acknowledge, empty for QoS 0 messages
+		 */
+		std::optional<packet_id_t> packetId;
+		std::string topic;
+		std::string content;
+		/**
+		 * @brief When the message has been received, to trace its
+		 * time in the queue
+		 */
+		std::chrono::steady_clock::time_point received;
+	};
+
+	/**
+	 * @brief The messages received and not yet stored, nor acknowledged
+	 *
+	 * The queue is filled by the publish handler in the I/O thread and
+	 * drained by the ingestion thread, so that a slow database does not
+	 * stall the MQTT session (keepalives, etc.).
+	 */
+	std::deque<PendingMessage> _ingestionQueue;
+
+	/**
+	 * @brief The mutex protecting the ingestion queue and the flags below
+	 */
+	std::mutex _ingestionMutex;
+
+	/**
+	 * @brief The condition variable used to wake up the ingestion thread
+	 */
+	std::condition_variable _ingestionCondition;
+
+	/**
+	 * @brief Whether the ingestion thread must exit
+	 */
+	bool _ingestionStopped = false;
+
+	/**
+	 * @brief Whether some messages have been left unacknowledged and must
+	 * be redelivered by the broker
+	 */
+	bool _redeliveryNeeded = false;
+
+	/**
+	 * @brief The thread decoding and storing the messages
+	 */
+	std::thread _ingestionThread;
+
+	/**
+	 * @brief The metrics of the subscriber, shared by all the subscribers
+	 * of the same type, set up before the ingestion thread first starts
+	 */
+	struct
+	{
+		Counter* received = nullptr;
+		Counter* failed = nullptr;
+		Gauge* queued = nullptr;
+		Histogram* ingestionDuration = nullptr;
+	} _metrics;
+
+	/**
+	 * @brief The histograms of the stages of the ingestion of the
+	 * messages, set up with the metrics
+	 */
+	std::optional<IngestionTrace::Path> _tracePath;
+
+	/**
+	 * @brief The maximum number of messages waiting to be ingested
+	 *
+	 * Messages are acknowledged only once stored so the broker stops
+	 * sending new ones when its window of in-flight messages is full and
+	 * holds the backlog. This bound is only a safety net in case the
+	 * broker window is larger.
+	 */
+	static constexpr std::size_t MAX_PENDING_MESSAGES = 256;
+
 	static constexpr char CLIENT_ID[] = "meteodata";
-	virtual void processArchive(const std::string_view& topicName, const std::string_view& content) = 0;
+
+	/**
+	 * @brief Decode and store a message received from the broker
+	 *
+	 * This is called from the ingestion thread, not the I/O thread.
+	 *
+	 * @param topicName The topic the message has been published to
+	 * @param content The payload
+	 * @return True if the message can be acknowledged (because it has been
+	 * stored or because it will never be), false if it must be delivered
+	 * again later
+	 */
+	virtual bool processArchive(const std::string_view& topicName, const std::string_view& content) = 0;
+	void ingest();
+	void startIngestion();
+	void stopIngestion();
 	virtual const char* getConnectorSuffix() = 0;
 	void checkRetryStartDeadline(const std::error_code& e);
 
+	/**
+	 * @brief Pick the time to wait before the next connection attempt
+	 *
+	 * The delay is drawn uniformly between MIN_RECONNECTION_DELAY and an
+	 * upper bound growing exponentially with the number of failed
+	 * attempts.
+	 *
+	 * @return The delay
+	 */
+	std::chrono::milliseconds getReconnectionDelay();
+
 	virtual bool handleConnAck(bool sp, mqtt::connect_return_code ret);
 	virtual void handleClose();
 	virtual void handleError(std::error_code const& ec);
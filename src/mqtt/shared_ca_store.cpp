@@ -0,0 +1,83 @@
+/**
+ * @file shared_ca_store.cpp
+ * @brief Implementation of the SharedCaStore class
+ * @author Laurent Georget
+ * @date 2026-10-18
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <stdexcept>
+#include <systemd/sd-daemon.h>
+
+#include <boost/asio/ssl.hpp>
+#include <openssl/ssl.h>
+#include <openssl/x509.h>
+#include <openssl/x509_vfy.h>
+
+#include "mqtt/shared_ca_store.h"
+
+namespace meteodata
+{
+
+constexpr char SharedCaStore::DEFAULT_CA_BUNDLE[];
+constexpr char SharedCaStore::DEFAULT_VERIFY_PATH[];
+
+SharedCaStore::SharedCaStore() :
+	_store{X509_STORE_new()}
+{
+	if (!_store)
+		throw std::runtime_error("Cannot allocate the CA store");
+
+	// The bundle is parsed once and for all, the directory is only a
+	// fallback since its certificates are looked up at each handshake
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+	bool loaded = X509_STORE_load_file(_store, DEFAULT_CA_BUNDLE) == 1;
+	if (!loaded)
+		loaded = X509_STORE_load_path(_store, DEFAULT_VERIFY_PATH) == 1;
+#else
+	bool loaded = X509_STORE_load_locations(_store, DEFAULT_CA_BUNDLE, nullptr) == 1;
+	if (!loaded)
+		loaded = X509_STORE_load_locations(_store, nullptr, DEFAULT_VERIFY_PATH) == 1;
+#endif
+
+	if (!loaded)
+		std::cerr << SD_ERR << "[TLS] management: " << "Cannot load the trusted certificate authorities from "
+			  << DEFAULT_CA_BUNDLE << " or " << DEFAULT_VERIFY_PATH << std::endl;
+}
+
+SharedCaStore::~SharedCaStore()
+{
+	X509_STORE_free(_store);
+}
+
+SharedCaStore& SharedCaStore::getInstance()
+{
+	static SharedCaStore instance;
+	return instance;
+}
+
+void SharedCaStore::applyTo(asio::ssl::context& context)
+{
+	X509_STORE* store = getInstance()._store;
+	// SSL_CTX_set_cert_store takes over one reference to the store
+	X509_STORE_up_ref(store);
+	SSL_CTX_set_cert_store(context.native_handle(), store);
+}
+
+}
@@ -0,0 +1,83 @@
+/**
+ * @file shared_ca_store.h
+ * @brief Definition of the SharedCaStore class
+ * @author Laurent Georget
+ * @date 2026-10-18
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SHARED_CA_STORE_H
+#define SHARED_CA_STORE_H
+
+#include <boost/asio/ssl.hpp>
+#include <openssl/x509.h>
+
+namespace meteodata
+{
+
+namespace asio = boost::asio;
+
+/**
+ * @brief The store of trusted certificate authorities shared by all the TLS
+ * clients of the process
+ *
+ * Each MQTT client gets its own SSL context, built anew at each
+ * reconnection. Rather than having each of them load the system CA directory,
+ * the certificates are loaded once in a single OpenSSL store and all the
+ * contexts point to it.
+ */
+class SharedCaStore
+{
+public:
+	SharedCaStore(const SharedCaStore&) = delete;
+	SharedCaStore& operator=(const SharedCaStore&) = delete;
+
+	/**
+	 * @brief Make a SSL context trust the shared CA store
+	 *
+	 * @param context The context, typically one freshly created by a
+	 * client, whose current store is replaced
+	 */
+	static void applyTo(asio::ssl::context& context);
+
+	/**
+	 * @brief The CA bundle loaded if available
+	 */
+	static constexpr char DEFAULT_CA_BUNDLE[] = "/etc/ssl/certs/ca-certificates.crt";
+
+	/**
+	 * @brief The CA directory searched if the bundle is not available
+	 */
+	static constexpr char DEFAULT_VERIFY_PATH[] = "/etc/ssl/certs";
+
+private:
+	SharedCaStore();
+	~SharedCaStore();
+
+	static SharedCaStore& getInstance();
+
+	/**
+	 * @brief The OpenSSL store, reference-counted, shared by all the
+	 * contexts
+	 */
+	X509_STORE* _store;
+};
+
+}
+
+#endif /* SHARED_CA_STORE_H */
@@ -28,16 +28,26 @@
 #include <map>
 #include <chrono>
 #include <mutex>
+#include <algorithm>
+#include <cstring>
+#include <vector>
 #include <systemd/sd-daemon.h>
 
 #include <cassandra.h>
-#include <cassobs/dbconnection_observations.h>
+#include <boost/asio/post.hpp>
 #include <mqtt_client_cpp.hpp>
 
+#include "storage/observations_storage.h"
 #include "../time_offseter.h"
 #include "../cassandra_utils.h"
 #include "mqtt_subscriber.h"
 #include "vp2_mqtt_subscriber.h"
+#include "davis/vantagepro2_message.h"
+#include "monitoring/ingestion_trace.h"
+
+#ifdef EVENT_MANAGER_ON
+#include "event/new_datapoint_event.h"
+#endif
 
 namespace chrono = std::chrono;
 
@@ -47,7 +57,7 @@ namespace meteodata
 using namespace date;
 
 VP2MqttSubscriber::VP2MqttSubscriber(const MqttSubscriber::MqttSubscriptionDetails& details,
-		asio::io_context& ioContext, DbConnectionObservations& db, std::shared_ptr<AsyncJobPublisher> jobPublisher) :
+		asio::io_context& ioContext, ObservationsStorage& db, std::shared_ptr<AsyncJobPublisher> jobPublisher) :
 	MqttSubscriber{details, ioContext, db, jobPublisher}
 {
 }
@@ -101,60 +111,97 @@ bool VP2MqttSubscriber::handleSubAck(packet_id_t packetId, std::vector<mqtt::sub
 	return false;
 }
 
-void VP2MqttSubscriber::processArchive(const std::string_view& topicName, const std::string_view& content)
+bool VP2MqttSubscriber::processArchive(const std::string_view& topicName, const std::string_view& content)
 {
 	std::lock_guard<std::mutex> lock{_stationsMutex};
 	auto stationIt = _stations.find(topicName);
 	if (stationIt == _stations.end()) {
 		std::cout << SD_NOTICE << "[MQTT protocol]: " << "Unknown topic " << topicName << std::endl;
-		return;
+		return true;
 	}
 
 	const CassUuid& station = std::get<0>(stationIt->second);
+	IngestionTrace::setCurrentStation(station);
 	const std::string& stationName = std::get<1>(stationIt->second);
 	const TimeOffseter& timeOffseter = std::get<4>(stationIt->second);
 	std::cout << SD_DEBUG << "[MQTT " << station << "] measurement: " << "Now receiving for MQTT station "
 		<< stationName << std::endl;
 
-	std::size_t expectedSize = sizeof(VantagePro2ArchiveMessage::ArchiveDataPoint);
+	constexpr std::size_t recordSize = sizeof(VantagePro2ArchiveMessage::ArchiveDataPoint);
 	std::size_t receivedSize = content.size();
-	if (receivedSize != expectedSize) {
+	std::size_t recordsCount;
+	if (receivedSize == recordSize) {
+		// a single record, as sent by the older gateways
+		recordsCount = 1;
+	} else if (receivedSize > CRC_SIZE && (receivedSize - CRC_SIZE) % recordSize == 0) {
+		// a batch of records, followed by the CRC
+		if (!VantagePro2Message::validateCRC(content.data(), receivedSize)) {
+			std::cerr << SD_WARNING << "[MQTT " << station << "] protocol: " << "input from broker has an invalid CRC, "
+				<< "discarding the batch" << std::endl;
+			return true;
+		}
+		recordsCount = (receivedSize - CRC_SIZE) / recordSize;
+	} else {
 		std::cerr << SD_WARNING << "[MQTT " << station << "] protocol: " << "input from broker has an invalid size "
-			<< "(" << receivedSize << " bytes instead of " << expectedSize << ")" << std::endl;
-		return;
+			<< "(" << receivedSize << " bytes instead of " << recordSize << " or a multiple of " << recordSize
+			<< " plus " << CRC_SIZE << ")" << std::endl;
+		return true;
 	}
 
-	VantagePro2ArchiveMessage::ArchiveDataPoint data;
-	std::memcpy(&data, content.data(), sizeof(data));
-	VantagePro2ArchiveMessage msg{data, &timeOffseter};
-	int ret = false;
-	if (msg.looksValid()) {
-		Observation o = msg.getObservation(station);
-		ret = _db.insertV2DataPoint(o) && _db.insertV2DataPointInTimescaleDB(o);
-	} else {
-		std::cerr << SD_WARNING << "[MQTT " << station << "] measurement: "
-			<< "Record looks invalid, discarding... (for information, timestamp says " << msg.getTimestamp()
-			<< " and system clock says " << chrono::system_clock::now() << ")" << std::endl;
+	std::vector<Observation> allObs;
+	allObs.reserve(recordsCount);
+	date::sys_seconds oldest = date::floor<chrono::seconds>(chrono::system_clock::now());
+	date::sys_seconds newest{};
+	for (std::size_t i = 0 ; i < recordsCount ; i++) {
+		VantagePro2ArchiveMessage::ArchiveDataPoint data;
+		std::memcpy(&data, content.data() + i * recordSize, recordSize);
+		VantagePro2ArchiveMessage msg{data, &timeOffseter};
+		if (msg.looksValid()) {
+			auto timestamp = msg.getTimestamp();
+			oldest = std::min(oldest, timestamp);
+			newest = std::max(newest, timestamp);
+			allObs.push_back(msg.getObservation(station));
+		} else {
+			std::cerr << SD_WARNING << "[MQTT " << station << "] measurement: "
+				<< "Record looks invalid, discarding... (for information, timestamp says " << msg.getTimestamp()
+				<< " and system clock says " << chrono::system_clock::now() << ")" << std::endl;
+		}
+	}
+
+	if (allObs.empty()) {
+		// nothing to store, do not get the message redelivered
+		return true;
 	}
 
+	IngestionTrace::markCurrent(IngestionTrace::Stage::DECODED);
+	bool ret = true;
+	for (const Observation& o : allObs)
+		ret = _db.insertV2DataPoint(o) && ret;
+	ret = ret && _db.insertV2DataPointsInTimescaleDB(allObs.begin(), allObs.end());
+
 	if (ret) {
 		std::cout << SD_INFO << "[MQTT " << station << "] measurement: "
-				  << "Archive data stored for datetime " << msg.getTimestamp()
+				  << "Archive data stored for " << allObs.size() << " datetime(s) up to " << newest
 				  << std::endl;
-		auto timestamp = msg.getTimestamp();
-		time_t lastArchiveDownloadTime = timestamp.time_since_epoch().count();
+		time_t lastArchiveDownloadTime = newest.time_since_epoch().count();
 		ret = _db.updateLastArchiveDownloadTime(station, lastArchiveDownloadTime);
 		if (!ret)
 			std::cerr << SD_ERR << "[MQTT " << station << "] management: "
 				<< "Couldn't update last archive download time" << std::endl;
 
+		IngestionTrace::markCurrent(IngestionTrace::Stage::STORED);
 		if (_jobPublisher)
-			_jobPublisher->publishJobsForPastDataInsertion(station, timestamp, timestamp);
+			_jobPublisher->publishJobsForPastDataInsertion(station, oldest, newest);
+
+#ifdef EVENT_MANAGER_ON
+		publish(NewDatapointEvent{station, date::floor<chrono::seconds>(chrono::system_clock::now()), oldest}, station);
+#endif
+		IngestionTrace::markCurrent(IngestionTrace::Stage::PUBLISHED);
 	} else {
 		std::cerr << SD_ERR << "[MQTT " << station << "] measurement: " << "Failed to store archive for MQTT station "
 			<< stationName << "! Aborting" << std::endl;
 		// will retry...
-		return;
+		return false;
 	}
 
 	// about four times a day, set the clock (it seems very frequent, but it doesn't matter)
@@ -167,6 +214,7 @@ void VP2MqttSubscriber::processArchive(const std::string_view& topicName, const
 		}
 	}
 
+	return true;
 }
 
 void VP2MqttSubscriber::setClock(const std::string& topic, const CassUuid& station, const TimeOffseter& timeOffseter)
@@ -176,16 +224,25 @@ void VP2MqttSubscriber::setClock(const std::string& topic, const CassUuid& stati
 
 	std::cerr << SD_INFO << "[MQTT " << station << "] protocol: "
 			  << "Setting the station clock to the Raspberry Pi current time" << std::endl;
+	std::string command;
 	if (timeOffseter.usesUTC()) {
 		// Force the datetime sent, in case the vp2-interface has a local timezone
 		// but the console is forced to use UTC
 		std::ostringstream os;
 		os << "SETTIME " << date::format("%Y-%m-%d %H:%M:%S", now);
-		_client->publish(topic, os.str(), mqtt::qos::at_least_once);
+		command = os.str();
 	} else {
 		// Trust the vp2-interface to have the same timezone as the station
-		_client->publish(topic, "SETTIME", mqtt::qos::at_least_once);
+		command = "SETTIME";
 	}
+	// We may be in the ingestion thread here, the client must only be used
+	// from the I/O thread
+	auto self = weak_from_this().lock();
+	if (!self)
+		return;
+	asio::post(_ioContext, [this, self, topic, command = std::move(command)]() {
+		_client->publish(topic, command, mqtt::qos::at_least_once);
+	});
 	_clockResetTimes[topic] = now;
 }
 
@@ -39,9 +39,9 @@
 #include <cassandra.h>
 #include <date/date.h>
 #include <date/tz.h>
-#include <cassobs/dbconnection_observations.h>
 #include <mqtt_client_cpp.hpp>
 
+#include "storage/observations_storage.h"
 #include "time_offseter.h"
 #include "async_job_publisher.h"
 #include "mqtt/mqtt_subscriber.h"
@@ -53,21 +53,32 @@ namespace meteodata
 using namespace meteodata;
 
 /**
+ * @brief Subscriber to the archives uploaded by the VP2 gateways
+ *
+ * On the dmpaft topics, each message is either a single 52-byte archive
+ * record, or a batch of consecutive archive records followed by their CRC,
+ * computed like the CRC ending the archive pages sent by the station itself
+ * (CRC-CCITT, big-endian). Catching up after a disconnection thus takes a
+ * few messages instead of one per record.
  */
 class VP2MqttSubscriber : public MqttSubscriber
 {
 public:
 	VP2MqttSubscriber(const MqttSubscriptionDetails& details, asio::io_context& ioContext,
-		DbConnectionObservations& db, const std::shared_ptr<AsyncJobPublisher> jobPublisher = nullptr);
+		ObservationsStorage& db, const std::shared_ptr<AsyncJobPublisher> jobPublisher = nullptr);
 
 private:
 	static constexpr char ARCHIVES_TOPIC[] = "/dmpaft";
+	/**
+	 * @brief The size of the CRC ending a batch of archive records
+	 */
+	static constexpr std::size_t CRC_SIZE = 2;
 	std::map<std::string, date::sys_seconds, std::less<>> _clockResetTimes;
 	void setClock(const std::string& topic, const CassUuid& station, const TimeOffseter& timeOffseter);
 
 protected:
 	bool handleSubAck(packet_id_t packetId, std::vector<mqtt::suback_return_code> results) override;
-	void processArchive(const std::string_view& topicName, const std::string_view& content) override;
+	bool processArchive(const std::string_view& topicName, const std::string_view& content) override;
 
 	const char* getConnectorSuffix() override
 	{ return "vp2"; }
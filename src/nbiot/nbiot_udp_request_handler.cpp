@@ -24,7 +24,6 @@
 #include <boost/asio.hpp>
 #include <systemd/sd-daemon.h>
 #include <date/date.h>
-#include <cassobs/dbconnection_observations.h>
 
 #include <sstream>
 #include <vector>
@@ -32,6 +31,7 @@
 #include <regex>
 #include <string>
 
+#include "storage/observations_storage.h"
 #include "cassandra_utils.h"
 #include "udp_connection.h"
 #include "async_job_publisher.h"
@@ -40,10 +40,11 @@
 #include "nbiot/nbiot_udp_request_handler.h"
 #include "hex_parser.h"
 #include "http_utils.h"
+#include "monitoring/ingestion_trace.h"
 
 namespace meteodata
 {
-NbiotUdpRequestHandler::NbiotUdpRequestHandler(DbConnectionObservations& db, AsyncJobPublisher* jobPublisher) :
+NbiotUdpRequestHandler::NbiotUdpRequestHandler(ObservationsStorage& db, AsyncJobPublisher* jobPublisher) :
 		_db{db},
 		_jobPublisher{jobPublisher}
 {
@@ -94,6 +95,7 @@ void NbiotUdpRequestHandler::processHexifiedRequest(const std::string& body, std
 	if (it != _infosByStation.end()) {
 		const NbiotStation& st = it->second;
 		const CassUuid& uuid = st.station;
+		IngestionTrace::setCurrentStation(uuid);
 
 		bool ret = _db.insertCollection(uuid, chrono::system_clock::to_time_t(chrono::system_clock::now()), "nbiot", body);
 		if (ret) {
@@ -150,6 +152,8 @@ void NbiotUdpRequestHandler::processHexifiedRequest(const std::string& body, std
 			allObs = msg.getObservations(uuid);
 		}
 
+		IngestionTrace::markCurrent(IngestionTrace::Stage::DECODED);
+
 		date::sys_seconds oldest = date::floor<chrono::seconds>(chrono::system_clock::now());
 		date::sys_seconds newest = date::sys_seconds{};
 
@@ -180,10 +184,12 @@ void NbiotUdpRequestHandler::processHexifiedRequest(const std::string& body, std
 				  << name << std::endl;
 		}
 
+		IngestionTrace::markCurrent(IngestionTrace::Stage::STORED);
 
 		if (oldest < newest && _jobPublisher) {
 			_jobPublisher->publishJobsForPastDataInsertion(uuid, oldest, newest);
 		}
+		IngestionTrace::markCurrent(IngestionTrace::Stage::PUBLISHED);
 	}
 }
 
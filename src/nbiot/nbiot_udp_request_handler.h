@@ -26,7 +26,6 @@
 #include <boost/asio.hpp>
 #include <systemd/sd-daemon.h>
 #include <date/date.h>
-#include <cassobs/dbconnection_observations.h>
 
 #include <functional>
 #include <map>
@@ -34,7 +33,9 @@
 #include <tuple>
 #include <regex>
 
+#include "storage/observations_storage.h"
 #include "async_job_publisher.h"
+#include "monitoring/profiled_db_connection.h"
 
 namespace meteodata
 {
@@ -42,7 +43,7 @@ namespace meteodata
 class NbiotUdpRequestHandler
 {
 public:
-	explicit NbiotUdpRequestHandler(DbConnectionObservations& db, AsyncJobPublisher* jobPublisher = nullptr);
+	explicit NbiotUdpRequestHandler(ObservationsStorage& db, AsyncJobPublisher* jobPublisher = nullptr);
 	void processRequest(const std::string& body, std::function<void(const std::string&)>* sendResponse = nullptr);
 	void processHexifiedRequest(const std::string& body, std::function<void(const std::string&)>* sendResponse = nullptr);
 	void dumpHexifiedRequestAsCSV(const std::string& body);
@@ -58,7 +59,7 @@ public:
 
 
 private:
-	DbConnectionObservations& _db;
+	ProfiledDbConnection _db;
 
 	AsyncJobPublisher* _jobPublisher;
 
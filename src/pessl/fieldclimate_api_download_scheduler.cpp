@@ -28,11 +28,12 @@
 #include <utility>
 #include <memory>
 #include <mutex>
+#include <optional>
 
 #include <systemd/sd-daemon.h>
 #include <cassandra.h>
-#include <cassobs/dbconnection_observations.h>
 
+#include "storage/observations_storage.h"
 #include "time_offseter.h"
 #include "abstract_download_scheduler.h"
 #include "async_job_publisher.h"
@@ -47,22 +48,19 @@ namespace meteodata
 using namespace date;
 
 FieldClimateApiDownloadScheduler::FieldClimateApiDownloadScheduler(asio::io_context& ioContext,
-	DbConnectionObservations& db, std::string apiId, std::string apiSecret,
+	ObservationsStorage& db, std::string apiId, std::string apiSecret,
 	const std::shared_ptr<AsyncJobPublisher>& jobPublisher) :
-		AbstractDownloadScheduler{chrono::minutes{POLLING_PERIOD}, ioContext, db},
+		AbstractDownloadScheduler{chrono::minutes{POLLING_PERIOD}, ioContext, db, "fieldclimate"},
 		_apiId{std::move(apiId)},
 		_apiSecret{std::move(apiSecret)},
 		_jobPublisher{jobPublisher}
 {
 }
 
-void FieldClimateApiDownloadScheduler::add(const CassUuid& station, const std::string& fieldClimateId,
-	TimeOffseter::PredefinedTimezone tz, const std::map<std::string, std::string>& sensors)
+std::shared_ptr<FieldClimateApiDownloader> FieldClimateApiDownloadScheduler::makeDownloader(const StationDetails& details)
 {
-	std::lock_guard<std::recursive_mutex> lock{_downloadersMutex};
-	_downloaders.emplace_back(
-		std::make_shared<FieldClimateApiDownloader>(station, fieldClimateId, sensors, _db, tz, _apiId, _apiSecret, _jobPublisher.get())
-	);
+	return std::make_shared<FieldClimateApiDownloader>(std::get<0>(details), std::get<1>(details), std::get<3>(details),
+		_db, TimeOffseter::PredefinedTimezone(std::get<2>(details)), _apiId, _apiSecret, _jobPublisher.get());
 }
 
 void FieldClimateApiDownloadScheduler::download()
@@ -74,7 +72,10 @@ void FieldClimateApiDownloadScheduler::download()
 		if (_mustStop)
 			break;
 		try {
-			downloader->download(_client);
+			{
+				IngestionTrace trace{_tracePath};
+				downloader->download(_client);
+			}
 			// Wait for 100ms to limit the number of requests
 			// (capped at 10 per second)
 			std::this_thread::sleep_for(chrono::milliseconds(100));
@@ -87,15 +88,17 @@ void FieldClimateApiDownloadScheduler::download()
 
 void FieldClimateApiDownloadScheduler::reloadStations()
 {
-	std::lock_guard<std::recursive_mutex> lock{_downloadersMutex};
-	_downloaders.clear();
-
-	std::vector<std::tuple<CassUuid, std::string, int, std::map<std::string, std::string>>> fieldClimateStations;
+	std::vector<StationDetails> fieldClimateStations;
 	_db.getAllFieldClimateApiStations(fieldClimateStations);
-	for (const auto& station : fieldClimateStations) {
-		add(std::get<0>(station), std::get<1>(station), TimeOffseter::PredefinedTimezone(std::get<2>(station)),
-			std::get<3>(station));
-	}
+
+	std::lock_guard<std::recursive_mutex> lock{_downloadersMutex};
+	ReloadSummary summary = _downloaders.reconcile(std::move(fieldClimateStations),
+		[this](const StationDetails& station) -> std::optional<std::shared_ptr<FieldClimateApiDownloader>> {
+			if (!ownsStation(std::get<0>(station)))
+				return std::nullopt;
+			return makeDownloader(station);
+		});
+	std::cerr << SD_INFO << "[Pessl] management: " << "Stations reloaded: " << summary << std::endl;
 }
 
 }
@@ -31,19 +31,21 @@
 #include <map>
 #include <memory>
 #include <mutex>
+#include <tuple>
 
 #include <boost/system/error_code.hpp>
 #include <boost/asio/ssl.hpp>
 #include <boost/asio.hpp>
 #include <boost/asio/basic_waitable_timer.hpp>
 #include <cassandra.h>
-#include <cassobs/dbconnection_observations.h>
 
+#include "storage/observations_storage.h"
 #include "async_job_publisher.h"
 #include "time_offseter.h"
 #include "curl_wrapper.h"
 #include "abstract_download_scheduler.h"
 #include "pessl/fieldclimate_api_downloader.h"
+#include "downloader_set.h"
 
 namespace meteodata
 {
@@ -75,22 +77,25 @@ public:
 	 * @param apiSecret the private part of the FieldClimate API key
 	 */
 	FieldClimateApiDownloadScheduler(asio::io_context& ioContext,
-		DbConnectionObservations& db, std::string apiId, std::string apiSecret,
+		ObservationsStorage& db, std::string apiId, std::string apiSecret,
 		const std::shared_ptr<AsyncJobPublisher>& jobPublisher = nullptr);
 
+private:
 	/**
-	 * @brief Add a station to download the data for
-	 *
-	 * @param station The station Météodata UUID
-	 * @param fieldClimateId The FieldClimate API id
-	 * @param tz The station's local timezone
-	 * @param sensors All the sensors registered for that station (see the
+	 * @brief The configuration of a station: its UUID, its FieldClimate
+	 * API id, its timezone and its sensors (see the
 	 * FieldClimateApiDownloader class for details)
 	 */
-	void add(const CassUuid& station, const std::string& fieldClimateId, TimeOffseter::PredefinedTimezone tz,
-		 const std::map<std::string, std::string>& sensors);
+	using StationDetails = std::tuple<CassUuid, std::string, int, std::map<std::string, std::string>>;
+
+	/**
+	 * @brief Build the downloader of a station
+	 *
+	 * @param details The configuration of the station
+	 * @return The new downloader
+	 */
+	std::shared_ptr<FieldClimateApiDownloader> makeDownloader(const StationDetails& details);
 
-private:
 	/**
 	 * @brief The public part of the FieldClimate API key
 	 */
@@ -110,14 +115,14 @@ private:
 	/**
 	 * @brief The list of all downloaders (one per station)
 	 */
-	std::vector<std::shared_ptr<FieldClimateApiDownloader>> _downloaders;
+	DownloaderSet<StationDetails, std::shared_ptr<FieldClimateApiDownloader>> _downloaders;
 
 	std::recursive_mutex _downloadersMutex;
 
 private:
 	/**
 	 * @brief Reload the list of Pessl stations from the database and
-	 * recreate all downloaders
+	 * update the downloaders of the stations that have changed
 	 */
 	void reloadStations() override;
 
@@ -24,15 +24,18 @@
 #include <string>
 #include <tuple>
 #include <map>
+#include <optional>
 
 #include <boost/asio.hpp>
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/json_parser.hpp>
-#include <cassobs/dbconnection_observations.h>
 #include <date/date.h>
 #include <systemd/sd-daemon.h>
 #include <cassandra.h>
 
+#include "storage/observations_storage.h"
+#include "archive_pipeline.h"
+#include "archive_cleanup.h"
 #include "http_utils.h"
 #include "cassandra_utils.h"
 #include "async_job_publisher.h"
@@ -49,7 +52,7 @@ namespace chrono = std::chrono;
 using namespace meteodata;
 
 FieldClimateApiDownloader::FieldClimateApiDownloader(const CassUuid& station, std::string fieldclimateId,
-	std::map<std::string, std::string> sensors, DbConnectionObservations& db, TimeOffseter::PredefinedTimezone tz,
+	std::map<std::string, std::string> sensors, ObservationsStorage& db, TimeOffseter::PredefinedTimezone tz,
 	const std::string& apiKey, const std::string& apiSecret, AsyncJobPublisher* jobPublisher) :
 		_station{station},
 		_fieldclimateId{std::move(fieldclimateId)},
@@ -133,49 +136,60 @@ void FieldClimateApiDownloader::download(CurlWrapper& client)
 	std::cout << SD_DEBUG << "[Pessl " << _station << "] measurement: " << "Last archive dates back from "
 			  << _lastArchive << "; last available is " << lastAvailable << "\n" << "(approximately "
 			  << date::floor<date::days>(lastAvailable - date) << " days)" << std::endl;
-	while (date < lastAvailable) {
-		auto datePlus24Hours = date + chrono::hours{24};
-		std::ostringstream routeBuilder;
-		routeBuilder << "/data/" << _fieldclimateId << "/raw/from/" << chrono::system_clock::to_time_t(date) << "/to/"
-					 << chrono::system_clock::to_time_t(datePlus24Hours);
-		std::string route = routeBuilder.str();
-		std::string authorization;
-		std::string headerDate;
-		std::tie(authorization, headerDate) = computeAuthorizationAndDateFields("GET", route);
-
-		client.setHeader("Authorization", authorization);
-		client.setHeader("Date", headerDate);
-		client.setHeader("Accept", "application/json");
-
-		std::cout << SD_DEBUG << "[Pessl " << _station << "] protocol: " << "GET " << "/v2" << route << " HTTP/1.1 "
-				  << "Host: " << APIHOST << " "
-				  << "Date: " << headerDate << " "
-				  << "Authorization: " << authorization << " "
-				  << "Accept: application/json ";
-
-
-		CURLcode ret = client.download(BASE_URL + route, [&](const std::string& body) {
-			std::istringstream responseStream(body);
-
-			bool insertionOk = true;
+	ArchivePipeline<std::string, FieldClimateApiArchiveMessageCollection> pipeline;
+	pipeline.run(
+		[&]() -> std::optional<std::string> {
+			if (date >= lastAvailable)
+				return std::nullopt;
+
+			auto datePlus24Hours = date + chrono::hours{24};
+			std::ostringstream routeBuilder;
+			routeBuilder << "/data/" << _fieldclimateId << "/raw/from/" << chrono::system_clock::to_time_t(date) << "/to/"
+						 << chrono::system_clock::to_time_t(datePlus24Hours);
+			std::string route = routeBuilder.str();
+			std::string authorization;
+			std::string headerDate;
+			std::tie(authorization, headerDate) = computeAuthorizationAndDateFields("GET", route);
+
+			client.setHeader("Authorization", authorization);
+			client.setHeader("Date", headerDate);
+			client.setHeader("Accept", "application/json");
+
+			std::cout << SD_DEBUG << "[Pessl " << _station << "] protocol: " << "GET " << "/v2" << route << " HTTP/1.1 "
+					  << "Host: " << APIHOST << " "
+					  << "Date: " << headerDate << " "
+					  << "Authorization: " << authorization << " "
+					  << "Accept: application/json ";
+
+			std::string body;
+			CURLcode ret = client.download(BASE_URL + route, [&](const std::string& content) {
+				body = content;
+			});
+
+			if (ret != CURLE_OK) {
+				logAndThrowCurlError(client);
+			}
 
+			date = datePlus24Hours;
+			return body;
+		},
+		[&](std::string&& body) {
+			std::istringstream responseStream(body);
 			FieldClimateApiArchiveMessageCollection collection{&_timeOffseter, &_sensors};
 			collection.parse(responseStream);
+			return collection;
+		},
+		[&](FieldClimateApiArchiveMessageCollection&& collection) {
+			bool insertionOk = true;
 
 			if (collection.begin() != collection.end()) {
 				// Not having data can happen if the station malfunctioned
 				auto newestTimestamp = collection.getNewestMessageTime();
 				auto oldestTimestamp = collection.getOldestMessageTime();
-				auto archiveDay = date::floor<date::days>(_lastArchive);
-				auto lastDay = date::floor<date::days>(newestTimestamp);
-				while (archiveDay <= lastDay) {
-					int ret = _db.deleteDataPoints(_station, archiveDay, _lastArchive, newestTimestamp);
-
-					if (!ret)
-						std::cerr << SD_ERR << "[Pessl " << _station << "] management: "
-								  << "couldn't delete replaced observations" << std::endl;
-					archiveDay += date::days(1);
-				}
+				if (!deleteSupersededRealtimeObservations(_db, _station, _lastArchive, oldestTimestamp, newestTimestamp,
+						chrono::minutes{_pollingPeriod}))
+					std::cerr << SD_ERR << "[Pessl " << _station << "] management: "
+							  << "couldn't delete replaced observations" << std::endl;
 				std::vector<Observation> allObs;
 				for (const FieldClimateApiArchiveMessage& m : collection) {
 					auto o = m.getObservation(_station);
@@ -210,14 +224,12 @@ void FieldClimateApiDownloader::download(CurlWrapper& client)
 						  << std::endl;
 				}
 			}
-		});
 
-		if (ret != CURLE_OK) {
-			logAndThrowCurlError(client);
+			// Do not go on with the next windows if this one could not
+			// be stored, the last archive download time would skip over it
+			return insertionOk;
 		}
-
-		date += chrono::hours{24};
-	}
+	);
 }
 
 void FieldClimateApiDownloader::downloadRealTime(CurlWrapper& client)
@@ -29,12 +29,13 @@
 #include <tuple>
 
 #include <boost/system/error_code.hpp>
-#include <cassobs/dbconnection_observations.h>
 #include <cassandra.h>
 
+#include "storage/observations_storage.h"
 #include "time_offseter.h"
 #include "curl_wrapper.h"
 #include "async_job_publisher.h"
+#include "monitoring/profiled_db_connection.h"
 
 namespace meteodata
 {
@@ -64,7 +65,7 @@ public:
 	 * @param apiSecret the FieldClimate API key private part
 	 */
 	FieldClimateApiDownloader(const CassUuid& station, std::string fieldclimateId,
-		std::map<std::string, std::string> sensors, DbConnectionObservations& db,
+		std::map<std::string, std::string> sensors, ObservationsStorage& db,
 		TimeOffseter::PredefinedTimezone tz, const std::string& apiId, const std::string& apiSecret,
 		AsyncJobPublisher* jobPublisher = nullptr);
 
@@ -116,7 +117,7 @@ private:
 	/**
 	 * @brief The observations database (part Cassandra, part SQL) connector
 	 */
-	DbConnectionObservations& _db;
+	ProfiledDbConnection _db;
 
 	/**
 	 * @brief A component used to schedule computations of climatology and
@@ -32,8 +32,8 @@
 #include <boost/json.hpp>
 #include <cassandra.h>
 #include <cassobs/observation.h>
-#include <cassobs/dbconnection_observations.h>
 
+#include "storage/observations_storage.h"
 #include "lorain_message.h"
 #include "../hex_parser.h"
 #include "cassandra_utils.h"
@@ -44,7 +44,7 @@ namespace meteodata
 namespace chrono = std::chrono;
 namespace json = boost::json;
 
-LorainMessage::LorainMessage(DbConnectionObservations& db):
+LorainMessage::LorainMessage(ObservationsStorage& db):
 	_db{db}
 {}
 
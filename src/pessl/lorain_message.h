@@ -35,9 +35,10 @@
 #include <date/date.h>
 #include <cassobs/observation.h>
 #include <cassandra.h>
-#include <cassobs/dbconnection_observations.h>
 
+#include "storage/observations_storage.h"
 #include "liveobjects/liveobjects_message.h"
+#include "monitoring/profiled_db_connection.h"
 
 namespace meteodata
 {
@@ -49,7 +50,7 @@ namespace meteodata
 class LorainMessage : public LiveobjectsMessage
 {
 public:
-	explicit LorainMessage(DbConnectionObservations& db);
+	explicit LorainMessage(ObservationsStorage& db);
 
 	Observation getObservation(const CassUuid& station) const override;
 
@@ -72,7 +73,7 @@ public:
 	boost::json::object getDecodedMessage() const override;
 
 private:
-	DbConnectionObservations& _db;
+	ProfiledDbConnection _db;
 
 	/**
 	 * @brief A struct used to store observation values to then populate the
@@ -40,12 +40,13 @@ namespace asio = boost::asio;
 namespace chrono = std::chrono;
 using tcp = boost::asio::ip::tcp;
 
-RestWebServer::RestWebServer(asio::io_context& io, DbConnectionObservations& db,
+RestWebServer::RestWebServer(asio::io_context& io, ObservationsStorage& db,
 		const std::shared_ptr<AsyncJobPublisher>& jobPublisher) :
 	Connector{io, db},
 	_acceptor{io, tcp::endpoint{tcp::v4(), 5887}},
 	_stopped{true}
 {
+	_db.setCaller("rest");
 	_status.shortStatus = "IDLE";
 	_status.nextDownload = date::floor<chrono::seconds>(chrono::system_clock::now());
 	_status.nbDownloads = -1;
@@ -31,8 +31,8 @@
 #include <string>
 #include <memory>
 
-#include <cassobs/dbconnection_observations.h>
 
+#include "storage/observations_storage.h"
 #include "http_connection.h"
 #include "connector.h"
 #include "async_job_publisher.h"
@@ -43,7 +43,7 @@ namespace meteodata
 class RestWebServer : public Connector
 {
 public:
-	RestWebServer(boost::asio::io_context& io, DbConnectionObservations& db,
+	RestWebServer(boost::asio::io_context& io, ObservationsStorage& db,
 		const std::shared_ptr<AsyncJobPublisher>& jobPublisher = nullptr);
 
 	// Start accepting incoming connections
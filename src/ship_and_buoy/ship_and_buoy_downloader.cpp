@@ -29,9 +29,9 @@
 #include <fstream>
 #include <systemd/sd-daemon.h>
 #include <boost/asio/io_context.hpp>
-#include <cassobs/dbconnection_observations.h>
 #include <date/date.h>
 
+#include "storage/observations_storage.h"
 #include "cassandra_utils.h"
 #include "abstract_download_scheduler.h"
 #include "ship_and_buoy/ship_and_buoy_downloader.h"
@@ -44,9 +44,9 @@ namespace meteodata
 using namespace date;
 
 ShipAndBuoyDownloader::ShipAndBuoyDownloader(asio::io_context& ioContext,
-	DbConnectionObservations& db,
+	ObservationsStorage& db,
 	const std::shared_ptr<AsyncJobPublisher>& jobPublisher) :
-		AbstractDownloadScheduler{chrono::hours(POLLING_PERIOD_HOURS), ioContext, db},
+		AbstractDownloadScheduler{chrono::hours(POLLING_PERIOD_HOURS), ioContext, db, "ship"},
 		_jobPublisher{jobPublisher}
 {
 	_status.shortStatus = "IDLE";
@@ -60,6 +60,9 @@ void ShipAndBuoyDownloader::download()
 	std::cout << SD_NOTICE << "[SHIP] measurement: " << "Now downloading SHIP and BUOY data " << std::endl;
 	auto ymd = date::year_month_day(date::floor<date::days>(chrono::system_clock::now() - date::days(1)));
 
+	// the bulletin holds the messages of all the stations at once, trace it
+	// as a single ingestion
+	IngestionTrace trace{_tracePath};
 	CURLcode ret = _client.download(std::string{"https://"} + HOST + date::format(URL, ymd),
 								   [&](const std::string& body) {
 		std::istringstream responseStream{body};
@@ -40,8 +40,8 @@
 #include <cassandra.h>
 #include <date/date.h>
 #include <date/tz.h>
-#include <cassobs/dbconnection_observations.h>
 
+#include "storage/observations_storage.h"
 #include "async_job_publisher.h"
 #include "abstract_download_scheduler.h"
 
@@ -61,7 +61,7 @@ using namespace meteodata;
 class ShipAndBuoyDownloader : public AbstractDownloadScheduler
 {
 public:
-	ShipAndBuoyDownloader(asio::io_context& ioContext, DbConnectionObservations& db,
+	ShipAndBuoyDownloader(asio::io_context& ioContext, ObservationsStorage& db,
 		const std::shared_ptr<AsyncJobPublisher>& jobPublisher = nullptr);
 
 private:
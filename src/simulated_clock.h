@@ -0,0 +1,212 @@
+/**
+ * @file simulated_clock.h
+ * @brief Definition of the SimulatedTime class and of the clocks and timers
+ * built upon it
+ * @author Laurent Georget
+ * @date 2026-10-18
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SIMULATED_CLOCK_H
+#define SIMULATED_CLOCK_H
+
+#include <atomic>
+#include <chrono>
+
+#include <boost/asio/basic_waitable_timer.hpp>
+#include <boost/asio/wait_traits.hpp>
+
+namespace meteodata
+{
+
+namespace chrono = std::chrono;
+
+/**
+ * @brief The time seen by the schedulers, the real time by default, or a
+ * simulated time running faster than the real time for the throughput tests
+ *
+ * When the time is accelerated by a factor F, one second of real time is F
+ * seconds of simulated time: the timers built upon SystemClock and
+ * SteadyClock go off F times sooner and the clocks advance F times faster,
+ * starting from the real time at which the acceleration is set up. With the
+ * in-memory storage and local stand-ins for the HTTP APIs, a day of
+ * scheduling over thousands of stations can then be replayed in a few
+ * seconds or minutes.
+ *
+ * Only the scheduling uses the simulated time: the metrics measuring the
+ * duration of the work (the downloads, the database calls, etc.), the I/O
+ * loop lag monitor and the watchdog keep using the real clocks.
+ */
+class SimulatedTime
+{
+public:
+	/**
+	 * @brief Make the simulated time run faster than the real time
+	 *
+	 * This must be called once, at startup, before any timer is armed.
+	 *
+	 * @param factor The number of simulated seconds per real second,
+	 * strictly positive
+	 */
+	static void accelerate(double factor)
+	{
+		State& s = state();
+		s.systemOrigin = chrono::system_clock::now();
+		s.steadyOrigin = chrono::steady_clock::now();
+		s.factor = factor;
+		s.accelerated.store(factor != 1.0, std::memory_order_release);
+	}
+
+	/**
+	 * @brief Tell whether the time is accelerated
+	 */
+	static bool isAccelerated()
+	{
+		return state().accelerated.load(std::memory_order_acquire);
+	}
+
+	/**
+	 * @brief Get the number of simulated seconds per real second
+	 */
+	static double getAcceleration()
+	{
+		return isAccelerated() ? state().factor : 1.0;
+	}
+
+	/**
+	 * @brief Get the current simulated wall-clock time
+	 */
+	static chrono::system_clock::time_point systemNow()
+	{
+		if (!isAccelerated())
+			return chrono::system_clock::now();
+		const State& s = state();
+		return s.systemOrigin + chrono::duration_cast<chrono::system_clock::duration>(
+			(chrono::steady_clock::now() - s.steadyOrigin) * s.factor);
+	}
+
+	/**
+	 * @brief Get the current simulated monotonic time
+	 */
+	static chrono::steady_clock::time_point steadyNow()
+	{
+		if (!isAccelerated())
+			return chrono::steady_clock::now();
+		const State& s = state();
+		return s.steadyOrigin + chrono::duration_cast<chrono::steady_clock::duration>(
+			(chrono::steady_clock::now() - s.steadyOrigin) * s.factor);
+	}
+
+	/**
+	 * @brief Convert a simulated duration to the real time it takes
+	 *
+	 * @param d A duration in simulated time
+	 * @return The same duration in real time
+	 */
+	template<typename Rep, typename Period>
+	static chrono::duration<Rep, Period> toRealDuration(const chrono::duration<Rep, Period>& d)
+	{
+		if (!isAccelerated() || d == chrono::duration<Rep, Period>::max() || d == chrono::duration<Rep, Period>::min())
+			return d;
+		return chrono::duration_cast<chrono::duration<Rep, Period>>(d / state().factor);
+	}
+
+private:
+	struct State
+	{
+		std::atomic<bool> accelerated{false};
+		double factor = 1.0;
+		chrono::system_clock::time_point systemOrigin;
+		chrono::steady_clock::time_point steadyOrigin;
+	};
+
+	static State& state()
+	{
+		static State s;
+		return s;
+	}
+};
+
+/**
+ * @brief A wall clock following the simulated time
+ *
+ * Its time points are the ones of std::chrono::system_clock so that they
+ * can be converted to dates as usual.
+ */
+struct SystemClock
+{
+	using rep = chrono::system_clock::rep;
+	using period = chrono::system_clock::period;
+	using duration = chrono::system_clock::duration;
+	using time_point = chrono::system_clock::time_point;
+	static constexpr bool is_steady = false;
+
+	static time_point now()
+	{
+		return SimulatedTime::systemNow();
+	}
+};
+
+/**
+ * @brief A monotonic clock following the simulated time
+ */
+struct SteadyClock
+{
+	using rep = chrono::steady_clock::rep;
+	using period = chrono::steady_clock::period;
+	using duration = chrono::steady_clock::duration;
+	using time_point = chrono::steady_clock::time_point;
+	static constexpr bool is_steady = true;
+
+	static time_point now()
+	{
+		return SimulatedTime::steadyNow();
+	}
+};
+
+/**
+ * @brief The wait traits making the Boost.Asio timers wait for the real time
+ * corresponding to a simulated duration
+ */
+template<typename Clock>
+struct SimulatedWaitTraits
+{
+	static typename Clock::duration to_wait_duration(const typename Clock::duration& d)
+	{
+		return SimulatedTime::toRealDuration(d);
+	}
+
+	static typename Clock::duration to_wait_duration(const typename Clock::time_point& t)
+	{
+		return SimulatedTime::toRealDuration(boost::asio::wait_traits<Clock>::to_wait_duration(t));
+	}
+};
+
+/**
+ * @brief A timer to wait for a wall-clock time in simulated time
+ */
+using SystemTimer = boost::asio::basic_waitable_timer<SystemClock, SimulatedWaitTraits<SystemClock>>;
+
+/**
+ * @brief A timer to wait for a duration in simulated time
+ */
+using SteadyTimer = boost::asio::basic_waitable_timer<SteadyClock, SimulatedWaitTraits<SteadyClock>>;
+
+}
+
+#endif /* SIMULATED_CLOCK_H */
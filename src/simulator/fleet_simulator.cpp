@@ -0,0 +1,582 @@
+/**
+ * @file fleet_simulator.cpp
+ * @brief Simulate a fleet of stations sending their measurements to Meteodata
+ * @author Laurent Georget
+ * @date 2026-10-18
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <algorithm>
+#include <csignal>
+#include <map>
+#include <memory>
+#include <queue>
+#include <sstream>
+#include <string>
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <system_error>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <boost/asio.hpp>
+#include <mqtt_client_cpp.hpp> // must be kept before boost/program_options.hpp else build breaks (not sure why...)
+#include <boost/program_options.hpp>
+#include <date/date.h>
+#include <openssl/evp.h>
+
+#include "simulator/synthetic_station_data.h"
+#include "config.h"
+
+#define DEFAULT_VERIFY_PATH "/etc/ssl/certs"
+
+using namespace meteodata;
+namespace po = boost::program_options;
+namespace asio = boost::asio;
+namespace sys = boost::system;
+namespace chrono = std::chrono;
+using udp = asio::ip::udp;
+
+namespace
+{
+
+constexpr char CLIENT_ID[] = "meteodata-fleet-simulator";
+
+/**
+ * @brief The connectors the simulated stations send their measurements to
+ */
+enum class StationType
+{
+	VP2_MQTT, CHIRPSTACK, LIVEOBJECTS, NBIOT
+};
+
+const char* typeName(StationType type)
+{
+	switch (type) {
+		case StationType::VP2_MQTT:
+			return "vp2-mqtt";
+		case StationType::CHIRPSTACK:
+			return "chirpstack";
+		case StationType::LIVEOBJECTS:
+			return "liveobjects";
+		case StationType::NBIOT:
+			return "nbiot";
+	}
+	return "?";
+}
+
+/**
+ * @brief A simulated station
+ */
+struct SimulatedStation
+{
+	StationType type;
+	std::string uuid;
+	std::string name;
+	float latitude;
+	float longitude;
+	int elevation;
+	/**
+	 * @brief The MQTT topic the station publishes to, for the MQTT
+	 * stations
+	 */
+	std::string topic;
+	/**
+	 * @brief The identifier of the station on its network: the device EUI
+	 * for the LoRa stations, the IMEI for the NB-IoT ones
+	 */
+	std::string identifier;
+	/**
+	 * @brief The HMAC key of the NB-IoT stations, in hexadecimal
+	 */
+	std::string hmacKey;
+};
+
+/**
+ * @brief The composition of the fleet and the MQTT broker it publishes to
+ */
+struct FleetConfiguration
+{
+	std::map<StationType, int> counts;
+	int period;
+	std::string mqttAddress;
+	int mqttPort;
+	std::string mqttUser;
+	std::string mqttPassword;
+};
+
+/**
+ * @brief Generate the stations of the fleet
+ *
+ * The fleet only depends on its composition and on the generator seed, so
+ * that the station table given to Meteodata and the stations simulated can be
+ * generated by two different runs of the simulator.
+ */
+std::vector<SimulatedStation> generateFleet(const FleetConfiguration& config, SyntheticStationData& data)
+{
+	std::vector<SimulatedStation> fleet;
+	for (auto&& [type, count] : config.counts) {
+		for (int i = 0 ; i < count ; i++) {
+			SimulatedStation st;
+			st.type = type;
+			st.uuid = data.randomUuid();
+			std::ostringstream name;
+			name << "sim-" << typeName(type) << "-" << std::setw(6) << std::setfill('0') << i;
+			st.name = name.str();
+			// somewhere in metropolitan France
+			st.latitude = data.randomInt(42500, 51000) / 1000.f;
+			st.longitude = data.randomInt(-4500, 7500) / 1000.f;
+			st.elevation = data.randomInt(0, 1500);
+			switch (type) {
+				case StationType::VP2_MQTT:
+					st.topic = "vp2/" + st.name + "/dmpaft";
+					break;
+				case StationType::CHIRPSTACK:
+					st.identifier = data.randomHex(16);
+					st.topic = "chirpstack/simulator/device/" + st.identifier + "/event/up";
+					break;
+				case StationType::LIVEOBJECTS:
+					st.identifier = data.randomHex(16);
+					// all the Liveobjects stations share the FIFO
+					st.topic = "fifo/simulator";
+					break;
+				case StationType::NBIOT:
+					st.identifier = data.randomImei();
+					st.hmacKey = data.randomHex(64);
+					break;
+			}
+			fleet.push_back(std::move(st));
+		}
+	}
+	return fleet;
+}
+
+/**
+ * @brief Write the station table describing the fleet, to be loaded by
+ * Meteodata with the in-memory storage
+ *
+ * @see InMemoryObservationsStorage::loadStationTable()
+ */
+void writeStationTable(std::ostream& os, const std::vector<SimulatedStation>& fleet, const FleetConfiguration& config)
+{
+	os << "# Generated by meteodata-fleet-simulator\n";
+	for (auto&& [type, count] : config.counts)
+		os << "# " << typeName(type) << ": " << count << " stations\n";
+
+	for (const SimulatedStation& st : fleet) {
+		os << "station\t" << st.uuid << "\t" << st.name << "\t" << config.period << "\t"
+		   << st.latitude << "\t" << st.longitude << "\t" << st.elevation << "\n";
+		if (!st.topic.empty()) {
+			// the time zone of the stations is UTC
+			os << "mqtt\t" << st.uuid << "\t" << config.mqttAddress << "\t" << config.mqttPort << "\t"
+			   << config.mqttUser << "\t" << config.mqttPassword << "\t" << st.topic << "\t0\n";
+		}
+		if (st.type == StationType::LIVEOBJECTS)
+			os << "liveobjects\t" << st.uuid << "\turn:lo:nsid:lora:" << st.identifier << "\tlora\n";
+		else if (st.type == StationType::NBIOT)
+			os << "nbiot\t" << st.uuid << "\t" << st.identifier << "\t" << st.hmacKey << "\tthplnbiot\n";
+	}
+}
+
+std::string toBase64(const std::string& raw)
+{
+	std::string encoded(4 * ((raw.size() + 2) / 3) + 1, '\0');
+	int size = EVP_EncodeBlock(reinterpret_cast<unsigned char*>(encoded.data()),
+		reinterpret_cast<const unsigned char*>(raw.data()), raw.size());
+	encoded.resize(size);
+	return encoded;
+}
+
+std::string toRaw(const std::string& hex)
+{
+	std::string raw(hex.size() / 2, '\0');
+	for (std::size_t i = 0 ; i < raw.size() ; i++)
+		raw[i] = static_cast<char>(std::stoi(hex.substr(2 * i, 2), nullptr, 16));
+	return raw;
+}
+
+/**
+ * @brief The messages sent for one type of stations
+ */
+struct Statistics
+{
+	std::uint64_t sent = 0;
+	std::uint64_t corrupted = 0;
+	std::uint64_t failed = 0;
+};
+
+/**
+ * @brief The simulation of the fleet: each station sends a message every
+ * period, the stations being evenly spread over the period
+ */
+class Simulation
+{
+public:
+	struct Parameters
+	{
+		std::string host;
+		int udpPort;
+		chrono::minutes period;
+		chrono::seconds duration;
+		chrono::milliseconds jitter;
+		double errorRate;
+	};
+
+	using MqttClient = decltype(mqtt::make_tls_sync_client(std::declval<asio::io_context&>(), std::string{}, std::declval<int>()));
+
+	Simulation(asio::io_context& ioContext, const std::vector<SimulatedStation>& fleet, SyntheticStationData& data,
+		Parameters parameters, MqttClient mqttClient) :
+		_fleet{fleet},
+		_data{data},
+		_parameters{std::move(parameters)},
+		_mqttClient{std::move(mqttClient)},
+		_timer{ioContext},
+		_signals{ioContext, SIGINT, SIGTERM},
+		_udpSocket{ioContext}
+	{
+		udp::resolver udpResolver{ioContext};
+		_udpEndpoint = *udpResolver.resolve(udp::v4(), _parameters.host, std::to_string(_parameters.udpPort)).begin();
+		_udpSocket.open(udp::v4());
+		_signals.async_wait([this](const sys::error_code& ec, int) {
+			if (ec != sys::errc::operation_canceled)
+				stop();
+		});
+	}
+
+	void start()
+	{
+		_start = chrono::steady_clock::now();
+		auto period = chrono::duration_cast<chrono::steady_clock::duration>(_parameters.period);
+		for (std::size_t i = 0 ; i < _fleet.size() ; i++)
+			push(_start + period * static_cast<long>(i) / static_cast<long>(_fleet.size()), i);
+		scheduleNext();
+	}
+
+	void stop()
+	{
+		if (_stopped)
+			return;
+		_stopped = true;
+		_timer.cancel();
+		_signals.cancel();
+		if (_mqttClient)
+			_mqttClient->disconnect();
+	}
+
+	void acknowledge()
+	{
+		_acknowledged++;
+	}
+
+	void report(std::ostream& os) const
+	{
+		auto elapsed = chrono::duration<double>(chrono::steady_clock::now() - _start).count();
+		std::uint64_t total = 0;
+		for (auto&& s : _statistics)
+			total += s.second.sent;
+
+		os << "Sent " << total << " messages from " << _fleet.size() << " stations in "
+		   << std::fixed << std::setprecision(3) << elapsed << "s ("
+		   << (elapsed > 0 ? total / elapsed : 0.) << " messages/s)\n";
+		for (auto&& [type, s] : _statistics) {
+			os << "  " << std::left << std::setw(12) << typeName(type) << std::right
+			   << " sent: " << s.sent << ", corrupted: " << s.corrupted << ", failed: " << s.failed << "\n";
+		}
+		if (_mqttClient)
+			os << "MQTT messages acknowledged by the broker: " << _acknowledged << "\n";
+		if (_lag.count() > 0)
+			os << "The simulation lagged behind the schedule by up to "
+			   << chrono::duration<double>(_lag).count() << "s\n";
+	}
+
+private:
+	const std::vector<SimulatedStation>& _fleet;
+	SyntheticStationData& _data;
+	Parameters _parameters;
+	MqttClient _mqttClient;
+	asio::steady_timer _timer;
+	asio::signal_set _signals;
+	udp::socket _udpSocket;
+	udp::endpoint _udpEndpoint;
+	bool _stopped = false;
+
+	/**
+	 * @brief The next messages to send, as the time they are due, the
+	 * time they were planned for (before the jitter), and the index of
+	 * the station, the earliest first
+	 */
+	using Slot = std::tuple<chrono::steady_clock::time_point, chrono::steady_clock::time_point, std::size_t>;
+	std::priority_queue<Slot, std::vector<Slot>, std::greater<>> _schedule;
+
+	chrono::steady_clock::time_point _start;
+	chrono::steady_clock::duration _lag{0};
+	std::map<StationType, Statistics> _statistics;
+	std::uint64_t _acknowledged = 0;
+
+	void push(chrono::steady_clock::time_point planned, std::size_t station)
+	{
+		auto due = planned;
+		if (_parameters.jitter.count() > 0)
+			due += chrono::milliseconds{_data.randomInt(0, _parameters.jitter.count())};
+		_schedule.emplace(due, planned, station);
+	}
+
+	void scheduleNext()
+	{
+		if (_stopped || _schedule.empty())
+			return;
+
+		auto [due, planned, station] = _schedule.top();
+		if (_parameters.duration.count() > 0 && due > _start + _parameters.duration) {
+			stop();
+			return;
+		}
+
+		_timer.expires_at(due);
+		_timer.async_wait([this](const sys::error_code& ec) {
+			if (ec == sys::errc::operation_canceled)
+				return;
+			auto [due, planned, station] = _schedule.top();
+			_schedule.pop();
+			_lag = std::max(_lag, chrono::steady_clock::now() - due);
+			send(_fleet[station]);
+			push(planned + _parameters.period, station);
+			scheduleNext();
+		});
+	}
+
+	void corrupt(std::string& message, bool binary)
+	{
+		if (binary) {
+			message[_data.randomInt(0, message.size() - 1)] ^= 0x5A;
+		} else {
+			message.resize(message.size() / 2);
+		}
+	}
+
+	void send(const SimulatedStation& st)
+	{
+		Statistics& statistics = _statistics[st.type];
+		auto now = date::floor<chrono::seconds>(chrono::system_clock::now());
+		bool corrupted = _data.happens(_parameters.errorRate);
+
+		try {
+			std::string message;
+			switch (st.type) {
+				case StationType::VP2_MQTT: {
+					// the archive record of the last minute, the consoles refuse the
+					// records from the future
+					auto time = date::floor<chrono::minutes>(now - chrono::seconds{1});
+					message = _data.makeVantagePro2ArchiveBatch(
+						{date::local_seconds{time.time_since_epoch()}}, _parameters.period.count());
+					break;
+				}
+				case StationType::CHIRPSTACK:
+					message = R"({"time":")" + date::format("%FT%TZ", now) +
+						R"(","deviceInfo":{"devEui":")" + st.identifier +
+						R"(","tags":{"sensors":"dragino-lsn50v2"}},"fPort":2,"data":")" +
+						toBase64(toRaw(_data.makeLsn50v2Payload())) + R"("})";
+					break;
+				case StationType::LIVEOBJECTS:
+					message = R"({"streamId":"urn:lo:nsid:lora:)" + st.identifier +
+						R"(","timestamp":")" + date::format("%FT%TZ", now) +
+						R"(","extra":{"sensors":"dragino-lsn50v2"},"value":{"payload":")" +
+						_data.makeLsn50v2Payload() +
+						R"("},"metadata":{"network":{"lora":{"devEUI":")" + st.identifier +
+						R"(","port":2}}}})";
+					break;
+				case StationType::NBIOT:
+					message = _data.makeThplnbiotDatagram(st.identifier, st.hmacKey, now);
+					break;
+			}
+
+			if (corrupted) {
+				corrupt(message, st.type == StationType::VP2_MQTT || st.type == StationType::NBIOT);
+				statistics.corrupted++;
+			}
+
+			if (st.type == StationType::NBIOT)
+				_udpSocket.send_to(asio::buffer(message), _udpEndpoint);
+			else
+				_mqttClient->publish(st.topic, message, mqtt::qos::at_least_once);
+			statistics.sent++;
+		} catch (const std::exception& e) {
+			std::cerr << "Failed to send a message for station " << st.name << ": " << e.what() << std::endl;
+			statistics.failed++;
+		}
+	}
+};
+
+}
+
+/**
+ * @brief Entry point
+ *
+ * @param argc the number of arguments passed on the command line
+ * @param argv the arguments passed on the command line
+ *
+ * @return 0 if everything went well, and either an "errno-style" error code
+ * or 255 otherwise
+ */
+int main(int argc, char** argv)
+{
+	FleetConfiguration fleetConfig;
+	int vp2Mqtt;
+	int chirpstack;
+	int liveobjects;
+	int nbiot;
+	unsigned int seed;
+	std::string stationTable;
+	unsigned long duration;
+	unsigned long jitter;
+	double errorRate;
+	std::string host;
+	int udpPort;
+
+	po::options_description desc("Allowed options");
+	desc.add_options()
+		("help", "display the help message and exit")
+		("version", "display the version of Meteodata and exit")
+		("vp2-mqtt", po::value<int>(&vp2Mqtt)->default_value(0), "the number of VantagePro2 stations publishing their archives through MQTT")
+		("chirpstack", po::value<int>(&chirpstack)->default_value(0), "the number of LoRa stations publishing through a Chirpstack MQTT integration")
+		("liveobjects", po::value<int>(&liveobjects)->default_value(0), "the number of LoRa stations publishing through the Liveobjects MQTT FIFO")
+		("nbiot", po::value<int>(&nbiot)->default_value(0), "the number of NB-IoT stations sending UDP datagrams")
+		("period", po::value<int>(&fleetConfig.period)->default_value(10), "the period, in minutes, at which each station sends its measurements")
+		("seed", po::value<unsigned int>(&seed)->default_value(1), "the seed of the generator of the stations and of their measurements, the same seed and the same numbers of stations give the same fleet")
+		("station-table", po::value<std::string>(&stationTable), "the file to write the station table to, to start meteodata with --storage memory --station-table <file>")
+		("generate-only", "write the station table and exit without simulating the stations")
+		("duration", po::value<unsigned long>(&duration)->default_value(0), "the duration of the simulation in seconds, 0 to run until interrupted")
+		("jitter", po::value<unsigned long>(&jitter)->default_value(0), "the maximum random delay, in milliseconds, added to the sending of each message")
+		("error-rate", po::value<double>(&errorRate)->default_value(0.), "the proportion of messages corrupted before being sent, between 0 and 1")
+		("host", po::value<std::string>(&host)->default_value("localhost"), "the host running meteodata, for the UDP datagrams")
+		("udp-port", po::value<int>(&udpPort)->default_value(5888), "the port of the meteodata UDP connector")
+		("mqtt-host", po::value<std::string>(&fleetConfig.mqttAddress)->default_value("localhost"), "the MQTT broker the stations publish to, also written in the station table for meteodata to subscribe to it")
+		("mqtt-port", po::value<int>(&fleetConfig.mqttPort)->default_value(8883), "the port of the MQTT broker")
+		("mqtt-user", po::value<std::string>(&fleetConfig.mqttUser), "the username to connect to the MQTT broker, also written in the station table")
+		("mqtt-password", po::value<std::string>(&fleetConfig.mqttPassword), "the password to connect to the MQTT broker, also written in the station table")
+	;
+
+	po::variables_map vm;
+	po::store(po::parse_command_line(argc, argv, desc), vm);
+	po::notify(vm);
+
+	if (vm.count("help")) {
+		std::cout << PACKAGE_STRING"\n";
+		std::cout << "Usage: " << argv[0] << " [--vp2-mqtt N] [--chirpstack N] [--liveobjects N] [--nbiot N] [--station-table file]\n";
+		std::cout << desc << "\n";
+		return 0;
+	}
+
+	if (vm.count("version")) {
+		std::cout << VERSION << std::endl;
+		return 0;
+	}
+
+	if (vp2Mqtt < 0 || chirpstack < 0 || liveobjects < 0 || nbiot < 0 || fleetConfig.period <= 0) {
+		std::cerr << "The numbers of stations cannot be negative and the period must be positive, aborting" << std::endl;
+		return 1;
+	}
+
+	if (errorRate < 0 || errorRate > 1) {
+		std::cerr << "The error rate must be between 0 and 1, aborting" << std::endl;
+		return 1;
+	}
+
+	fleetConfig.counts = {
+		{StationType::VP2_MQTT, vp2Mqtt},
+		{StationType::CHIRPSTACK, chirpstack},
+		{StationType::LIVEOBJECTS, liveobjects},
+		{StationType::NBIOT, nbiot},
+	};
+
+	try {
+		SyntheticStationData fleetData{seed};
+		std::vector<SimulatedStation> fleet = generateFleet(fleetConfig, fleetData);
+
+		if (!stationTable.empty()) {
+			std::ofstream os{stationTable};
+			if (!os)
+				throw std::runtime_error("Cannot open the station table " + stationTable);
+			writeStationTable(os, fleet, fleetConfig);
+			std::cerr << "Station table for " << fleet.size() << " stations written to " << stationTable << std::endl;
+		}
+
+		if (vm.count("generate-only"))
+			return 0;
+
+		if (fleet.empty()) {
+			std::cerr << "No station to simulate, aborting" << std::endl;
+			return 1;
+		}
+
+		asio::io_context ioContext;
+
+		Simulation::MqttClient client;
+		if (vp2Mqtt + chirpstack + liveobjects > 0) {
+			client = mqtt::make_tls_sync_client(ioContext, fleetConfig.mqttAddress, fleetConfig.mqttPort);
+			client->set_client_id(CLIENT_ID);
+			client->set_user_name(fleetConfig.mqttUser);
+			client->set_password(fleetConfig.mqttPassword);
+			client->set_clean_session(true);
+			client->get_ssl_context().add_verify_path(DEFAULT_VERIFY_PATH);
+			client->get_ssl_context().set_verify_mode(asio::ssl::verify_none);
+		}
+
+		// the measurements do not depend on the composition of the fleet
+		SyntheticStationData measurementsData{seed + 1};
+		Simulation simulation{ioContext, fleet, measurementsData,
+			Simulation::Parameters{host, udpPort, chrono::minutes{fleetConfig.period}, chrono::seconds{duration},
+				chrono::milliseconds{jitter}, errorRate},
+			client};
+
+		if (client) {
+			using packet_id_t = typename std::remove_reference_t<decltype(*client)>::packet_id_t;
+			client->set_connack_handler([&](bool, mqtt::connect_return_code ret) {
+				if (ret != mqtt::connect_return_code::accepted) {
+					std::cerr << "Failed to connect to the MQTT broker: " << mqtt::connect_return_code_to_str(ret) << std::endl;
+					simulation.stop();
+					return false;
+				}
+				simulation.start();
+				return true;
+			});
+			client->set_close_handler([]() {});
+			client->set_error_handler([](std::error_code const& ec) {
+				std::cerr << "MQTT client disconnected: " << ec.message() << std::endl;
+			});
+			client->set_puback_handler([&simulation]([[maybe_unused]] packet_id_t packetId) {
+				simulation.acknowledge();
+				return true;
+			});
+			client->connect();
+		} else {
+			simulation.start();
+		}
+
+		ioContext.run();
+		simulation.report(std::cout);
+	} catch (const std::exception& e) {
+		std::cerr << "Simulation aborted: " << e.what() << std::endl;
+		return 1;
+	}
+}
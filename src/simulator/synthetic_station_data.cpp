@@ -0,0 +1,231 @@
+/**
+ * @file synthetic_station_data.cpp
+ * @brief Implementation of the SyntheticStationData class
+ * @author Laurent Georget
+ * @date 2026-10-18
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <date/date.h>
+
+#include "davis/vantagepro2_message.h"
+#include "davis/vantagepro2_archive_message.h"
+#include "http_utils.h"
+#include "simulator/synthetic_station_data.h"
+
+namespace meteodata
+{
+
+namespace chrono = std::chrono;
+
+namespace
+{
+std::string hex(unsigned int value, int digits)
+{
+	std::ostringstream os;
+	os << std::hex << std::setfill('0') << std::setw(digits) << value;
+	return os.str();
+}
+
+void put16(std::string& buffer, std::size_t offset, std::uint16_t value)
+{
+	buffer[offset] = value & 0xFF;
+	buffer[offset + 1] = value >> 8;
+}
+
+std::string unhexify(const std::string& hex)
+{
+	std::string raw(hex.size() / 2, '\0');
+	for (std::size_t i = 0 ; i < raw.size() ; i++)
+		raw[i] = static_cast<char>(std::stoi(hex.substr(2 * i, 2), nullptr, 16));
+	return raw;
+}
+}
+
+SyntheticStationData::SyntheticStationData(std::uint_fast32_t seed) :
+	_rng{seed}
+{
+}
+
+int SyntheticStationData::randomInt(int min, int max)
+{
+	return std::uniform_int_distribution<int>{min, max}(_rng);
+}
+
+bool SyntheticStationData::happens(double probability)
+{
+	return std::uniform_real_distribution<double>{0., 1.}(_rng) < probability;
+}
+
+std::string SyntheticStationData::randomHex(std::size_t length)
+{
+	static constexpr char DIGITS[] = "0123456789abcdef";
+	std::string s(length, '0');
+	for (char& c : s)
+		c = DIGITS[randomInt(0, 15)];
+	return s;
+}
+
+std::string SyntheticStationData::randomUuid()
+{
+	std::string uuid = randomHex(32);
+	uuid[12] = '4';
+	uuid[16] = "89ab"[randomInt(0, 3)];
+	return uuid.substr(0, 8) + "-" + uuid.substr(8, 4) + "-" + uuid.substr(12, 4) + "-" +
+		uuid.substr(16, 4) + "-" + uuid.substr(20);
+}
+
+std::string SyntheticStationData::randomImei()
+{
+	std::string imei(15, '0');
+	for (char& c : imei)
+		c = '0' + randomInt(0, 9);
+	return imei;
+}
+
+VantagePro2ArchiveMessage::ArchiveDataPoint SyntheticStationData::makeVantagePro2ArchiveRecord(
+	const date::local_seconds& time, int archivePeriod)
+{
+	date::local_days day = date::floor<date::days>(time);
+	date::year_month_day ymd{day};
+	date::hh_mm_ss<chrono::seconds> tod{time - day};
+
+	VantagePro2ArchiveMessage::ArchiveDataPoint point;
+	// the sensors not connected to the console are reported as 0xFF...
+	std::memset(&point, 0xFF, sizeof(point));
+	point.day = unsigned(ymd.day());
+	point.month = unsigned(ymd.month());
+	point.year = int(ymd.year()) - 2000;
+	point.time = tod.hours().count() * 100 + tod.minutes().count();
+	point.outsideTemp = randomInt(300, 900);
+	point.maxOutsideTemp = point.outsideTemp + randomInt(0, 10);
+	point.minOutsideTemp = point.outsideTemp - randomInt(0, 10);
+	point.rainfall = randomInt(0, 3);
+	point.maxRainRate = randomInt(0, 200);
+	point.barometer = randomInt(29500, 30500);
+	point.solarRad = randomInt(0, 900);
+	// about one sample every 2.5 seconds with a good reception
+	point.nbWindSamples = randomInt(archivePeriod * 20, archivePeriod * 24);
+	point.insideTemp = randomInt(600, 750);
+	point.insideHum = randomInt(30, 60);
+	point.outsideHum = randomInt(40, 100);
+	point.avgWindSpeed = randomInt(0, 30);
+	point.maxWindSpeed = point.avgWindSpeed + randomInt(0, 20);
+	point.maxWindSpeedDir = randomInt(0, 15);
+	point.prevailingWindDir = randomInt(0, 15);
+	point.uv = randomInt(0, 80);
+	point.et = randomInt(0, 5);
+	point.maxSolarRad = point.solarRad + randomInt(0, 100);
+	point.maxUV = point.uv;
+	point.forecast = 8;
+	point.recordType = 0;
+	return point;
+}
+
+std::string SyntheticStationData::makeVantagePro2ArchiveBatch(const std::vector<date::local_seconds>& times,
+	int archivePeriod)
+{
+	constexpr std::size_t recordSize = sizeof(VantagePro2ArchiveMessage::ArchiveDataPoint);
+	std::string batch(times.size() * recordSize + 2, '\0');
+	for (std::size_t i = 0 ; i < times.size() ; i++) {
+		auto point = makeVantagePro2ArchiveRecord(times[i], archivePeriod);
+		std::memcpy(batch.data() + i * recordSize, &point, recordSize);
+	}
+	VantagePro2Message::computeCRC(batch.data(), batch.size());
+	return batch;
+}
+
+std::string SyntheticStationData::makeVantagePro2LoopPackets()
+{
+	// both packets are 99 bytes long, CRC included
+	constexpr std::size_t packetSize = 99;
+	std::string l1(packetSize, '\0');
+	std::string l2(packetSize, '\0');
+	std::uint16_t barometer = randomInt(29500, 30500);
+	std::uint16_t outsideTemp = randomInt(300, 900);
+	std::uint8_t outsideHum = randomInt(40, 100);
+	std::uint8_t windSpeed = randomInt(0, 30);
+	std::uint16_t windDir = randomInt(1, 360);
+	for (std::string* l : {&l1, &l2}) {
+		l->replace(0, 3, "LOO");
+		put16(*l, 7, barometer);
+		put16(*l, 9, randomInt(600, 750));
+		(*l)[11] = randomInt(30, 60);
+		put16(*l, 12, outsideTemp);
+		(*l)[14] = windSpeed;
+		put16(*l, 16, windDir);
+		(*l)[33] = outsideHum;
+		put16(*l, 41, randomInt(0, 200));
+		(*l)[43] = randomInt(0, 80);
+		put16(*l, 44, randomInt(0, 900));
+		put16(*l, 50, randomInt(0, 100));
+		(*l)[95] = '\n';
+		(*l)[96] = '\r';
+	}
+	l1[4] = 0;
+	l2[4] = 1;
+	// the extra sensors are not connected
+	l1.replace(18, 15, 15, '\xFF');
+	l1.replace(34, 7, 7, '\xFF');
+	l1.replace(62, 8, 8, '\xFF');
+	// the dew point, heat index, wind chill and THSW index
+	put16(l2, 30, outsideTemp / 10 - 5);
+	put16(l2, 35, outsideTemp / 10);
+	put16(l2, 37, outsideTemp / 10);
+	put16(l2, 39, outsideTemp / 10);
+	VantagePro2Message::computeCRC(l1.data(), l1.size());
+	VantagePro2Message::computeCRC(l2.data(), l2.size());
+	return l1 + l2;
+}
+
+std::string SyntheticStationData::makeLsn50v2Payload()
+{
+	// battery, five ignored bytes, temperature, humidity
+	int temp = randomInt(-50, 350);
+	return hex(randomInt(3000, 3600), 4) + "0000010900" + hex(temp & 0xFFFF, 4) + hex(randomInt(300, 1000), 4);
+}
+
+std::string SyntheticStationData::makeThplnbiotDatagram(const std::string& imei, const std::string& hmacKey,
+	const date::sys_seconds& now)
+{
+	// header (the IMEI, the version, the battery, the signal strength
+	// and the mode), then seven records, ten minutes apart, the first one
+	// being skipped by the decoders
+	std::string message = "0" + imei + "0001" + hex(randomInt(3000, 3600), 4) + hex(randomInt(10, 31), 2) + "01";
+	auto timestamp = chrono::system_clock::to_time_t(now) - 6 * 600;
+	for (int i = 0 ; i < 7 ; i++) {
+		message += hex(randomInt(0, 300), 4)
+			+ hex(randomInt(400, 1000), 4)
+			+ hex(randomInt(9800, 10300), 4)
+			+ hex(randomInt(0, 60), 2)
+			+ hex(randomInt(0, 10), 2)
+			+ hex(randomInt(0, 359), 4)
+			+ hex(timestamp + i * 600, 8);
+	}
+	return unhexify(message + computeHMACWithSHA256(message, unhexify(hmacKey)));
+}
+
+}
@@ -0,0 +1,147 @@
+/**
+ * @file synthetic_station_data.h
+ * @brief Definition of the SyntheticStationData class
+ * @author Laurent Georget
+ * @date 2026-10-18
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SYNTHETIC_STATION_DATA_H
+#define SYNTHETIC_STATION_DATA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <date/date.h>
+
+#include "davis/vantagepro2_archive_message.h"
+
+namespace meteodata
+{
+
+/**
+ * @brief A generator of plausible, random, messages from the stations, in
+ * the formats the connectors expect, for the simulators used in the load
+ * tests
+ *
+ * The values are random but within the ranges of real measurements, so that
+ * the messages go through the whole decoding and storing path in Meteodata.
+ * The generator is seeded so that two runs with the same seed produce the
+ * same fleet and the same messages.
+ */
+class SyntheticStationData
+{
+public:
+	/**
+	 * @brief Construct the generator
+	 *
+	 * @param seed The seed of the pseudo-random number generator
+	 */
+	explicit SyntheticStationData(std::uint_fast32_t seed);
+
+	/**
+	 * @brief Draw a random integer, uniformly
+	 *
+	 * @param min The lower bound, included
+	 * @param max The upper bound, included
+	 */
+	int randomInt(int min, int max);
+
+	/**
+	 * @brief Tell whether an event of a given probability occurs
+	 *
+	 * @param probability The probability of the event, between 0 and 1
+	 */
+	bool happens(double probability);
+
+	/**
+	 * @brief Draw a random string of hexadecimal digits (lowercase)
+	 *
+	 * @param length The number of digits
+	 */
+	std::string randomHex(std::size_t length);
+
+	/**
+	 * @brief Draw a random (version 4) UUID, in its textual form
+	 */
+	std::string randomUuid();
+
+	/**
+	 * @brief Draw a random IMEI, 15 decimal digits
+	 */
+	std::string randomImei();
+
+	/**
+	 * @brief Build a VantagePro2 archive record
+	 *
+	 * @param time The time of the record, in the station local time
+	 * @param archivePeriod The archive period of the station, in minutes
+	 * @return The record, as the console stores it
+	 */
+	VantagePro2ArchiveMessage::ArchiveDataPoint makeVantagePro2ArchiveRecord(const date::local_seconds& time,
+		int archivePeriod);
+
+	/**
+	 * @brief Build a batch of VantagePro2 archive records, as published by
+	 * the MQTT gateways (the records followed by the CRC)
+	 *
+	 * @param times The times of the records, in the station local time
+	 * @param archivePeriod The archive period of the station, in minutes
+	 * @return The raw content of the MQTT message
+	 */
+	std::string makeVantagePro2ArchiveBatch(const std::vector<date::local_seconds>& times, int archivePeriod);
+
+	/**
+	 * @brief Build a LOOP packet followed by a LOOP2 packet, as sent by a
+	 * VantagePro2 console in answer to the "LPS 3 2" command
+	 *
+	 * @return The two packets, with their CRC
+	 */
+	std::string makeVantagePro2LoopPackets();
+
+	/**
+	 * @brief Build the hexadecimal payload of a Dragino LSN50v2 temperature
+	 * and humidity sensor, sent over LoRa
+	 */
+	std::string makeLsn50v2Payload();
+
+	/**
+	 * @brief Build the datagram of a Dragino NB-IoT temperature, humidity
+	 * and pressure sensor
+	 *
+	 * @param imei The IMEI of the sensor
+	 * @param hmacKey The HMAC key of the sensor, in hexadecimal
+	 * @param now The time of the last measurement, the datagram carries
+	 * the measurements of the last hour
+	 * @return The raw datagram
+	 */
+	std::string makeThplnbiotDatagram(const std::string& imei, const std::string& hmacKey, const date::sys_seconds& now);
+
+private:
+	/**
+	 * @brief The pseudo-random number generator
+	 */
+	std::minstd_rand _rng;
+};
+
+}
+
+#endif /* SYNTHETIC_STATION_DATA_H */
@@ -0,0 +1,886 @@
+/**
+ * @file vp2_console_emulator.cpp
+ * @brief Emulate VantagePro2 consoles connecting directly to Meteodata
+ * @author Laurent Georget
+ * @date 2026-10-18
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <csignal>
+#include <cstring>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include <sys/resource.h>
+
+#include <boost/asio.hpp>
+#include <boost/asio/coroutine.hpp>
+#include <boost/program_options.hpp>
+#include <date/date.h>
+
+#include "davis/vantagepro2_message.h"
+#include "davis/vantagepro2_archive_message.h"
+#include "time_offseter.h"
+#include "simulator/synthetic_station_data.h"
+#include "config.h"
+
+using namespace meteodata;
+namespace po = boost::program_options;
+namespace asio = boost::asio;
+namespace sys = boost::system;
+namespace chrono = std::chrono;
+using tcp = asio::ip::tcp;
+
+namespace
+{
+
+constexpr char ACK = '\x06';
+constexpr char NAK = '\x21';
+constexpr char CANCEL = '\x18';
+
+/**
+ * @brief The identity of an emulated console, as stored in its EEPROM and
+ * in the station table
+ */
+struct EmulatedStation
+{
+	std::string uuid;
+	std::string name;
+	int latitude; /*!< In tenths of degrees */
+	int longitude; /*!< In tenths of degrees */
+	int elevation; /*!< In meters */
+};
+
+/**
+ * @brief Generate the emulated consoles
+ *
+ * Meteodata identifies the consoles by their coordinates, truncated to the
+ * tenth of degree, and their elevation, so the consoles are laid out on a
+ * grid, the elevation growing by one meter every 10000 consoles.
+ */
+std::vector<EmulatedStation> generateConsoles(int count, SyntheticStationData& data)
+{
+	std::vector<EmulatedStation> consoles;
+	consoles.reserve(count);
+	for (int i = 0 ; i < count ; i++) {
+		EmulatedStation st;
+		st.uuid = data.randomUuid();
+		std::ostringstream name;
+		name << "sim-vp2-console-" << std::setw(6) << std::setfill('0') << i;
+		st.name = name.str();
+		int cell = i % 10000;
+		st.latitude = 425 + cell / 100;
+		st.longitude = -45 + cell % 100;
+		st.elevation = i / 10000;
+		consoles.push_back(std::move(st));
+	}
+	return consoles;
+}
+
+/**
+ * @brief Write the station table describing the consoles, to be loaded by
+ * Meteodata with the in-memory storage
+ *
+ * @see InMemoryObservationsStorage::loadStationTable()
+ */
+void writeStationTable(std::ostream& os, const std::vector<EmulatedStation>& consoles, int period)
+{
+	os << "# Generated by meteodata-vp2-console-emulator\n";
+	os << "# vp2-direct-connect: " << consoles.size() << " stations\n";
+	os << std::fixed << std::setprecision(1);
+	for (const EmulatedStation& st : consoles) {
+		os << "station\t" << st.uuid << "\t" << st.name << "\t" << period << "\t"
+		   << st.latitude / 10. << "\t" << st.longitude / 10. << "\t" << st.elevation << "\n";
+	}
+}
+
+/**
+ * @brief The behaviour of the consoles
+ */
+struct Parameters
+{
+	tcp::endpoint endpoint;
+	chrono::minutes period;
+	int archiveDepth; /*!< The number of records stored in each console */
+	chrono::milliseconds latency;
+	chrono::milliseconds jitter;
+	double dropRate;
+	double badCrcRate;
+	double stallRate;
+	double disconnectRate;
+	chrono::seconds clockDrift;
+	chrono::seconds reconnectDelay;
+	bool loop;
+};
+
+/**
+ * @brief The activity of all the consoles
+ */
+struct Statistics
+{
+	std::uint64_t connections = 0;
+	std::uint64_t connectionFailures = 0;
+	std::uint64_t disconnections = 0;
+	std::uint64_t commands = 0;
+	std::uint64_t unknownCommands = 0;
+	std::uint64_t downloads = 0;
+	std::uint64_t abortedDownloads = 0;
+	std::uint64_t pagesSent = 0;
+	std::uint64_t pagesResent = 0;
+	std::uint64_t recordsSent = 0;
+	std::uint64_t clockSettings = 0;
+	std::uint64_t loops = 0;
+	std::uint64_t stalls = 0;
+	std::uint64_t droppedBytes = 0;
+	std::uint64_t badCrcs = 0;
+	std::uint64_t injectedDisconnections = 0;
+};
+
+/**
+ * @brief The parameters of the DMPAFT command
+ */
+struct ArchiveRequestParams
+{
+	uint16_t date; /*!< | year - 2000 (7 bits) | month (4 bits) | day (5 bits) | */
+	uint16_t time; /*!< hours * 100 + minutes */
+	uint16_t crc;
+} __attribute__((packed));
+
+/**
+ * @brief The parameters of the SETTIME command
+ */
+struct SettimeRequestParams
+{
+	uint8_t seconds;
+	uint8_t minutes;
+	uint8_t hours;
+	uint8_t day;
+	uint8_t month;
+	uint8_t year; /*!< The year - 1900 */
+	uint16_t crc;
+} __attribute__((packed));
+
+/**
+ * @brief The answer to the DMPAFT command
+ */
+struct ArchiveSizeBuffer
+{
+	uint16_t pagesLeft;
+	uint16_t index;
+	uint16_t crc;
+} __attribute__((packed));
+
+/**
+ * @brief One page of archive, as sent after a DMPAFT command
+ */
+struct ArchivePage
+{
+	uint8_t sequenceNumber;
+	VantagePro2ArchiveMessage::ArchiveDataPoint points[5];
+	uint8_t unused[4];
+	uint16_t crc;
+} __attribute__((packed));
+
+/**
+ * @brief The coordinates stored in the EEPROM, as read by "EEBRD 0B 06"
+ */
+struct CoordinatesAnswer
+{
+	int16_t latitude;
+	int16_t longitude;
+	int16_t elevation;
+	uint16_t crc;
+} __attribute__((packed));
+
+/**
+ * @brief The time configuration stored in the EEPROM, as read by "EEBRD 11 06"
+ */
+struct TimezoneAnswer
+{
+	TimeOffseter::VantagePro2TimezoneBuffer timezone;
+	uint16_t crc;
+} __attribute__((packed));
+
+/**
+ * @brief The clock of the console, as read by GETTIME
+ */
+struct GettimeAnswer
+{
+	uint8_t seconds;
+	uint8_t minutes;
+	uint8_t hours;
+	uint8_t day;
+	uint8_t month;
+	uint8_t year; /*!< The year - 1900 */
+	uint16_t crc;
+} __attribute__((packed));
+
+template<typename T>
+std::string toBytes(T& data)
+{
+	VantagePro2Message::computeCRC(&data, sizeof(T));
+	return std::string(reinterpret_cast<const char*>(&data), sizeof(T));
+}
+
+/**
+ * @brief An emulated VantagePro2 console, connected to Meteodata through a
+ * serial-to-IP bridge
+ *
+ * The console connects to Meteodata and answers its commands, as described in
+ * the Davis serial communication reference manual, with the subset of the
+ * protocol used by the VantagePro2Connector: the wake-up, the EEPROM reads of
+ * the coordinates and of the time zone, RXTEST, DMPAFT, SETTIME, GETTIME and
+ * LPS. The archive is generated on the fly, a record every archive period, up
+ * to the console clock. The console clock is the UTC time, off by a random
+ * drift until Meteodata sets it.
+ *
+ * Faults can be injected in the answers: a delay before answering, no answer
+ * at all (a stall), a byte lost, a corrupted CRC, or the connection dropped.
+ * After a disconnection, the console reconnects after a delay, as the bridges
+ * do.
+ */
+class EmulatedConsole : public std::enable_shared_from_this<EmulatedConsole>
+{
+public:
+	EmulatedConsole(asio::io_context& ioContext, const EmulatedStation& station, const Parameters& parameters,
+		Statistics& statistics, std::uint_fast32_t seed) :
+		_station{station},
+		_parameters{parameters},
+		_statistics{statistics},
+		_data{seed},
+		_socket{ioContext},
+		_timer{ioContext},
+		_clockOffset{_data.randomInt(-_parameters.clockDrift.count(), _parameters.clockDrift.count())}
+	{
+	}
+
+	void start(chrono::steady_clock::duration delay)
+	{
+		_timer.expires_after(delay);
+		_timer.async_wait([this, self = shared_from_this()](const sys::error_code& ec) {
+			if (ec != sys::errc::operation_canceled)
+				run();
+		});
+	}
+
+	void stop()
+	{
+		_stopped = true;
+		sys::error_code ignored;
+		_socket.close(ignored);
+		_timer.cancel();
+	}
+
+private:
+	const EmulatedStation& _station;
+	const Parameters& _parameters;
+	Statistics& _statistics;
+	SyntheticStationData _data;
+	tcp::socket _socket;
+	asio::steady_timer _timer;
+	asio::streambuf _input;
+	std::string _output;
+	std::string _command;
+	std::string _page;
+	asio::coroutine _coro;
+	bool _stopped = false;
+
+	/**
+	 * @brief The difference between the console clock and the UTC time
+	 */
+	chrono::seconds _clockOffset;
+
+	/**
+	 * @brief The archive download in progress: the records are numbered
+	 * from the epoch, five per page
+	 */
+	std::int64_t _oldestRecord = 0;
+	std::int64_t _newestRecord = 0;
+	std::int64_t _firstRecord = 0;
+	std::int64_t _currentPage = 0;
+	std::int64_t _lastPage = 0;
+
+	date::local_seconds consoleTime() const
+	{
+		auto now = date::floor<chrono::seconds>(chrono::system_clock::now()) + _clockOffset;
+		return date::local_seconds{now.time_since_epoch()};
+	}
+
+	auto resume()
+	{
+		return [this, self = shared_from_this()](const sys::error_code& ec, std::size_t = 0) {
+			run(ec);
+		};
+	}
+
+	void connect()
+	{
+		_input.consume(_input.size());
+		_socket.async_connect(_parameters.endpoint, resume());
+	}
+
+	void waitBeforeReconnecting()
+	{
+		_timer.expires_after(_parameters.reconnectDelay);
+		_timer.async_wait(resume());
+	}
+
+	void readCommand()
+	{
+		asio::async_read_until(_socket, _input, '\n', resume());
+	}
+
+	void extractCommand()
+	{
+		std::istream is{&_input};
+		std::getline(is, _command);
+		if (!_command.empty() && _command.back() == '\r')
+			_command.pop_back();
+		_statistics.commands++;
+	}
+
+	void readBytes(std::size_t n)
+	{
+		if (_input.size() >= n) {
+			asio::post(_socket.get_executor(), [this, self = shared_from_this()]() { run(); });
+		} else {
+			asio::async_read(_socket, _input, asio::transfer_exactly(n - _input.size()), resume());
+		}
+	}
+
+	template<typename T>
+	bool extractBytes(T& data)
+	{
+		std::memcpy(&data, _input.data().data(), sizeof(T));
+		_input.consume(sizeof(T));
+		return VantagePro2Message::validateCRC(&data, sizeof(T));
+	}
+
+	char extractByte()
+	{
+		char c = *static_cast<const char*>(_input.data().data());
+		_input.consume(1);
+		return c;
+	}
+
+	/**
+	 * @brief Send an answer, after the latency, and with the faults
+	 * injected
+	 *
+	 * @param data The answer
+	 * @param hasCrc Whether the answer ends with a CRC
+	 */
+	void answer(std::string data, bool hasCrc = false)
+	{
+		if (_data.happens(_parameters.disconnectRate)) {
+			_statistics.injectedDisconnections++;
+			sys::error_code ignored;
+			_socket.close(ignored);
+			asio::post(_socket.get_executor(), [this, self = shared_from_this()]() {
+				run(asio::error::connection_aborted);
+			});
+			return;
+		}
+
+		if (_data.happens(_parameters.stallRate)) {
+			// the console does not answer, meteodata will time out
+			// and send its command again
+			_statistics.stalls++;
+			asio::post(_socket.get_executor(), [this, self = shared_from_this()]() { run(); });
+			return;
+		}
+
+		if (hasCrc && _data.happens(_parameters.badCrcRate)) {
+			_statistics.badCrcs++;
+			data.back() ^= 0x5A;
+		}
+		if (data.size() > 1 && _data.happens(_parameters.dropRate)) {
+			_statistics.droppedBytes++;
+			data.erase(_data.randomInt(0, data.size() - 1), 1);
+		}
+		_output = std::move(data);
+
+		auto delay = _parameters.latency;
+		if (_parameters.jitter.count() > 0)
+			delay += chrono::milliseconds{_data.randomInt(0, _parameters.jitter.count())};
+		if (delay.count() == 0) {
+			asio::async_write(_socket, asio::buffer(_output), resume());
+			return;
+		}
+		_timer.expires_after(delay);
+		_timer.async_wait([this, self = shared_from_this()](const sys::error_code& ec) {
+			if (ec)
+				run(ec);
+			else
+				asio::async_write(_socket, asio::buffer(_output), resume());
+		});
+	}
+
+	std::string makeCoordinates()
+	{
+		CoordinatesAnswer coords{};
+		coords.latitude = _station.latitude;
+		coords.longitude = _station.longitude;
+		coords.elevation = _station.elevation;
+		return std::string(1, ACK) + toBytes(coords);
+	}
+
+	std::string makeTimezone()
+	{
+		// the consoles are set to UTC
+		TimezoneAnswer tz{};
+		tz.timezone.gmtOrZone = 1;
+		tz.timezone.gmtOffset = 0;
+		return std::string(1, ACK) + toBytes(tz);
+	}
+
+	std::string makeTime()
+	{
+		auto now = consoleTime();
+		auto day = date::floor<date::days>(now);
+		date::year_month_day ymd{day};
+		date::hh_mm_ss<chrono::seconds> tod{now - day};
+		GettimeAnswer time{};
+		time.seconds = tod.seconds().count();
+		time.minutes = tod.minutes().count();
+		time.hours = tod.hours().count();
+		time.day = unsigned(ymd.day());
+		time.month = unsigned(ymd.month());
+		time.year = int(ymd.year()) - 1900;
+		return std::string(1, ACK) + toBytes(time);
+	}
+
+	void setTime(const SettimeRequestParams& params)
+	{
+		date::year_month_day ymd{date::year{params.year + 1900}, date::month{params.month}, date::day{params.day}};
+		if (!ymd.ok())
+			return;
+		auto requested = date::local_days{ymd} + chrono::hours{params.hours} +
+			chrono::minutes{params.minutes} + chrono::seconds{params.seconds};
+		auto now = date::floor<chrono::seconds>(chrono::system_clock::now());
+		_clockOffset = requested.time_since_epoch() - now.time_since_epoch();
+		_statistics.clockSettings++;
+	}
+
+	/**
+	 * @brief Prepare the archive download requested by DMPAFT
+	 *
+	 * @return The answer to the request
+	 */
+	std::string prepareDownload(const ArchiveRequestParams& params)
+	{
+		auto period = chrono::duration_cast<chrono::seconds>(_parameters.period);
+		_newestRecord = consoleTime().time_since_epoch() / period;
+		_oldestRecord = _newestRecord - _parameters.archiveDepth + 1;
+
+		// the whole archive is sent if the timestamp is not valid
+		_firstRecord = _oldestRecord;
+		date::year_month_day ymd{date::year{(params.date >> 9) + 2000},
+			date::month{(params.date >> 5) & 0xFU}, date::day{params.date & 0x1FU}};
+		if (ymd.ok()) {
+			auto requested = date::local_days{ymd} + chrono::hours{params.time / 100} + chrono::minutes{params.time % 100};
+			_firstRecord = std::max<std::int64_t>(_oldestRecord, requested.time_since_epoch() / period + 1);
+		}
+
+		ArchiveSizeBuffer size{};
+		if (_firstRecord <= _newestRecord) {
+			_currentPage = _firstRecord / 5;
+			_lastPage = _newestRecord / 5;
+			size.pagesLeft = _lastPage - _currentPage + 1;
+			size.index = _firstRecord % 5;
+		} else {
+			_currentPage = 1;
+			_lastPage = 0;
+		}
+		return std::string(1, ACK) + toBytes(size);
+	}
+
+	std::string makeArchivePage()
+	{
+		ArchivePage page{};
+		page.sequenceNumber = _currentPage % 256;
+		for (int i = 0 ; i < 5 ; i++) {
+			std::int64_t record = _currentPage * 5 + i;
+			if (record < _oldestRecord || record > _newestRecord) {
+				// a dash record, the archive is not full
+				std::memset(&page.points[i], 0xFF, sizeof(page.points[i]));
+			} else {
+				date::local_seconds time{chrono::duration_cast<chrono::seconds>(_parameters.period) * record};
+				page.points[i] = _data.makeVantagePro2ArchiveRecord(time, _parameters.period.count());
+				if (record >= _firstRecord)
+					_statistics.recordsSent++;
+			}
+		}
+		return toBytes(page);
+	}
+
+	void run(sys::error_code ec = {})
+	{
+		if (_stopped)
+			return;
+
+		BOOST_ASIO_CORO_REENTER(_coro) {
+			for (;;) {
+				BOOST_ASIO_CORO_YIELD connect();
+				if (ec) {
+					_statistics.connectionFailures++;
+				} else {
+					_statistics.connections++;
+					for (;;) {
+						BOOST_ASIO_CORO_YIELD readCommand();
+						if (ec)
+							break;
+						extractCommand();
+
+						if (_command.empty()) {
+							// the wake-up
+							BOOST_ASIO_CORO_YIELD answer("\n\r");
+						} else if (_command == "EEBRD 0B 06") {
+							BOOST_ASIO_CORO_YIELD answer(makeCoordinates(), true);
+						} else if (_command == "RXTEST") {
+							BOOST_ASIO_CORO_YIELD answer("\n\rOK\n\r");
+						} else if (_command == "EEBRD 11 06") {
+							BOOST_ASIO_CORO_YIELD answer(makeTimezone(), true);
+						} else if (_command == "GETTIME") {
+							BOOST_ASIO_CORO_YIELD answer(makeTime(), true);
+						} else if (_command == "SETTIME") {
+							BOOST_ASIO_CORO_YIELD answer(std::string(1, ACK));
+							if (ec)
+								break;
+							BOOST_ASIO_CORO_YIELD readBytes(sizeof(SettimeRequestParams));
+							if (ec)
+								break;
+							{
+								SettimeRequestParams params;
+								if (extractBytes(params)) {
+									setTime(params);
+									_output = std::string(1, ACK);
+								} else {
+									_output = std::string(1, CANCEL);
+								}
+							}
+							BOOST_ASIO_CORO_YIELD answer(_output);
+						} else if (_command == "DMPAFT") {
+							BOOST_ASIO_CORO_YIELD answer(std::string(1, ACK));
+							if (ec)
+								break;
+							BOOST_ASIO_CORO_YIELD readBytes(sizeof(ArchiveRequestParams));
+							if (ec)
+								break;
+							{
+								ArchiveRequestParams params;
+								if (extractBytes(params))
+									_output = prepareDownload(params);
+								else
+									_output = std::string(1, CANCEL);
+							}
+							if (_output.size() == 1) {
+								BOOST_ASIO_CORO_YIELD answer(_output);
+								continue;
+							}
+							BOOST_ASIO_CORO_YIELD answer(_output, true);
+							if (ec)
+								break;
+							BOOST_ASIO_CORO_YIELD readBytes(1);
+							if (ec)
+								break;
+							if (extractByte() != ACK) {
+								// ESC, meteodata could not validate the size
+								_statistics.abortedDownloads++;
+								continue;
+							}
+
+							_statistics.downloads++;
+							while (_currentPage <= _lastPage) {
+								_page = makeArchivePage();
+								do {
+									BOOST_ASIO_CORO_YIELD answer(_page, true);
+									if (ec)
+										break;
+									_statistics.pagesSent++;
+									BOOST_ASIO_CORO_YIELD readBytes(1);
+									if (ec)
+										break;
+									_output = std::string(1, extractByte());
+									if (_output[0] == NAK)
+										_statistics.pagesResent++;
+								} while (_output[0] == NAK);
+								if (ec || _output[0] != ACK)
+									break;
+								_currentPage++;
+							}
+							if (ec)
+								break;
+							if (_currentPage <= _lastPage)
+								_statistics.abortedDownloads++;
+						} else if (_command == "LPS 3 2") {
+							if (_parameters.loop) {
+								_statistics.loops++;
+								BOOST_ASIO_CORO_YIELD answer(std::string(1, ACK) + _data.makeVantagePro2LoopPackets(), true);
+							} else {
+								BOOST_ASIO_CORO_YIELD answer(std::string(1, NAK));
+							}
+						} else {
+							_statistics.unknownCommands++;
+							BOOST_ASIO_CORO_YIELD answer(std::string(1, NAK));
+						}
+						if (ec)
+							break;
+					}
+					_statistics.disconnections++;
+				}
+
+				{
+					sys::error_code ignored;
+					_socket.close(ignored);
+				}
+				BOOST_ASIO_CORO_YIELD waitBeforeReconnecting();
+				if (ec)
+					return;
+			}
+		}
+	}
+};
+
+/**
+ * @brief The emulation of all the consoles, started evenly over the ramp-up
+ * duration
+ */
+class Emulation
+{
+public:
+	Emulation(asio::io_context& ioContext, const std::vector<EmulatedStation>& stations, const Parameters& parameters,
+		std::uint_fast32_t seed) :
+		_timer{ioContext},
+		_signals{ioContext, SIGINT, SIGTERM}
+	{
+		_consoles.reserve(stations.size());
+		for (std::size_t i = 0 ; i < stations.size() ; i++)
+			_consoles.push_back(std::make_shared<EmulatedConsole>(ioContext, stations[i], parameters, _statistics, seed + i));
+		_signals.async_wait([this](const sys::error_code& ec, int) {
+			if (ec != sys::errc::operation_canceled)
+				stop();
+		});
+	}
+
+	void start(chrono::seconds rampUp, chrono::seconds duration)
+	{
+		_start = chrono::steady_clock::now();
+		auto ramp = chrono::duration_cast<chrono::steady_clock::duration>(rampUp);
+		for (std::size_t i = 0 ; i < _consoles.size() ; i++)
+			_consoles[i]->start(ramp * static_cast<long>(i) / static_cast<long>(_consoles.size()));
+
+		if (duration.count() > 0) {
+			_timer.expires_after(duration);
+			_timer.async_wait([this](const sys::error_code& ec) {
+				if (ec != sys::errc::operation_canceled)
+					stop();
+			});
+		}
+	}
+
+	void stop()
+	{
+		if (_stopped)
+			return;
+		_stopped = true;
+		_timer.cancel();
+		_signals.cancel();
+		for (auto&& console : _consoles)
+			console->stop();
+	}
+
+	void report(std::ostream& os) const
+	{
+		auto elapsed = chrono::duration<double>(chrono::steady_clock::now() - _start).count();
+		os << "Emulated " << _consoles.size() << " consoles for "
+		   << std::fixed << std::setprecision(3) << elapsed << "s\n"
+		   << "  connections: " << _statistics.connections << ", failed: " << _statistics.connectionFailures
+		   << ", closed: " << _statistics.disconnections << "\n"
+		   << "  commands: " << _statistics.commands << ", unknown: " << _statistics.unknownCommands << "\n"
+		   << "  archive downloads: " << _statistics.downloads << ", aborted: " << _statistics.abortedDownloads
+		   << ", pages: " << _statistics.pagesSent << ", pages sent again: " << _statistics.pagesResent
+		   << ", records: " << _statistics.recordsSent
+		   << " (" << (elapsed > 0 ? _statistics.recordsSent / elapsed : 0.) << " records/s)\n"
+		   << "  clock settings: " << _statistics.clockSettings << ", LOOP packets: " << _statistics.loops << "\n"
+		   << "  faults injected: " << _statistics.stalls << " stalls, " << _statistics.droppedBytes << " dropped bytes, "
+		   << _statistics.badCrcs << " bad CRCs, " << _statistics.injectedDisconnections << " disconnections\n";
+	}
+
+private:
+	asio::steady_timer _timer;
+	asio::signal_set _signals;
+	Statistics _statistics;
+	std::vector<std::shared_ptr<EmulatedConsole>> _consoles;
+	chrono::steady_clock::time_point _start;
+	bool _stopped = false;
+};
+
+/**
+ * @brief Raise the limit on the number of open files as much as possible,
+ * each console uses a socket
+ */
+void raiseFileLimit(std::size_t needed)
+{
+	struct rlimit limit;
+	if (getrlimit(RLIMIT_NOFILE, &limit) != 0)
+		return;
+	if (limit.rlim_cur < limit.rlim_max) {
+		limit.rlim_cur = limit.rlim_max;
+		setrlimit(RLIMIT_NOFILE, &limit);
+	}
+	if (limit.rlim_cur != RLIM_INFINITY && limit.rlim_cur < needed + 16)
+		std::cerr << "Warning: only " << limit.rlim_cur << " files can be opened, "
+			  << "not enough for all the consoles (see ulimit -n)" << std::endl;
+}
+
+}
+
+/**
+ * @brief Entry point
+ *
+ * @param argc the number of arguments passed on the command line
+ * @param argv the arguments passed on the command line
+ *
+ * @return 0 if everything went well, and either an "errno-style" error code
+ * or 255 otherwise
+ */
+int main(int argc, char** argv)
+{
+	int count;
+	int period;
+	unsigned int seed;
+	std::string stationTable;
+	std::string host;
+	int port;
+	int archiveDepth;
+	unsigned long latency;
+	unsigned long jitter;
+	double dropRate;
+	double badCrcRate;
+	double stallRate;
+	double disconnectRate;
+	unsigned long clockDrift;
+	unsigned long reconnectDelay;
+	unsigned long rampUp;
+	unsigned long duration;
+
+	po::options_description desc("Allowed options");
+	desc.add_options()
+		("help", "display the help message and exit")
+		("version", "display the version of Meteodata and exit")
+		("consoles", po::value<int>(&count)->default_value(1), "the number of consoles to emulate")
+		("period", po::value<int>(&period)->default_value(10), "the archive period of the consoles, in minutes")
+		("archive-depth", po::value<int>(&archiveDepth)->default_value(2560), "the number of archive records stored in each console, 2560 for a full VantagePro2 archive")
+		("seed", po::value<unsigned int>(&seed)->default_value(1), "the seed of the generator of the consoles and of their measurements, the same seed and the same number of consoles give the same stations")
+		("station-table", po::value<std::string>(&stationTable), "the file to write the station table to, to start meteodata with --storage memory --station-table <file>")
+		("generate-only", "write the station table and exit without emulating the consoles")
+		("host", po::value<std::string>(&host)->default_value("localhost"), "the host running meteodata")
+		("port", po::value<int>(&port)->default_value(5886), "the port of the meteodata VantagePro2 connector")
+		("latency", po::value<unsigned long>(&latency)->default_value(0), "the delay, in milliseconds, before each answer of the consoles")
+		("jitter", po::value<unsigned long>(&jitter)->default_value(0), "the maximum random delay, in milliseconds, added to the latency")
+		("drop-rate", po::value<double>(&dropRate)->default_value(0.), "the proportion of answers losing a byte, between 0 and 1")
+		("bad-crc-rate", po::value<double>(&badCrcRate)->default_value(0.), "the proportion of answers with a corrupted CRC, between 0 and 1")
+		("stall-rate", po::value<double>(&stallRate)->default_value(0.), "the proportion of commands left unanswered, between 0 and 1")
+		("disconnect-rate", po::value<double>(&disconnectRate)->default_value(0.), "the proportion of commands upon which the console disconnects, between 0 and 1")
+		("clock-drift", po::value<unsigned long>(&clockDrift)->default_value(0), "the maximum offset, in seconds, of the console clocks, until meteodata sets them")
+		("reconnect-delay", po::value<unsigned long>(&reconnectDelay)->default_value(10), "the delay, in seconds, before a console reconnects")
+		("no-loop", "make the consoles refuse the LPS command, as the consoles too old for LOOP2 packets")
+		("ramp-up", po::value<unsigned long>(&rampUp)->default_value(0), "the duration, in seconds, over which the consoles connect")
+		("duration", po::value<unsigned long>(&duration)->default_value(0), "the duration of the emulation in seconds, 0 to run until interrupted")
+	;
+
+	po::variables_map vm;
+	po::store(po::parse_command_line(argc, argv, desc), vm);
+	po::notify(vm);
+
+	if (vm.count("help")) {
+		std::cout << PACKAGE_STRING"\n";
+		std::cout << "Usage: " << argv[0] << " [--consoles N] [--station-table file] [--host host] [--port port]\n";
+		std::cout << desc << "\n";
+		return 0;
+	}
+
+	if (vm.count("version")) {
+		std::cout << VERSION << std::endl;
+		return 0;
+	}
+
+	if (count < 0 || period <= 0 || archiveDepth <= 0) {
+		std::cerr << "The number of consoles cannot be negative and the period and the archive depth must be positive, aborting" << std::endl;
+		return 1;
+	}
+
+	for (double rate : {dropRate, badCrcRate, stallRate, disconnectRate}) {
+		if (rate < 0 || rate > 1) {
+			std::cerr << "The fault rates must be between 0 and 1, aborting" << std::endl;
+			return 1;
+		}
+	}
+
+	try {
+		SyntheticStationData stationsData{seed};
+		std::vector<EmulatedStation> stations = generateConsoles(count, stationsData);
+
+		if (!stationTable.empty()) {
+			std::ofstream os{stationTable};
+			if (!os)
+				throw std::runtime_error("Cannot open the station table " + stationTable);
+			writeStationTable(os, stations, period);
+			std::cerr << "Station table for " << stations.size() << " stations written to " << stationTable << std::endl;
+		}
+
+		if (vm.count("generate-only"))
+			return 0;
+
+		if (stations.empty()) {
+			std::cerr << "No console to emulate, aborting" << std::endl;
+			return 1;
+		}
+
+		raiseFileLimit(stations.size());
+
+		asio::io_context ioContext;
+		tcp::resolver resolver{ioContext};
+		Parameters parameters{
+			*resolver.resolve(host, std::to_string(port)).begin(),
+			chrono::minutes{period}, archiveDepth,
+			chrono::milliseconds{latency}, chrono::milliseconds{jitter},
+			dropRate, badCrcRate, stallRate, disconnectRate,
+			chrono::seconds{clockDrift}, chrono::seconds{reconnectDelay},
+			vm.count("no-loop") == 0
+		};
+
+		// the measurements do not depend on the number of consoles
+		Emulation emulation{ioContext, stations, parameters, seed + 1};
+		emulation.start(chrono::seconds{rampUp}, chrono::seconds{duration});
+		ioContext.run();
+		emulation.report(std::cout);
+	} catch (const std::exception& e) {
+		std::cerr << "Emulation aborted: " << e.what() << std::endl;
+		return 1;
+	}
+}
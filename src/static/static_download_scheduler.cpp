@@ -24,11 +24,12 @@
 #include <iostream>
 #include <chrono>
 #include <thread>
+#include <optional>
 
 #include <systemd/sd-daemon.h>
 #include <cassandra.h>
-#include <cassobs/dbconnection_observations.h>
 
+#include "storage/observations_storage.h"
 #include "async_job_publisher.h"
 #include "time_offseter.h"
 #include "abstract_download_scheduler.h"
@@ -41,21 +42,15 @@ namespace meteodata
 {
 using namespace date;
 
-StatICDownloadScheduler::StatICDownloadScheduler(asio::io_context& ioContext, DbConnectionObservations& db):
-		AbstractDownloadScheduler{chrono::minutes{POLLING_PERIOD}, ioContext, db}
+StatICDownloadScheduler::StatICDownloadScheduler(asio::io_context& ioContext, ObservationsStorage& db):
+		AbstractDownloadScheduler{chrono::minutes{POLLING_PERIOD}, ioContext, db, "static"}
 {
 }
 
-void
-StatICDownloadScheduler::add(
-	const CassUuid& station, const std::string& host, const std::string& url,
-	bool https, int timezone, const std::map<std::string, std::string>& sensors
-) {
-	std::lock_guard<std::recursive_mutex> lock{_downloadersMutex};
-
-	_downloaders.emplace_back(
-		std::make_shared<StatICTxtDownloader>(_db, station, host, url, https, timezone, sensors)
-	);
+std::shared_ptr<StatICTxtDownloader> StatICDownloadScheduler::makeDownloader(const StationDetails& details)
+{
+	return std::make_shared<StatICTxtDownloader>(_db, std::get<0>(details), std::get<1>(details),
+		std::get<2>(details), std::get<3>(details), std::get<4>(details), std::get<5>(details));
 }
 
 void StatICDownloadScheduler::download()
@@ -68,6 +63,7 @@ void StatICDownloadScheduler::download()
 		if (_mustStop)
 			break;
 		try {
+			IngestionTrace trace{_tracePath};
 			_downloader->ingest();
 		} catch (const std::runtime_error& e) {
 			std::cerr << SD_ERR << "[StatIC] protocol: " << "Runtime error, impossible to download " << e.what()
@@ -78,15 +74,17 @@ void StatICDownloadScheduler::download()
 
 void StatICDownloadScheduler::reloadStations()
 {
-	std::lock_guard<std::recursive_mutex> lock{_downloadersMutex};
-	_downloaders.clear();
-
-	std::vector<std::tuple<CassUuid, std::string, std::string, bool, int, std::map<std::string, std::string>>> statICTxtStations;
+	std::vector<StationDetails> statICTxtStations;
 	_db.getStatICTxtStations(statICTxtStations);
-	for (const auto& station : statICTxtStations) {
-		add(std::get<0>(station), std::get<1>(station), std::get<2>(station),
-		    std::get<3>(station), std::get<4>(station), std::get<5>(station));
-	}
+
+	std::lock_guard<std::recursive_mutex> lock{_downloadersMutex};
+	ReloadSummary summary = _downloaders.reconcile(std::move(statICTxtStations),
+		[this](const StationDetails& station) -> std::optional<std::shared_ptr<StatICTxtDownloader>> {
+			if (!ownsStation(std::get<0>(station)))
+				return std::nullopt;
+			return makeDownloader(station);
+		});
+	std::cerr << SD_INFO << "[StatIC] management: " << "Stations reloaded: " << summary << std::endl;
 }
 
 }
@@ -30,18 +30,20 @@
 #include <chrono>
 #include <map>
 #include <mutex>
+#include <tuple>
 
 #include <boost/system/error_code.hpp>
 #include <boost/asio/ssl.hpp>
 #include <boost/asio.hpp>
 #include <boost/asio/basic_waitable_timer.hpp>
 #include <cassandra.h>
-#include <cassobs/dbconnection_observations.h>
 
+#include "storage/observations_storage.h"
 #include "time_offseter.h"
 #include "curl_wrapper.h"
 #include "abstract_download_scheduler.h"
 #include "static/static_txt_downloader.h"
+#include "downloader_set.h"
 
 namespace meteodata
 {
@@ -68,26 +70,27 @@ public:
 	 * @param db the MétéoData observations database connector
 	 * @param jobPublisher the asynchronous job scheduler
 	 */
-	StatICDownloadScheduler(asio::io_context& ioContext, DbConnectionObservations& db);
+	StatICDownloadScheduler(asio::io_context& ioContext, ObservationsStorage& db);
 
+private:
 	/**
-	 * @brief Add a station to download the data for
+	 * @brief The configuration of a station: its UUID, host, URL, whether
+	 * to use HTTPS, its timezone and its sensors
+	 */
+	using StationDetails = std::tuple<CassUuid, std::string, std::string, bool, int, std::map<std::string, std::string>>;
+
+	/**
+	 * @brief Build the downloader of a station
 	 *
-	 * @param station The station Météodata UUID
-	 * @param fieldClimateId The Static API id
-	 * @param tz The station's local timezone
-	 * @param sensors All the sensors registered for that station (see the
-	 * StaticApiDownloader class for details)
+	 * @param details The configuration of the station
+	 * @return The new downloader
 	 */
-	void add(const CassUuid& station, const std::string& host, const std::string& url,
-			 bool https, int timezone,
-			 const std::map<std::string, std::string>& sensors);
+	std::shared_ptr<StatICTxtDownloader> makeDownloader(const StationDetails& details);
 
-private:
 	/**
 	 * @brief The list of all downloaders (one per station)
 	 */
-	std::vector<std::shared_ptr<StatICTxtDownloader>> _downloaders;
+	DownloaderSet<StationDetails, std::shared_ptr<StatICTxtDownloader>> _downloaders;
 
 	/**
 	 * @brief The mutex protecting the downloaders list
@@ -96,7 +99,7 @@ private:
 
 	/**
 	 * @brief Reload the list of StatIC stations from the database and
-	 * recreate all downloaders
+	 * update the downloaders of the stations that have changed
 	 */
 	void reloadStations() override;
 
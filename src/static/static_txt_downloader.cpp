@@ -28,14 +28,15 @@
 #include <systemd/sd-daemon.h>
 
 #include <date/date.h>
-#include <cassobs/dbconnection_observations.h>
 #include <cassobs/dto/download.h>
 
+#include "storage/observations_storage.h"
 #include "time_offseter.h"
 #include "curl_wrapper.h"
 #include "cassandra_utils.h"
 #include "static/static_txt_downloader.h"
 #include "static/static_message.h"
+#include "monitoring/ingestion_trace.h"
 
 namespace asio = boost::asio;
 namespace sys = boost::system;
@@ -49,7 +50,7 @@ using namespace date;
 
 const std::string StatICTxtDownloader::DOWNLOAD_CONNECTOR_ID = "static";
 
-StatICTxtDownloader::StatICTxtDownloader(DbConnectionObservations& db,
+StatICTxtDownloader::StatICTxtDownloader(ObservationsStorage& db,
 	CassUuid station, const std::string& host,
 	const std::string& url, bool https, int timezone,
 	std::map<std::string, std::string> sensors) :
@@ -80,7 +81,7 @@ StatICTxtDownloader::StatICTxtDownloader(DbConnectionObservations& db,
 	_query = query.str();
 }
 
-void StatICTxtDownloader::downloadOnly(DbConnectionObservations& db, CurlWrapper& client, const CassUuid& station,
+void StatICTxtDownloader::downloadOnly(ObservationsStorage& db, CurlWrapper& client, const CassUuid& station,
 		const std::string& host, const std::string& url, bool https)
 {
 	std::ostringstream queryStr;
@@ -115,8 +116,10 @@ void StatICTxtDownloader::downloadOnly(DbConnectionObservations& db, CurlWrapper
 
 void StatICTxtDownloader::ingest()
 {
+	IngestionTrace::setCurrentStation(_station);
 	std::vector<Download> downloads;
 	_db.selectDownloadsByStation(_station, DOWNLOAD_CONNECTOR_ID, downloads);
+	IngestionTrace::markCurrent(IngestionTrace::Stage::RECEIVED);
 
 	if (downloads.empty()) {
 		std::cout << SD_WARNING << "[StatIC " << _station << "] measurement: "
@@ -136,6 +139,7 @@ void StatICTxtDownloader::ingest()
 		} else {
 			_db.updateDownloadStatus(d.station, chrono::system_clock::to_time_t(d.datetime), true, "completed");
 		}
+		IngestionTrace::markCurrent(IngestionTrace::Stage::STORED);
 	}
 }
 
@@ -171,6 +175,7 @@ bool StatICTxtDownloader::doProcess(const std::string& body)
 	}
 
 	auto o = m.getObservation(_station);
+	IngestionTrace::markCurrent(IngestionTrace::Stage::DECODED);
 	bool ret = _db.insertV2DataPoint(o) &&
 		   _db.insertV2DataPointInTimescaleDB(o);
 	if (ret) {
@@ -186,6 +191,7 @@ bool StatICTxtDownloader::doProcess(const std::string& body)
 		std::cerr << SD_ERR << "[StatIC " << _station << "] measurement: "
 			  << "Failed to update the last insertion time of station " << _station << std::endl;
 	}
+	IngestionTrace::markCurrent(IngestionTrace::Stage::STORED);
 
 	std::optional<float> newDayRain = m.getDayRainfall();
 	if (newDayRain) {
@@ -202,10 +208,12 @@ bool StatICTxtDownloader::doProcess(const std::string& body)
 
 void StatICTxtDownloader::download(CurlWrapper& client)
 {
+	IngestionTrace::setCurrentStation(_station);
 	std::cout << SD_INFO << "[StatIC " << _station << "] measurement: " << "Now downloading a StatIC file for station "
 		  << _stationName << " (" << _query << ")" << std::endl;
 
 	CURLcode ret = client.download(_query, [&](const std::string& body) {
+		IngestionTrace::markCurrent(IngestionTrace::Stage::RECEIVED);
 		doProcess(body);
 	});
 
@@ -36,10 +36,11 @@
 #include <boost/asio/basic_waitable_timer.hpp>
 #include <cassandra.h>
 #include <date/date.h>
-#include <cassobs/dbconnection_observations.h>
 
+#include "storage/observations_storage.h"
 #include "time_offseter.h"
 #include "curl_wrapper.h"
+#include "monitoring/profiled_db_connection.h"
 
 namespace meteodata
 {
@@ -54,18 +55,18 @@ using namespace meteodata;
 class StatICTxtDownloader : public std::enable_shared_from_this<StatICTxtDownloader>
 {
 public:
-	StatICTxtDownloader(DbConnectionObservations& db, CassUuid station,
+	StatICTxtDownloader(ObservationsStorage& db, CassUuid station,
 		const std::string& host, const std::string& url, bool _https, int timezone,
 		std::map<std::string, std::string> sensors);
 
 	void download(CurlWrapper& client);
 	void ingest();
 
-	static void downloadOnly(DbConnectionObservations& db,CurlWrapper& client, const CassUuid& station,
+	static void downloadOnly(ObservationsStorage& db,CurlWrapper& client, const CassUuid& station,
 		const std::string& host, const std::string& url, bool https);
 
 private:
-	DbConnectionObservations& _db;
+	ProfiledDbConnection _db;
 	CassUuid _station;
 	std::string _stationName;
 	std::string _query;
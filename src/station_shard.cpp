@@ -0,0 +1,81 @@
+/**
+ * @file station_shard.cpp
+ * @brief Implementation of the StationShard class
+ * @author Laurent Georget
+ * @date 2026-10-18
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+#include <cassandra.h>
+
+#include "station_shard.h"
+
+namespace meteodata
+{
+
+namespace
+{
+	/* The finalizer of SplitMix64, it spreads well the UUIDs, whose high
+	 * bits are often very close to each other (version 1 UUIDs are
+	 * time-based) */
+	std::uint64_t mix(std::uint64_t x)
+	{
+		x += 0x9E3779B97F4A7C15ULL;
+		x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+		return x ^ (x >> 31);
+	}
+}
+
+StationShard::StationShard(unsigned int id, unsigned int count) :
+	_id{id},
+	_count{count}
+{
+	if (_count == 0 || _id >= _count)
+		throw std::invalid_argument("Invalid shard " + std::to_string(_id) + " of " + std::to_string(_count));
+
+	if (_count == 1)
+		return;
+
+	_ring.reserve(_count * POINTS_PER_SHARD);
+	for (unsigned int shard = 0 ; shard < _count ; shard++) {
+		for (unsigned int point = 0 ; point < POINTS_PER_SHARD ; point++)
+			_ring.emplace_back(mix((std::uint64_t{shard} << 32) | point), shard);
+	}
+	std::sort(_ring.begin(), _ring.end());
+}
+
+unsigned int StationShard::ownerOf(const CassUuid& station) const
+{
+	if (_ring.empty())
+		return 0;
+
+	std::uint64_t hash = mix(station.time_and_version ^ mix(station.clock_seq_and_node));
+	auto it = std::upper_bound(_ring.begin(), _ring.end(), hash,
+		[](std::uint64_t h, const std::pair<std::uint64_t, unsigned int>& point) { return h < point.first; });
+	if (it == _ring.end())
+		it = _ring.begin();
+	return it->second;
+}
+
+}
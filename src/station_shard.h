@@ -0,0 +1,109 @@
+/**
+ * @file station_shard.h
+ * @brief Definition of the StationShard class
+ * @author Laurent Georget
+ * @date 2026-10-18
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef STATION_SHARD_H
+#define STATION_SHARD_H
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <cassandra.h>
+
+namespace meteodata
+{
+
+/**
+ * @brief The portion of the stations a meteodata instance is responsible for
+ *
+ * Stations are spread over the instances by consistent hashing: each shard
+ * owns a number of points on a 64-bit ring and a station belongs to the shard
+ * owning the first point following the hash of its UUID. When a shard is
+ * added, it only takes over some of the stations of the other shards, the
+ * rest of the stations do not move.
+ *
+ * The hashes do not depend on the platform or on the process, so all the
+ * instances agree on the owner of every station as long as they are given
+ * the same number of shards.
+ */
+class StationShard
+{
+public:
+	/**
+	 * @brief Construct a shard
+	 *
+	 * The default shard owns all the stations.
+	 *
+	 * @param id The index of this shard, in [0, count)
+	 * @param count The total number of shards
+	 */
+	explicit StationShard(unsigned int id = 0, unsigned int count = 1);
+
+	/**
+	 * @brief Tell whether a station belongs to this shard
+	 *
+	 * @param station The station
+	 * @return True if, and only if, this instance must handle the station
+	 */
+	bool owns(const CassUuid& station) const
+	{
+		return _count <= 1 || ownerOf(station) == _id;
+	}
+
+	/**
+	 * @brief Find the shard a station belongs to
+	 *
+	 * @param station The station
+	 * @return The index of the shard owning the station
+	 */
+	unsigned int ownerOf(const CassUuid& station) const;
+
+	unsigned int getId() const
+	{
+		return _id;
+	}
+
+	unsigned int getCount() const
+	{
+		return _count;
+	}
+
+	/**
+	 * @brief The number of points each shard owns on the ring, the more
+	 * points, the more even the distribution of the stations
+	 */
+	static constexpr unsigned int POINTS_PER_SHARD = 128;
+
+private:
+	unsigned int _id;
+	unsigned int _count;
+	/**
+	 * @brief The points on the ring, sorted, with the shard owning each
+	 * of them
+	 */
+	std::vector<std::pair<std::uint64_t, unsigned int>> _ring;
+};
+
+}
+
+#endif /* STATION_SHARD_H */
@@ -0,0 +1,295 @@
+/**
+ * @file cassobs_observations_storage.cpp
+ * @brief Implementation of the CassobsObservationsStorage class
+ * @author Laurent Georget
+ * @date 2026-10-18
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <ctime>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <cassandra.h>
+#include <date/date.h>
+#include <cassobs/dbconnection_observations.h>
+
+#include "storage/cassobs_observations_storage.h"
+
+namespace meteodata
+{
+
+CassobsObservationsStorage::CassobsObservationsStorage(const std::string& address, const std::string& user,
+	const std::string& password, const std::string& pgAddress, const std::string& pgUser,
+	const std::string& pgPassword) :
+		_db{address, user, password, pgAddress, pgUser, pgPassword}
+{}
+
+bool CassobsObservationsStorage::cacheFloat(const CassUuid& station, const std::string& key, time_t update,
+	float value)
+{
+	return _db.cacheFloat(station, key, update, value);
+}
+
+bool CassobsObservationsStorage::cacheInt(const CassUuid& station, const std::string& key, time_t update,
+	int value)
+{
+	return _db.cacheInt(station, key, update, value);
+}
+
+bool CassobsObservationsStorage::getCachedFloat(const CassUuid& station, const std::string& key,
+	time_t& update, float& value)
+{
+	return _db.getCachedFloat(station, key, update, value);
+}
+
+bool CassobsObservationsStorage::getCachedInt(const CassUuid& station, const std::string& key,
+	time_t& update, int& value)
+{
+	return _db.getCachedInt(station, key, update, value);
+}
+
+bool CassobsObservationsStorage::getAllCimelStations(std::vector<std::tuple<CassUuid, std::string, int>>& stations)
+{
+	return _db.getAllCimelStations(stations);
+}
+
+bool CassobsObservationsStorage::getAllFieldClimateApiStations(std::vector<std::tuple<CassUuid, std::string, int, std::map<std::string, std::string>>>& stations)
+{
+	return _db.getAllFieldClimateApiStations(stations);
+}
+
+bool CassobsObservationsStorage::getAllIcaos(std::vector<std::tuple<CassUuid, std::string>>& stations)
+{
+	return _db.getAllIcaos(stations);
+}
+
+bool CassobsObservationsStorage::getAllLiveobjectsStations(std::vector<std::tuple<CassUuid, std::string, std::string>>& stations)
+{
+	return _db.getAllLiveobjectsStations(stations);
+}
+
+bool CassobsObservationsStorage::getAllNbiotStations(std::vector<NbiotStation>& stations)
+{
+	return _db.getAllNbiotStations(stations);
+}
+
+bool CassobsObservationsStorage::getAllVirtualStations(std::vector<VirtualStation>& stations)
+{
+	return _db.getAllVirtualStations(stations);
+}
+
+bool CassobsObservationsStorage::getAllWeatherlinkAPIv2Stations(std::vector<std::tuple<CassUuid, bool, std::map<int, CassUuid>, std::string, std::map<int, std::map<std::string, std::string>>>>& stations)
+{
+	return _db.getAllWeatherlinkAPIv2Stations(stations);
+}
+
+bool CassobsObservationsStorage::getAllWeatherlinkStations(std::vector<std::tuple<CassUuid, std::string, std::string, int>>& stations)
+{
+	return _db.getAllWeatherlinkStations(stations);
+}
+
+bool CassobsObservationsStorage::getDeferredSynops(std::vector<std::tuple<CassUuid, std::string>>& stations)
+{
+	return _db.getDeferredSynops(stations);
+}
+
+bool CassobsObservationsStorage::getMBDataTxtStations(std::vector<std::tuple<CassUuid, std::string, std::string, bool, int, std::string>>& stations)
+{
+	return _db.getMBDataTxtStations(stations);
+}
+
+bool CassobsObservationsStorage::getMeteoFranceStations(std::vector<std::tuple<CassUuid, std::string, std::string, int, float, float, int, int>>& stations)
+{
+	return _db.getMeteoFranceStations(stations);
+}
+
+bool CassobsObservationsStorage::getMqttStations(std::vector<std::tuple<CassUuid, std::string, int, std::string, std::unique_ptr<char[]>, size_t, std::string, int>>& stations)
+{
+	return _db.getMqttStations(stations);
+}
+
+bool CassobsObservationsStorage::getStatICTxtStations(std::vector<std::tuple<CassUuid, std::string, std::string, bool, int, std::map<std::string, std::string>>>& stations)
+{
+	return _db.getStatICTxtStations(stations);
+}
+
+bool CassobsObservationsStorage::selectExportedStations(const std::string& partner,
+	std::vector<ExportedStation>& stations)
+{
+	return _db.selectExportedStations(partner, stations);
+}
+
+bool CassobsObservationsStorage::getStationByCoords(int elevation, int latitude, int longitude,
+	CassUuid& station, std::string& name, int& pollPeriod, time_t& lastArchiveDownloadTime,
+	bool* storeInsideMeasurements)
+{
+	return _db.getStationByCoords(elevation, latitude, longitude, station, name, pollPeriod, lastArchiveDownloadTime, storeInsideMeasurements);
+}
+
+bool CassobsObservationsStorage::getStationCoordinates(const CassUuid& station, float& latitude,
+	float& longitude, int& elevation, std::string& name, int& pollPeriod)
+{
+	return _db.getStationCoordinates(station, latitude, longitude, elevation, name, pollPeriod);
+}
+
+bool CassobsObservationsStorage::getStationDetails(const CassUuid& station, std::string& name,
+	int& pollPeriod, time_t& lastArchiveDownloadTime, bool* storeInsideMeasurements)
+{
+	return _db.getStationDetails(station, name, pollPeriod, lastArchiveDownloadTime, storeInsideMeasurements);
+}
+
+bool CassobsObservationsStorage::getStationLocation(const CassUuid& station, float& latitude,
+	float& longitude, int& elevation)
+{
+	return _db.getStationLocation(station, latitude, longitude, elevation);
+}
+
+bool CassobsObservationsStorage::getLastConfiguration(const CassUuid& station,
+	ModemStationConfiguration& configuration)
+{
+	std::lock_guard<std::mutex> lock{_pgMutex};
+	return _db.getLastConfiguration(station, configuration);
+}
+
+bool CassobsObservationsStorage::getOneConfiguration(const CassUuid& station, int id,
+	ModemStationConfiguration& configuration)
+{
+	std::lock_guard<std::mutex> lock{_pgMutex};
+	return _db.getOneConfiguration(station, id, configuration);
+}
+
+bool CassobsObservationsStorage::updateConfigurationStatus(const CassUuid& station, int id, bool active)
+{
+	std::lock_guard<std::mutex> lock{_pgMutex};
+	return _db.updateConfigurationStatus(station, id, active);
+}
+
+bool CassobsObservationsStorage::getLastSchedulerDownloadTime(const std::string& scheduler,
+	time_t& lastDownloadTime)
+{
+	return _db.getLastSchedulerDownloadTime(scheduler, lastDownloadTime);
+}
+
+bool CassobsObservationsStorage::insertLastSchedulerDownloadTime(const std::string& scheduler,
+	time_t lastDownloadTime)
+{
+	return _db.insertLastSchedulerDownloadTime(scheduler, lastDownloadTime);
+}
+
+bool CassobsObservationsStorage::updateLastArchiveDownloadTime(const CassUuid& station,
+	time_t lastArchiveDownloadTime)
+{
+	return _db.updateLastArchiveDownloadTime(station, lastArchiveDownloadTime);
+}
+
+bool CassobsObservationsStorage::getLastDataBefore(const CassUuid& station, time_t boundary,
+	Observation& observation)
+{
+	return _db.getLastDataBefore(station, boundary, observation);
+}
+
+bool CassobsObservationsStorage::getDataBetween(const CassUuid& station, time_t begin, time_t end,
+	std::vector<Observation>& observations)
+{
+	return _db.getDataBetween(station, begin, end, observations);
+}
+
+bool CassobsObservationsStorage::getRainfall(const CassUuid& station, time_t begin, time_t end,
+	float& rainfall)
+{
+	return _db.getRainfall(station, begin, end, rainfall);
+}
+
+bool CassobsObservationsStorage::insertCollection(const CassUuid& station, time_t time,
+	const std::string& type, const std::string& body)
+{
+	return _db.insertCollection(station, time, type, body);
+}
+
+bool CassobsObservationsStorage::insertV2DataPoint(const Observation& observation)
+{
+	return _db.insertV2DataPoint(observation);
+}
+
+bool CassobsObservationsStorage::insertV2DataPoints(std::vector<Observation>::const_iterator begin,
+	std::vector<Observation>::const_iterator end)
+{
+	return _db.insertV2DataPoints(begin, end);
+}
+
+bool CassobsObservationsStorage::insertV2DataPointInTimescaleDB(const Observation& observation)
+{
+	std::lock_guard<std::mutex> lock{_pgMutex};
+	return _db.insertV2DataPointInTimescaleDB(observation);
+}
+
+bool CassobsObservationsStorage::insertV2DataPointsInTimescaleDB(std::vector<Observation>::const_iterator begin,
+	std::vector<Observation>::const_iterator end)
+{
+	std::lock_guard<std::mutex> lock{_pgMutex};
+	return _db.insertV2DataPointsInTimescaleDB(begin, end);
+}
+
+bool CassobsObservationsStorage::insertV2EntireDayValues(const CassUuid& station, time_t time,
+	std::pair<bool, float> rainfall, std::pair<bool, int> insolationTime)
+{
+	return _db.insertV2EntireDayValues(station, time, rainfall, insolationTime);
+}
+
+bool CassobsObservationsStorage::insertV2Tn(const CassUuid& station, time_t time, float tn)
+{
+	return _db.insertV2Tn(station, time, tn);
+}
+
+bool CassobsObservationsStorage::insertV2Tx(const CassUuid& station, time_t time, float tx)
+{
+	return _db.insertV2Tx(station, time, tx);
+}
+
+bool CassobsObservationsStorage::deleteDataPoints(const CassUuid& station, const date::sys_days& day,
+	const date::sys_seconds& begin, const date::sys_seconds& end)
+{
+	std::lock_guard<std::mutex> lock{_pgMutex};
+	return _db.deleteDataPoints(station, day, begin, end);
+}
+
+bool CassobsObservationsStorage::insertDownload(const CassUuid& station, time_t time,
+	const std::string& connectorId, const std::string& content, bool done, const std::string& status)
+{
+	return _db.insertDownload(station, time, connectorId, content, done, status);
+}
+
+bool CassobsObservationsStorage::selectDownloadsByStation(const CassUuid& station,
+	const std::string& connectorId, std::vector<Download>& downloads)
+{
+	return _db.selectDownloadsByStation(station, connectorId, downloads);
+}
+
+bool CassobsObservationsStorage::updateDownloadStatus(const CassUuid& station, time_t time, bool done,
+	const std::string& status)
+{
+	return _db.updateDownloadStatus(station, time, done, status);
+}
+
+}
@@ -0,0 +1,142 @@
+/**
+ * @file cassobs_observations_storage.h
+ * @brief Definition of the CassobsObservationsStorage class
+ * @author Laurent Georget
+ * @date 2026-10-18
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CASSOBS_OBSERVATIONS_STORAGE_H
+#define CASSOBS_OBSERVATIONS_STORAGE_H
+
+#include <ctime>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <cassandra.h>
+#include <date/date.h>
+#include <cassobs/dbconnection_observations.h>
+
+#include "storage/observations_storage.h"
+
+namespace meteodata
+{
+
+/**
+ * @brief The storage backed by the observations databases, Cassandra and
+ * TimescaleDB, through the cassobs library
+ *
+ * All the calls are forwarded as-is to a DbConnectionObservations. The
+ * connection is shared by the I/O threads, the MQTT ingestion threads, the
+ * warm-up and the archive writers. The Cassandra driver is thread-safe and
+ * those calls run concurrently, but the TimescaleDB connection is not, so
+ * only the calls going to TimescaleDB are serialized.
+ */
+class CassobsObservationsStorage : public ObservationsStorage
+{
+public:
+	/**
+	 * @brief Connect to the databases
+	 *
+	 * @param address The address of the Cassandra cluster
+	 * @param user The Cassandra username
+	 * @param password The Cassandra password
+	 * @param pgAddress The address of the TimescaleDB database
+	 * @param pgUser The TimescaleDB username
+	 * @param pgPassword The TimescaleDB password
+	 */
+	CassobsObservationsStorage(const std::string& address, const std::string& user, const std::string& password,
+		const std::string& pgAddress, const std::string& pgUser, const std::string& pgPassword);
+
+	bool cacheFloat(const CassUuid& station, const std::string& key, time_t update, float value) override;
+	bool cacheInt(const CassUuid& station, const std::string& key, time_t update, int value) override;
+	bool getCachedFloat(const CassUuid& station, const std::string& key, time_t& update, float& value) override;
+	bool getCachedInt(const CassUuid& station, const std::string& key, time_t& update, int& value) override;
+
+	bool getAllCimelStations(std::vector<std::tuple<CassUuid, std::string, int>>& stations) override;
+	bool getAllFieldClimateApiStations(std::vector<std::tuple<CassUuid, std::string, int, std::map<std::string, std::string>>>& stations) override;
+	bool getAllIcaos(std::vector<std::tuple<CassUuid, std::string>>& stations) override;
+	bool getAllLiveobjectsStations(std::vector<std::tuple<CassUuid, std::string, std::string>>& stations) override;
+	bool getAllNbiotStations(std::vector<NbiotStation>& stations) override;
+	bool getAllVirtualStations(std::vector<VirtualStation>& stations) override;
+	bool getAllWeatherlinkAPIv2Stations(std::vector<std::tuple<CassUuid, bool, std::map<int, CassUuid>, std::string, std::map<int, std::map<std::string, std::string>>>>& stations) override;
+	bool getAllWeatherlinkStations(std::vector<std::tuple<CassUuid, std::string, std::string, int>>& stations) override;
+	bool getDeferredSynops(std::vector<std::tuple<CassUuid, std::string>>& stations) override;
+	bool getMBDataTxtStations(std::vector<std::tuple<CassUuid, std::string, std::string, bool, int, std::string>>& stations) override;
+	bool getMeteoFranceStations(std::vector<std::tuple<CassUuid, std::string, std::string, int, float, float, int, int>>& stations) override;
+	bool getMqttStations(std::vector<std::tuple<CassUuid, std::string, int, std::string, std::unique_ptr<char[]>, size_t, std::string, int>>& stations) override;
+	bool getStatICTxtStations(std::vector<std::tuple<CassUuid, std::string, std::string, bool, int, std::map<std::string, std::string>>>& stations) override;
+	bool selectExportedStations(const std::string& partner, std::vector<ExportedStation>& stations) override;
+
+	bool getStationByCoords(int elevation, int latitude, int longitude, CassUuid& station,
+		std::string& name, int& pollPeriod, time_t& lastArchiveDownloadTime, bool* storeInsideMeasurements) override;
+	bool getStationCoordinates(const CassUuid& station, float& latitude, float& longitude, int& elevation,
+		std::string& name, int& pollPeriod) override;
+	bool getStationDetails(const CassUuid& station, std::string& name, int& pollPeriod,
+		time_t& lastArchiveDownloadTime, bool* storeInsideMeasurements) override;
+	bool getStationLocation(const CassUuid& station, float& latitude, float& longitude, int& elevation) override;
+
+	bool getLastConfiguration(const CassUuid& station, ModemStationConfiguration& configuration) override;
+	bool getOneConfiguration(const CassUuid& station, int id, ModemStationConfiguration& configuration) override;
+	bool updateConfigurationStatus(const CassUuid& station, int id, bool active) override;
+
+	bool getLastSchedulerDownloadTime(const std::string& scheduler, time_t& lastDownloadTime) override;
+	bool insertLastSchedulerDownloadTime(const std::string& scheduler, time_t lastDownloadTime) override;
+	bool updateLastArchiveDownloadTime(const CassUuid& station, time_t lastArchiveDownloadTime) override;
+
+	bool getLastDataBefore(const CassUuid& station, time_t boundary, Observation& observation) override;
+	bool getDataBetween(const CassUuid& station, time_t begin, time_t end,
+		std::vector<Observation>& observations) override;
+	bool getRainfall(const CassUuid& station, time_t begin, time_t end, float& rainfall) override;
+	bool insertCollection(const CassUuid& station, time_t time, const std::string& type, const std::string& body) override;
+	bool insertV2DataPoint(const Observation& observation) override;
+	bool insertV2DataPoints(std::vector<Observation>::const_iterator begin,
+		std::vector<Observation>::const_iterator end) override;
+	bool insertV2DataPointInTimescaleDB(const Observation& observation) override;
+	bool insertV2DataPointsInTimescaleDB(std::vector<Observation>::const_iterator begin,
+		std::vector<Observation>::const_iterator end) override;
+	bool insertV2EntireDayValues(const CassUuid& station, time_t time,
+		std::pair<bool, float> rainfall, std::pair<bool, int> insolationTime) override;
+	bool insertV2Tn(const CassUuid& station, time_t time, float tn) override;
+	bool insertV2Tx(const CassUuid& station, time_t time, float tx) override;
+	bool deleteDataPoints(const CassUuid& station, const date::sys_days& day,
+		const date::sys_seconds& begin, const date::sys_seconds& end) override;
+
+	bool insertDownload(const CassUuid& station, time_t time, const std::string& connectorId,
+		const std::string& content, bool done, const std::string& status) override;
+	bool selectDownloadsByStation(const CassUuid& station, const std::string& connectorId,
+		std::vector<Download>& downloads) override;
+	bool updateDownloadStatus(const CassUuid& station, time_t time, bool done, const std::string& status) override;
+
+private:
+	DbConnectionObservations _db;
+
+	/**
+	 * @brief The mutex serializing the calls going to TimescaleDB
+	 */
+	std::mutex _pgMutex;
+};
+
+}
+
+#endif /* CASSOBS_OBSERVATIONS_STORAGE_H */
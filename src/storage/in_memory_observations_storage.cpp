@@ -0,0 +1,605 @@
+/**
+ * @file in_memory_observations_storage.cpp
+ * @brief Implementation of the InMemoryObservationsStorage class
+ * @author Laurent Georget
+ * @date 2026-10-18
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <cassandra.h>
+#include <date/date.h>
+#include <cassobs/dbconnection_observations.h>
+#include <cassobs/observation.h>
+
+#include "storage/in_memory_observations_storage.h"
+#include "cassandra_utils.h"
+
+namespace meteodata
+{
+
+namespace
+{
+	std::vector<std::string> splitFields(const std::string& line)
+	{
+		std::vector<std::string> fields;
+		std::istringstream is{line};
+		std::string field;
+		while (std::getline(is, field, '\t'))
+			fields.push_back(field);
+		return fields;
+	}
+
+	date::sys_seconds toSysSeconds(time_t time)
+	{
+		return date::floor<chrono::seconds>(chrono::system_clock::from_time_t(time));
+	}
+
+	date::sys_days toSysDays(time_t time)
+	{
+		return date::floor<date::days>(chrono::system_clock::from_time_t(time));
+	}
+}
+
+InMemoryObservationsStorage::InMemoryObservationsStorage(chrono::microseconds latency) :
+	_latency{latency.count()}
+{}
+
+void InMemoryObservationsStorage::loadStationTable(const std::string& stationTable)
+{
+	std::ifstream is{stationTable};
+	if (!is)
+		throw std::runtime_error("Cannot open the station table " + stationTable);
+
+	auto parseUuid = [&](const std::string& s, int lineNumber) {
+		CassUuid uuid;
+		if (cass_uuid_from_string(s.c_str(), &uuid) != CASS_OK)
+			throw std::runtime_error(stationTable + ":" + std::to_string(lineNumber) + ": invalid UUID '" + s + "'");
+		return uuid;
+	};
+
+	std::lock_guard<std::mutex> lock{_mutex};
+	std::string line;
+	int lineNumber = 0;
+	while (std::getline(is, line)) {
+		lineNumber++;
+		if (line.empty() || line[0] == '#')
+			continue;
+
+		std::vector<std::string> fields = splitFields(line);
+		const std::string& type = fields[0];
+		std::size_t expected = type == "station" ? 7 :
+				       type == "mqtt" ? 8 :
+				       type == "liveobjects" ? 4 :
+				       type == "nbiot" ? 5 :
+				       type == "icao" ? 3 : 0;
+		if (expected == 0)
+			throw std::runtime_error(stationTable + ":" + std::to_string(lineNumber) + ": unknown line type '" + type + "'");
+		if (fields.size() != expected)
+			throw std::runtime_error(stationTable + ":" + std::to_string(lineNumber) + ": expected " +
+				std::to_string(expected) + " fields for a '" + type + "' line");
+
+		CassUuid uuid = parseUuid(fields[1], lineNumber);
+		auto it = _stations.find(uuid);
+		if (it == _stations.end()) {
+			it = _stations.emplace(uuid, Station{}).first;
+			it->second.name = fields[1];
+		}
+
+		try {
+			if (type == "station") {
+				Station& st = it->second;
+				st.name = fields[2];
+				st.pollPeriod = std::stoi(fields[3]);
+				st.latitude = std::stof(fields[4]);
+				st.longitude = std::stof(fields[5]);
+				st.elevation = std::stoi(fields[6]);
+			} else if (type == "mqtt") {
+				_mqttStations.push_back(MqttStation{uuid, fields[2], std::stoi(fields[3]), fields[4], fields[5],
+					fields[6], std::stoi(fields[7])});
+			} else if (type == "liveobjects") {
+				_liveobjectsStations.emplace_back(uuid, fields[2], fields[3]);
+			} else if (type == "nbiot") {
+				NbiotStation st;
+				st.station = uuid;
+				st.imei = fields[2];
+				st.hmacKey = fields[3];
+				st.sensorType = fields[4];
+				_nbiotStations.push_back(std::move(st));
+			} else if (type == "icao") {
+				_icaos.emplace_back(uuid, fields[2]);
+			}
+		} catch (std::logic_error&) {
+			// thrown by std::stoi and std::stof
+			throw std::runtime_error(stationTable + ":" + std::to_string(lineNumber) + ": invalid number");
+		}
+	}
+}
+
+void InMemoryObservationsStorage::setLatency(chrono::microseconds latency)
+{
+	_latency = latency.count();
+}
+
+std::size_t InMemoryObservationsStorage::getObservationsCount() const
+{
+	std::lock_guard<std::mutex> lock{_mutex};
+	std::size_t count = 0;
+	for (auto&& [station, observations] : _observations)
+		count += observations.size();
+	return count;
+}
+
+void InMemoryObservationsStorage::simulateLatency() const
+{
+	auto latency = _latency.load(std::memory_order_relaxed);
+	if (latency > 0)
+		std::this_thread::sleep_for(chrono::microseconds{latency});
+}
+
+void InMemoryObservationsStorage::simulateTimescaleDBLatency() const
+{
+	// like the real storage, the calls going to TimescaleDB wait for each
+	// other
+	std::lock_guard<std::mutex> lock{_pgMutex};
+	simulateLatency();
+}
+
+void InMemoryObservationsStorage::store(const Observation& observation)
+{
+	_observations[observation.station][observation.time] = observation;
+}
+
+bool InMemoryObservationsStorage::cacheFloat(const CassUuid& station, const std::string& key, time_t update, float value)
+{
+	simulateLatency();
+	std::lock_guard<std::mutex> lock{_mutex};
+	_cachedFloats[{station, key}] = {update, value};
+	return true;
+}
+
+bool InMemoryObservationsStorage::cacheInt(const CassUuid& station, const std::string& key, time_t update, int value)
+{
+	simulateLatency();
+	std::lock_guard<std::mutex> lock{_mutex};
+	_cachedInts[{station, key}] = {update, value};
+	return true;
+}
+
+bool InMemoryObservationsStorage::getCachedFloat(const CassUuid& station, const std::string& key, time_t& update, float& value)
+{
+	simulateLatency();
+	std::lock_guard<std::mutex> lock{_mutex};
+	auto it = _cachedFloats.find({station, key});
+	if (it == _cachedFloats.end())
+		return false;
+	std::tie(update, value) = it->second;
+	return true;
+}
+
+bool InMemoryObservationsStorage::getCachedInt(const CassUuid& station, const std::string& key, time_t& update, int& value)
+{
+	simulateLatency();
+	std::lock_guard<std::mutex> lock{_mutex};
+	auto it = _cachedInts.find({station, key});
+	if (it == _cachedInts.end())
+		return false;
+	std::tie(update, value) = it->second;
+	return true;
+}
+
+bool InMemoryObservationsStorage::getAllCimelStations(std::vector<std::tuple<CassUuid, std::string, int>>&)
+{
+	simulateLatency();
+	return true;
+}
+
+bool InMemoryObservationsStorage::getAllFieldClimateApiStations(std::vector<std::tuple<CassUuid, std::string, int, std::map<std::string, std::string>>>&)
+{
+	simulateLatency();
+	return true;
+}
+
+bool InMemoryObservationsStorage::getAllIcaos(std::vector<std::tuple<CassUuid, std::string>>& stations)
+{
+	simulateLatency();
+	std::lock_guard<std::mutex> lock{_mutex};
+	stations = _icaos;
+	return true;
+}
+
+bool InMemoryObservationsStorage::getAllLiveobjectsStations(std::vector<std::tuple<CassUuid, std::string, std::string>>& stations)
+{
+	simulateLatency();
+	std::lock_guard<std::mutex> lock{_mutex};
+	stations = _liveobjectsStations;
+	return true;
+}
+
+bool InMemoryObservationsStorage::getAllNbiotStations(std::vector<NbiotStation>& stations)
+{
+	simulateLatency();
+	std::lock_guard<std::mutex> lock{_mutex};
+	stations = _nbiotStations;
+	return true;
+}
+
+bool InMemoryObservationsStorage::getAllVirtualStations(std::vector<VirtualStation>&)
+{
+	simulateLatency();
+	return true;
+}
+
+bool InMemoryObservationsStorage::getAllWeatherlinkAPIv2Stations(std::vector<std::tuple<CassUuid, bool, std::map<int, CassUuid>, std::string, std::map<int, std::map<std::string, std::string>>>>&)
+{
+	simulateLatency();
+	return true;
+}
+
+bool InMemoryObservationsStorage::getAllWeatherlinkStations(std::vector<std::tuple<CassUuid, std::string, std::string, int>>&)
+{
+	simulateLatency();
+	return true;
+}
+
+bool InMemoryObservationsStorage::getDeferredSynops(std::vector<std::tuple<CassUuid, std::string>>&)
+{
+	simulateLatency();
+	return true;
+}
+
+bool InMemoryObservationsStorage::getMBDataTxtStations(std::vector<std::tuple<CassUuid, std::string, std::string, bool, int, std::string>>&)
+{
+	simulateLatency();
+	return true;
+}
+
+bool InMemoryObservationsStorage::getMeteoFranceStations(std::vector<std::tuple<CassUuid, std::string, std::string, int, float, float, int, int>>&)
+{
+	simulateLatency();
+	return true;
+}
+
+bool InMemoryObservationsStorage::getMqttStations(std::vector<std::tuple<CassUuid, std::string, int, std::string, std::unique_ptr<char[]>, size_t, std::string, int>>& stations)
+{
+	simulateLatency();
+	std::lock_guard<std::mutex> lock{_mutex};
+	for (const MqttStation& st : _mqttStations) {
+		std::unique_ptr<char[]> password{new char[st.password.size()]};
+		std::memcpy(password.get(), st.password.data(), st.password.size());
+		stations.emplace_back(st.station, st.host, st.port, st.user, std::move(password), st.password.size(),
+			st.topic, st.timezone);
+	}
+	return true;
+}
+
+bool InMemoryObservationsStorage::getStatICTxtStations(std::vector<std::tuple<CassUuid, std::string, std::string, bool, int, std::map<std::string, std::string>>>&)
+{
+	simulateLatency();
+	return true;
+}
+
+bool InMemoryObservationsStorage::selectExportedStations(const std::string&, std::vector<ExportedStation>&)
+{
+	simulateLatency();
+	return true;
+}
+
+bool InMemoryObservationsStorage::getStationByCoords(int elevation, int latitude, int longitude, CassUuid& station,
+	std::string& name, int& pollPeriod, time_t& lastArchiveDownloadTime, bool* storeInsideMeasurements)
+{
+	simulateLatency();
+	std::lock_guard<std::mutex> lock{_mutex};
+	// the coordinates are in tenths of degrees, as in the VantagePro2
+	// EEPROM
+	auto it = std::find_if(_stations.begin(), _stations.end(), [&](auto&& st) {
+		return st.second.elevation == elevation &&
+		       std::lround(st.second.latitude * 10) == latitude &&
+		       std::lround(st.second.longitude * 10) == longitude;
+	});
+	if (it == _stations.end())
+		return false;
+
+	station = it->first;
+	name = it->second.name;
+	pollPeriod = it->second.pollPeriod;
+	lastArchiveDownloadTime = it->second.lastArchiveDownloadTime;
+	if (storeInsideMeasurements)
+		*storeInsideMeasurements = false;
+	return true;
+}
+
+bool InMemoryObservationsStorage::getStationCoordinates(const CassUuid& station, float& latitude, float& longitude,
+	int& elevation, std::string& name, int& pollPeriod)
+{
+	simulateLatency();
+	std::lock_guard<std::mutex> lock{_mutex};
+	auto it = _stations.find(station);
+	if (it == _stations.end())
+		return false;
+	latitude = it->second.latitude;
+	longitude = it->second.longitude;
+	elevation = it->second.elevation;
+	name = it->second.name;
+	pollPeriod = it->second.pollPeriod;
+	return true;
+}
+
+bool InMemoryObservationsStorage::getStationDetails(const CassUuid& station, std::string& name, int& pollPeriod,
+	time_t& lastArchiveDownloadTime, bool* storeInsideMeasurements)
+{
+	simulateLatency();
+	std::lock_guard<std::mutex> lock{_mutex};
+	auto it = _stations.find(station);
+	if (it == _stations.end())
+		return false;
+	name = it->second.name;
+	pollPeriod = it->second.pollPeriod;
+	lastArchiveDownloadTime = it->second.lastArchiveDownloadTime;
+	if (storeInsideMeasurements)
+		*storeInsideMeasurements = false;
+	return true;
+}
+
+bool InMemoryObservationsStorage::getStationLocation(const CassUuid& station, float& latitude, float& longitude,
+	int& elevation)
+{
+	simulateLatency();
+	std::lock_guard<std::mutex> lock{_mutex};
+	auto it = _stations.find(station);
+	if (it == _stations.end())
+		return false;
+	latitude = it->second.latitude;
+	longitude = it->second.longitude;
+	elevation = it->second.elevation;
+	return true;
+}
+
+bool InMemoryObservationsStorage::getLastConfiguration(const CassUuid&, ModemStationConfiguration&)
+{
+	simulateTimescaleDBLatency();
+	return false;
+}
+
+bool InMemoryObservationsStorage::getOneConfiguration(const CassUuid&, int, ModemStationConfiguration&)
+{
+	simulateTimescaleDBLatency();
+	return false;
+}
+
+bool InMemoryObservationsStorage::updateConfigurationStatus(const CassUuid&, int, bool)
+{
+	simulateTimescaleDBLatency();
+	return true;
+}
+
+bool InMemoryObservationsStorage::getLastSchedulerDownloadTime(const std::string& scheduler, time_t& lastDownloadTime)
+{
+	simulateLatency();
+	std::lock_guard<std::mutex> lock{_mutex};
+	auto it = _schedulerDownloadTimes.find(scheduler);
+	if (it == _schedulerDownloadTimes.end())
+		return false;
+	lastDownloadTime = it->second;
+	return true;
+}
+
+bool InMemoryObservationsStorage::insertLastSchedulerDownloadTime(const std::string& scheduler, time_t lastDownloadTime)
+{
+	simulateLatency();
+	std::lock_guard<std::mutex> lock{_mutex};
+	_schedulerDownloadTimes[scheduler] = lastDownloadTime;
+	return true;
+}
+
+bool InMemoryObservationsStorage::updateLastArchiveDownloadTime(const CassUuid& station, time_t lastArchiveDownloadTime)
+{
+	simulateLatency();
+	std::lock_guard<std::mutex> lock{_mutex};
+	_stations[station].lastArchiveDownloadTime = lastArchiveDownloadTime;
+	return true;
+}
+
+bool InMemoryObservationsStorage::getLastDataBefore(const CassUuid& station, time_t boundary, Observation& observation)
+{
+	simulateLatency();
+	std::lock_guard<std::mutex> lock{_mutex};
+	auto it = _observations.find(station);
+	if (it == _observations.end())
+		return false;
+	auto obsIt = it->second.upper_bound(toSysSeconds(boundary));
+	if (obsIt == it->second.begin())
+		return false;
+	observation = std::prev(obsIt)->second;
+	return true;
+}
+
+bool InMemoryObservationsStorage::getDataBetween(const CassUuid& station, time_t begin, time_t end,
+	std::vector<Observation>& observations)
+{
+	simulateLatency();
+	std::lock_guard<std::mutex> lock{_mutex};
+	auto it = _observations.find(station);
+	if (it == _observations.end())
+		return true;
+	for (auto obsIt = it->second.lower_bound(toSysSeconds(begin)) ;
+	     obsIt != it->second.end() && obsIt->first <= toSysSeconds(end) ; ++obsIt)
+		observations.push_back(obsIt->second);
+	return true;
+}
+
+bool InMemoryObservationsStorage::getRainfall(const CassUuid& station, time_t begin, time_t end, float& rainfall)
+{
+	simulateLatency();
+	std::lock_guard<std::mutex> lock{_mutex};
+	rainfall = 0.f;
+	auto it = _observations.find(station);
+	if (it == _observations.end())
+		return true;
+	// an observation gives the rainfall since the previous one, so the
+	// observation at the beginning of the period is excluded
+	for (auto obsIt = it->second.upper_bound(toSysSeconds(begin)) ;
+	     obsIt != it->second.end() && obsIt->first <= toSysSeconds(end) ; ++obsIt) {
+		if (obsIt->second.rainfall.first)
+			rainfall += obsIt->second.rainfall.second;
+	}
+	return true;
+}
+
+bool InMemoryObservationsStorage::insertCollection(const CassUuid&, time_t, const std::string&, const std::string&)
+{
+	simulateLatency();
+	std::lock_guard<std::mutex> lock{_mutex};
+	_collections++;
+	return true;
+}
+
+bool InMemoryObservationsStorage::insertV2DataPoint(const Observation& observation)
+{
+	simulateLatency();
+	std::lock_guard<std::mutex> lock{_mutex};
+	store(observation);
+	return true;
+}
+
+bool InMemoryObservationsStorage::insertV2DataPoints(std::vector<Observation>::const_iterator begin,
+	std::vector<Observation>::const_iterator end)
+{
+	simulateLatency();
+	std::lock_guard<std::mutex> lock{_mutex};
+	for (auto it = begin ; it != end ; ++it)
+		store(*it);
+	return true;
+}
+
+bool InMemoryObservationsStorage::insertV2DataPointInTimescaleDB(const Observation& observation)
+{
+	simulateTimescaleDBLatency();
+	std::lock_guard<std::mutex> lock{_mutex};
+	store(observation);
+	return true;
+}
+
+bool InMemoryObservationsStorage::insertV2DataPointsInTimescaleDB(std::vector<Observation>::const_iterator begin,
+	std::vector<Observation>::const_iterator end)
+{
+	simulateTimescaleDBLatency();
+	std::lock_guard<std::mutex> lock{_mutex};
+	for (auto it = begin ; it != end ; ++it)
+		store(*it);
+	return true;
+}
+
+bool InMemoryObservationsStorage::insertV2EntireDayValues(const CassUuid& station, time_t time,
+	std::pair<bool, float> rainfall, std::pair<bool, int> insolationTime)
+{
+	simulateLatency();
+	std::lock_guard<std::mutex> lock{_mutex};
+	DayValues& values = _dayValues[{station, toSysDays(time)}];
+	values.rainfall = rainfall;
+	values.insolationTime = insolationTime;
+	return true;
+}
+
+bool InMemoryObservationsStorage::insertV2Tn(const CassUuid& station, time_t time, float tn)
+{
+	simulateLatency();
+	std::lock_guard<std::mutex> lock{_mutex};
+	_dayValues[{station, toSysDays(time)}].tn = {true, tn};
+	return true;
+}
+
+bool InMemoryObservationsStorage::insertV2Tx(const CassUuid& station, time_t time, float tx)
+{
+	simulateLatency();
+	std::lock_guard<std::mutex> lock{_mutex};
+	_dayValues[{station, toSysDays(time)}].tx = {true, tx};
+	return true;
+}
+
+bool InMemoryObservationsStorage::deleteDataPoints(const CassUuid& station, const date::sys_days&,
+	const date::sys_seconds& begin, const date::sys_seconds& end)
+{
+	simulateTimescaleDBLatency();
+	std::lock_guard<std::mutex> lock{_mutex};
+	auto it = _observations.find(station);
+	if (it != _observations.end())
+		it->second.erase(it->second.lower_bound(begin), it->second.upper_bound(end));
+	return true;
+}
+
+bool InMemoryObservationsStorage::insertDownload(const CassUuid& station, time_t time, const std::string& connectorId,
+	const std::string& content, bool done, const std::string& status)
+{
+	simulateLatency();
+	std::lock_guard<std::mutex> lock{_mutex};
+	_downloads[{station, time}] = StoredDownload{connectorId, content, done, status};
+	return true;
+}
+
+bool InMemoryObservationsStorage::selectDownloadsByStation(const CassUuid& station, const std::string& connectorId,
+	std::vector<Download>& downloads)
+{
+	simulateLatency();
+	std::lock_guard<std::mutex> lock{_mutex};
+	// only the downloads not processed yet are selected
+	for (auto it = _downloads.lower_bound({station, std::numeric_limits<time_t>::min()}) ;
+	     it != _downloads.end() && it->first.first == station ; ++it) {
+		if (it->second.done || it->second.connectorId != connectorId)
+			continue;
+		Download d;
+		d.station = station;
+		d.datetime = toSysSeconds(it->first.second);
+		d.content = it->second.content;
+		downloads.push_back(std::move(d));
+	}
+	return true;
+}
+
+bool InMemoryObservationsStorage::updateDownloadStatus(const CassUuid& station, time_t time, bool done,
+	const std::string& status)
+{
+	simulateLatency();
+	std::lock_guard<std::mutex> lock{_mutex};
+	auto it = _downloads.find({station, time});
+	if (it == _downloads.end())
+		return false;
+	it->second.done = done;
+	it->second.status = status;
+	return true;
+}
+
+}
@@ -0,0 +1,257 @@
+/**
+ * @file in_memory_observations_storage.h
+ * @brief Definition of the InMemoryObservationsStorage class
+ * @author Laurent Georget
+ * @date 2026-10-18
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef IN_MEMORY_OBSERVATIONS_STORAGE_H
+#define IN_MEMORY_OBSERVATIONS_STORAGE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <ctime>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <cassandra.h>
+#include <date/date.h>
+#include <cassobs/dbconnection_observations.h>
+#include <cassobs/observation.h>
+
+#include "storage/observations_storage.h"
+#include "cassandra_utils.h"
+
+namespace meteodata
+{
+
+namespace chrono = std::chrono;
+
+/**
+ * @brief An in-process stand-in for the observations databases
+ *
+ * The observations, the cached values, the last archive download times, the
+ * scheduler download times and the downloads are kept in memory, behind a
+ * single mutex, and lost when the process exits. The stations are loaded
+ * from a station table (see loadStationTable()), the lists of stations of
+ * the connectors not described in the table are empty and the modem
+ * configurations are never found.
+ *
+ * Each call can be delayed by a fixed latency, to approximate the round-trip
+ * to a real database while still not depending on one. The concurrency
+ * follows CassobsObservationsStorage: the latency of the calls that would go
+ * to Cassandra is spent before taking the mutex, so that concurrent calls
+ * overlap, while the calls that would go to TimescaleDB are serialized,
+ * latency included.
+ */
+class InMemoryObservationsStorage : public ObservationsStorage
+{
+public:
+	/**
+	 * @brief Create an empty storage
+	 *
+	 * @param latency The delay added to each call
+	 */
+	explicit InMemoryObservationsStorage(chrono::microseconds latency = chrono::microseconds::zero());
+
+	/**
+	 * @brief Load the stations from a station table
+	 *
+	 * The station table is a text file, with one station or connector per
+	 * line and the fields separated by tabulations. Empty lines and lines
+	 * starting with '#' are ignored. The first field gives the type of the
+	 * line:
+	 * - station, uuid, name, poll period (in minutes), latitude, longitude,
+	 *   elevation;
+	 * - mqtt, uuid, broker host, broker port, user, password, topic,
+	 *   timezone identifier;
+	 * - liveobjects, uuid, Liveobjects identifier, stream identifier;
+	 * - nbiot, uuid, IMEI, HMAC key, sensor type;
+	 * - icao, uuid, ICAO code.
+	 * The stations referenced by a connector line but missing a station
+	 * line get a default name and a poll period of 10 minutes.
+	 *
+	 * @param stationTable The path to the station table
+	 * @throw std::runtime_error If the file cannot be read or a line is
+	 * invalid
+	 */
+	void loadStationTable(const std::string& stationTable);
+
+	/**
+	 * @brief Change the delay added to each call
+	 *
+	 * @param latency The new delay
+	 */
+	void setLatency(chrono::microseconds latency);
+
+	/**
+	 * @brief Count the observations stored so far, an observation
+	 * replacing another one for the same station and the same time is
+	 * not counted twice
+	 */
+	std::size_t getObservationsCount() const;
+
+	bool cacheFloat(const CassUuid& station, const std::string& key, time_t update, float value) override;
+	bool cacheInt(const CassUuid& station, const std::string& key, time_t update, int value) override;
+	bool getCachedFloat(const CassUuid& station, const std::string& key, time_t& update, float& value) override;
+	bool getCachedInt(const CassUuid& station, const std::string& key, time_t& update, int& value) override;
+
+	bool getAllCimelStations(std::vector<std::tuple<CassUuid, std::string, int>>& stations) override;
+	bool getAllFieldClimateApiStations(std::vector<std::tuple<CassUuid, std::string, int, std::map<std::string, std::string>>>& stations) override;
+	bool getAllIcaos(std::vector<std::tuple<CassUuid, std::string>>& stations) override;
+	bool getAllLiveobjectsStations(std::vector<std::tuple<CassUuid, std::string, std::string>>& stations) override;
+	bool getAllNbiotStations(std::vector<NbiotStation>& stations) override;
+	bool getAllVirtualStations(std::vector<VirtualStation>& stations) override;
+	bool getAllWeatherlinkAPIv2Stations(std::vector<std::tuple<CassUuid, bool, std::map<int, CassUuid>, std::string, std::map<int, std::map<std::string, std::string>>>>& stations) override;
+	bool getAllWeatherlinkStations(std::vector<std::tuple<CassUuid, std::string, std::string, int>>& stations) override;
+	bool getDeferredSynops(std::vector<std::tuple<CassUuid, std::string>>& stations) override;
+	bool getMBDataTxtStations(std::vector<std::tuple<CassUuid, std::string, std::string, bool, int, std::string>>& stations) override;
+	bool getMeteoFranceStations(std::vector<std::tuple<CassUuid, std::string, std::string, int, float, float, int, int>>& stations) override;
+	bool getMqttStations(std::vector<std::tuple<CassUuid, std::string, int, std::string, std::unique_ptr<char[]>, size_t, std::string, int>>& stations) override;
+	bool getStatICTxtStations(std::vector<std::tuple<CassUuid, std::string, std::string, bool, int, std::map<std::string, std::string>>>& stations) override;
+	bool selectExportedStations(const std::string& partner, std::vector<ExportedStation>& stations) override;
+
+	bool getStationByCoords(int elevation, int latitude, int longitude, CassUuid& station,
+		std::string& name, int& pollPeriod, time_t& lastArchiveDownloadTime, bool* storeInsideMeasurements) override;
+	bool getStationCoordinates(const CassUuid& station, float& latitude, float& longitude, int& elevation,
+		std::string& name, int& pollPeriod) override;
+	bool getStationDetails(const CassUuid& station, std::string& name, int& pollPeriod,
+		time_t& lastArchiveDownloadTime, bool* storeInsideMeasurements) override;
+	bool getStationLocation(const CassUuid& station, float& latitude, float& longitude, int& elevation) override;
+
+	bool getLastConfiguration(const CassUuid& station, ModemStationConfiguration& configuration) override;
+	bool getOneConfiguration(const CassUuid& station, int id, ModemStationConfiguration& configuration) override;
+	bool updateConfigurationStatus(const CassUuid& station, int id, bool active) override;
+
+	bool getLastSchedulerDownloadTime(const std::string& scheduler, time_t& lastDownloadTime) override;
+	bool insertLastSchedulerDownloadTime(const std::string& scheduler, time_t lastDownloadTime) override;
+	bool updateLastArchiveDownloadTime(const CassUuid& station, time_t lastArchiveDownloadTime) override;
+
+	bool getLastDataBefore(const CassUuid& station, time_t boundary, Observation& observation) override;
+	bool getDataBetween(const CassUuid& station, time_t begin, time_t end,
+		std::vector<Observation>& observations) override;
+	bool getRainfall(const CassUuid& station, time_t begin, time_t end, float& rainfall) override;
+	bool insertCollection(const CassUuid& station, time_t time, const std::string& type, const std::string& body) override;
+	bool insertV2DataPoint(const Observation& observation) override;
+	bool insertV2DataPoints(std::vector<Observation>::const_iterator begin,
+		std::vector<Observation>::const_iterator end) override;
+	bool insertV2DataPointInTimescaleDB(const Observation& observation) override;
+	bool insertV2DataPointsInTimescaleDB(std::vector<Observation>::const_iterator begin,
+		std::vector<Observation>::const_iterator end) override;
+	bool insertV2EntireDayValues(const CassUuid& station, time_t time,
+		std::pair<bool, float> rainfall, std::pair<bool, int> insolationTime) override;
+	bool insertV2Tn(const CassUuid& station, time_t time, float tn) override;
+	bool insertV2Tx(const CassUuid& station, time_t time, float tx) override;
+	bool deleteDataPoints(const CassUuid& station, const date::sys_days& day,
+		const date::sys_seconds& begin, const date::sys_seconds& end) override;
+
+	bool insertDownload(const CassUuid& station, time_t time, const std::string& connectorId,
+		const std::string& content, bool done, const std::string& status) override;
+	bool selectDownloadsByStation(const CassUuid& station, const std::string& connectorId,
+		std::vector<Download>& downloads) override;
+	bool updateDownloadStatus(const CassUuid& station, time_t time, bool done, const std::string& status) override;
+
+private:
+	struct Station
+	{
+		std::string name;
+		int pollPeriod = 10;
+		float latitude = 0.f;
+		float longitude = 0.f;
+		int elevation = 0;
+		time_t lastArchiveDownloadTime = 0;
+	};
+
+	struct MqttStation
+	{
+		CassUuid station;
+		std::string host;
+		int port;
+		std::string user;
+		std::string password;
+		std::string topic;
+		int timezone;
+	};
+
+	struct DayValues
+	{
+		std::pair<bool, float> rainfall{false, 0.f};
+		std::pair<bool, int> insolationTime{false, 0};
+		std::pair<bool, float> tn{false, 0.f};
+		std::pair<bool, float> tx{false, 0.f};
+	};
+
+	struct StoredDownload
+	{
+		std::string connectorId;
+		std::string content;
+		bool done;
+		std::string status;
+	};
+
+	std::atomic<chrono::microseconds::rep> _latency;
+
+	mutable std::mutex _mutex;
+
+	/**
+	 * @brief The mutex serializing the calls standing for the TimescaleDB
+	 * ones, like in the real storage
+	 */
+	mutable std::mutex _pgMutex;
+
+	std::map<CassUuid, Station> _stations;
+	std::vector<MqttStation> _mqttStations;
+	std::vector<std::tuple<CassUuid, std::string, std::string>> _liveobjectsStations;
+	std::vector<NbiotStation> _nbiotStations;
+	std::vector<std::tuple<CassUuid, std::string>> _icaos;
+
+	std::map<std::pair<CassUuid, std::string>, std::pair<time_t, float>> _cachedFloats;
+	std::map<std::pair<CassUuid, std::string>, std::pair<time_t, int>> _cachedInts;
+	std::map<std::string, time_t> _schedulerDownloadTimes;
+
+	std::map<CassUuid, std::map<date::sys_seconds, Observation>> _observations;
+	std::map<std::pair<CassUuid, date::sys_days>, DayValues> _dayValues;
+	std::size_t _collections = 0;
+	std::map<std::pair<CassUuid, time_t>, StoredDownload> _downloads;
+
+	/**
+	 * @brief Wait for the configured latency
+	 */
+	void simulateLatency() const;
+
+	/**
+	 * @brief Wait for the configured latency, one call at a time
+	 */
+	void simulateTimescaleDBLatency() const;
+
+	/**
+	 * @brief Store an observation, the mutex must be held
+	 */
+	void store(const Observation& observation);
+};
+
+}
+
+#endif /* IN_MEMORY_OBSERVATIONS_STORAGE_H */
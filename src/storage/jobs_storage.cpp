@@ -0,0 +1,96 @@
+/**
+ * @file jobs_storage.cpp
+ * @brief Implementation of the JobsStorage implementations
+ * @author Laurent Georget
+ * @date 2026-10-18
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <cassandra.h>
+#include <cassobs/dbconnection_jobs.h>
+
+#include "storage/jobs_storage.h"
+
+namespace meteodata
+{
+
+std::unique_ptr<JobsStorage> JobsStorage::create(const StorageConfiguration& storage,
+	const std::string& address, const std::string& user, const std::string& password,
+	const std::string& database)
+{
+	if (storage.backend == "cassandra")
+		return std::make_unique<CassobsJobsStorage>(address, user, password, database);
+	else if (storage.backend == "memory")
+		return std::make_unique<InMemoryJobsStorage>(chrono::microseconds{storage.latency});
+
+	throw std::runtime_error("Unknown storage backend '" + storage.backend + "', expected 'cassandra' or 'memory'");
+}
+
+CassobsJobsStorage::CassobsJobsStorage(const std::string& address, const std::string& user,
+	const std::string& password, const std::string& database) :
+		_db{address, user, password, database}
+{}
+
+void CassobsJobsStorage::publishMinmax(const CassUuid& station, time_t begin, time_t end)
+{
+	_db.publishMinmax(station, begin, end);
+}
+
+void CassobsJobsStorage::publishAnomalyMonitoring(const CassUuid& station, time_t begin, time_t end)
+{
+	_db.publishAnomalyMonitoring(station, begin, end);
+}
+
+InMemoryJobsStorage::InMemoryJobsStorage(chrono::microseconds latency) :
+	_latency{latency}
+{}
+
+void InMemoryJobsStorage::publishMinmax(const CassUuid& station, time_t begin, time_t end)
+{
+	publish(Job::Type::MINMAX, station, begin, end);
+}
+
+void InMemoryJobsStorage::publishAnomalyMonitoring(const CassUuid& station, time_t begin, time_t end)
+{
+	publish(Job::Type::ANOMALY_MONITORING, station, begin, end);
+}
+
+void InMemoryJobsStorage::publish(Job::Type type, const CassUuid& station, time_t begin, time_t end)
+{
+	if (_latency > chrono::microseconds::zero())
+		std::this_thread::sleep_for(_latency);
+	std::lock_guard<std::mutex> lock{_mutex};
+	_jobs.push_back(Job{type, station, begin, end});
+}
+
+std::vector<InMemoryJobsStorage::Job> InMemoryJobsStorage::getJobs() const
+{
+	std::lock_guard<std::mutex> lock{_mutex};
+	return _jobs;
+}
+
+}
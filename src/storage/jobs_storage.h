@@ -0,0 +1,134 @@
+/**
+ * @file jobs_storage.h
+ * @brief Definition of the JobsStorage interface and its implementations
+ * @author Laurent Georget
+ * @date 2026-10-18
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JOBS_STORAGE_H
+#define JOBS_STORAGE_H
+
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <cassandra.h>
+#include <cassobs/dbconnection_jobs.h>
+
+#include "storage/observations_storage.h"
+
+namespace meteodata
+{
+
+namespace chrono = std::chrono;
+
+/**
+ * @brief The queue of the jobs published for the workers (the computation
+ * of the daily and monthly extremes, the anomaly monitoring, etc.)
+ */
+class JobsStorage
+{
+public:
+	virtual ~JobsStorage() = default;
+
+	/**
+	 * @brief Create the jobs queue matching the storage selected in the
+	 * configuration
+	 *
+	 * @param storage The backend selection
+	 * @param address The address of the jobs database
+	 * @param user The jobs database username
+	 * @param password The jobs database password
+	 * @param database The jobs database name
+	 * @return The jobs queue
+	 * @throw std::runtime_error If the backend is unknown
+	 */
+	static std::unique_ptr<JobsStorage> create(const StorageConfiguration& storage,
+		const std::string& address, const std::string& user, const std::string& password,
+		const std::string& database);
+
+	virtual void publishMinmax(const CassUuid& station, time_t begin, time_t end) = 0;
+	virtual void publishAnomalyMonitoring(const CassUuid& station, time_t begin, time_t end) = 0;
+};
+
+/**
+ * @brief The jobs queue in the PostgreSQL jobs database, through the cassobs
+ * library
+ */
+class CassobsJobsStorage : public JobsStorage
+{
+public:
+	CassobsJobsStorage(const std::string& address, const std::string& user, const std::string& password,
+		const std::string& database);
+
+	void publishMinmax(const CassUuid& station, time_t begin, time_t end) override;
+	void publishAnomalyMonitoring(const CassUuid& station, time_t begin, time_t end) override;
+
+private:
+	DbConnectionJobs _db;
+};
+
+/**
+ * @brief An in-process jobs queue, the counterpart of the
+ * InMemoryObservationsStorage
+ *
+ * No worker consumes the jobs, they are only kept to be inspected.
+ */
+class InMemoryJobsStorage : public JobsStorage
+{
+public:
+	struct Job
+	{
+		enum class Type { MINMAX, ANOMALY_MONITORING };
+		Type type;
+		CassUuid station;
+		time_t begin;
+		time_t end;
+	};
+
+	/**
+	 * @brief Create an empty queue
+	 *
+	 * @param latency The delay added to each call
+	 */
+	explicit InMemoryJobsStorage(chrono::microseconds latency = chrono::microseconds::zero());
+
+	void publishMinmax(const CassUuid& station, time_t begin, time_t end) override;
+	void publishAnomalyMonitoring(const CassUuid& station, time_t begin, time_t end) override;
+
+	/**
+	 * @brief Get a copy of the jobs published so far
+	 */
+	std::vector<Job> getJobs() const;
+
+private:
+	chrono::microseconds _latency;
+	mutable std::mutex _mutex;
+	std::vector<Job> _jobs;
+
+	void publish(Job::Type type, const CassUuid& station, time_t begin, time_t end);
+};
+
+}
+
+#endif /* JOBS_STORAGE_H */
@@ -0,0 +1,57 @@
+/**
+ * @file observations_storage.cpp
+ * @brief Implementation of the ObservationsStorage factory
+ * @author Laurent Georget
+ * @date 2026-10-18
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include <systemd/sd-daemon.h>
+
+#include "storage/observations_storage.h"
+#include "storage/cassobs_observations_storage.h"
+#include "storage/in_memory_observations_storage.h"
+
+namespace meteodata
+{
+
+std::unique_ptr<ObservationsStorage> ObservationsStorage::create(const StorageConfiguration& storage,
+	const std::string& address, const std::string& user, const std::string& password,
+	const std::string& pgAddress, const std::string& pgUser, const std::string& pgPassword)
+{
+	if (storage.backend == "cassandra") {
+		return std::make_unique<CassobsObservationsStorage>(address, user, password, pgAddress, pgUser, pgPassword);
+	} else if (storage.backend == "memory") {
+		auto inMemory = std::make_unique<InMemoryObservationsStorage>(std::chrono::microseconds{storage.latency});
+		if (!storage.stationTable.empty())
+			inMemory->loadStationTable(storage.stationTable);
+		std::cerr << SD_WARNING << "[Server] management: " << "Using the in-memory storage, "
+			  << "nothing will be persisted" << std::endl;
+		return inMemory;
+	}
+
+	throw std::runtime_error("Unknown storage backend '" + storage.backend + "', expected 'cassandra' or 'memory'");
+}
+
+}
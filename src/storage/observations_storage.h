@@ -0,0 +1,169 @@
+/**
+ * @file observations_storage.h
+ * @brief Definition of the ObservationsStorage interface
+ * @author Laurent Georget
+ * @date 2026-10-18
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef OBSERVATIONS_STORAGE_H
+#define OBSERVATIONS_STORAGE_H
+
+#include <ctime>
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <cassandra.h>
+#include <date/date.h>
+#include <cassobs/dbconnection_observations.h>
+#include <cassobs/observation.h>
+#include <cassobs/dto/download.h>
+#include <cassobs/dto/exported_station.h>
+#include <cassobs/dto/virtual_station.h>
+
+namespace meteodata
+{
+
+/**
+ * @brief The selection of the storage backend, common to the daemon and the
+ * standalone programs
+ */
+struct StorageConfiguration
+{
+	/**
+	 * @brief The backend, "cassandra" for the real databases (Cassandra
+	 * and TimescaleDB), or "memory" for the in-process stand-in
+	 */
+	std::string backend = "cassandra";
+	/**
+	 * @brief With the "memory" backend, the file listing the stations
+	 * to serve (see InMemoryObservationsStorage::loadStationTable())
+	 */
+	std::string stationTable;
+	/**
+	 * @brief With the "memory" backend, the latency added to each call,
+	 * in microseconds
+	 */
+	unsigned long latency = 0;
+};
+
+/**
+ * @brief The storage of the observations and of the stations metadata, as
+ * seen by the connectors, the downloaders and the standalone programs
+ *
+ * The interface mirrors the subset of DbConnectionObservations used in
+ * Meteodata, with the same semantics: each method returns false when the
+ * call fails or, for the lookups, when there is nothing to return.
+ * Two implementations are available: CassobsObservationsStorage, which
+ * forwards the calls to the real databases, and InMemoryObservationsStorage,
+ * an in-process stand-in used to measure the throughput of the decoding
+ * and dispatching without the database latency, or to load-test Meteodata
+ * without a cluster.
+ */
+class ObservationsStorage
+{
+public:
+	virtual ~ObservationsStorage() = default;
+
+	/**
+	 * @brief Create the storage selected in the configuration
+	 *
+	 * @param storage The backend selection
+	 * @param address The address of the Cassandra cluster
+	 * @param user The Cassandra username
+	 * @param password The Cassandra password
+	 * @param pgAddress The address of the TimescaleDB database
+	 * @param pgUser The TimescaleDB username
+	 * @param pgPassword The TimescaleDB password
+	 * @return The storage, connected to the databases or loaded from the
+	 * station table
+	 * @throw std::runtime_error If the backend is unknown or the station
+	 * table cannot be read
+	 */
+	static std::unique_ptr<ObservationsStorage> create(const StorageConfiguration& storage,
+		const std::string& address, const std::string& user, const std::string& password,
+		const std::string& pgAddress, const std::string& pgUser, const std::string& pgPassword);
+
+	virtual bool cacheFloat(const CassUuid& station, const std::string& key, time_t update, float value) = 0;
+	virtual bool cacheInt(const CassUuid& station, const std::string& key, time_t update, int value) = 0;
+	virtual bool getCachedFloat(const CassUuid& station, const std::string& key, time_t& update, float& value) = 0;
+	virtual bool getCachedInt(const CassUuid& station, const std::string& key, time_t& update, int& value) = 0;
+
+	virtual bool getAllCimelStations(std::vector<std::tuple<CassUuid, std::string, int>>& stations) = 0;
+	virtual bool getAllFieldClimateApiStations(std::vector<std::tuple<CassUuid, std::string, int, std::map<std::string, std::string>>>& stations) = 0;
+	virtual bool getAllIcaos(std::vector<std::tuple<CassUuid, std::string>>& stations) = 0;
+	virtual bool getAllLiveobjectsStations(std::vector<std::tuple<CassUuid, std::string, std::string>>& stations) = 0;
+	virtual bool getAllNbiotStations(std::vector<NbiotStation>& stations) = 0;
+	virtual bool getAllVirtualStations(std::vector<VirtualStation>& stations) = 0;
+	virtual bool getAllWeatherlinkAPIv2Stations(std::vector<std::tuple<CassUuid, bool, std::map<int, CassUuid>, std::string, std::map<int, std::map<std::string, std::string>>>>& stations) = 0;
+	virtual bool getAllWeatherlinkStations(std::vector<std::tuple<CassUuid, std::string, std::string, int>>& stations) = 0;
+	virtual bool getDeferredSynops(std::vector<std::tuple<CassUuid, std::string>>& stations) = 0;
+	virtual bool getMBDataTxtStations(std::vector<std::tuple<CassUuid, std::string, std::string, bool, int, std::string>>& stations) = 0;
+	virtual bool getMeteoFranceStations(std::vector<std::tuple<CassUuid, std::string, std::string, int, float, float, int, int>>& stations) = 0;
+	virtual bool getMqttStations(std::vector<std::tuple<CassUuid, std::string, int, std::string, std::unique_ptr<char[]>, size_t, std::string, int>>& stations) = 0;
+	virtual bool getStatICTxtStations(std::vector<std::tuple<CassUuid, std::string, std::string, bool, int, std::map<std::string, std::string>>>& stations) = 0;
+	virtual bool selectExportedStations(const std::string& partner, std::vector<ExportedStation>& stations) = 0;
+
+	virtual bool getStationByCoords(int elevation, int latitude, int longitude, CassUuid& station,
+		std::string& name, int& pollPeriod, time_t& lastArchiveDownloadTime, bool* storeInsideMeasurements = nullptr) = 0;
+	virtual bool getStationCoordinates(const CassUuid& station, float& latitude, float& longitude, int& elevation,
+		std::string& name, int& pollPeriod) = 0;
+	virtual bool getStationDetails(const CassUuid& station, std::string& name, int& pollPeriod,
+		time_t& lastArchiveDownloadTime, bool* storeInsideMeasurements = nullptr) = 0;
+	virtual bool getStationLocation(const CassUuid& station, float& latitude, float& longitude, int& elevation) = 0;
+
+	virtual bool getLastConfiguration(const CassUuid& station, ModemStationConfiguration& configuration) = 0;
+	virtual bool getOneConfiguration(const CassUuid& station, int id, ModemStationConfiguration& configuration) = 0;
+	virtual bool updateConfigurationStatus(const CassUuid& station, int id, bool active) = 0;
+
+	virtual bool getLastSchedulerDownloadTime(const std::string& scheduler, time_t& lastDownloadTime) = 0;
+	virtual bool insertLastSchedulerDownloadTime(const std::string& scheduler, time_t lastDownloadTime) = 0;
+	virtual bool updateLastArchiveDownloadTime(const CassUuid& station, time_t lastArchiveDownloadTime) = 0;
+
+	virtual bool getLastDataBefore(const CassUuid& station, time_t boundary, Observation& observation) = 0;
+	virtual bool getDataBetween(const CassUuid& station, time_t begin, time_t end,
+		std::vector<Observation>& observations) = 0;
+	virtual bool getRainfall(const CassUuid& station, time_t begin, time_t end, float& rainfall) = 0;
+	virtual bool insertCollection(const CassUuid& station, time_t time, const std::string& type, const std::string& body) = 0;
+	virtual bool insertV2DataPoint(const Observation& observation) = 0;
+	virtual bool insertV2DataPoints(std::vector<Observation>::const_iterator begin,
+		std::vector<Observation>::const_iterator end) = 0;
+	virtual bool insertV2DataPointInTimescaleDB(const Observation& observation) = 0;
+	virtual bool insertV2DataPointsInTimescaleDB(std::vector<Observation>::const_iterator begin,
+		std::vector<Observation>::const_iterator end) = 0;
+	virtual bool insertV2EntireDayValues(const CassUuid& station, time_t time,
+		std::pair<bool, float> rainfall, std::pair<bool, int> insolationTime) = 0;
+	virtual bool insertV2Tn(const CassUuid& station, time_t time, float tn) = 0;
+	virtual bool insertV2Tx(const CassUuid& station, time_t time, float tx) = 0;
+	virtual bool deleteDataPoints(const CassUuid& station, const date::sys_days& day,
+		const date::sys_seconds& begin, const date::sys_seconds& end) = 0;
+
+	virtual bool insertDownload(const CassUuid& station, time_t time, const std::string& connectorId,
+		const std::string& content, bool done, const std::string& status) = 0;
+	virtual bool selectDownloadsByStation(const CassUuid& station, const std::string& connectorId,
+		std::vector<Download>& downloads) = 0;
+	virtual bool updateDownloadStatus(const CassUuid& station, time_t time, bool done, const std::string& status) = 0;
+};
+
+}
+
+#endif /* OBSERVATIONS_STORAGE_H */
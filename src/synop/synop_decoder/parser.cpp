@@ -3,13 +3,86 @@
 
 #include <vector>
 #include <string>
+#include <string_view>
 #include <iterator>
 #include <iostream>
-#include <sstream>
-#include <experimental/optional>
+#include <optional>
 
 #include <date/date.h>
 
+namespace
+{
+
+/* All the helpers below work on views on the groups of the message, they
+ * never allocate */
+
+bool isSpace(char c)
+{
+	return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+std::optional<int>
+parseInt(std::string_view s, std::string_view::size_type pos, std::string_view::size_type endpos = std::string_view::npos)
+{
+	int n = 0;
+	for (auto i = pos ; i < s.length() && i <= endpos ; i++) {
+		if (s[i] == '/')
+			return std::optional<int>();
+		n = (n * 10) + (s[i] - '0');
+	}
+	return std::optional<int>(n);
+}
+
+std::optional<int>
+parseSInt(std::string_view s, std::string_view::size_type pos, std::string_view::size_type endpos = std::string_view::npos)
+{
+	int n = 0;
+	if (pos >= s.length() || s[pos] == '/')
+		return std::optional<int>();
+	for (auto i = pos + 1 ; i < s.length() && i <= endpos ; i++) {
+		if (s[i] == '/')
+			return std::optional<int>();
+		n = (n * 10) + (s[i] - '0');
+	}
+	if (s[pos] == '1')
+		n *= -1;
+	return std::optional<int>(n);
+}
+
+std::optional<PrecipitationAmount> parseRain(std::string_view s)
+{
+	std::optional<int> rrr = parseInt(s, 1, 3);
+	if (rrr) {
+		PrecipitationAmount pr;
+		if (rrr > 990) {
+			pr._amount = (*rrr - 990) / 10.;
+			pr._trace = false;
+		} else if (rrr == 990) {
+			pr._amount = 0;
+			pr._trace = true;
+		} else {
+			pr._amount = *rrr;
+			pr._trace = false;
+		}
+		pr._duration =
+			s[4] == '1' ? 6 :
+			s[4] == '2' ? 12 :
+			s[4] == '3' ? 18 :
+			s[4] == '4' ? 24 :
+			s[4] == '5' ? 1 :
+			s[4] == '6' ? 2 :
+			s[4] == '7' ? 3 :
+			s[4] == '8' ? 9 :
+			s[4] == '9' ? 15 :
+			              0;
+		return pr;
+	} else {
+		return std::optional<PrecipitationAmount>();
+	}
+}
+
+}
+
 Parser::Parser()
 {
 }
@@ -22,9 +95,19 @@ bool Parser::parseSection0(decltype(_groups)::iterator& it)
 	if (it == _groups.end())
 		return false;
 
-	// Timestamp
-	std::istringstream timestamp{*it};
-	timestamp >> date::parse("%Y,%m,%d,%H,%M", _message._observationTime);
+	// Timestamp, YYYY,MM,DD,HH,mm
+	const std::string_view& timestamp = *it;
+	std::optional<int> year = parseInt(timestamp, 0, 3);
+	std::optional<int> month = parseInt(timestamp, 5, 6);
+	std::optional<int> day = parseInt(timestamp, 8, 9);
+	std::optional<int> hour = parseInt(timestamp, 11, 12);
+	std::optional<int> minute = parseInt(timestamp, 14, 15);
+	if (!year || !month || !day || !hour || !minute)
+		return false;
+	date::year_month_day ymd{date::year{*year}, date::month(*month), date::day(*day)};
+	if (!ymd.ok())
+		return false;
+	_message._observationTime = date::sys_days{ymd} + std::chrono::hours{*hour} + std::chrono::minutes{*minute};
 	++it;
 	if (it == _groups.end())
 		return false;
@@ -73,66 +156,6 @@ bool Parser::parseSection0(decltype(_groups)::iterator& it)
 	return true;
 }
 
-std::experimental::optional<int>
-parseInt(const std::string& s, std::string::size_type pos, std::string::size_type endpos = std::string::npos)
-{
-	int n = 0;
-	for (auto i = pos ; i < s.length() && i <= endpos ; i++) {
-		if (s[i] == '/')
-			return std::experimental::optional<int>();
-		n = (n * 10) + (s[i] - '0');
-	}
-	return std::experimental::optional<int>(n);
-}
-
-std::experimental::optional<int>
-parseSInt(const std::string& s, std::string::size_type pos, std::string::size_type endpos = std::string::npos)
-{
-	int n = 0;
-	if (s[pos] == '/')
-		return std::experimental::optional<int>();
-	for (auto i = pos + 1 ; i < s.length() && i <= endpos ; i++) {
-		if (s[i] == '/')
-			return std::experimental::optional<int>();
-		n = (n * 10) + (s[i] - '0');
-	}
-	if (s[pos] == '1')
-		n *= -1;
-	return std::experimental::optional<int>(n);
-}
-
-std::experimental::optional<PrecipitationAmount> parseRain(const std::string& s)
-{
-	std::experimental::optional<int> rrr = parseInt(s, 1, 3);
-	if (rrr) {
-		PrecipitationAmount pr;
-		if (rrr > 990) {
-			pr._amount = (*rrr - 990) / 10.;
-			pr._trace = false;
-		} else if (rrr == 990) {
-			pr._amount = 0;
-			pr._trace = true;
-		} else {
-			pr._amount = *rrr;
-			pr._trace = false;
-		}
-		pr._duration =
-			s[4] == '1' ? 6 :
-			s[4] == '2' ? 12 :
-			s[4] == '3' ? 18 :
-			s[4] == '4' ? 24 :
-			s[4] == '5' ? 1 :
-			s[4] == '6' ? 2 :
-			s[4] == '7' ? 3 :
-			s[4] == '8' ? 9 :
-			s[4] == '9' ? 15 :
-			              0;
-		return pr;
-	} else {
-		return std::experimental::optional<PrecipitationAmount>();
-	}
-}
-
 bool Parser::parseSection1(decltype(_groups)::iterator& it)
 {
 	// No section 1, that's not normal, going on anyway
@@ -200,7 +223,7 @@ bool Parser::parseSection1(decltype(_groups)::iterator& it)
 
 	// Horizontal visibility, VV
 	if (it->at(3) != '/' && it->at(4) != '/') {
-		int vv = (*it)[3] * 10 + (*it)[4];
+		int vv = ((*it)[3] - '0') * 10 + ((*it)[4] - '0');
 		if (vv == 0)
 			_message._horizVisibility = Range<float>{0., 0.1, false, false};
 		else if (vv >= 1 && vv <= 50)
@@ -246,12 +269,12 @@ bool Parser::parseSection1(decltype(_groups)::iterator& it)
 	_message._cloudCover = static_cast<Nebulosity>(it->at(0));
 
 	// Dominant direction of the wind
-	std::experimental::optional<int> n = parseInt(*it, 1, 2);
+	std::optional<int> n = parseInt(*it, 1, 2);
 	if (n)
 		_message._meanWindDirection = (*n) * 10;
 
 	// Mean wind speed
-	std::experimental::optional<int> ff = parseInt(*it, 3);
+	std::optional<int> ff = parseInt(*it, 3);
 	if (ff) {
 		//special case first
 		if (*ff == 99) {
@@ -273,6 +296,12 @@ bool Parser::parseSection1(decltype(_groups)::iterator& it)
 	char indicative = '0';
 	while (it != _groups.end() && it->compare(0, 3, "222") != 0 && it->length() != 3) {
 		auto& s = *it;
+		// The groups are views into the line, a truncated group must not
+		// be read past its end
+		if (s.length() != 5) {
+			++it;
+			continue;
+		}
 		if (s[0] < indicative)
 			return false;
 
@@ -309,7 +338,7 @@ bool Parser::parseSection1(decltype(_groups)::iterator& it)
 			_message._pressureTendency = PressureTendency{static_cast<PressureTendency::Description>(s[1]),
 				parseInt(s, 2).value()};
 		} else if (s[0] == '6') {
-			std::experimental::optional<PrecipitationAmount> pr = parseRain(s);
+			std::optional<PrecipitationAmount> pr = parseRain(s);
 
 			if (pr)
 				_message._precipitation.push_back(*pr);
@@ -356,6 +385,12 @@ bool Parser::parseSection3(decltype(_groups)::iterator& it)
 	char indicative = '0';
 	while (it != _groups.end() && it->compare(0, 3, "222") != 0 && it->length() != 3) {
 		auto& s = *it;
+		// The groups are views into the line, a truncated group must not
+		// be read past its end
+		if (s.length() != 5) {
+			++it;
+			continue;
+		}
 		if (s[0] < indicative)
 			return false;
 
@@ -370,7 +405,7 @@ bool Parser::parseSection3(decltype(_groups)::iterator& it)
 			_message._minSoilTemperature = parseSInt(s, 2);
 		} else if (s[0] == '4') {
 			_message._groundStateWithSnowOrIce = static_cast<GroundStateWithSnowOrIce>(s[1]);
-			std::experimental::optional<int> maybeSnow = parseInt(s, 2);
+			std::optional<int> maybeSnow = parseInt(s, 2);
 			if (maybeSnow) {
 				SnowDepth d;
 				int sss = *maybeSnow;
@@ -387,6 +422,7 @@ bool Parser::parseSection3(decltype(_groups)::iterator& it)
 					d._depth = 0;
 					d._cover = SnowDepth::SnowCoverageCondition::NOT_MEASURED;
 				}
+				_message._snowDepth = d;
 			}
 		} else if (s[0] == '5') {
 			if (s == "55407") {
@@ -410,7 +446,7 @@ bool Parser::parseSection3(decltype(_groups)::iterator& it)
 					break;
 				_message._directSolarRadiationLast24Hours = parseInt(*it, 1);
 			} else if (s[1] == '5' && s[2] == '3') {
-				std::experimental::optional<int> time = parseInt(s, 3);
+				std::optional<int> time = parseInt(s, 3);
 				if (time)
 					_message._minutesOfSunshineLastHour = *time * 6; // conversion from tenths of hours to minutes
 				++it;
@@ -429,7 +465,7 @@ bool Parser::parseSection3(decltype(_groups)::iterator& it)
 				else if (it->at(0) == '6')
 					_message._shortWaveRadiationLastHour = parseInt(*it, 1);
 			} else if (s[1] == '5') {
-				std::experimental::optional<int> time = parseInt(s, 2);
+				std::optional<int> time = parseInt(s, 2);
 				if (time)
 					_message._minutesOfSunshineLastDay = *time * 6; // conversion from tenths of hours to minutes
 				++it;
@@ -457,7 +493,7 @@ bool Parser::parseSection3(decltype(_groups)::iterator& it)
 				_message._clouds.push_back(CloudElevation{static_cast<CloudGenus>(s[2]), static_cast<Direction>(s[3]),
 					static_cast<CloudElevation::ElevationAngle>(s[4])});
 			} else {
-				std::experimental::optional<int> eee = parseInt(s, 1, 3);
+				std::optional<int> eee = parseInt(s, 1, 3);
 				if (eee) {
 					_message._evapoMaybeTranspiRation = EvapoMaybeTranspiRation{
 						static_cast<EvapoMaybeTranspiRation::Instrumentation>(s[4]),
@@ -466,13 +502,13 @@ bool Parser::parseSection3(decltype(_groups)::iterator& it)
 				}
 			}
 		} else if (s[0] == '6') {
-			std::experimental::optional<PrecipitationAmount> pr = parseRain(s);
+			std::optional<PrecipitationAmount> pr = parseRain(s);
 
 			if (pr)
 				_message._precipitation.push_back(*pr);
 		} else if (s[0] == '7') {
 			PrecipitationAmount pr;
-			std::experimental::optional<int> rrrr = parseInt(s, 1);
+			std::optional<int> rrrr = parseInt(s, 1);
 			if (rrrr) {
 				if (*rrrr <= 9998) {
 					pr._amount = *rrrr / 10.;
@@ -485,7 +521,7 @@ bool Parser::parseSection3(decltype(_groups)::iterator& it)
 				_message._precipitation.push_back(pr);
 			}
 		} else if (s[0] == '8') {
-			std::experimental::optional<int> hshs = parseInt(s, 3);
+			std::optional<int> hshs = parseInt(s, 3);
 			if (hshs) {
 				Range<int> height;
 				if (*hshs <= 50) {
@@ -531,14 +567,14 @@ bool Parser::parseSection3(decltype(_groups)::iterator& it)
 				++it;
 				if (it == _groups.end())
 					break;
-				if (duration && *duration <= 60) {
+				if (duration && *duration <= 60 && it->length() == 5) {
 					if ((*it)[1] == '1' && (*it)[2] == '1') {
-						std::experimental::optional<int> gust;
+						std::optional<int> gust;
 						if ((*it)[3] == '9' && (*it)[4] == '9') {
 							++it;
 							if (it == _groups.end())
 								break;
-							if ((*it)[0] == '0' && (*it)[1] == '0')
+							if (it->length() == 5 && (*it)[0] == '0' && (*it)[1] == '0')
 								gust = parseInt(*it, 2);
 						} else {
 							gust = parseInt(*it, 3);
@@ -569,7 +605,7 @@ bool Parser::parseSection4(decltype(_groups)::iterator& it)
 	++it;
 
 	// Do not parse this section
-	while (it->length() != 3 && it != _groups.end())
+	while (it != _groups.end() && it->length() != 3)
 		++it;
 	return true;
 }
@@ -582,9 +618,15 @@ bool Parser::parseSection5(decltype(_groups)::iterator& it)
 
 	while (it != _groups.end()) {
 		auto& s = *it;
+		// The groups are views into the line, a truncated group must not
+		// be read past its end
+		if (s.length() != 5) {
+			++it;
+			continue;
+		}
 
 		if (s[0] == '6') {
-			std::experimental::optional<PrecipitationAmount> pr = parseRain(s);
+			std::optional<PrecipitationAmount> pr = parseRain(s);
 
 			if (pr)
 				_message._precipitation.push_back(*pr);
@@ -594,14 +636,14 @@ bool Parser::parseSection5(decltype(_groups)::iterator& it)
 				++it;
 				if (it == _groups.end())
 					break;
-				if (duration && *duration <= 60) {
+				if (duration && *duration <= 60 && it->length() == 5) {
 					if ((*it)[1] == '1' && (*it)[2] == '1') {
-						std::experimental::optional<int> gust;
+						std::optional<int> gust;
 						if ((*it)[3] == '9' && (*it)[4] == '9') {
 							++it;
 							if (it == _groups.end())
 								break;
-							if ((*it)[0] == '0' && (*it)[1] == '0')
+							if (it->length() == 5 && (*it)[0] == '0' && (*it)[1] == '0')
 								gust = parseInt(*it, 2);
 						} else {
 							gust = parseInt(*it, 3);
@@ -627,28 +669,74 @@ bool Parser::parseSection5(decltype(_groups)::iterator& it)
 
 bool Parser::parse(std::istream& in)
 {
-	std::string extracted;
-	in >> extracted;
+	std::getline(in, _buffer);
+	return parse(_buffer);
+}
+
+void Parser::resetMessage()
+{
+	// Keep the storage of the previous message's lists, the parser is
+	// usually fed thousands of lines in a row
+	auto precipitation = std::move(_message._precipitation);
+	auto gusts = std::move(_message._gustObservations);
+	auto clouds = std::move(_message._clouds);
+	auto cloudBases = std::move(_message._heightOfBaseOfClouds);
+	precipitation.clear();
+	gusts.clear();
+	clouds.clear();
+	cloudBases.clear();
+
+	_message = SynopMessage{};
+	_message._precipitation = std::move(precipitation);
+	_message._gustObservations = std::move(gusts);
+	_message._clouds = std::move(clouds);
+	_message._heightOfBaseOfClouds = std::move(cloudBases);
+}
+
+bool Parser::parse(std::string_view line)
+{
+	resetMessage();
+	_groups.clear();
+
+	// Split the line in groups, the views point into the line
+	std::string_view::size_type pos = 0;
+	while (pos < line.size()) {
+		while (pos < line.size() && isSpace(line[pos]))
+			++pos;
+		std::string_view::size_type end = pos;
+		while (end < line.size() && !isSpace(line[end]))
+			++end;
+		std::string_view::size_type next = end;
+		// Leave out the '=' ending the message, the last group must
+		// not be taken for a truncated one
+		if (end > pos && line[end - 1] == '=')
+			--end;
+		if (end > pos)
+			_groups.push_back(line.substr(pos, end - pos));
+		pos = next;
+	}
+
+	if (_groups.empty())
+		return false;
+
 	// First group has structure IIIii,YYYY,MM,DD,HH,mm,AAXX
 	// IIIii: Identifier (5 characters)
 	// YYYY,MM,DD,HH,mm Date and time (16 characters)
 	// AAXX: Type of message (4 characters)
 	// + 2 commas
 	// = 27 characters
-	if (extracted.size() != 27)
+	std::string_view first = _groups.front();
+	if (first.size() != 27)
 		return false;
 
-	_groups.emplace_back(extracted.substr(0, 5));
-	_groups.emplace_back(extracted.substr(6, 16));
-	_groups.emplace_back(extracted.substr(23, 4));
-
-	std::istream_iterator<std::string> begin{in}, end;
-	std::copy(begin, end, std::back_inserter(_groups));
+	// Split the first group in three, in place
+	_groups.insert(_groups.begin() + 1, {first.substr(6, 16), first.substr(23, 4)});
+	_groups.front() = first.substr(0, 5);
 
 	// The last group may be padded with one or more "=" signs, remove those
-	std::string& lastGroup = _groups.back();
+	std::string_view& lastGroup = _groups.back();
 	if (lastGroup.size() > 5)
-		lastGroup.erase(5);
+		lastGroup = lastGroup.substr(0, 5);
 
 	auto it = _groups.begin();
 
@@ -663,7 +751,7 @@ bool Parser::parse(std::istream& in)
 	r = parseSection1(it);
 
 	// ### Possibly section 2 ### //
-	if (it != _groups.end() && (*it)[0] == 2 && (*it)[1] == 2 && (*it)[2] == 2) {
+	if (it != _groups.end() && it->compare(0, 3, "222") == 0) {
 		_message._sections[2] = true;
 		r = parseSection2(it);
 	}
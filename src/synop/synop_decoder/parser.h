@@ -3,14 +3,27 @@
 
 #include "synop_message.h"
 
+#include <istream>
+#include <string>
+#include <string_view>
 #include <vector>
 
+/**
+ * A SYNOP decoder for the lines of the ogimet.com bulletins
+ *
+ * The groups are views on the line being parsed so decoding a message does not
+ * allocate memory per group. A parser can (and should) be reused for all the
+ * lines of a bulletin, the storage for the groups is kept from one line to the
+ * next.
+ */
 class Parser
 {
 private:
 	SynopMessage _message;
-	std::vector<std::string> _groups;
+	std::vector<std::string_view> _groups;
+	std::string _buffer;
 
+	void resetMessage();
 	bool parseSection0(decltype(_groups)::iterator& it);
 	bool parseSection1(decltype(_groups)::iterator& it);
 	bool parseSection2(decltype(_groups)::iterator& it);
@@ -21,8 +34,16 @@ private:
 public:
 	Parser();
 
+	/**
+	 * Parse the next line from a stream
+	 */
 	bool parse(std::istream& in);
 
+	/**
+	 * Parse a SYNOP message, the line must outlive the call
+	 */
+	bool parse(std::string_view line);
+
 	const SynopMessage& getDecodedMessage()
 	{
 		return _message;
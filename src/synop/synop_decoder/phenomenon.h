@@ -9,8 +9,8 @@ struct Phenomenon
 	using TimePoint = std::chrono::time_point<std::chrono::system_clock, std::chrono::minutes>;
 
 	std::string _description;
-	std::experimental::optional<TimePoint> _begin;
-	std::experimental::optional<TimePoint> _end;
+	std::optional<TimePoint> _begin;
+	std::optional<TimePoint> _end;
 };
 
 template<typename Numeric>
@@ -3,19 +3,19 @@
 
 #include <iostream>
 #include <limits>
-#include <experimental/optional>
+#include <optional>
 
 template<typename Numeric>
 struct Range
 {
-	std::experimental::optional<Numeric> _begin;
-	std::experimental::optional<Numeric> _end;
+	std::optional<Numeric> _begin;
+	std::optional<Numeric> _end;
 	bool _beginIncluded;
 	bool _endIncluded;
 
-	static std::experimental::optional<Numeric> unbound()
+	static std::optional<Numeric> unbound()
 	{
-		return std::experimental::optional<Numeric>();
+		return std::optional<Numeric>();
 	}
 };
 
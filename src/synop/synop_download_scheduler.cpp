@@ -29,8 +29,8 @@
 #include <mutex>
 
 #include <systemd/sd-daemon.h>
-#include <cassobs/dbconnection_observations.h>
 
+#include "storage/observations_storage.h"
 #include "cassandra_utils.h"
 #include "synop/ogimet_synop.h"
 #include "synop/synop_download_scheduler.h"
@@ -42,8 +42,8 @@ namespace meteodata
 {
 using namespace date;
 
-SynopDownloadScheduler::SynopDownloadScheduler(asio::io_context& ioContext, DbConnectionObservations& db) :
-	AbstractDownloadScheduler{chrono::minutes{MINIMAL_PERIOD_MINUTES}, ioContext, db}
+SynopDownloadScheduler::SynopDownloadScheduler(asio::io_context& ioContext, ObservationsStorage& db) :
+	AbstractDownloadScheduler{chrono::minutes{MINIMAL_PERIOD_MINUTES}, ioContext, db, "synop"}
 {
 }
 
@@ -81,6 +81,7 @@ void SynopDownloadScheduler::download()
 		auto now = chrono::system_clock::now();
 		auto time = date::floor<chrono::minutes>(now - date::floor<date::days>(now));
 		if (time.count() % group.period.count() < MINIMAL_PERIOD_MINUTES) {
+			IngestionTrace trace{_tracePath};
 			downloadGroup(group.prefix, group.backlog);
 		}
 	}
@@ -100,11 +101,9 @@ void SynopDownloadScheduler::downloadGroup(const std::string& group, const chron
 
 		std::vector<Observation> allObs;
 
+		Parser parser;
 		while (std::getline(bodyIterator, line)) {
-			std::istringstream lineIterator{line};
-
-			Parser parser;
-			if (parser.parse(lineIterator)) {
+			if (parser.parse(line)) {
 				const SynopMessage& m = parser.getDecodedMessage();
 				auto uuidIt = _icaos.find(m._stationIcao);
 				if (uuidIt != _icaos.end()) {
@@ -44,7 +44,7 @@ namespace chrono = std::chrono;
 class SynopDownloadScheduler : public AbstractDownloadScheduler
 {
 public:
-	SynopDownloadScheduler(asio::io_context& ioContext, DbConnectionObservations& db);
+	SynopDownloadScheduler(asio::io_context& ioContext, ObservationsStorage& db);
 
 private:
 	std::map<std::string, CassUuid> _icaos;
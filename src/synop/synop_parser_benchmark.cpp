@@ -0,0 +1,148 @@
+/**
+ * @file synop_parser_benchmark.cpp
+ * @brief Measure the throughput of the SYNOP parser
+ * @author Laurent Georget
+ * @date 2026-10-18
+ */
+/*
+ * Copyright (C) 2026  SAS Météo Concept <contact@meteo-concept.fr>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <boost/program_options.hpp>
+
+#include "synop_decoder/parser.h"
+#include "config.h"
+
+namespace po = boost::program_options;
+namespace chrono = std::chrono;
+
+namespace
+{
+std::atomic<std::size_t> allocations{0};
+}
+
+/* Count all the allocations made by the program to spot regressions in the
+ * parser */
+void* operator new(std::size_t size)
+{
+	allocations++;
+	void* p = std::malloc(size ? size : 1);
+	if (!p)
+		throw std::bad_alloc{};
+	return p;
+}
+
+void operator delete(void* p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+	std::free(p);
+}
+
+/**
+ * @brief Entry point
+ *
+ * @param argc the number of arguments passed on the command line
+ * @param argv the arguments passed on the command line
+ *
+ * @return 0 if everything went well, and either an "errno-style" error code
+ * or 255 otherwise
+ */
+int main(int argc, char** argv)
+{
+	std::string file;
+	unsigned long iterations = 100;
+
+	po::options_description desc("Allowed options");
+	desc.add_options()
+		("help", "display the help message and exit")
+		("version", "display the version of Meteodata and exit")
+		("iterations,n", po::value<unsigned long>(&iterations), "number of times the whole corpus is parsed, defaults to 100")
+		("corpus", po::value<std::string>(&file), "file containing SYNOP messages in the ogimet.com format, one per line")
+	;
+	po::positional_options_description pd;
+	pd.add("corpus", 1);
+
+	po::variables_map vm;
+	po::store(po::command_line_parser(argc, argv).options(desc).positional(pd).run(), vm);
+	po::notify(vm);
+
+	if (vm.count("help")) {
+		std::cout << "Usage: " << argv[0] << " <corpus file> [-n iterations]\n";
+		std::cout << desc << "\n";
+		std::cout << "The corpus can be any bulletin downloaded from ogimet.com, for instance "
+			  << "tests/ogimet_synop_sample.txt in the source tree" << std::endl;
+		return 0;
+	}
+
+	if (vm.count("version")) {
+		std::cout << PACKAGE_STRING << std::endl;
+		return 0;
+	}
+
+	if (file.empty()) {
+		std::cerr << "Missing corpus file, see --help" << std::endl;
+		return 1;
+	}
+
+	std::vector<std::string> lines;
+	std::ifstream input{file};
+	std::string line;
+	while (std::getline(input, line)) {
+		if (!line.empty())
+			lines.push_back(line);
+	}
+
+	if (lines.empty()) {
+		std::cerr << "No SYNOP message in " << file << std::endl;
+		return 1;
+	}
+
+	Parser parser;
+	std::size_t valid = 0;
+	std::size_t allocationsBefore = allocations;
+	auto begin = chrono::steady_clock::now();
+	for (unsigned long i = 0 ; i < iterations ; i++) {
+		for (const std::string& l : lines) {
+			if (parser.parse(l))
+				valid++;
+		}
+	}
+	auto end = chrono::steady_clock::now();
+	std::size_t allocationsDuringParsing = allocations - allocationsBefore;
+
+	std::size_t total = lines.size() * iterations;
+	double seconds = chrono::duration<double>(end - begin).count();
+	std::cout << "Parsed " << total << " lines (" << lines.size() << " distinct, "
+		  << valid / iterations << " valid) in " << seconds << "s\n"
+		  << "Throughput: " << static_cast<unsigned long>(total / seconds) << " lines/s, "
+		  << chrono::duration<double, std::nano>(end - begin).count() / total << " ns/line\n"
+		  << "Allocations: " << static_cast<double>(allocationsDuringParsing) / total << " per line" << std::endl;
+
+	return 0;
+}
@@ -21,6 +21,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <memory>
 #include <iostream>
 #include <iterator>
 #include <map>
@@ -29,11 +30,11 @@
 
 #include <boost/program_options.hpp>
 #include <cassandra.h>
-#include <cassobs/dbconnection_observations.h>
 
 #include "synop_standalone.h"
 #include "ogimet_synop.h"
 #include "synop_decoder/parser.h"
+#include "storage/observations_storage.h"
 #include "config.h"
 
 #define DEFAULT_CONFIG_FILE "/etc/meteodata/db_credentials"
@@ -44,7 +45,7 @@ namespace po = boost::program_options;
 namespace meteodata
 {
 
-SynopStandalone::SynopStandalone(DbConnectionObservations& db) :
+SynopStandalone::SynopStandalone(ObservationsStorage& db) :
 		_db(db)
 {
 }
@@ -69,9 +70,10 @@ void SynopStandalone::start(const std::string& file)
 
 	std::vector<Observation> allObs;
 
+	Parser parser;
+	std::string line;
 	std::ifstream input{file};
 	while (input) {
-		std::string line;
 		std::getline(input, line);
 		lineCount++;
 
@@ -79,10 +81,7 @@ void SynopStandalone::start(const std::string& file)
 		if (line.empty() || line.find("NIL") != std::string::npos)
 			continue;
 
-		std::istringstream lineIterator{line};
-
-		Parser parser;
-		if (parser.parse(lineIterator)) {
+		if (parser.parse(line)) {
 			const SynopMessage& m = parser.getDecodedMessage();
 			auto uuidIt = _icaos.find(m._stationIcao);
 			if (uuidIt != _icaos.end()) {
@@ -147,6 +146,7 @@ int main(int argc, char** argv)
 	std::string pguser;
 	std::string pgpassword;
 	std::string pgaddress;
+	StorageConfiguration storageConfig;
 	std::string fileName;
 	std::string inputFile;
 
@@ -168,6 +168,9 @@ int main(int argc, char** argv)
 		("pguser", po::value<std::string>(&pguser), "PostgreSQL database username")
 		("pgpassword", po::value<std::string>(&pgpassword), "PostgreSQL database password")
 		("pghost", po::value<std::string>(&pgaddress), "PostgreSQL database IP address or domain name")
+		("storage", po::value<std::string>(&storageConfig.backend), "storage backend, 'cassandra' (Cassandra and PostgreSQL databases) or 'memory' (in-process stand-in keeping everything in memory, for benchmarks), defaults to 'cassandra'")
+		("station-table", po::value<std::string>(&storageConfig.stationTable), "with the 'memory' storage, file listing the stations and connectors to serve")
+		("storage-latency", po::value<unsigned long>(&storageConfig.latency), "with the 'memory' storage, delay in microseconds added to each call, defaults to 0")
 		("weatherlink-apiv2-key,k", po::value<std::string>(), "Ignored")
 		("weatherlink-apiv2-secret,s", po::value<std::string>(), "Ignored")
 		("input-file", po::value<std::string>(&inputFile), "input CSV file containing the SYNOP messages (in the OGIMET getsynop format)")
@@ -200,7 +203,9 @@ int main(int argc, char** argv)
 
 
 	try {
-		DbConnectionObservations db(address, user, password, pgaddress, pguser, pgpassword);
+		std::unique_ptr<ObservationsStorage> storage = ObservationsStorage::create(storageConfig,
+			address, user, password, pgaddress, pguser, pgpassword);
+		ObservationsStorage& db = *storage;
 
 		cass_log_set_level(CASS_LOG_INFO);
 		CassLogCallback logCallback = [](const CassLogMessage* message, void*) -> void {
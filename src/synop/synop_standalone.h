@@ -30,7 +30,8 @@
 
 #include <cassandra.h>
 #include <date/date.h>
-#include <cassobs/dbconnection_observations.h>
+
+#include "storage/observations_storage.h"
 
 
 namespace meteodata
@@ -43,11 +44,11 @@ using namespace meteodata;
 class SynopStandalone
 {
 public:
-	SynopStandalone(DbConnectionObservations& db);
+	SynopStandalone(ObservationsStorage& db);
 	void start(const std::string& file);
 
 private:
-	DbConnectionObservations& _db;
+	ObservationsStorage& _db;
 	std::map<std::string, CassUuid> _icaos;
 
 	static constexpr char HOST[] = "www.ogimet.com";
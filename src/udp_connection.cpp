@@ -25,11 +25,16 @@
 #include <boost/system/error_code.hpp>
 #include <chrono>
 
-#include <cassobs/dbconnection_observations.h>
 
+#include "storage/observations_storage.h"
 #include "udp_connection.h"
 #include "nbiot/nbiot_udp_request_handler.h"
 #include "async_job_publisher.h"
+#include "monitoring/metrics.h"
+#include "monitoring/loop_lag_monitor.h"
+#include "monitoring/db_profiler.h"
+#include "monitoring/ingestion_trace.h"
+#include "capture/traffic_capture.h"
 
 namespace meteodata
 {
@@ -37,12 +42,13 @@ namespace asio = boost::asio;
 namespace sys = boost::system;
 using udp = boost::asio::ip::udp;
 
-UdpConnection::UdpConnection(boost::asio::io_context& io, DbConnectionObservations& db, AsyncJobPublisher* jobPublisher) :
+UdpConnection::UdpConnection(boost::asio::io_context& io, ObservationsStorage& db, AsyncJobPublisher* jobPublisher) :
 	Connector{io, db},
 	_jobPublisher{jobPublisher},
 	_socket{io},
 	_nbiotHandler{_db, _jobPublisher}
 {
+	_db.setCaller("udp");
 	_status.activeSince = date::floor<chrono::seconds>(chrono::system_clock::now());
 }
 
@@ -110,6 +116,14 @@ void UdpConnection::processRequest(std::size_t size)
 			 }
 		});
 	};
+	static Histogram& duration = MetricsRegistry::instance().histogram("meteodata_udp_request_duration_seconds",
+		"Time taken to process the datagrams received by the UDP server");
+	Histogram::ScopedTimer timer{duration};
+	LoopLagMonitor::Activity activity{"UDP datagram processing"};
+	DbProfiler::CallerScope callerScope{"udp"};
+	static const IngestionTrace::Path tracePath{"udp"};
+	IngestionTrace trace{tracePath};
+	TrafficCapture::instance().record(CapturedMessage::Type::UDP, {}, {_buffer.data(), size});
 	_nbiotHandler.processRequest(std::string{_buffer.data(), size}, &responseSender);
 }
 
@@ -30,8 +30,8 @@
 #include <boost/beast.hpp>
 #include <boost/asio.hpp>
 #include <boost/asio/ip/udp.hpp>
-#include <cassobs/dbconnection_observations.h>
 
+#include "storage/observations_storage.h"
 #include "connector.h"
 #include "async_job_publisher.h"
 #include "nbiot/nbiot_udp_request_handler.h"
@@ -41,7 +41,7 @@ namespace meteodata
 class UdpConnection : public Connector
 {
 public:
-	UdpConnection(boost::asio::io_context& io, DbConnectionObservations& db, AsyncJobPublisher* jobPublisher = nullptr);
+	UdpConnection(boost::asio::io_context& io, ObservationsStorage& db, AsyncJobPublisher* jobPublisher = nullptr);
 	void start();
 	void stop();
 	void reload() override;
@@ -25,40 +25,77 @@
 #include <chrono>
 #include <memory>
 #include <thread>
+#include <mutex>
 
 #include <systemd/sd-daemon.h>
 #include <boost/system/error_code.hpp>
 #include <boost/asio/basic_waitable_timer.hpp>
+#include <boost/asio/post.hpp>
 #include <cassandra.h>
-#include <cassobs/dbconnection_observations.h>
 
+#include "storage/observations_storage.h"
 #include "virtual/virtual_computation_scheduler.h"
 #include "virtual/virtual_obs_computer.h"
 #include "abstract_download_scheduler.h"
+#include "meteo_server.h"
+#include "event/event_manager.h"
+#include "event/new_datapoint_event.h"
+#include "monitoring/loop_lag_monitor.h"
+#include "monitoring/db_profiler.h"
 
 namespace meteodata
 {
 using namespace date;
 
+VirtualComputationScheduler::PendingComputation::PendingComputation(asio::io_context& ioContext,
+	std::shared_ptr<VirtualObsComputer> computer) :
+		computer{std::move(computer)},
+		deadline{ioContext}
+{
+}
+
 VirtualComputationScheduler::VirtualComputationScheduler(asio::io_context& ioContext,
-	DbConnectionObservations& db, const std::shared_ptr<AsyncJobPublisher>& jobPublisher) :
-		AbstractDownloadScheduler{chrono::minutes{POLLING_PERIOD}, ioContext, db},
+	ObservationsStorage& db, const std::shared_ptr<AsyncJobPublisher>& jobPublisher) :
+		AbstractDownloadScheduler{chrono::minutes{POLLING_PERIOD}, ioContext, db, "virtual"},
 		_jobPublisher{jobPublisher}
 {
 }
 
 void VirtualComputationScheduler::add(const VirtualStation& station)
 {
-	_downloaders.emplace_back(std::make_shared<VirtualObsComputer>(station, _db, _jobPublisher.get()));
+	auto computer = std::make_shared<VirtualObsComputer>(station, _db, _jobPublisher.get());
+	_downloaders.push_back(computer);
+	for (auto&& [s,vars] : station.sources)
+		_computersBySource[s].push_back(computer);
 }
 
 void VirtualComputationScheduler::download()
 {
-	for (const auto & _downloader : _downloaders) {
+	auto now = chrono::steady_clock::now();
+	// reloadStations() may refill the list from another thread, work on a
+	// copy
+	std::vector<std::shared_ptr<VirtualObsComputer>> downloaders;
+	{
+		std::lock_guard<std::mutex> lock{_pendingMutex};
+		downloaders = _downloaders;
+	}
+
+	for (const auto& downloader : downloaders) {
 		if (_mustStop)
 			break;
+
+		{
+			std::lock_guard<std::mutex> lock{_pendingMutex};
+			auto it = _lastEventComputation.find(downloader->getStation());
+			if (it != _lastEventComputation.end() && it->second + chrono::minutes{POLLING_PERIOD} > now)
+				continue; // already up-to-date thanks to the sources events
+		}
+
 		try {
-			_downloader->compute();
+			std::lock_guard<std::mutex> lock{_computationMutex};
+			IngestionTrace trace{_tracePath};
+			IngestionTrace::setCurrentStation(downloader->getStation());
+			downloader->compute();
 		} catch (const std::runtime_error& e) {
 			std::cerr << SD_ERR << "[Virtual] protocol: " << "Runtime error, impossible to compute " << e.what()
 				  << ", moving on..." << std::endl;
@@ -68,13 +105,113 @@ void VirtualComputationScheduler::download()
 
 void VirtualComputationScheduler::reloadStations()
 {
-	_downloaders.clear();
+	std::vector<CassUuid> sources;
+	{
+		std::lock_guard<std::mutex> lock{_pendingMutex};
+		for (auto&& [station, pending] : _pending)
+			pending->deadline.cancel();
+		_pending.clear();
+		_lastEventComputation.clear();
+		_computersBySource.clear();
+		_downloaders.clear();
+
+		std::vector<VirtualStation> virtualStations;
+		_db.getAllVirtualStations(virtualStations);
+		for (auto&& station : virtualStations) {
+			if (!ownsStation(station.station))
+				continue;
+			add(station);
+		}
+
+		for (auto&& [source, computers] : _computersBySource)
+			sources.push_back(source);
+	}
 
-	std::vector<VirtualStation> virtualStations;
-	_db.getAllVirtualStations(virtualStations);
-	for (auto&& station : virtualStations) {
-		add(station);
+	// The event manager lock is held while the events are dispatched, do
+	// not hold the pending mutex while subscribing to avoid deadlocks
+	auto self{std::static_pointer_cast<VirtualComputationScheduler>(shared_from_this())};
+	EventManager& em = MeteoServer::getEventManager();
+	em.unsubscribeFromAll(self);
+	for (auto&& source : sources) {
+		em.subscribe(self, Event::EventType::NewDatapoint, source);
 	}
 }
 
+void VirtualComputationScheduler::handle(const Event& event)
+{
+	//no-op: event unknown
+	std::cerr << SD_WARNING << "[Virtual] protocol: " << "Unhandled event " << event.getEventName() << " received" << std::endl;
+}
+
+void VirtualComputationScheduler::handle(const NewDatapointEvent& event)
+{
+	if (_mustStop)
+		return;
+
+	std::lock_guard<std::mutex> lock{_pendingMutex};
+	CassUuid source = event.getStation();
+	auto it = _computersBySource.find(source);
+	if (it == _computersBySource.end())
+		return;
+
+	for (auto&& computer : it->second) {
+		const CassUuid& station = computer->getStation();
+		auto pendingIt = _pending.find(station);
+		if (pendingIt == _pending.end()) {
+			auto pending = std::make_unique<PendingComputation>(_ioContext, computer);
+			pending->earliest = event.getMeasuredAt();
+
+			// Do not wait forever for sources that might never report
+			auto self{std::static_pointer_cast<VirtualComputationScheduler>(shared_from_this())};
+			pending->deadline.expires_after(SOURCES_DEADLINE);
+			pending->deadline.async_wait([this, self, station](const sys::error_code& e) {
+				if (e == sys::errc::operation_canceled)
+					return;
+				std::lock_guard<std::mutex> lock{_pendingMutex};
+				if (_pending.find(station) != _pending.end()) {
+					std::cerr << SD_NOTICE << "[Virtual " << station << "] management: "
+						  << "Not all sources reported in time, computing anyway" << std::endl;
+					triggerComputation(station);
+				}
+			});
+			pendingIt = _pending.emplace(station, std::move(pending)).first;
+		} else if (event.getMeasuredAt() < pendingIt->second->earliest) {
+			pendingIt->second->earliest = event.getMeasuredAt();
+		}
+
+		PendingComputation& pending = *pendingIt->second;
+		pending.reported.insert(source);
+		if (pending.reported.size() == pending.computer->getSourcesCount())
+			triggerComputation(station);
+	}
+}
+
+void VirtualComputationScheduler::triggerComputation(const CassUuid& station)
+{
+	auto it = _pending.find(station);
+	if (it == _pending.end())
+		return;
+
+	it->second->deadline.cancel();
+	std::shared_ptr<VirtualObsComputer> computer = it->second->computer;
+	date::sys_seconds earliest = it->second->earliest;
+	_pending.erase(it);
+	_lastEventComputation[station] = chrono::steady_clock::now();
+
+	auto self{std::static_pointer_cast<VirtualComputationScheduler>(shared_from_this())};
+	asio::post(_ioContext, [this, self, computer, earliest]() {
+		if (_mustStop)
+			return;
+		try {
+			LoopLagMonitor::Activity activity{"virtual observations computation"};
+			DbProfiler::CallerScope callerScope{"virtual"};
+			std::lock_guard<std::mutex> lock{_computationMutex};
+			computer->computeAfterNewData(earliest);
+		} catch (const std::runtime_error& e) {
+			std::cerr << SD_ERR << "[Virtual] protocol: " << "Runtime error, impossible to compute " << e.what()
+				  << ", moving on..." << std::endl;
+		}
+	});
+}
+
 }
@@ -30,23 +30,34 @@
 #include <chrono>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <set>
 
 #include <boost/system/error_code.hpp>
 #include <boost/asio/basic_waitable_timer.hpp>
 #include <cassandra.h>
-#include <cassobs/dbconnection_observations.h>
 #include <cassobs/dto/virtual_station.h>
 
+#include "storage/observations_storage.h"
 #include "async_job_publisher.h"
 #include "abstract_download_scheduler.h"
+#include "cassandra_utils.h"
 #include "virtual/virtual_obs_computer.h"
+#include "event/event.h"
+#include "event/subscriber.h"
+#include "event/new_datapoint_event.h"
 
 namespace meteodata
 {
 /**
  * @brief The orchestrator for all virtual stations operations
+ *
+ * Virtual stations are recomputed as soon as all their sources have received
+ * new data, as notified by the new datapoint events, or when a deadline has
+ * passed after the first source reported. The periodic sweep is kept for the
+ * sources whose connectors do not publish events.
  */
-class VirtualComputationScheduler : public AbstractDownloadScheduler
+class VirtualComputationScheduler : public AbstractDownloadScheduler, public Subscriber
 {
 public:
 	/**
@@ -57,7 +68,7 @@ public:
 	 * @param db the MétéoData observations database connector
 	 * @param dbJobs the MétéoData asynchronous jobs database connector
 	 */
-	VirtualComputationScheduler(asio::io_context& ioContext, DbConnectionObservations& db,
+	VirtualComputationScheduler(asio::io_context& ioContext, ObservationsStorage& db,
 		const std::shared_ptr<AsyncJobPublisher>& jobPublisher = nullptr);
 
 	/**
@@ -69,6 +80,9 @@ public:
 	 */
 	void add(const VirtualStation& station);
 
+	void handle(const Event& event) override;
+	void handle(const NewDatapointEvent& event) override;
+
 private:
 	/**
 	 * @brief The list of all computer (one per station)
@@ -80,6 +94,47 @@ private:
 	 */
 	std::shared_ptr<AsyncJobPublisher> _jobPublisher{};
 
+	/**
+	 * @brief The virtual stations computers indexed by source station
+	 */
+	std::map<CassUuid, std::vector<std::shared_ptr<VirtualObsComputer>>> _computersBySource;
+
+	/**
+	 * @brief The state of a virtual station waiting for all its sources to
+	 * report
+	 */
+	struct PendingComputation
+	{
+		PendingComputation(asio::io_context& ioContext, std::shared_ptr<VirtualObsComputer> computer);
+
+		std::shared_ptr<VirtualObsComputer> computer;
+		std::set<CassUuid> reported;
+		date::sys_seconds earliest;
+		asio::basic_waitable_timer<chrono::steady_clock> deadline;
+	};
+
+	/**
+	 * @brief The virtual stations for which at least one source has
+	 * reported new data, indexed by virtual station
+	 */
+	std::map<CassUuid, std::unique_ptr<PendingComputation>> _pending;
+
+	/**
+	 * @brief The last time each virtual station has been computed after
+	 * new datapoint events, used to skip it in the periodic sweep
+	 */
+	std::map<CassUuid, chrono::steady_clock::time_point> _lastEventComputation;
+
+	/**
+	 * @brief The mutex protecting the pending computations
+	 */
+	std::mutex _pendingMutex;
+
+	/**
+	 * @brief The mutex serializing the computations
+	 */
+	std::mutex _computationMutex;
+
 private:
 	/**
 	 * @brief Reload the list of virtual stations from the database and
@@ -96,10 +151,24 @@ private:
 	 */
 	void download() override;
 
+	/**
+	 * @brief Schedule the computation of a virtual station whose sources
+	 * have reported, the pending mutex must be held
+	 *
+	 * @param station The virtual station
+	 */
+	void triggerComputation(const CassUuid& station);
+
 	/**
 	 * @brief The fixed polling period in minutes
 	 */
 	static constexpr int POLLING_PERIOD = 5;
+
+	/**
+	 * @brief How long to wait for all the sources of a virtual station to
+	 * report after the first one did
+	 */
+	static constexpr chrono::minutes SOURCES_DEADLINE{3};
 };
 
 }
@@ -21,21 +21,23 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
 #include <chrono>
 #include <iostream>
 #include <string>
 #include <map>
 #include <optional>
 #include <utility>
+#include <vector>
 
 #include <boost/asio.hpp>
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/json_parser.hpp>
-#include <cassobs/dbconnection_observations.h>
 #include <date/date.h>
 #include <systemd/sd-daemon.h>
 #include <cassandra.h>
 
+#include "storage/observations_storage.h"
 #include "virtual/virtual_obs_computer.h"
 #include "http_utils.h"
 #include "cassandra_utils.h"
@@ -49,12 +51,12 @@ namespace chrono = std::chrono;
 using namespace meteodata;
 
 VirtualObsComputer::VirtualObsComputer(const VirtualStation& station,
-		DbConnectionObservations& db, AsyncJobPublisher* jobPublisher) :
+		ObservationsStorage& db, AsyncJobPublisher* jobPublisher) :
 		_station{station},
 		_db{db},
 		_jobPublisher{jobPublisher}
 {
-	time_t lastArchiveDownloadTime;
+	time_t lastArchiveDownloadTime = 0;
 	int period;
 	db.getStationDetails(station.station, _stationName, period, lastArchiveDownloadTime);
 	float latitude, longitude;
@@ -79,7 +81,11 @@ date::sys_seconds VirtualObsComputer::getLastDatetimeAvailable()
 		std::string name;
 		time_t t;
 		int p;
-		_db.getStationDetails(s, name, p, t);
+		if (!_db.getStationDetails(s, name, p, t)) {
+			std::cerr << SD_ERR << "[Virtual " << s << "] management: "
+				  << "Couldn't get the details of source station " << s << std::endl;
+			continue;
+		}
 		date::sys_seconds lastAvailable = date::floor<chrono::seconds>(chrono::system_clock::from_time_t(t));
 		std::cout << SD_DEBUG << "[Virtual " << s << "] connection: "
 			<< "Source station " << name << " has data available until "
@@ -100,25 +106,61 @@ date::sys_seconds VirtualObsComputer::getLastDatetimeAvailable()
 	return lastDateFromSource;
 }
 
-void VirtualObsComputer::doCompute(const date::sys_seconds& begin, const date::sys_seconds& end, bool updateLastArchive)
+std::vector<Observation> VirtualObsComputer::fetchSourceObservations(const CassUuid& source, const std::vector<date::sys_seconds>& targets)
 {
-	date::sys_seconds oldestArchive = begin;
-	date::sys_seconds newestArchive = end;
+	std::vector<Observation> observations;
+	if (targets.empty())
+		return observations;
 
-	bool insertionOk = true;
+	/* One range read for the whole chunk, from far enough before the
+	 * first timestep to find the observation it uses */
+	time_t begin = chrono::system_clock::to_time_t(targets.front() - MAX_SOURCE_AGE);
+	time_t end = chrono::system_clock::to_time_t(targets.back());
+	if (!_db.getDataBetween(source, begin, end, observations)) {
+		std::cerr << SD_ERR << "[Virtual " << _station.station << "] measurement: "
+			  << "Failed to fetch the observations of source station " << source << std::endl;
+		observations.clear();
+		return observations;
+	}
+
+	// the merge join relies on the chronological order
+	std::stable_sort(observations.begin(), observations.end(), [](const Observation& o1, const Observation& o2) {
+		return o1.time < o2.time;
+	});
+
+	return observations;
+}
 
-	for (date::sys_seconds target = begin - begin.time_since_epoch() % chrono::minutes{10} ; target <= end && insertionOk ; target += chrono::minutes{_station.period}) {
+std::vector<Observation> VirtualObsComputer::computeChunk(const std::vector<date::sys_seconds>& targets)
+{
+	std::vector<std::vector<Observation>> sourceObservations;
+	sourceObservations.reserve(_station.sources.size());
+	for (auto&& [s,vars] : _station.sources)
+		sourceObservations.push_back(fetchSourceObservations(s, targets));
+
+	std::vector<Observation> result;
+	result.reserve(targets.size());
+	std::vector<std::size_t> cursors(sourceObservations.size(), 0);
+
+	for (auto&& target : targets) {
 		Observation final;
 		final.station = _station.station;
 		final.day = date::floor<date::days>(target);
 		final.time = target;
-		time_t targetAsTime_t = chrono::system_clock::to_time_t(target);
+
+		std::size_t i = 0;
 		for (auto&& [s,vars] : _station.sources) {
-			Observation obs;
-			bool ret = _db.getLastDataBefore(s, targetAsTime_t, obs);
-			if (!ret || obs.time < target - chrono::minutes{10}) {
+			const std::vector<Observation>& observations = sourceObservations[i];
+			std::size_t& cursor = cursors[i];
+			i++;
+
+			/* Advance to the last observation before the target */
+			while (cursor + 1 < observations.size() && observations[cursor + 1].time <= target)
+				cursor++;
+			if (observations.empty() || observations[cursor].time > target || observations[cursor].time < target - MAX_SOURCE_AGE)
 				continue;
-			}
+
+			const Observation& obs = observations[cursor];
 			for (auto&& v : vars) {
 				if (obs.isPresent(v)) {
 					if (Observation::isValidIntVariable(v)) {
@@ -132,24 +174,49 @@ void VirtualObsComputer::doCompute(const date::sys_seconds& begin, const date::s
 			}
 		}
 
-		insertionOk = _db.insertV2DataPoint(final) && _db.insertV2DataPointInTimescaleDB(final);
+		result.push_back(std::move(final));
+	}
 
-		if (insertionOk) {
-			if (target < oldestArchive)
-				oldestArchive = target;
-			if (target > newestArchive)
-				newestArchive = target;
+	return result;
+}
+
+void VirtualObsComputer::doCompute(const date::sys_seconds& begin, const date::sys_seconds& end, bool updateLastArchive)
+{
+	date::sys_seconds oldestArchive = begin;
+	date::sys_seconds newestArchive = end;
+
+	bool insertionOk = true;
+
+	date::sys_seconds target = begin - begin.time_since_epoch() % chrono::minutes{10};
+	while (target <= end && insertionOk) {
+		std::vector<date::sys_seconds> targets;
+		date::sys_seconds chunkEnd = std::min(end, target + CHUNK_DURATION);
+		for ( ; target <= chunkEnd ; target += chrono::minutes{_station.period})
+			targets.push_back(target);
+
+		std::vector<Observation> allObs = computeChunk(targets);
+		insertionOk = _db.insertV2DataPoints(allObs.begin(), allObs.end()) &&
+			_db.insertV2DataPointsInTimescaleDB(allObs.begin(), allObs.end());
+
+		if (insertionOk && !targets.empty()) {
+			if (targets.front() < oldestArchive)
+				oldestArchive = targets.front();
+			if (targets.back() > newestArchive)
+				newestArchive = targets.back();
 			std::cout << SD_INFO << "[Virtual " << _station.station << "] measurement: "
 				  << "Archive data stored for virtual station " << _stationName << std::endl;
 			if (updateLastArchive) {
-				insertionOk = _db.updateLastArchiveDownloadTime(_station.station, chrono::system_clock::to_time_t(newestArchive));
+				insertionOk = _db.updateLastArchiveDownloadTime(_station.station, chrono::system_clock::to_time_t(targets.back()));
 				if (!insertionOk) {
 					std::cerr << SD_ERR << "[Virtual " << _station.station << "] management: "
 						  << "couldn't update last archive download time for station " << _stationName << std::endl;
 				} else {
-					_lastArchive = target;
+					_lastArchive = targets.back();
 				}
 			}
+		} else if (!insertionOk) {
+			std::cerr << SD_ERR << "[Virtual " << _station.station << "] measurement: "
+				  << "Failed to store archive data for virtual station " << _stationName << std::endl;
 		}
 	}
 
@@ -188,4 +255,15 @@ void VirtualObsComputer::compute()
 	doCompute(_lastArchive, date::floor<chrono::seconds>(chrono::system_clock::now()), true);
 }
 
+void VirtualObsComputer::computeAfterNewData(const date::sys_seconds& earliest)
+{
+	if (earliest < _lastArchive) {
+		std::cout << SD_INFO << "[Virtual " << _station.station << "] measurement: "
+			  << "Recomputing past observations for station " << _stationName << std::endl;
+		doCompute(earliest, _lastArchive, false);
+	}
+
+	compute();
+}
+
 }
@@ -28,13 +28,15 @@
 #include <map>
 #include <string>
 #include <tuple>
+#include <vector>
 
 #include <boost/system/error_code.hpp>
-#include <cassobs/dbconnection_observations.h>
 #include <cassobs/dto/virtual_station.h>
 #include <cassandra.h>
 
+#include "storage/observations_storage.h"
 #include "async_job_publisher.h"
+#include "monitoring/profiled_db_connection.h"
 
 namespace meteodata
 {
@@ -56,7 +58,7 @@ public:
 	 * @param jobPublisher an optional component used to schedule climatology
 	 * and monitoring computations
 	 */
-	VirtualObsComputer(const VirtualStation& station, DbConnectionObservations& db,
+	VirtualObsComputer(const VirtualStation& station, ObservationsStorage& db,
 		AsyncJobPublisher* jobPublisher = nullptr);
 
 	date::sys_seconds getLastDatetimeAvailable();
@@ -73,6 +75,26 @@ public:
 	 */
 	void compute(const date::sys_seconds& begin, const date::sys_seconds& end);
 
+	/**
+	 * @brief Compute the observation points for the virtual station after
+	 * its sources have received new data
+	 *
+	 * @param earliest The earliest datetime of the new source data, if
+	 * it's older than the last archive, the timesteps in-between are
+	 * recomputed as well
+	 */
+	void computeAfterNewData(const date::sys_seconds& earliest);
+
+	const CassUuid& getStation() const
+	{
+		return _station.station;
+	}
+
+	std::size_t getSourcesCount() const
+	{
+		return _station.sources.size();
+	}
+
 private:
 	/**
 	 * @brief The station in MétéoData
@@ -82,7 +104,7 @@ private:
 	/**
 	 * @brief The observations database (part Cassandra, part SQL) connector
 	 */
-	DbConnectionObservations& _db;
+	ProfiledDbConnection _db;
 
 	/**
 	 * @brief The human-readable name given to the station
@@ -99,8 +121,48 @@ private:
 
 	/**
 	 * @brief Inner function for the computation of observation points
+	 *
+	 * The interval is processed in chunks of CHUNK_DURATION, each chunk
+	 * being computed entirely in memory by computeChunk() and then
+	 * stored in a single batch.
 	 */
 	void doCompute(const date::sys_seconds& begin, const date::sys_seconds& end, bool updateLastArchive);
+
+	/**
+	 * @brief Compute the virtual observations for a list of timesteps
+	 *
+	 * The observations of each source for the whole chunk are fetched
+	 * by fetchSourceObservations() before the timesteps are computed, the
+	 * observations being then matched to the timesteps in a single pass.
+	 *
+	 * @param targets The timesteps, in chronological order
+	 * @return The virtual observations, one per timestep
+	 */
+	std::vector<Observation> computeChunk(const std::vector<date::sys_seconds>& targets);
+
+	/**
+	 * @brief Fetch the observations of a source station relevant for a
+	 * list of timesteps
+	 *
+	 * The observations are read in a single range query covering all the
+	 * timesteps, archive and real-time data alike.
+	 *
+	 * @param source The source station
+	 * @param targets The timesteps, in chronological order
+	 * @return The distinct observations of the source station, in
+	 * chronological order
+	 */
+	std::vector<Observation> fetchSourceObservations(const CassUuid& source, const std::vector<date::sys_seconds>& targets);
+
+	/**
+	 * @brief The maximum interval computed and stored in one go
+	 */
+	static constexpr date::days CHUNK_DURATION{1};
+
+	/**
+	 * @brief How old a source observation can be to be used for a timestep
+	 */
+	static constexpr std::chrono::minutes MAX_SOURCE_AGE{10};
 };
 
 }
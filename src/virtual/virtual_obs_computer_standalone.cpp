@@ -21,6 +21,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <memory>
 #include <iostream>
 #include <fstream>
 #include <unistd.h>
@@ -35,10 +36,10 @@
 #include <boost/program_options.hpp>
 #include <boost/json.hpp>
 #include <boost/json/src.hpp>
-#include <cassobs/dbconnection_observations.h>
 #include <cassandra.h>
 #include <cassobs/dto/virtual_station.h>
 
+#include "storage/observations_storage.h"
 #include "config.h"
 #include "../cassandra_utils.h"
 #include "virtual/virtual_obs_computer.h"
@@ -68,6 +69,7 @@ int main(int argc, char** argv)
 	std::string pguser;
 	std::string pgpassword;
 	std::string pgaddress;
+	StorageConfiguration storageConfig;
 	std::vector<std::string> namedStations;
 	std::string apiKey;
 
@@ -79,6 +81,9 @@ int main(int argc, char** argv)
 		("pguser", po::value<std::string>(&pguser), "PostgreSQL database username")
 		("pgpassword", po::value<std::string>(&pgpassword), "PostgreSQL database password")
 		("pghost", po::value<std::string>(&pgaddress), "PostgreSQL database IP address or domain name")
+		("storage", po::value<std::string>(&storageConfig.backend), "storage backend, 'cassandra' (Cassandra and PostgreSQL databases) or 'memory' (in-process stand-in keeping everything in memory, for benchmarks), defaults to 'cassandra'")
+		("station-table", po::value<std::string>(&storageConfig.stationTable), "with the 'memory' storage, file listing the stations and connectors to serve")
+		("storage-latency", po::value<unsigned long>(&storageConfig.latency), "with the 'memory' storage, delay in microseconds added to each call, defaults to 0")
 	;
 
 	po::options_description desc("Allowed options");
@@ -146,7 +151,9 @@ int main(int argc, char** argv)
 
 		// Start the Objenious downloaders workers (one per Objenious station)
 		std::vector<VirtualStation> virtualStations;
-		DbConnectionObservations db{address, user, password, pgaddress, pguser, pgpassword};
+		std::unique_ptr<ObservationsStorage> storage = ObservationsStorage::create(storageConfig,
+			address, user, password, pgaddress, pguser, pgpassword);
+		ObservationsStorage& db = *storage;
 		db.getAllVirtualStations(virtualStations);
 		std::cerr << "Got the list of stations from the db" << std::endl;
 